@@ -0,0 +1,205 @@
+/**
+ * @file    almacenconfig.cpp
+ * @brief   Configuración clave-valor en RAM con escritura diferida por espacio.
+ */
+
+#include "almacenconfig.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Copia con corte; devuelve false si no entraba (no se usa strlcpy para
+// compilar igual en el host)
+static bool copiarTexto(char* destino, size_t capacidad, const char* origen) {
+    size_t n = strlen(origen);
+    if (n >= capacidad) return false;
+    memcpy(destino, origen, n + 1);
+    return true;
+}
+
+uint8_t AlmacenConfig::espacio(const char* nombre, bool crear) {
+    for (uint8_t i = 0; i < nEspacios; ++i) {
+        if (strcmp(espacios[i], nombre) == 0) return i;
+    }
+    if (!crear || !*nombre || nEspacios >= WM_CONFIG_ESPACIOS) return NINGUNO;
+    if (!copiarTexto(espacios[nEspacios], sizeof(espacios[0]), nombre)) return NINGUNO;
+    return nEspacios++;
+}
+
+EntradaConfig* AlmacenConfig::buscar(uint8_t e, const char* clave) {
+    for (EntradaConfig& entrada : entradas) {
+        if (entrada.clave[0] && entrada.espacio == e && strcmp(entrada.clave, clave) == 0) return &entrada;
+    }
+    return nullptr;
+}
+
+const EntradaConfig* AlmacenConfig::buscar(uint8_t e, const char* clave) const {
+    return const_cast<AlmacenConfig*>(this)->buscar(e, clave);
+}
+
+bool AlmacenConfig::poner(uint8_t e, const char* clave, TipoValor tipo, const char* valor, bool marcar) {
+    if (e >= nEspacios || (marcar && protegido(e)) || !*clave || strlen(clave) >= sizeof(entradas[0].clave) ||
+        strlen(valor) >= sizeof(entradas[0].valor)) {
+        return false;
+    }
+
+    EntradaConfig* entrada = buscar(e, clave);
+    if (entrada) {
+        if (entrada->tipo == tipo && strcmp(entrada->valor, valor) == 0) return true;   // sin cambios
+    } else {
+        for (EntradaConfig& libre : entradas) {
+            if (!libre.clave[0]) {
+                entrada = &libre;
+                break;
+            }
+        }
+        if (!entrada) return false;
+        entrada->espacio = e;
+        copiarTexto(entrada->clave, sizeof(entrada->clave), clave);
+    }
+    entrada->tipo = tipo;
+    copiarTexto(entrada->valor, sizeof(entrada->valor), valor);
+    if (marcar) sucios |= 1u << e;
+    return true;
+}
+
+bool AlmacenConfig::set(uint8_t e, const char* clave, const char* valor) {
+    return poner(e, clave, TipoValor::TEXTO, valor, true);
+}
+
+bool AlmacenConfig::set(uint8_t e, const char* clave, long valor) {
+    char texto[12];
+    snprintf(texto, sizeof(texto), "%ld", valor);
+    return poner(e, clave, TipoValor::ENTERO, texto, true);
+}
+
+bool AlmacenConfig::set(uint8_t e, const char* clave, double valor) {
+    if (isnan(valor) || isinf(valor)) return false;     // JSON no los representa
+    char texto[24];
+    snprintf(texto, sizeof(texto), "%.9g", valor);
+    return poner(e, clave, TipoValor::REAL, texto, true);
+}
+
+bool AlmacenConfig::set(uint8_t e, const char* clave, bool valor) {
+    return poner(e, clave, TipoValor::BOOLEANO, valor ? "true" : "false", true);
+}
+
+bool AlmacenConfig::cargar(uint8_t e, const char* clave, TipoValor tipo, const char* valor) {
+    return poner(e, clave, tipo, valor, false);
+}
+
+bool AlmacenConfig::borrar(uint8_t e, const char* clave) {
+    EntradaConfig* entrada = buscar(e, clave);
+    if (!entrada || protegido(e)) return false;
+    entrada->clave[0] = '\0';
+    sucios |= 1u << e;
+    return true;
+}
+
+void AlmacenConfig::vaciar(uint8_t e) {
+    for (EntradaConfig& entrada : entradas) {
+        if (e == NINGUNO || entrada.espacio == e) entrada.clave[0] = '\0';
+    }
+    if (e == NINGUNO) {
+        sucios = 0;
+        protegidos = 0;
+    } else if (e < nEspacios) {
+        sucios &= ~(1u << e);
+        protegidos &= ~(1u << e);
+    }
+}
+
+bool AlmacenConfig::contiene(uint8_t e, const char* clave) const {
+    return buscar(e, clave) != nullptr;
+}
+
+const char* AlmacenConfig::getString(uint8_t e, const char* clave, const char* porDefecto) const {
+    const EntradaConfig* entrada = buscar(e, clave);
+    return entrada ? entrada->valor : porDefecto;
+}
+
+int32_t AlmacenConfig::getInt(uint8_t e, const char* clave, int32_t porDefecto) const {
+    const EntradaConfig* entrada = buscar(e, clave);
+    if (!entrada) return porDefecto;
+    if (entrada->tipo == TipoValor::BOOLEANO) return entrada->valor[0] == 't';
+    char* fin;
+    long v = strtol(entrada->valor, &fin, 10);
+    return fin == entrada->valor ? porDefecto : static_cast<int32_t>(v);
+}
+
+float AlmacenConfig::getFloat(uint8_t e, const char* clave, float porDefecto) const {
+    const EntradaConfig* entrada = buscar(e, clave);
+    if (!entrada) return porDefecto;
+    char* fin;
+    double v = strtod(entrada->valor, &fin);
+    return fin == entrada->valor ? porDefecto : static_cast<float>(v);
+}
+
+bool AlmacenConfig::getBool(uint8_t e, const char* clave, bool porDefecto) const {
+    const EntradaConfig* entrada = buscar(e, clave);
+    if (!entrada) return porDefecto;
+    const char* v = entrada->valor;
+    if (strcmp(v, "true") == 0 || strcmp(v, "1") == 0) return true;
+    if (strcmp(v, "false") == 0 || strcmp(v, "0") == 0) return false;
+    return porDefecto;
+}
+
+void AlmacenConfig::empezarGuardado(uint8_t e) {
+    sucios &= ~(1u << e);
+}
+
+void AlmacenConfig::guardadoFallido(uint8_t e) {
+    sucios |= 1u << e;
+}
+
+bool AlmacenConfig::copiar(uint8_t i, EntradaConfig& destino) const {
+    if (i >= WM_CONFIG_CLAVES || !entradas[i].clave[0]) return false;
+    destino = entradas[i];
+    return true;
+}
+
+// Escapa comillas, barras y bytes de control como pide JSON. Corta antes del
+// primer carácter cuyo escape no entra entero (con el '\0')
+size_t AlmacenConfig::escaparJson(const char* texto, char* destino, size_t capacidad) {
+    static const char HEX[] = "0123456789abcdef";
+    if (!capacidad) return 0;
+    size_t n = 0;
+    for (const char* p = texto; *p; ++p) {
+        uint8_t c = static_cast<uint8_t>(*p);
+        size_t escape = c == '"' || c == '\\' ? 2 : c < 0x20 ? 6 : 1;
+        if (n + escape >= capacidad) break;
+        if (c == '"' || c == '\\') {
+            destino[n++] = '\\';
+            destino[n++] = c;
+        } else if (c < 0x20) {
+            n += snprintf(destino + n, capacidad - n, "\\u00%c%c", HEX[c >> 4], HEX[c & 0x0F]);
+        } else {
+            destino[n++] = c;
+        }
+    }
+    destino[n] = '\0';
+    return n;
+}
+
+size_t AlmacenConfig::largoJson(const char* texto) {
+    size_t n = 0;
+    for (const char* p = texto; *p; ++p) {
+        uint8_t c = static_cast<uint8_t>(*p);
+        n += c == '"' || c == '\\' ? 2 : c < 0x20 ? 6 : 1;
+    }
+    return n;
+}
+
+size_t AlmacenConfig::comoJson(const EntradaConfig& entrada, bool primera, char* destino, size_t capacidad) {
+    size_t n = snprintf(destino, capacidad, "%s\"", primera ? "" : ",");
+    n += escaparJson(entrada.clave, destino + n, capacidad - n);
+    if (entrada.tipo == TipoValor::TEXTO) {
+        n += snprintf(destino + n, capacidad - n, "\":\"");
+        n += escaparJson(entrada.valor, destino + n, capacidad - n);
+        n += snprintf(destino + n, capacidad - n, "\"");
+    } else {
+        n += snprintf(destino + n, capacidad - n, "\":%s", entrada.valor);
+    }
+    return n < capacidad ? n : capacidad - 1;
+}
@@ -0,0 +1,114 @@
+#ifndef ALMACEN_CONFIG_H
+#define ALMACEN_CONFIG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef WM_CONFIG_CLAVES
+#define WM_CONFIG_CLAVES   24   ///< pares clave-valor en RAM, entre todos los espacios
+#endif
+#ifndef WM_CONFIG_ESPACIOS
+#define WM_CONFIG_ESPACIOS 4    ///< espacios (un archivo JSON cada uno)
+#endif
+#ifndef WM_CONFIG_VALOR
+#define WM_CONFIG_VALOR    64   ///< bytes de cada valor, '\0' incluido
+#endif
+
+enum class TipoValor : uint8_t {
+    TEXTO,
+    ENTERO,
+    REAL,
+    BOOLEANO
+};
+
+/**
+ * @struct EntradaConfig
+ * @brief Un par clave-valor. El valor se guarda como texto y se convierte al
+ *        leer. Clave vacía = lugar libre.
+ */
+struct EntradaConfig {
+    uint8_t   espacio;                  ///< índice del espacio
+    TipoValor tipo;
+    char      clave[24];
+    char      valor[WM_CONFIG_VALOR];
+};
+
+/**
+ * @class AlmacenConfig
+ * @brief Configuración clave-valor en RAM, agrupada en espacios ("setup",
+ *        "iporton"...), cada uno respaldado por un archivo JSON plano.
+ *
+ * Se carga una vez; después get() no toca la flash y set() sólo marca el
+ * espacio como sucio si el valor cambió. Quien lo usa decide cuándo escribir
+ * (WifiManager junta los cambios y guarda desde update()). Un espacio cuyo
+ * archivo no entró entero se protege: set() y borrar() fallan, así nunca se
+ * reescribe sin lo que quedó afuera. Sin memoria dinámica y sin Arduino; no
+ * tiene cerrojo propio.
+ */
+class AlmacenConfig {
+public:
+    static constexpr uint8_t NINGUNO = 0xFF;   ///< espacio inexistente
+
+    /** Índice del espacio @p nombre; con @p crear lo agrega si hay lugar. */
+    uint8_t espacio(const char* nombre, bool crear = false);
+    const char* nombreEspacio(uint8_t e) const { return e < nEspacios ? espacios[e] : ""; }
+    uint8_t cantidadEspacios() const { return nEspacios; }
+
+    // -------- escritura (marcan sucio sólo si el valor cambia) --------
+    // int y long por separado: según la versión del IDF int32_t es uno u otro,
+    // y con un solo entero set(e, "k", 5) sería ambiguo
+    bool set(uint8_t e, const char* clave, const char* valor);
+    bool set(uint8_t e, const char* clave, int valor)  { return set(e, clave, static_cast<long>(valor)); }
+    bool set(uint8_t e, const char* clave, long valor);
+    bool set(uint8_t e, const char* clave, double valor);    ///< false con NaN o infinito
+    bool set(uint8_t e, const char* clave, bool valor);
+    bool borrar(uint8_t e, const char* clave);
+    /** Vacía un espacio (NINGUNO = todos) y lo deja limpio y sin proteger. */
+    void vaciar(uint8_t e = NINGUNO);
+    /** Deja @p e de sólo lectura: su archivo tiene más de lo que entra en RAM. */
+    void proteger(uint8_t e)           { if (e < nEspacios) protegidos |= 1u << e; }
+    bool protegido(uint8_t e) const    { return protegidos & (1u << e); }
+
+    /** Carga desde el archivo: como set() pero sin marcar sucio. */
+    bool cargar(uint8_t e, const char* clave, TipoValor tipo, const char* valor);
+
+    // -------- lectura --------
+    bool        contiene(uint8_t e, const char* clave) const;
+    const char* getString(uint8_t e, const char* clave, const char* porDefecto = "") const;
+    int32_t     getInt(uint8_t e, const char* clave, int32_t porDefecto = 0) const;
+    float       getFloat(uint8_t e, const char* clave, float porDefecto = 0) const;
+    bool        getBool(uint8_t e, const char* clave, bool porDefecto = false) const;
+
+    // -------- persistencia --------
+    bool     sucio(uint8_t e) const { return sucios & (1u << e); }
+    bool     pendiente() const      { return sucios != 0; }
+
+    /** Marca @p e como guardándose: lo que cambie mientras se escribe lo vuelve a ensuciar. */
+    void empezarGuardado(uint8_t e);
+    void guardadoFallido(uint8_t e);                           ///< vuelve a marcarlo sucio
+
+    /** Copia la entrada @p i (0..WM_CONFIG_CLAVES-1). false si está libre. */
+    bool copiar(uint8_t i, EntradaConfig& destino) const;
+    /** Escribe ,"clave":valor (sin coma si @p primera). @return bytes escritos */
+    static size_t comoJson(const EntradaConfig& entrada, bool primera, char* destino, size_t capacidad);
+    /** Copia @p texto escapado para una cadena JSON; corta si no entra. Lo
+     *  usan también /params y /scan. */
+    static size_t escaparJson(const char* texto, char* destino, size_t capacidad);
+    /** Largo de @p texto una vez escapado, sin el '\0'. */
+    static size_t largoJson(const char* texto);
+
+private:
+    EntradaConfig*       buscar(uint8_t e, const char* clave);
+    const EntradaConfig* buscar(uint8_t e, const char* clave) const;
+    bool poner(uint8_t e, const char* clave, TipoValor tipo, const char* valor, bool marcar);
+
+    EntradaConfig entradas[WM_CONFIG_CLAVES] = {};
+    char          espacios[WM_CONFIG_ESPACIOS][16] = {};
+    uint8_t       nEspacios = 0;
+    uint8_t       sucios = 0;                   ///< un bit por espacio
+    uint8_t       protegidos = 0;               ///< un bit por espacio de sólo lectura
+};
+
+static_assert(WM_CONFIG_ESPACIOS <= 8, "los espacios sucios se marcan en un uint8_t");
+
+#endif
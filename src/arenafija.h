@@ -0,0 +1,59 @@
+#ifndef ARENA_FIJA_H
+#define ARENA_FIJA_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @class ArenaFija
+ * @brief Memoria temporal de N bytes para armar textos durante un pedido HTTP.
+ *
+ * reservar() sólo avanza un índice y reiniciar() lo vuelve a cero al terminar
+ * el manejador, así los textos de una respuesta (cabeceras, mensajes) no pasan
+ * por el heap ni lo fragmentan. Lo reservado vale hasta el próximo reiniciar().
+ */
+template <size_t N>
+class ArenaFija {
+public:
+    /** @return nullptr si no entra */
+    void* reservar(size_t bytes) {
+        size_t inicio = (usado + 3) & ~static_cast<size_t>(3);
+        if (inicio + bytes > N) {
+            ++fallos;
+            return nullptr;
+        }
+        usado = inicio + bytes;
+        if (usado > maximo) maximo = usado;
+        return datos + inicio;
+    }
+
+    /** printf a la arena. Si no entra devuelve "" (nunca nullptr). */
+    const char* formatear(const char* formato, ...) {
+        va_list args;
+        va_start(args, formato);
+        va_list copia;
+        va_copy(copia, args);
+        int largo = vsnprintf(nullptr, 0, formato, copia);
+        va_end(copia);
+
+        char* destino = largo >= 0 ? static_cast<char*>(reservar(static_cast<size_t>(largo) + 1)) : nullptr;
+        if (destino) vsnprintf(destino, static_cast<size_t>(largo) + 1, formato, args);
+        va_end(args);
+        return destino ? destino : "";
+    }
+
+    void   reiniciar()      { usado = 0; }
+    size_t enUso() const    { return usado; }
+    size_t pico() const     { return maximo; }     ///< para dimensionar N
+    uint32_t sinLugar() const { return fallos; }   ///< reservas que no entraron
+
+private:
+    alignas(4) uint8_t datos[N];
+    size_t   usado  = 0;
+    size_t   maximo = 0;
+    uint32_t fallos = 0;
+};
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * @file    boton.cpp
+ * @brief   Antirrebote y pulsación larga del botón de borrado.
+ */
+
+#include "boton.h"
+
+EventoBoton Boton::actualizar(bool presionado, uint32_t ahoraMs) {
+    if (presionado != crudo) {
+        crudo = presionado;
+        cambioCrudo = ahoraMs;
+    }
+    if (crudo != estable && ahoraMs - cambioCrudo >= config.antirreboteMs) {
+        estable = crudo;
+        if (estable) {
+            desde = cambioCrudo;        // se mide desde el flanco, no desde el filtro
+            avisado = false;
+            return EventoBoton::PRESIONADO;
+        }
+        return avisado ? EventoBoton::NINGUNO : EventoBoton::SOLTADO;
+    }
+    if (estable && !avisado && ahoraMs - desde >= config.mantenerMs) {
+        avisado = true;
+        return EventoBoton::MANTENIDO;
+    }
+    return EventoBoton::NINGUNO;
+}
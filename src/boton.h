@@ -0,0 +1,50 @@
+#ifndef BOTON_H
+#define BOTON_H
+
+#include <stdint.h>
+
+/**
+ * @struct ConfigBoton
+ * @brief Tiempos del botón de borrado. Todos en ms.
+ */
+struct ConfigBoton {
+    uint16_t antirreboteMs = 30;      ///< el nivel debe quedarse quieto este tiempo
+    uint32_t mantenerMs    = 5000;    ///< pulsación larga que borra las credenciales
+};
+
+enum class EventoBoton : uint8_t {
+    NINGUNO,
+    PRESIONADO,     ///< flanco ya filtrado
+    SOLTADO,        ///< se soltó antes de llegar a mantenerMs
+    MANTENIDO       ///< llegó a mantenerMs (se informa una vez; soltarlo después no avisa)
+};
+
+/**
+ * @class Boton
+ * @brief Botón con antirrebote y pulsación larga, por sondeo y sin bloquear.
+ *
+ * Se le pasa el nivel leído en cada vuelta de update(); no espera ni toca
+ * pines, así que la conexión avanza mientras el usuario mantiene el botón.
+ * No depende de Arduino.
+ */
+class Boton {
+public:
+    void configurar(const ConfigBoton& nueva) { config = nueva; }
+    const ConfigBoton& configuracion() const { return config; }
+
+    /** @param presionado nivel crudo (true = apretado) */
+    EventoBoton actualizar(bool presionado, uint32_t ahoraMs);
+
+    bool     presionado() const { return estable; }
+    uint32_t presionadoMs(uint32_t ahoraMs) const { return estable ? ahoraMs - desde : 0; }
+
+private:
+    ConfigBoton config;
+    bool     crudo   = false;
+    bool     estable = false;
+    bool     avisado = false;   ///< ya se informó MANTENIDO en esta pulsación
+    uint32_t cambioCrudo = 0;
+    uint32_t desde = 0;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ * @file    cacheportal.cpp
+ * @brief   ETags y Cache-Control para las páginas del portal.
+ */
+
+#include "cacheportal.h"
+#include <stdio.h>
+#include <string.h>
+
+uint32_t CachePortal::fnv1a(const uint8_t* datos, size_t longitud, uint32_t hash) {
+    for (size_t i = 0; i < longitud; ++i) {
+        hash ^= datos[i];
+        hash *= 0x01000193u;
+    }
+    return hash;
+}
+
+bool CachePortal::registrar(const char* ruta, uint32_t hash, uint32_t longitud) {
+    if (cantidadArchivos >= WM_CACHE_ENTRADAS || strlen(ruta) >= sizeof(archivos[0].ruta)) return false;
+    Archivo& a = archivos[cantidadArchivos++];
+    memcpy(a.ruta, ruta, strlen(ruta) + 1);
+    snprintf(a.etag, sizeof(a.etag), "\"%08lx\"", static_cast<unsigned long>(hash));
+    a.longitud = longitud;
+    return true;
+}
+
+const char* CachePortal::etag(const char* ruta, uint32_t* longitud) const {
+    for (uint8_t i = 0; i < cantidadArchivos; ++i) {
+        if (strcmp(archivos[i].ruta, ruta) != 0) continue;
+        if (longitud) *longitud = archivos[i].longitud;
+        return archivos[i].etag;
+    }
+    return nullptr;
+}
+
+bool CachePortal::setMaxAge(const char* pagina, uint32_t segundos) {
+    for (uint8_t i = 0; i < cantidadPoliticas; ++i) {
+        if (strcmp(politicas[i].pagina, pagina) == 0) {
+            politicas[i].maxAge = segundos;
+            return true;
+        }
+    }
+    if (cantidadPoliticas >= WM_CACHE_ENTRADAS || strlen(pagina) >= sizeof(politicas[0].pagina)) return false;
+    Politica& p = politicas[cantidadPoliticas++];
+    memcpy(p.pagina, pagina, strlen(pagina) + 1);
+    p.maxAge = segundos;
+    return true;
+}
+
+uint32_t CachePortal::maxAge(const char* pagina) const {
+    for (uint8_t i = 0; i < cantidadPoliticas; ++i) {
+        if (strcmp(politicas[i].pagina, pagina) == 0) return politicas[i].maxAge;
+    }
+    return 0;
+}
+
+void CachePortal::cacheControl(const char* pagina, char* destino, size_t capacidad) const {
+    uint32_t segundos = maxAge(pagina);
+    if (segundos == 0) snprintf(destino, capacidad, "no-cache");
+    else snprintf(destino, capacidad, "max-age=%lu", static_cast<unsigned long>(segundos));
+}
+
+// Recorre la lista separada por comas sin copiarla. Las ETags débiles (W/)
+// valen igual: para If-None-Match la comparación es débil (RFC 9110, 13.1.2).
+bool CachePortal::coincide(const char* ifNoneMatch, const char* etag) {
+    if (!ifNoneMatch || !etag) return false;
+    size_t largoEtag = strlen(etag);
+    const char* p = ifNoneMatch;
+    while (*p) {
+        while (*p == ' ' || *p == ',') ++p;
+        if (*p == '*') return true;
+        if (p[0] == 'W' && p[1] == '/') p += 2;
+        const char* fin = p;
+        while (*fin && *fin != ',') ++fin;
+        const char* ultimo = fin;
+        while (ultimo > p && ultimo[-1] == ' ') --ultimo;
+        if (static_cast<size_t>(ultimo - p) == largoEtag && memcmp(p, etag, largoEtag) == 0) return true;
+        p = fin;
+    }
+    return false;
+}
@@ -0,0 +1,62 @@
+#ifndef CACHE_PORTAL_H
+#define CACHE_PORTAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef WM_CACHE_ENTRADAS
+#define WM_CACHE_ENTRADAS 8     ///< archivos del portal con ETag y políticas de Cache-Control
+#endif
+
+/**
+ * @class CachePortal
+ * @brief ETags y Cache-Control de las páginas del portal.
+ *
+ * Las páginas embebidas traen su ETag desde tools/embed_portal.py. Las de
+ * LittleFS se hashean una sola vez al montar (FNV-1a 32, el mismo que usa el
+ * script) y quedan en una tabla chica por ruta. Después la tabla sólo se lee,
+ * así que la pueden consultar a la vez el servidor síncrono y el asíncrono.
+ * No depende de Arduino.
+ */
+class CachePortal {
+public:
+    static constexpr uint32_t FNV_INICIAL = 0x811C9DC5u;
+    static constexpr size_t   LARGO_ETAG  = 11;   ///< "xxxxxxxx" con comillas y '\0'
+
+    /** FNV-1a incremental: pasar el resultado anterior para seguir un archivo por partes. */
+    static uint32_t fnv1a(const uint8_t* datos, size_t longitud, uint32_t hash = FNV_INICIAL);
+
+    // -------- ETags de archivos (se llenan al montar) --------
+    void limpiar() { cantidadArchivos = 0; }
+    bool registrar(const char* ruta, uint32_t hash, uint32_t longitud);  ///< false si la tabla está llena
+    /** nullptr si la ruta no se indexó. @p longitud recibe el tamaño del archivo. */
+    const char* etag(const char* ruta, uint32_t* longitud = nullptr) const;
+
+    // -------- políticas por página --------
+    /** max-age en segundos para @p pagina ("index.html"); 0 = no-cache (revalidar con ETag). */
+    bool setMaxAge(const char* pagina, uint32_t segundos);
+    uint32_t maxAge(const char* pagina) const;
+    /** Valor de Cache-Control para @p pagina ("no-cache" o "max-age=N"). */
+    void cacheControl(const char* pagina, char* destino, size_t capacidad) const;
+
+    /** ¿Alguna de las ETags de If-None-Match (lista, W/ o "*") es @p etag? */
+    static bool coincide(const char* ifNoneMatch, const char* etag);
+
+private:
+    struct Archivo {
+        char     ruta[64];
+        char     etag[LARGO_ETAG];
+        uint32_t longitud;
+    };
+    struct Politica {
+        char     pagina[24];
+        uint32_t maxAge;
+    };
+
+    Archivo  archivos[WM_CACHE_ENTRADAS];
+    uint8_t  cantidadArchivos = 0;
+    Politica politicas[WM_CACHE_ENTRADAS];
+    uint8_t  cantidadPoliticas = 0;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef CADENA_FIJA_H
+#define CADENA_FIJA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @class CadenaFija
+ * @brief Texto de hasta N bytes en un arreglo propio, sin memoria dinámica.
+ *
+ * Reemplaza a String en los datos que viven todo el programa (SSID, clave,
+ * prefijo de rutas). Lo que no entra se trunca. c_str(), length() e isEmpty()
+ * se llaman como en String para no tocar a quienes ya los usaban.
+ */
+template <size_t N>
+class CadenaFija {
+public:
+    CadenaFija() { texto[0] = '\0'; }
+    CadenaFija(const char* s) { asignar(s); }
+    CadenaFija& operator=(const char* s) { asignar(s); return *this; }
+
+    /** @return false si hubo que truncar */
+    bool asignar(const char* s) {
+        largo = 0;
+        return agregar(s);
+    }
+
+    /** @return false si hubo que truncar */
+    bool agregar(const char* s) {
+        if (!s) s = "";
+        while (*s && largo < N) texto[largo++] = *s++;
+        texto[largo] = '\0';
+        return *s == '\0';
+    }
+
+    const char* c_str() const   { return texto; }
+    size_t      length() const  { return largo; }
+    bool        isEmpty() const { return largo == 0; }
+    char        ultimo() const  { return largo ? texto[largo - 1] : '\0'; }
+    bool operator==(const char* s) const { return strcmp(texto, s ? s : "") == 0; }
+    bool operator!=(const char* s) const { return !(*this == s); }
+    static constexpr size_t capacidad() { return N; }
+
+private:
+    char   texto[N + 1];
+    size_t largo = 0;
+};
+
+typedef CadenaFija<32> CadenaSsid;     ///< 802.11: SSID de hasta 32 bytes
+typedef CadenaFija<64> CadenaClave;    ///< WPA: hasta 63 caracteres o 64 hexadecimales
+
+#endif
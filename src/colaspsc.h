@@ -0,0 +1,51 @@
+#ifndef COLA_SPSC_H
+#define COLA_SPSC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @class ColaSPSC
+ * @brief Cola circular sin bloqueos para un productor y un consumidor.
+ *
+ * Pensada para pasar datos de una tarea (p. ej. la de eventos WiFi) a la de
+ * loop() sin cerrojos ni memoria dinámica. Sólo usa cargas y guardados
+ * atómicos de 32 bits, que son libres de bloqueo en todos los ESP32.
+ * @tparam N capacidad; debe ser potencia de 2
+ */
+template <typename T, uint8_t N>
+class ColaSPSC {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N debe ser potencia de 2");
+
+public:
+    /** Sólo el productor. @return false si estaba llena (el dato se pierde) */
+    bool poner(const T& dato) {
+        uint32_t e = escritura.load(std::memory_order_relaxed);
+        if (e - lectura.load(std::memory_order_acquire) >= N) return false;
+        datos[e & (N - 1)] = dato;
+        escritura.store(e + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Sólo el consumidor. @return false si estaba vacía */
+    bool sacar(T& dato) {
+        uint32_t l = lectura.load(std::memory_order_relaxed);
+        if (l == escritura.load(std::memory_order_acquire)) return false;
+        dato = datos[l & (N - 1)];
+        lectura.store(l + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t cantidad() const {
+        return escritura.load(std::memory_order_acquire) - lectura.load(std::memory_order_acquire);
+    }
+    static constexpr size_t capacidad() { return N; }
+
+private:
+    T datos[N];
+    std::atomic<uint32_t> escritura{0};
+    std::atomic<uint32_t> lectura{0};
+};
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * @file    dnscautivo.cpp
+ * @brief   DNS cautivo del portal sobre un socket UDP no bloqueante de lwIP.
+ */
+
+#include "dnscautivo.h"
+#include <string.h>
+#include <lwip/sockets.h>
+
+static inline uint16_t leer16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+static inline void escribir16(uint8_t* p, uint16_t v) {
+    p[0] = v >> 8;
+    p[1] = v & 0xFF;
+}
+
+DnsCautivo::~DnsCautivo() {
+    stop();
+}
+
+bool DnsCautivo::begin(uint32_t ip, uint16_t puerto) {
+    stop();
+    memcpy(ipAp, &ip, sizeof(ipAp));
+
+    sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) return false;
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+
+    sockaddr_in dir;
+    memset(&dir, 0, sizeof(dir));
+    dir.sin_family      = AF_INET;
+    dir.sin_port        = htons(puerto);
+    dir.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(sock, reinterpret_cast<sockaddr*>(&dir), sizeof(dir)) < 0) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void DnsCautivo::stop() {
+    if (sock < 0) return;
+    close(sock);
+    sock = -1;
+}
+
+// Lee, responde en el mismo búfer y devuelve; sin datos recvfrom() vuelve con EWOULDBLOCK
+void DnsCautivo::update() {
+    if (sock < 0) return;
+
+    for (uint8_t i = 0; i < MAX_POR_UPDATE; ++i) {
+        sockaddr_in origen;
+        socklen_t lenOrigen = sizeof(origen);
+        int r = recvfrom(sock, buf, sizeof(buf), 0, reinterpret_cast<sockaddr*>(&origen), &lenOrigen);
+        if (r <= 0) return;
+
+        size_t len = responder(buf, static_cast<size_t>(r), sizeof(buf));
+        if (len == 0) {
+            ++cantDescartadas;
+            continue;
+        }
+        sendto(sock, buf, len, 0, reinterpret_cast<sockaddr*>(&origen), lenOrigen);
+        ++cantRespondidas;
+    }
+}
+
+bool DnsCautivo::excluir(const char* nombre) {
+    size_t n = nombre ? strlen(nombre) : 0;
+    if (n && nombre[n - 1] == '.') --n;
+    if (n == 0 || n >= sizeof(excluidos[0])) return false;
+
+    char normalizado[sizeof(excluidos[0])];
+    for (size_t i = 0; i < n; ++i) {
+        char c = nombre[i];
+        normalizado[i] = (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+    }
+    normalizado[n] = '\0';
+
+    if (excluido(normalizado, n)) return true;
+    if (cantExcluidos >= WM_DNS_EXCLUIDOS) return false;
+    memcpy(excluidos[cantExcluidos++], normalizado, n + 1);
+    return true;
+}
+
+// Coincide el nombre exacto o cualquier subdominio (corte en un '.')
+bool DnsCautivo::excluido(const char* nombre, size_t longitud) const {
+    for (uint8_t i = 0; i < cantExcluidos; ++i) {
+        size_t n = strlen(excluidos[i]);
+        if (longitud < n || memcmp(nombre + longitud - n, excluidos[i], n) != 0) continue;
+        if (longitud == n || nombre[longitud - n - 1] == '.') return true;
+    }
+    return false;
+}
+
+// Cabecera de 12 bytes, una pregunta y, para A/ANY, una respuesta que apunta
+// al nombre de la pregunta (puntero 0xC00C). Los demás tipos (AAAA, HTTPS…)
+// reciben NOERROR sin respuestas para que el cliente pase a preguntar A.
+size_t DnsCautivo::responder(uint8_t* p, size_t largo, size_t capacidad) const {
+    if (largo < 12 || largo > capacidad) return 0;
+
+    uint16_t flags = leer16(p + 2);
+    if (flags & 0x8000) return 0;                       // es una respuesta
+
+    if ((flags & 0x7800) != 0 || leer16(p + 4) != 1) {
+        // Otro opcode o varias preguntas: NOTIMP con la cabecera sola
+        escribir16(p + 2, 0x8000 | (flags & 0x7900) | 4);
+        memset(p + 4, 0, 8);
+        return 12;
+    }
+
+    char nombre[256];
+    size_t lenNombre = 0;
+    size_t i = 12;
+    for (;;) {
+        if (i >= largo) return 0;
+        uint8_t l = p[i++];
+        if (l == 0) break;
+        if (l & 0xC0) return 0;                         // sin compresión en la pregunta
+        if (i + l > largo || lenNombre + l + 1 >= sizeof(nombre)) return 0;
+        if (lenNombre) nombre[lenNombre++] = '.';
+        for (uint8_t k = 0; k < l; ++k) {
+            char c = static_cast<char>(p[i + k]);
+            nombre[lenNombre++] = (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+        }
+        i += l;
+    }
+    nombre[lenNombre] = '\0';
+
+    if (i + 4 > largo) return 0;
+    uint16_t tipo  = leer16(p + i);
+    uint16_t clase = leer16(p + i + 2);
+    size_t fin = i + 4;                                 // se descarta EDNS y lo demás
+
+    uint16_t rcode = 0;
+    bool conRespuesta = false;
+    if (excluido(nombre, lenNombre)) {
+        rcode = 3;                                      // NXDOMAIN
+    } else if ((tipo == 1 || tipo == 255) && (clase == 1 || clase == 255)) {
+        conRespuesta = fin + 16 <= capacidad;
+    }
+
+    escribir16(p + 2, 0x8400 | (flags & 0x0100) | rcode);   // QR, AA y RD de la consulta
+    escribir16(p + 6, conRespuesta ? 1 : 0);
+    memset(p + 8, 0, 4);                                // sin autoridad ni adicionales
+
+    if (conRespuesta) {
+        uint8_t* r = p + fin;
+        r[0] = 0xC0;
+        r[1] = 0x0C;
+        escribir16(r + 2, 1);                           // A
+        escribir16(r + 4, 1);                           // IN
+        escribir16(r + 6, TTL_S >> 16);
+        escribir16(r + 8, TTL_S & 0xFFFF);
+        escribir16(r + 10, sizeof(ipAp));
+        memcpy(r + 12, ipAp, sizeof(ipAp));
+        fin += 16;
+    }
+    return fin;
+}
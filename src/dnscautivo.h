@@ -0,0 +1,61 @@
+#ifndef DNS_CAUTIVO_H
+#define DNS_CAUTIVO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef WM_DNS_EXCLUIDOS
+#define WM_DNS_EXCLUIDOS 8      ///< nombres que pueden responder NXDOMAIN
+#endif
+
+/**
+ * @class DnsCautivo
+ * @brief Servidor DNS mínimo del portal: toda consulta A se responde con la IP
+ *        del AP, así los teléfonos abren el portal solos al conectarse.
+ *
+ * Usa un socket UDP no bloqueante y un único búfer fijo; la respuesta se arma
+ * sobre el mismo paquete recibido (la pregunta ya está en su lugar), por lo que
+ * no hay memoria dinámica por paquete. Se atiende desde update().
+ */
+class DnsCautivo {
+public:
+    static constexpr size_t   TAM_PAQUETE = 512;     ///< máximo DNS sobre UDP sin EDNS
+    static constexpr uint32_t TTL_S       = 60;
+    static constexpr uint8_t  MAX_POR_UPDATE = 4;    ///< acota el tiempo de cada update()
+
+    ~DnsCautivo();
+
+    /** @param ip IP del AP tal como la da IPAddress (orden de red) */
+    bool begin(uint32_t ip, uint16_t puerto = 53);
+    void stop();
+    void update();                ///< atiende las consultas pendientes sin bloquear
+    bool activo() const { return sock >= 0; }
+
+    /** Responde NXDOMAIN para @p nombre y sus subdominios (p. ej. "ota.miempresa.com") */
+    bool excluir(const char* nombre);
+    void limpiarExclusiones() { cantExcluidos = 0; }
+
+    /**
+     * Convierte en el lugar una consulta en su respuesta.
+     * @param largo     bytes recibidos
+     * @param capacidad tamaño del búfer
+     * @return bytes a enviar, o 0 si el paquete se descarta
+     */
+    size_t responder(uint8_t* paquete, size_t largo, size_t capacidad) const;
+
+    uint32_t respondidas() const { return cantRespondidas; }
+    uint32_t descartadas() const { return cantDescartadas; }
+
+private:
+    bool excluido(const char* nombre, size_t longitud) const;
+
+    int      sock = -1;
+    uint8_t  ipAp[4] = {0};
+    char     excluidos[WM_DNS_EXCLUIDOS][64];
+    uint8_t  cantExcluidos = 0;
+    uint32_t cantRespondidas = 0;
+    uint32_t cantDescartadas = 0;
+    uint8_t  buf[TAM_PAQUETE];
+};
+
+#endif
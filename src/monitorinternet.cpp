@@ -0,0 +1,147 @@
+/**
+ * @file    monitorinternet.cpp
+ * @brief   Verificación periódica de Internet en segundo plano.
+ */
+
+#include "monitorinternet.h"
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include <freertos/task.h>
+#include <climits>
+
+void MonitorInternet::configurarSonda(TipoSonda tipo, const char* host, uint16_t puerto,
+                                      const char* ruta, uint16_t timeoutMs) {
+    wmBloquear(cerrojo);
+    config.tipo = tipo;
+    strlcpy(config.host, host, sizeof(config.host));
+    config.puerto = puerto ? puerto : 80;
+    strlcpy(config.ruta, ruta ? ruta : "/", sizeof(config.ruta));
+    config.timeoutMs = timeoutMs;
+    wmDesbloquear(cerrojo);
+    forzar();
+}
+
+void MonitorInternet::setIntervalos(unsigned long okMs, unsigned long backoffMinMs, unsigned long backoffMaxMs) {
+    wmBloquear(cerrojo);
+    config.okMs = okMs;
+    config.backoffMin = backoffMinMs;
+    config.backoffMax = backoffMaxMs < backoffMinMs ? backoffMinMs : backoffMaxMs;
+    wmDesbloquear(cerrojo);
+}
+
+// Al perder el enlace el resultado anterior deja de valer; al recuperarlo se
+// sondea enseguida en lugar de esperar lo que quedaba del intervalo
+void MonitorInternet::setEnlace(bool conectado) {
+    if (conectado == enlace) return;
+    enlace = conectado;
+
+    if (!conectado) {
+        wmBloquear(cerrojo);
+        ultimo.alcance = Alcance::DESCONOCIDO;
+        ultimo.fallosSeguidos = 0;
+        ++ultimo.secuencia;
+        wmDesbloquear(cerrojo);
+        return;
+    }
+    forzar();
+}
+
+void MonitorInternet::activar() {
+    if (tareaHandle) return;
+    if (xTaskCreate(&MonitorInternet::tarea, "wm_internet", 4096, this, 1, &tareaHandle) != pdPASS) {
+        tareaHandle = nullptr;
+        Serial.println("⚠️ No se pudo crear la tarea de verificación de Internet.");
+        return;
+    }
+    if (enlace) forzar();
+}
+
+void MonitorInternet::forzar() {
+    if (tareaHandle) xTaskNotifyGive(tareaHandle);
+}
+
+EstadoAlcance MonitorInternet::estado() const {
+    wmBloquear(cerrojo);
+    EstadoAlcance copia = ultimo;
+    wmDesbloquear(cerrojo);
+    return copia;
+}
+
+unsigned long MonitorInternet::edadMs() const {
+    EstadoAlcance e = estado();
+    return e.alcance == Alcance::DESCONOCIDO ? ULONG_MAX : wmMillis() - e.momento;
+}
+
+// Sin fallos: intervalo normal. Con fallos: min, 2·min, 4·min… hasta max
+unsigned long MonitorInternet::proximaEspera(uint32_t fallosSeguidos, unsigned long okMs,
+                                             unsigned long minMs, unsigned long maxMs) {
+    if (fallosSeguidos == 0) return okMs;
+    unsigned long espera = minMs;
+    for (uint32_t i = 1; i < fallosSeguidos && espera < maxMs; ++i) espera <<= 1;
+    return espera < maxMs ? espera : maxMs;
+}
+
+void MonitorInternet::tarea(void* arg) {
+    static_cast<MonitorInternet*>(arg)->bucle();
+}
+
+// Duerme hasta el próximo turno (o hasta un forzar()) y sondea. Todo lo que
+// bloquea (DNS, TCP, HTTP) pasa acá, fuera de la tarea de loop().
+void MonitorInternet::bucle() {
+    for (;;) {
+        TickType_t espera = portMAX_DELAY;
+        if (enlace) {
+            EstadoAlcance e = estado();
+            wmBloquear(cerrojo);
+            unsigned long ms = e.alcance == Alcance::DESCONOCIDO
+                ? 0 : proximaEspera(e.fallosSeguidos, config.okMs, config.backoffMin, config.backoffMax);
+            wmDesbloquear(cerrojo);
+            espera = pdMS_TO_TICKS(ms);
+        }
+        ulTaskNotifyTake(pdTRUE, espera);
+        if (!enlace) continue;
+
+        wmBloquear(cerrojo);
+        Config cfg = config;
+        wmDesbloquear(cerrojo);
+
+        unsigned long inicio = wmMillis();
+        bool ok = sondear(cfg);
+        unsigned long fin = wmMillis();
+        if (!enlace) continue;              // el enlace cayó durante la sonda
+
+        wmBloquear(cerrojo);
+        ultimo.alcance        = ok ? Alcance::ONLINE : Alcance::SIN_INTERNET;
+        ultimo.momento        = fin;
+        ultimo.latenciaMs     = fin - inicio;
+        ultimo.fallosSeguidos = ok ? 0 : ultimo.fallosSeguidos + 1;
+        ++ultimo.secuencia;
+        wmDesbloquear(cerrojo);
+    }
+}
+
+bool MonitorInternet::sondear(const Config& cfg) {
+    switch (cfg.tipo) {
+    case TipoSonda::DNS: {
+        IPAddress ip;
+        return WiFi.hostByName(cfg.host, ip) == 1 && static_cast<uint32_t>(ip) != 0;
+    }
+    case TipoSonda::TCP: {
+        WiFiClient client;
+        bool ok = client.connect(cfg.host, cfg.puerto, cfg.timeoutMs);
+        client.stop();
+        return ok;
+    }
+    case TipoSonda::HTTP_204:
+    default: {
+        WiFiClient client;
+        HTTPClient http;
+        http.setConnectTimeout(cfg.timeoutMs);
+        http.setTimeout(cfg.timeoutMs);
+        if (!http.begin(client, cfg.host, cfg.puerto, cfg.ruta)) return false;
+        int httpCode = http.GET();
+        http.end();
+        return httpCode == 204;
+    }
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef MONITOR_INTERNET_H
+#define MONITOR_INTERNET_H
+
+#include <Arduino.h>
+#include "wifimanager_hal.h"
+
+/** Resultado cacheado de la verificación de Internet. */
+enum class Alcance : uint8_t {
+    DESCONOCIDO,    ///< sin enlace o todavía sin sondear
+    ONLINE,         ///< la última sonda respondió
+    SIN_INTERNET    ///< hay WiFi pero la última sonda falló
+};
+
+/** Cómo se verifica la salida a Internet. */
+enum class TipoSonda : uint8_t {
+    HTTP_204,       ///< GET http://host:puerto/ruta y se espera 204
+    TCP,            ///< sólo abrir una conexión a host:puerto
+    DNS             ///< sólo resolver host
+};
+
+/**
+ * @struct EstadoAlcance
+ * @brief Copia consistente del último resultado.
+ */
+struct EstadoAlcance {
+    Alcance       alcance        = Alcance::DESCONOCIDO;
+    unsigned long momento        = 0;   ///< wmMillis() del último resultado
+    uint32_t      latenciaMs     = 0;   ///< duración de la última sonda
+    uint32_t      fallosSeguidos = 0;
+    uint32_t      secuencia      = 0;   ///< cambia con cada resultado nuevo
+};
+
+/**
+ * @class MonitorInternet
+ * @brief Sondea la salida a Internet desde una tarea propia de FreeRTOS y deja
+ *        el resultado en caché, así consultarlo no bloquea nunca.
+ *
+ * Con Internet sondea cada INTERVALO_OK_MS; sin Internet reintenta con espera
+ * exponencial entre BACKOFF_MIN_MS y BACKOFF_MAX_MS. Sin enlace WiFi la tarea
+ * duerme hasta que setEnlace(true) la despierta.
+ *
+ * La tarea no existe hasta que alguien pide el resultado: activar() la crea
+ * (WifiManager::hayInternet() lo hace en la primera llamada), así un equipo que
+ * nunca pregunta por Internet no gasta pila ni tráfico en sondas.
+ */
+class MonitorInternet {
+public:
+    static constexpr unsigned long INTERVALO_OK_MS = 30000;
+    static constexpr unsigned long BACKOFF_MIN_MS  = 2000;
+    static constexpr unsigned long BACKOFF_MAX_MS  = 60000;
+    static constexpr uint16_t      TIMEOUT_MS      = 3000;
+
+    /** Sonda a usar. Con @p puerto 0 se usa el 80. @p ruta sólo aplica a HTTP_204. */
+    void configurarSonda(TipoSonda tipo, const char* host, uint16_t puerto = 0,
+                         const char* ruta = "/generate_204", uint16_t timeoutMs = TIMEOUT_MS);
+    void setIntervalos(unsigned long okMs, unsigned long backoffMinMs, unsigned long backoffMaxMs);
+
+    /** WifiManager avisa de cada cambio de enlace. No crea la tarea. */
+    void setEnlace(bool conectado);
+    /** Crea la tarea la primera vez y, con enlace, sondea enseguida. */
+    void activar();
+    bool activo() const { return tareaHandle != nullptr; }
+    void forzar();                          ///< sondea ya, sin esperar el intervalo (si está activo)
+
+    EstadoAlcance estado() const;
+    Alcance alcance() const { return estado().alcance; }
+    unsigned long edadMs() const;           ///< ULONG_MAX si todavía no hubo resultado
+
+    /** Espera antes de la próxima sonda según los fallos consecutivos. */
+    static unsigned long proximaEspera(uint32_t fallosSeguidos, unsigned long okMs,
+                                       unsigned long minMs, unsigned long maxMs);
+
+private:
+    struct Config {
+        TipoSonda     tipo       = TipoSonda::HTTP_204;
+        char          host[64]   = "clients3.google.com";
+        uint16_t      puerto     = 80;
+        char          ruta[64]   = "/generate_204";
+        uint16_t      timeoutMs  = TIMEOUT_MS;
+        unsigned long okMs       = INTERVALO_OK_MS;
+        unsigned long backoffMin = BACKOFF_MIN_MS;
+        unsigned long backoffMax = BACKOFF_MAX_MS;
+    };
+
+    static void tarea(void* arg);
+    void bucle();
+    static bool sondear(const Config& cfg);
+
+    mutable WmCerrojo cerrojo;
+    Config            config;
+    EstadoAlcance     ultimo;
+    volatile bool     enlace = false;
+    TaskHandle_t      tareaHandle = nullptr;
+};
+
+#endif
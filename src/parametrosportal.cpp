@@ -0,0 +1,249 @@
+/**
+ * @file    parametrosportal.cpp
+ * @brief   Campos propios del portal: registro, validación y esquema JSON.
+ */
+
+#include "parametrosportal.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+ParametroPortal* ParametrosPortal::nuevo(const char* id, const char* etiqueta, TipoParametro tipo) {
+    if (n >= WM_MAX_PARAMETROS || !id || !*id || strlen(id) >= sizeof(EntradaConfig::clave) ||
+        indice(id) >= 0 || strcmp(id, MARCA_FORMULARIO) == 0 ||
+        strcmp(id, "ssid") == 0 || strcmp(id, "password") == 0) {
+        return nullptr;
+    }
+    ParametroPortal& p = lista[n++];
+    p = ParametroPortal();
+    p.id = id;
+    p.etiqueta = etiqueta ? etiqueta : id;
+    p.tipo = tipo;
+    p.texto = "";
+    p.opciones = "";
+    return &p;
+}
+
+// Cierra el registro del último parámetro: si su objeto de /params no entra
+// en WM_PARAMETRO_JSON se quita, así la página nunca recibe JSON cortado.
+bool ParametrosPortal::confirmar() {
+    if (entraEnJson(n - 1)) return true;
+    --n;
+    return false;
+}
+
+bool ParametrosPortal::agregarTexto(const char* id, const char* etiqueta, const char* porDefecto,
+                                    uint8_t largoMaximo, uint8_t largoMinimo) {
+    ParametroPortal* p = nuevo(id, etiqueta, TipoParametro::TEXTO);
+    if (!p) return false;
+    p->texto  = porDefecto ? porDefecto : "";
+    p->minimo = largoMinimo;
+    p->maximo = largoMaximo < WM_CONFIG_VALOR ? largoMaximo : WM_CONFIG_VALOR - 1;
+    return confirmar();
+}
+
+bool ParametrosPortal::agregarEntero(const char* id, const char* etiqueta, int32_t porDefecto,
+                                     int32_t minimo, int32_t maximo) {
+    ParametroPortal* p = nuevo(id, etiqueta, TipoParametro::ENTERO);
+    if (!p) return false;
+    p->numero = porDefecto;
+    p->minimo = minimo;
+    p->maximo = maximo;
+    return confirmar();
+}
+
+bool ParametrosPortal::agregarBool(const char* id, const char* etiqueta, bool porDefecto) {
+    ParametroPortal* p = nuevo(id, etiqueta, TipoParametro::BOOLEANO);
+    if (!p) return false;
+    p->numero = porDefecto;
+    return confirmar();
+}
+
+bool ParametrosPortal::agregarOpciones(const char* id, const char* etiqueta, const char* opciones,
+                                       const char* porDefecto) {
+    if (!opciones || !*opciones) return false;
+    ParametroPortal* p = nuevo(id, etiqueta, TipoParametro::OPCIONES);
+    if (!p) return false;
+    p->opciones = opciones;
+    p->texto = porDefecto ? porDefecto : "";
+    return confirmar();
+}
+
+int ParametrosPortal::indice(const char* id) const {
+    for (uint8_t i = 0; i < n; ++i) {
+        if (strcmp(lista[i].id, id) == 0) return i;
+    }
+    return -1;
+}
+
+// ¿@p valor es una de las opciones "a|b|c"? Se compara sin copiar la lista.
+static bool esOpcion(const char* opciones, const char* valor) {
+    size_t largo = strlen(valor);
+    const char* p = opciones;
+    while (true) {
+        const char* fin = strchr(p, '|');
+        size_t n = fin ? static_cast<size_t>(fin - p) : strlen(p);
+        if (n == largo && strncmp(p, valor, n) == 0) return true;
+        if (!fin) return false;
+        p = fin + 1;
+    }
+}
+
+bool ParametrosPortal::validar(const ParametroPortal& p, const char* valor, char* destino, size_t capacidad) {
+    size_t largo = strlen(valor);
+    switch (p.tipo) {
+    case TipoParametro::TEXTO:
+        if (largo < static_cast<size_t>(p.minimo) || largo > static_cast<size_t>(p.maximo)) return false;
+        break;
+    case TipoParametro::ENTERO: {
+        char* fin;
+        long v = strtol(valor, &fin, 10);
+        if (fin == valor || *fin || v < p.minimo || v > p.maximo) return false;
+        snprintf(destino, capacidad, "%ld", v);
+        return true;
+    }
+    case TipoParametro::BOOLEANO:
+        // Una casilla tildada llega como "on" salvo que tenga value
+        if (strcmp(valor, "1") == 0 || strcmp(valor, "on") == 0 || strcmp(valor, "true") == 0) {
+            valor = "true";
+        } else if (strcmp(valor, "0") == 0 || strcmp(valor, "off") == 0 || strcmp(valor, "false") == 0) {
+            valor = "false";
+        } else {
+            return false;
+        }
+        largo = strlen(valor);
+        break;
+    case TipoParametro::OPCIONES:
+        if (!esOpcion(p.opciones, valor)) return false;
+        break;
+    }
+    if (largo >= capacidad) return false;
+    memcpy(destino, valor, largo + 1);
+    return true;
+}
+
+bool ParametrosPortal::recibir(const char* nombre, const char* valor) {
+    if (strcmp(nombre, MARCA_FORMULARIO) == 0) {
+        conMarca = true;
+        return true;
+    }
+    int i = indice(nombre);
+    if (i < 0) return true;
+    ParametroPortal& p = lista[i];
+    p.hayRecibido = validar(p, valor, p.recibido, sizeof(p.recibido));
+    return p.hayRecibido;
+}
+
+void ParametrosPortal::completar() {
+    if (conMarca) {
+        for (uint8_t i = 0; i < n; ++i) {
+            if (lista[i].tipo != TipoParametro::BOOLEANO || lista[i].hayRecibido) continue;
+            memcpy(lista[i].recibido, "false", sizeof("false"));
+            lista[i].hayRecibido = true;
+        }
+    }
+    conMarca = false;
+}
+
+void ParametrosPortal::descartar() {
+    for (uint8_t i = 0; i < n; ++i) lista[i].hayRecibido = false;
+    conMarca = false;
+}
+
+// Agrega al búfer. Si no entra devuelve @p capacidad y lo que sigue ya no
+// escribe: comoJson() termina en 0 en vez de mandar un objeto cortado.
+static size_t agregar(char* destino, size_t capacidad, size_t pos, const char* formato, ...) {
+    if (pos >= capacidad) return capacidad;
+    va_list args;
+    va_start(args, formato);
+    int escritos = vsnprintf(destino + pos, capacidad - pos, formato, args);
+    va_end(args);
+    if (escritos < 0 || pos + static_cast<size_t>(escritos) >= capacidad) return capacidad;
+    return pos + static_cast<size_t>(escritos);
+}
+
+static size_t campoTexto(char* destino, size_t capacidad, size_t pos, const char* clave, const char* valor) {
+    pos = agregar(destino, capacidad, pos, ",\"%s\":\"", clave);
+    if (pos >= capacidad) return capacidad;
+    size_t largo = AlmacenConfig::largoJson(valor);
+    if (AlmacenConfig::escaparJson(valor, destino + pos, capacidad - pos) != largo) return capacidad;
+    return agregar(destino, capacidad, pos + largo, "\"");
+}
+
+// {"type":"text|int|bool|enum","id":..,"label":..,...,"value":..}
+size_t ParametrosPortal::comoJson(uint8_t i, const char* actual, bool primero, char* destino, size_t capacidad) const {
+    static const char* const TIPOS[] = { "text", "int", "bool", "enum" };
+    const ParametroPortal& p = lista[i];
+    // Un valor guardado que el campo ya no acepta se muestra como el por defecto
+    char normalizado[WM_CONFIG_VALOR];
+    if (actual && !validar(p, actual, normalizado, sizeof(normalizado))) actual = nullptr;
+
+    size_t pos = agregar(destino, capacidad, 0, "%s{\"type\":\"%s\"", primero ? "" : ",",
+                         TIPOS[static_cast<uint8_t>(p.tipo)]);
+    pos = campoTexto(destino, capacidad, pos, "id", p.id);
+    pos = campoTexto(destino, capacidad, pos, "label", p.etiqueta);
+
+    switch (p.tipo) {
+    case TipoParametro::TEXTO:
+    case TipoParametro::ENTERO:
+        pos = agregar(destino, capacidad, pos, ",\"min\":%ld,\"max\":%ld",
+                      static_cast<long>(p.minimo), static_cast<long>(p.maximo));
+        if (p.tipo == TipoParametro::TEXTO) {
+            pos = campoTexto(destino, capacidad, pos, "value", actual ? actual : p.texto);
+        } else {
+            long v = actual ? strtol(actual, nullptr, 10) : p.numero;
+            pos = agregar(destino, capacidad, pos, ",\"value\":%ld", v);
+        }
+        break;
+    case TipoParametro::BOOLEANO: {
+        bool v = actual ? strcmp(normalizado, "true") == 0 : p.numero != 0;
+        pos = agregar(destino, capacidad, pos, ",\"value\":%s", v ? "true" : "false");
+        break;
+    }
+    case TipoParametro::OPCIONES:
+        pos = campoTexto(destino, capacidad, pos, "options", p.opciones);
+        pos = campoTexto(destino, capacidad, pos, "value", actual ? actual : p.texto);
+        break;
+    }
+    pos = agregar(destino, capacidad, pos, "}");
+    return pos < capacidad ? pos : 0;
+}
+
+// ¿El objeto del parámetro @p i entra en WM_PARAMETRO_JSON con el valor por
+// defecto y con el más largo que puede mostrar? Sólo se muestran valores que
+// validar() acepta: para un texto, hasta su largo máximo de bytes de control
+// (cada uno sale como \u00XX); para un entero, el extremo más largo del
+// rango; para opciones, cada una.
+bool ParametrosPortal::entraEnJson(uint8_t i) const {
+    const ParametroPortal& p = lista[i];
+    char buf[WM_PARAMETRO_JSON];
+    char peor[WM_CONFIG_VALOR];
+    if (!comoJson(i, nullptr, false, buf, sizeof(buf))) return false;
+
+    switch (p.tipo) {
+    case TipoParametro::TEXTO:
+        memset(peor, '\x01', static_cast<size_t>(p.maximo));
+        peor[p.maximo] = '\0';
+        return comoJson(i, peor, false, buf, sizeof(buf)) > 0;
+    case TipoParametro::ENTERO:
+        snprintf(peor, sizeof(peor), "%ld", static_cast<long>(p.minimo));
+        if (!comoJson(i, peor, false, buf, sizeof(buf))) return false;
+        snprintf(peor, sizeof(peor), "%ld", static_cast<long>(p.maximo));
+        return comoJson(i, peor, false, buf, sizeof(buf)) > 0;
+    case TipoParametro::BOOLEANO:
+        return comoJson(i, "false", false, buf, sizeof(buf)) > 0;
+    case TipoParametro::OPCIONES:
+        for (const char* o = p.opciones; ; ) {
+            const char* fin = strchr(o, '|');
+            size_t largo = fin ? static_cast<size_t>(fin - o) : strlen(o);
+            if (largo >= sizeof(peor)) return false;        // validar() tampoco la aceptaría
+            memcpy(peor, o, largo);
+            peor[largo] = '\0';
+            if (!comoJson(i, peor, false, buf, sizeof(buf))) return false;
+            if (!fin) return true;
+            o = fin + 1;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,101 @@
+#ifndef PARAMETROS_PORTAL_H
+#define PARAMETROS_PORTAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "almacenconfig.h"
+
+#ifndef WM_MAX_PARAMETROS
+#define WM_MAX_PARAMETROS 8     ///< campos propios que puede sumar la aplicación al portal
+#endif
+
+#ifndef WM_PARAMETRO_JSON
+#define WM_PARAMETRO_JSON 640   ///< búfer de un objeto de /params (etiqueta, opciones y valor)
+#endif
+
+enum class TipoParametro : uint8_t {
+    TEXTO,
+    ENTERO,
+    BOOLEANO,
+    OPCIONES        ///< uno de una lista fija ("a|b|c")
+};
+
+/**
+ * @struct ParametroPortal
+ * @brief Un campo propio del formulario del portal y su lugar de recepción.
+ *
+ * id, etiqueta, opciones y el texto por defecto no se copian: deben vivir
+ * todo el programa (literales). El id es también la clave en la configuración.
+ */
+struct ParametroPortal {
+    const char*   id;
+    const char*   etiqueta;
+    TipoParametro tipo;
+    const char*   texto;        ///< por defecto (TEXTO, OPCIONES)
+    const char*   opciones;     ///< OPCIONES: valores separados por '|'
+    int32_t       numero;       ///< por defecto (ENTERO, BOOLEANO)
+    int32_t       minimo;       ///< ENTERO: rango; TEXTO: largo mínimo
+    int32_t       maximo;       ///< ENTERO: rango; TEXTO: largo máximo
+    char          recibido[WM_CONFIG_VALOR];   ///< valor del formulario, ya validado
+    bool          hayRecibido;
+};
+
+/**
+ * @class ParametrosPortal
+ * @brief Registro de campos propios del portal (p. ej. servidor MQTT, id de
+ *        equipo, intervalos): esquema para la página, validación y lugar
+ *        reservado para cada valor recibido.
+ *
+ * Se registra todo antes de begin(). El formulario se valida campo por campo
+ * a medida que se recorre, directo a los lugares ya reservados; si algo no
+ * vale se descarta el envío entero. No depende de Arduino ni tiene cerrojo.
+ */
+class ParametrosPortal {
+public:
+    /** Nombre del campo oculto que agrega la página cuando dibujó los parámetros. */
+    static constexpr const char* MARCA_FORMULARIO = "wm_params";
+
+    // Devuelven false si no hay lugar, el id no vale o el objeto de /params
+    // (etiqueta, opciones y el peor valor que acepta el campo, todo escapado)
+    // no entra en WM_PARAMETRO_JSON.
+
+    bool agregarTexto(const char* id, const char* etiqueta, const char* porDefecto = "",
+                      uint8_t largoMaximo = WM_CONFIG_VALOR - 1, uint8_t largoMinimo = 0);
+    bool agregarEntero(const char* id, const char* etiqueta, int32_t porDefecto,
+                       int32_t minimo = INT32_MIN, int32_t maximo = INT32_MAX);
+    bool agregarBool(const char* id, const char* etiqueta, bool porDefecto = false);
+    bool agregarOpciones(const char* id, const char* etiqueta, const char* opciones, const char* porDefecto);
+
+    uint8_t cantidad() const { return n; }
+    const ParametroPortal& parametro(uint8_t i) const { return lista[i]; }
+    int indice(const char* id) const;           ///< -1 si no existe
+
+    // -------- recepción del formulario --------
+    /** Valida y guarda un campo. Nombres ajenos se ignoran (true); false si el valor no vale. */
+    bool recibir(const char* nombre, const char* valor);
+    /** Cierra el envío: sin la marca de la página no se toca nada; con ella,
+     *  las casillas sin tildar (que el navegador no envía) pasan a "false". */
+    void completar();
+    void descartar();
+    bool pendiente(uint8_t i) const { return lista[i].hayRecibido; }
+    void aplicado(uint8_t i)        { lista[i].hayRecibido = false; }
+
+    /** Normaliza el valor para el almacén. @return false si no es válido */
+    static bool validar(const ParametroPortal& p, const char* valor, char* destino, size_t capacidad);
+
+    /** Describe el parámetro @p i como objeto JSON para la página; @p actual
+     *  es el valor guardado (nullptr o uno que el campo no acepta = por
+     *  defecto). @return bytes escritos; 0 si no entra en @p capacidad */
+    size_t comoJson(uint8_t i, const char* actual, bool primero, char* destino, size_t capacidad) const;
+
+private:
+    ParametroPortal* nuevo(const char* id, const char* etiqueta, TipoParametro tipo);
+    bool confirmar();
+    bool entraEnJson(uint8_t i) const;
+
+    ParametroPortal lista[WM_MAX_PARAMETROS];
+    uint8_t         n = 0;
+    bool            conMarca = false;       ///< llegó MARCA_FORMULARIO en este envío
+};
+
+#endif
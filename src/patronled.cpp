@@ -0,0 +1,18 @@
+/**
+ * @file    patronled.cpp
+ * @brief   Patrones de parpadeo no bloqueantes para el LED de estado.
+ */
+
+#include "patronled.h"
+
+void MotorLed::setPatron(const PatronLed& nuevo, uint32_t ahoraMs) {
+    if (nuevo.bits == patron.bits && nuevo.pasos == patron.pasos && nuevo.pasoMs == patron.pasoMs) return;
+    patron = nuevo;
+    inicio = ahoraMs;
+}
+
+bool MotorLed::nivel(uint32_t ahoraMs) const {
+    if (patron.pasos == 0 || patron.pasoMs == 0) return false;
+    uint32_t paso = ((ahoraMs - inicio) / patron.pasoMs) % patron.pasos;
+    return (patron.bits >> paso) & 1u;
+}
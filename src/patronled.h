@@ -0,0 +1,35 @@
+#ifndef PATRON_LED_H
+#define PATRON_LED_H
+
+#include <stdint.h>
+
+/**
+ * @struct PatronLed
+ * @brief Secuencia de encendido que se repite: hasta 16 pasos de igual duración.
+ *
+ * Ej.: { 0b0101, 4, 100 } = dos destellos de 100 ms y 200 ms apagado.
+ */
+struct PatronLed {
+    uint16_t bits;      ///< bit 0 primero; 1 = encendido
+    uint8_t  pasos;     ///< bits usados (1..16); 0 = siempre apagado
+    uint16_t pasoMs;    ///< duración de cada paso
+};
+
+/**
+ * @class MotorLed
+ * @brief Reproduce un PatronLed sin bloquear.
+ *
+ * El nivel sale de la hora actual, así que no importa cada cuánto se consulte.
+ * Cambiar al mismo patrón no reinicia la fase. No depende de Arduino.
+ */
+class MotorLed {
+public:
+    void setPatron(const PatronLed& nuevo, uint32_t ahoraMs);
+    bool nivel(uint32_t ahoraMs) const;     ///< true = encendido
+
+private:
+    PatronLed patron = { 0, 0, 100 };
+    uint32_t  inicio = 0;
+};
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file    planreconexion.cpp
+ * @brief   Backoff exponencial con jitter para los reintentos de conexión.
+ */
+
+#include "planreconexion.h"
+
+void PlanReconexion::setAleatorio(Aleatorio funcion, void* contexto) {
+    generador = funcion;
+    contextoGenerador = contexto;
+}
+
+uint32_t PlanReconexion::aleatorio(uint32_t limite) {
+    uint32_t r;
+    if (generador) {
+        r = generador(contextoGenerador);
+    } else {
+        semilla ^= semilla << 13;
+        semilla ^= semilla >> 17;
+        semilla ^= semilla << 5;
+        r = semilla;
+    }
+    return limite == UINT32_MAX ? r : r % (limite + 1);
+}
+
+uint32_t PlanReconexion::registrarFallo(MotivoFallo m) {
+    motivo = m;
+    ++totalFallos;
+    ++porMotivo[static_cast<uint8_t>(m)];
+
+    if (m == MotivoFallo::CLAVE_INCORRECTA) {
+        if (clavesSeguidas < UINT8_MAX) ++clavesSeguidas;
+        if (config.maxFallosClave && clavesSeguidas >= config.maxFallosClave) {
+            parado = true;
+            return 0;
+        }
+    } else {
+        clavesSeguidas = 0;
+    }
+
+    if (m == MotivoFallo::AP_NO_ENCONTRADO) {
+        ++seguidos;
+        uint32_t mitad = config.lentoMs / 2;
+        return mitad + aleatorio(config.lentoMs - mitad);
+    }
+
+    // Tope de esta ronda: base·2^n sin pasar de maxMs (sin desbordar)
+    uint32_t tope = config.baseMs;
+    for (uint32_t i = 0; i < seguidos && tope < config.maxMs; ++i) {
+        tope = tope > config.maxMs / 2 ? config.maxMs : tope * 2;
+    }
+    if (tope > config.maxMs) tope = config.maxMs;
+    ++seguidos;
+    return aleatorio(tope);
+}
+
+void PlanReconexion::registrarExito() {
+    ++totalExitos;
+    seguidos = 0;
+    clavesSeguidas = 0;
+    motivo = MotivoFallo::NINGUNO;
+    parado = false;
+}
+
+void PlanReconexion::reanudar() {
+    parado = false;
+    seguidos = 0;
+    clavesSeguidas = 0;
+}
@@ -0,0 +1,75 @@
+#ifndef PLAN_RECONEXION_H
+#define PLAN_RECONEXION_H
+
+#include <stdint.h>
+
+/** Por qué terminó mal el último intento (o se cayó el enlace). */
+enum class MotivoFallo : uint8_t {
+    NINGUNO,
+    TIMEOUT,            ///< sin respuesta clara del driver
+    CLAVE_INCORRECTA,   ///< el AP rechazó la autenticación
+    AP_NO_ENCONTRADO,   ///< el SSID no aparece
+    ENLACE_PERDIDO,     ///< estaba conectado y se cayó
+    CANTIDAD
+};
+
+/**
+ * @struct ConfigReconexion
+ * @brief Parámetros del backoff. Todos los tiempos en ms.
+ */
+struct ConfigReconexion {
+    uint32_t baseMs         = 2000;     ///< tope del primer reintento
+    uint32_t maxMs          = 120000;   ///< tope del backoff exponencial
+    uint32_t lentoMs        = 60000;    ///< cadencia cuando el AP no aparece
+    uint8_t  maxFallosClave = 3;        ///< rechazos seguidos antes de detenerse (0 = nunca)
+};
+
+/**
+ * @class PlanReconexion
+ * @brief Decide cuánto esperar antes de cada reintento.
+ *
+ * Backoff exponencial con "full jitter": la espera es aleatoria entre 0 y
+ * min(maxMs, baseMs·2^n). Así, cuando un AP se reinicia, los equipos que lo
+ * pierden a la vez no vuelven todos en el mismo instante. Según el motivo:
+ * - CLAVE_INCORRECTA: tras maxFallosClave seguidos se detiene hasta reanudar().
+ * - AP_NO_ENCONTRADO: pasa a una cadencia lenta, entre lentoMs/2 y lentoMs.
+ * No depende de Arduino; el generador aleatorio se inyecta.
+ */
+class PlanReconexion {
+public:
+    typedef uint32_t (*Aleatorio)(void* contexto);
+
+    void configurar(const ConfigReconexion& nueva) { config = nueva; }
+    const ConfigReconexion& configuracion() const { return config; }
+    void setAleatorio(Aleatorio funcion, void* contexto);
+
+    /** @return espera en ms antes del próximo intento; 0 si quedó detenido */
+    uint32_t registrarFallo(MotivoFallo motivo);
+    void registrarExito();
+    void reanudar();                        ///< sale de detenido (p. ej. con clave nueva)
+
+    bool        detenido() const        { return parado; }
+    uint32_t    intentos() const        { return totalFallos + totalExitos; }
+    uint32_t    exitos() const          { return totalExitos; }
+    uint32_t    fallosSeguidos() const  { return seguidos; }
+    MotivoFallo ultimoMotivo() const    { return motivo; }
+    uint32_t    fallos(MotivoFallo m) const { return porMotivo[static_cast<uint8_t>(m)]; }
+
+private:
+    uint32_t aleatorio(uint32_t limite);    ///< uniforme en [0, limite]
+
+    ConfigReconexion config;
+    Aleatorio   generador = nullptr;
+    void*       contextoGenerador = nullptr;
+    uint32_t    semilla = 0x9E3779B9;       ///< xorshift32 si no se inyecta otro
+
+    bool        parado = false;
+    uint32_t    seguidos = 0;
+    uint8_t     clavesSeguidas = 0;
+    MotivoFallo motivo = MotivoFallo::NINGUNO;
+    uint32_t    totalFallos = 0;
+    uint32_t    totalExitos = 0;
+    uint32_t    porMotivo[static_cast<uint8_t>(MotivoFallo::CANTIDAD)] = {0};
+};
+
+#endif
@@ -0,0 +1,203 @@
+/**
+ * @file    portalasync.cpp
+ * @brief   Portal de configuración sobre ESPAsyncWebServer (WM_ASYNC_SERVER=1).
+ */
+
+#include "portalasync.h"
+
+#if WM_ASYNC_SERVER
+
+#include <ESPAsyncWebServer.h>
+#include <LittleFS.h>
+#include <new>
+
+PortalAsync::~PortalAsync() {
+    delete servidor;
+}
+
+void PortalAsync::iniciar(const PuentePortal& p, bool portal, bool metricas) {
+    puente = p;
+    bool nuevo = servidor == nullptr;
+    if (nuevo) servidor = new AsyncWebServer(80);
+
+    if (portal && !rutasPortal) {
+        servidor->on("/", HTTP_GET, [this](AsyncWebServerRequest* req) {
+            uint64_t inicio = wmMicros();
+            if (!servirArchivo(req, "index.html", 200)) {
+                req->send(500, "text/html", "<h1>Error: index.html no encontrado</h1>");
+            }
+            medir(RutaHttp::RAIZ, inicio);
+        });
+        servidor->on("/save", HTTP_ANY, [this](AsyncWebServerRequest* req) { handleSave(req); });
+        servidor->on("/scan", HTTP_GET, [this](AsyncWebServerRequest* req) { handleScan(req); });
+        servidor->on("/params", HTTP_GET, [this](AsyncWebServerRequest* req) { handleParams(req); });
+        servidor->onNotFound([this](AsyncWebServerRequest* req) {
+            uint64_t inicio = wmMicros();
+            req->redirect(puente.urlPortal);
+            medir(RutaHttp::NOT_FOUND, inicio);
+        });
+        rutasPortal = true;
+    }
+    if (metricas && !rutaMetricas) {
+        servidor->on("/metrics", HTTP_GET, [this](AsyncWebServerRequest* req) { handleMetrics(req); });
+        rutaMetricas = true;
+    }
+    if (nuevo) servidor->begin();
+}
+
+// Corre en la tarea de AsyncTCP: WifiMetrics toma su cerrojo
+void PortalAsync::medir(RutaHttp ruta, uint64_t inicioUs) {
+    uint64_t us = wmMicros() - inicioUs;
+    puente.metrics->registrarRuta(ruta, static_cast<uint32_t>((us + 999) / 1000));
+}
+
+static bool aceptaGzip(AsyncWebServerRequest* req) {
+    const AsyncWebHeader* h = req->getHeader("Accept-Encoding");
+    return h && strstr(h->value().c_str(), "gzip") != nullptr;
+}
+
+// Misma prioridad que WifiManager::servirArchivo(): embebido por defecto y, si
+// no, LittleFS, primero el ".gz" si el navegador lo acepta y después el plano.
+// AsyncFileResponse lo envía de a bloques. Con código 200 también agrega ETag
+// y Cache-Control, o contesta 304.
+bool PortalAsync::servirArchivo(AsyncWebServerRequest* req, const char* nombre, int codigo) {
+    const uint8_t* datos = nullptr;
+    size_t longitud = 0;
+    const char* tipo = nullptr;
+    const char* etag = nullptr;
+    bool embebido = puente.recursoEmbebido(nombre, &datos, &longitud, &tipo, &etag);
+    char control[24];
+    puente.cache->cacheControl(nombre, control, sizeof(control));
+
+    if (!*puente.portalEmbebido || !embebido) {
+        char ruta[100];
+        bool gzip = false;
+        if (aceptaGzip(req)) {
+            snprintf(ruta, sizeof(ruta), "%s%s.gz", puente.htmlPathPrefix, nombre);
+            gzip = LittleFS.exists(ruta);
+        }
+        if (!gzip) snprintf(ruta, sizeof(ruta), "%s%s", puente.htmlPathPrefix, nombre);
+        if (gzip || LittleFS.exists(ruta)) {
+            uint32_t tam = 0;
+            const char* etagArchivo = codigo == 200 ? puente.cache->etag(ruta, &tam) : nullptr;
+            if (etagArchivo && noModificado(req, etagArchivo, tam)) return true;
+            AsyncWebServerResponse* resp = req->beginResponse(LittleFS, ruta, "text/html");
+            resp->setCode(codigo);
+            if (gzip) resp->addHeader("Content-Encoding", "gzip");
+            if (etagArchivo) {
+                resp->addHeader("ETag", etagArchivo);
+                resp->addHeader("Cache-Control", control);
+            }
+            req->send(resp);
+            return true;
+        }
+    }
+    if (!embebido) return false;
+
+    if (codigo == 200 && noModificado(req, etag, longitud)) return true;
+    AsyncWebServerResponse* resp = req->beginResponse_P(codigo, tipo, datos, longitud);
+    resp->addHeader("Content-Encoding", "gzip");
+    if (codigo == 200) {
+        resp->addHeader("ETag", etag);
+        resp->addHeader("Cache-Control", control);
+    }
+    req->send(resp);
+    return true;
+}
+
+// Contesta 304 si el navegador ya tiene esa versión de la página
+bool PortalAsync::noModificado(AsyncWebServerRequest* req, const char* etag, size_t longitud) {
+    if (!req->hasHeader("If-None-Match")) return false;
+    if (!CachePortal::coincide(req->getHeader("If-None-Match")->value().c_str(), etag)) return false;
+
+    AsyncWebServerResponse* resp = req->beginResponse(304);
+    resp->addHeader("ETag", etag);
+    req->send(resp);
+    puente.metrics->registrarNoModificado(longitud);
+    return true;
+}
+
+// Pasa cada campo del formulario ya decodificado por la librería a su lugar
+// reservado y después las credenciales. Si algún campo propio no vale,
+// recibirCredenciales() descarta el envío entero.
+static bool recibirFormulario(const PuentePortal& puente, AsyncWebServerRequest* req) {
+    for (size_t i = 0; i < req->params(); ++i) {
+        const AsyncWebParameter* p = req->getParam(i);
+        puente.recibirParametro(puente.contexto, p->name().c_str(), p->value().c_str());
+    }
+    return puente.recibirCredenciales(puente.contexto, req->arg("ssid").c_str(), req->arg("password").c_str());
+}
+
+// Responde enseguida; el guardado en flash y el reinicio los hace update()
+void PortalAsync::handleSave(AsyncWebServerRequest* req) {
+    uint64_t inicio = wmMicros();
+    if (req->method() != HTTP_POST) {
+        req->send(405, "text/plain", "Método no permitido");
+    } else if (!recibirFormulario(puente, req)) {
+        if (!servirArchivo(req, "error.html", 500)) {
+            req->send(500, "text/html", "<h1>Error: Faltan datos para guardar.</h1>");
+        }
+    } else if (!servirArchivo(req, "success.html", 200)) {
+        req->send(200, "text/html", "<h1>Guardado. Reiniciando...</h1>");
+    }
+    medir(RutaHttp::SAVE, inicio);
+}
+
+// El cuerpo sale de CursorJsonScan a medida que AsyncTCP pide bytes, sin armar
+// el JSON completo en memoria. El cursor vive en el heap hasta que se cierra la
+// conexión (AsyncTCP sigue pidiendo bytes después de que el manejador volvió);
+// el filler sólo guarda el puntero.
+void PortalAsync::handleScan(AsyncWebServerRequest* req) {
+    uint64_t inicio = wmMicros();
+    const WifiScanner& escaner = *puente.escaner;
+    *puente.scanPedido = true;
+
+    FiltroScan filtro;
+    static const char* parametros[] = { "min_rssi", "limit", "secure" };
+    for (const char* p : parametros) {
+        if (req->hasParam(p)) filtro.leer(p, req->getParam(p)->value().c_str());
+    }
+
+    CursorJsonScan* cursor = new (std::nothrow) CursorJsonScan(escaner, filtro);
+    if (!cursor) {
+        req->send(503, "text/plain", "Sin memoria");
+        medir(RutaHttp::SCAN, inicio);
+        return;
+    }
+    req->onDisconnect([cursor]() { delete cursor; });
+
+    AsyncWebServerResponse* resp = req->beginChunkedResponse("application/json",
+        [cursor](uint8_t* buf, size_t max, size_t) { return cursor->leer(buf, max); });
+    resp->addHeader("X-Scan-Generation", String(escaner.generacion()));
+    if (escaner.enCurso() || !escaner.vigente()) resp->addHeader("X-Scan-Pending", "1");
+    if (escaner.descartadas()) resp->addHeader("X-Scan-Truncated", String(escaner.descartadas()));
+    req->send(resp);
+    medir(RutaHttp::SCAN, inicio);
+}
+
+// Pocos parámetros y chicos: se escriben en un AsyncResponseStream
+void PortalAsync::handleParams(AsyncWebServerRequest* req) {
+    uint64_t inicio = wmMicros();
+    AsyncResponseStream* resp = req->beginResponseStream("application/json");
+    char buf[WM_PARAMETRO_JSON];
+    resp->write('[');
+    size_t n;
+    for (uint8_t i = 0; (n = puente.parametroJson(puente.contexto, i, i == 0, buf, sizeof(buf))) > 0; ++i) {
+        resp->write(reinterpret_cast<const uint8_t*>(buf), n);
+    }
+    resp->write(']');
+    req->send(resp);
+    medir(RutaHttp::PARAMS, inicio);
+}
+
+void PortalAsync::handleMetrics(AsyncWebServerRequest* req) {
+    uint64_t inicio = wmMicros();
+    AsyncResponseStream* resp = req->beginResponseStream("text/plain; version=0.0.4");
+    puente.metrics->exportarPrometheus([](const char* texto, size_t longitud, void* contexto) {
+        static_cast<AsyncResponseStream*>(contexto)->write(reinterpret_cast<const uint8_t*>(texto), longitud);
+    }, resp);
+    req->send(resp);
+    medir(RutaHttp::METRICS, inicio);
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef PORTAL_ASYNC_H
+#define PORTAL_ASYNC_H
+
+#include <Arduino.h>
+#include "wifiscanner.h"
+#include "wifimetrics.h"
+#include "cacheportal.h"
+#include "parametrosportal.h"
+
+#ifndef WM_ASYNC_SERVER
+#define WM_ASYNC_SERVER 0       ///< 1 = compilar el backend ESPAsyncWebServer (requiere la librería)
+#endif
+
+/**
+ * @struct PuentePortal
+ * @brief Lo que el portal asíncrono necesita de WifiManager.
+ *
+ * ESPAsyncWebServer y WebServer declaran cada uno su propio HTTP_GET/HTTP_POST,
+ * así que no pueden compartir unidad de compilación: portalasync.cpp no incluye
+ * wifimanager.h y recibe punteros a los datos y funciones que usa.
+ */
+struct PuentePortal {
+    WifiScanner*   escaner;
+    WifiMetrics*   metrics;
+    const char*    htmlPathPrefix;          ///< termina en '/'
+    const char*    urlPortal;               ///< Location de los redireccionamientos, de setupAP()
+    const bool*    portalEmbebido;
+    volatile bool* scanPedido;              ///< update() lanza el escaneo si hace falta
+    const CachePortal* cache;               ///< ETags y Cache-Control; sólo se lee
+
+    /** Deja las credenciales para que update() las guarde. false si no son válidas. */
+    bool (*recibirCredenciales)(void* contexto, const char* ssid, const char* password);
+    /** Un campo propio del formulario; se valida al recibirlo. */
+    bool (*recibirParametro)(void* contexto, const char* nombre, const char* valor);
+    /** Parámetro @p i como objeto JSON para /params; 0 cuando no hay más. */
+    size_t (*parametroJson)(void* contexto, uint8_t i, bool primero, char* destino, size_t capacidad);
+    /** Página compilada en flash (gzip). false si no existe. */
+    bool (*recursoEmbebido)(const char* nombre, const uint8_t** datos, size_t* longitud,
+                            const char** tipo, const char** etag);
+    void* contexto;
+};
+
+class AsyncWebServer;
+class AsyncWebServerRequest;
+
+/**
+ * @class PortalAsync
+ * @brief Backend del portal sobre ESPAsyncWebServer: varias conexiones a la
+ *        vez y manejadores que nunca bloquean.
+ *
+ * Los manejadores corren en la tarea de AsyncTCP. No escriben la flash ni
+ * tocan el driver WiFi: /save copia las credenciales y /scan pide el escaneo,
+ * y ambas cosas las completa update() en la tarea de loop().
+ */
+class PortalAsync {
+public:
+    ~PortalAsync();
+
+    /** Registra las rutas que falten y arranca el servidor la primera vez. */
+    void iniciar(const PuentePortal& puente, bool portal, bool metricas);
+
+private:
+#if WM_ASYNC_SERVER
+    bool servirArchivo(AsyncWebServerRequest* req, const char* nombre, int codigo);
+    bool noModificado(AsyncWebServerRequest* req, const char* etag, size_t longitud);
+    void handleSave(AsyncWebServerRequest* req);
+    void handleScan(AsyncWebServerRequest* req);
+    void handleParams(AsyncWebServerRequest* req);
+    void handleMetrics(AsyncWebServerRequest* req);
+    void medir(RutaHttp ruta, uint64_t inicioUs);
+#endif
+
+    PuentePortal    puente = {};
+    AsyncWebServer* servidor = nullptr;     ///< se crea al iniciar y vive hasta el reinicio
+    bool            rutasPortal  = false;
+    bool            rutaMetricas = false;
+};
+
+#endif
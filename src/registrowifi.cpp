@@ -0,0 +1,108 @@
+/**
+ * @file    registrowifi.cpp
+ * @brief   Lectura y escritura del registro binario de credenciales (/wifi.bin).
+ */
+
+#include "registrowifi.h"
+#include <string.h>
+
+// CRC32 IEEE 802.3 (el de zip/Ethernet) con tabla de 16 entradas: 64 bytes de flash
+uint32_t RegistroWifi::crc32(const uint8_t* datos, size_t longitud, uint32_t crc) {
+    static const uint32_t tabla[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < longitud; ++i) {
+        crc = tabla[(crc ^ datos[i]) & 0x0F] ^ (crc >> 4);
+        crc = tabla[(crc ^ (datos[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+static void copiarCampo(uint8_t& len, char* destino, size_t capacidad, const char* origen) {
+    size_t n = strnlen(origen, capacidad);
+    len = static_cast<uint8_t>(n);
+    memset(destino, 0, capacidad);
+    memcpy(destino, origen, n);
+}
+
+static void leerCampo(uint8_t len, const char* origen, size_t capacidad, char* destino) {
+    size_t n = len < capacidad ? len : capacidad;
+    memcpy(destino, origen, n);
+    destino[n] = '\0';
+}
+
+void RegistroWifi::empaquetar(const TablaRedes& redes, const CacheConexion& cache, Archivo& destino) {
+    memset(&destino, 0, sizeof(destino));
+    destino.magia     = MAGIA;
+    destino.version   = VERSION;
+    destino.capacidad = WM_MAX_REDES;
+    destino.cantidad  = redes.cantidad();
+    destino.longitud  = offsetof(Archivo, redes) + destino.cantidad * sizeof(Red);
+
+    if (cache.valida) {
+        copiarCampo(destino.cache.lenSsid, destino.cache.ssid, sizeof(destino.cache.ssid), cache.ssid);
+        memcpy(destino.cache.bssid, cache.bssid, sizeof(cache.bssid));
+        destino.cache.canal   = cache.canal;
+        destino.cache.ip      = cache.ip;
+        destino.cache.gateway = cache.gateway;
+        destino.cache.mascara = cache.mascara;
+        destino.cache.dns1    = cache.dns1;
+        destino.cache.dns2    = cache.dns2;
+    }
+
+    for (uint8_t i = 0; i < destino.cantidad; ++i) {
+        const RedGuardada& origen = redes.red(i);
+        Red& r = destino.redes[i];
+        copiarCampo(r.lenSsid, r.ssid, sizeof(r.ssid), origen.ssid);
+        copiarCampo(r.lenPassword, r.password, sizeof(r.password), origen.password);
+        r.ultimoExito = origen.ultimoExito;
+        r.fallos      = origen.fallos;
+        r.latenciaMs  = origen.latenciaMs;
+    }
+
+    const uint8_t* cuerpo = reinterpret_cast<const uint8_t*>(&destino) + offsetof(Archivo, capacidad);
+    destino.crc = crc32(cuerpo, destino.longitud - offsetof(Archivo, capacidad));
+}
+
+bool RegistroWifi::desempaquetar(const Archivo& origen, size_t leidos,
+                                 TablaRedes& redes, CacheConexion& cache) {
+    if (leidos < offsetof(Archivo, redes) || origen.magia != MAGIA || origen.version != VERSION) {
+        return false;
+    }
+    if (origen.longitud > leidos || origen.longitud < offsetof(Archivo, redes) ||
+        origen.cantidad > origen.capacidad ||
+        origen.longitud != offsetof(Archivo, redes) + origen.cantidad * sizeof(Red)) {
+        return false;
+    }
+
+    const uint8_t* cuerpo = reinterpret_cast<const uint8_t*>(&origen) + offsetof(Archivo, capacidad);
+    if (crc32(cuerpo, origen.longitud - offsetof(Archivo, capacidad)) != origen.crc) return false;
+
+    cache = CacheConexion();
+    if (origen.cache.canal != 0 && origen.cache.lenSsid != 0) {
+        leerCampo(origen.cache.lenSsid, origen.cache.ssid, sizeof(cache.ssid) - 1, cache.ssid);
+        memcpy(cache.bssid, origen.cache.bssid, sizeof(cache.bssid));
+        cache.canal   = origen.cache.canal;
+        cache.ip      = origen.cache.ip;
+        cache.gateway = origen.cache.gateway;
+        cache.mascara = origen.cache.mascara;
+        cache.dns1    = origen.cache.dns1;
+        cache.dns2    = origen.cache.dns2;
+        cache.valida  = true;
+    }
+
+    redes.limpiar();
+    for (uint8_t i = 0; i < origen.cantidad && i < WM_MAX_REDES; ++i) {
+        const Red& r = origen.redes[i];
+        RedGuardada red;
+        leerCampo(r.lenSsid, r.ssid, sizeof(red.ssid) - 1, red.ssid);
+        leerCampo(r.lenPassword, r.password, sizeof(red.password) - 1, red.password);
+        red.ultimoExito = r.ultimoExito;
+        red.fallos      = r.fallos;
+        red.latenciaMs  = r.latenciaMs;
+        redes.restaurar(red);
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef REGISTRO_WIFI_H
+#define REGISTRO_WIFI_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "tablaredes.h"
+
+/**
+ * @struct CacheConexion
+ * @brief Datos de la última conexión exitosa para la reconexión rápida.
+ */
+struct CacheConexion {
+    bool     valida = false;
+    char     ssid[33] = {0};
+    uint8_t  bssid[6] = {0};
+    uint8_t  canal = 0;
+    uint32_t ip = 0, gateway = 0, mascara = 0, dns1 = 0, dns2 = 0;
+};
+
+/**
+ * @class RegistroWifi
+ * @brief Formato binario de /wifi.bin: cabecera versionada con CRC32, caché de
+ *        conexión y tabla de redes con campos de longitud prefijada.
+ *
+ * El registro tiene tamaño fijo, por lo que se lee con un único read() sobre
+ * una variable local, sin JSON ni memoria dinámica. La caché va antes que las
+ * redes para que un cambio de WM_MAX_REDES sólo afecte la cola del archivo.
+ */
+class RegistroWifi {
+public:
+    static constexpr uint32_t MAGIA   = 0x314D5741;   // "AWM1"
+    static constexpr uint16_t VERSION = 1;
+
+    struct __attribute__((packed)) Red {
+        uint8_t  lenSsid;
+        char     ssid[32];
+        uint8_t  lenPassword;
+        char     password[64];
+        uint32_t ultimoExito;
+        uint16_t fallos;
+        uint16_t latenciaMs;
+    };
+
+    struct __attribute__((packed)) Cache {
+        uint8_t  lenSsid;
+        char     ssid[32];
+        uint8_t  bssid[6];
+        uint8_t  canal;
+        uint32_t ip, gateway, mascara, dns1, dns2;
+    };
+
+    struct __attribute__((packed)) Archivo {
+        uint32_t magia;
+        uint16_t version;
+        uint16_t longitud;      ///< bytes válidos del archivo, cabecera incluida
+        uint32_t crc;           ///< CRC32 desde 'capacidad' hasta 'longitud'
+        uint8_t  capacidad;     ///< WM_MAX_REDES con el que se escribió
+        uint8_t  cantidad;
+        Cache    cache;
+        Red      redes[WM_MAX_REDES];
+    };
+
+    static void empaquetar(const TablaRedes& redes, const CacheConexion& cache, Archivo& destino);
+
+    /**
+     * Valida cabecera, longitud y CRC y vuelca el contenido.
+     * @param leidos bytes efectivamente leídos del archivo
+     * @return false si el registro no es válido (no se modifica nada)
+     */
+    static bool desempaquetar(const Archivo& origen, size_t leidos,
+                              TablaRedes& redes, CacheConexion& cache);
+
+    static uint32_t crc32(const uint8_t* datos, size_t longitud, uint32_t crc = 0);
+};
+
+#endif
@@ -0,0 +1,52 @@
+/**
+ * @file    relojntp.cpp
+ * @brief   Anclaje de la hora NTP al reloj monótono y corrección de deriva.
+ */
+
+#include "relojntp.h"
+
+static inline int64_t absoluto(int64_t v) { return v < 0 ? -v : v; }
+
+// La deriva se mide contra la predicción del ancla anterior (que ya incluye la
+// deriva conocida), así que el residuo es la corrección que falta. Se suaviza
+// 3:1 como la latencia de TablaRedes. Un residuo mayor que MAX_DERIVA_PPB del
+// intervalo es un salto de hora: sólo se reancla, antes de multiplicarlo (un
+// salto de más de ~9 s desbordaría residuoUs * 1e9).
+void RelojNtp::sincronizar(int64_t nuevoEpochUs, int64_t monoUs) {
+    if (anclado) {
+        int64_t transcurrido = monoUs - anclaMonoUs;
+        int64_t residuoUs = nuevoEpochUs - epochUs(monoUs);
+        if (transcurrido >= MIN_INTERVALO_DERIVA_US &&
+            absoluto(residuoUs) <= transcurrido / (1000000000LL / MAX_DERIVA_PPB)) {
+            int64_t correccion = residuoUs * 1000000000LL / transcurrido;
+            int64_t medida     = deriva + correccion;
+            if (absoluto(medida) <= MAX_DERIVA_PPB) {
+                deriva = derivaMedida ? static_cast<int32_t>((deriva * 3LL + medida) / 4)
+                                      : static_cast<int32_t>(medida);
+                incertidumbre = static_cast<int32_t>(absoluto(correccion));
+                derivaMedida = true;
+            }
+        }
+    }
+    anclaEpochUs = nuevoEpochUs;
+    anclaMonoUs  = monoUs;
+    anclado      = true;
+}
+
+int64_t RelojNtp::epochUs(int64_t monoUs) const {
+    if (!anclado) return 0;
+    int64_t transcurrido = monoUs - anclaMonoUs;
+    return anclaEpochUs + transcurrido + transcurrido * deriva / 1000000000LL;
+}
+
+int64_t RelojNtp::edadUs(int64_t monoUs) const {
+    return anclado ? monoUs - anclaMonoUs : -1;
+}
+
+// Error de la sincronización más lo que pudo acumular la deriva no corregida
+uint32_t RelojNtp::errorUs(int64_t monoUs) const {
+    if (!anclado) return UINT32_MAX;
+    int64_t acumulado = edadUs(monoUs) * incertidumbre / 1000000000LL;
+    int64_t total = ERROR_SYNC_US + acumulado;
+    return total > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(total);
+}
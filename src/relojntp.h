@@ -0,0 +1,41 @@
+#ifndef RELOJ_NTP_H
+#define RELOJ_NTP_H
+
+#include <stdint.h>
+
+/**
+ * @class RelojNtp
+ * @brief Hora de pared en microsegundos a partir de la última sincronización
+ *        NTP y un reloj monótono (esp_timer), con corrección de deriva.
+ *
+ * Cada sincronización deja un ancla (época, monótono). Entre anclas la hora se
+ * extrapola con el monótono, ajustado por la deriva medida del cristal: la
+ * diferencia entre la hora que predijo el ancla anterior y la que trajo NTP,
+ * dividida por el tiempo transcurrido. No depende de Arduino.
+ */
+class RelojNtp {
+public:
+    static constexpr int64_t  MIN_INTERVALO_DERIVA_US = 60LL * 1000000;   ///< más corto mide sólo ruido
+    static constexpr int32_t  MAX_DERIVA_PPB          = 500000;           ///< ±500 ppm: más es un salto de hora
+    static constexpr uint32_t ERROR_SYNC_US           = 10000;            ///< incertidumbre de una sincronización
+    static constexpr uint32_t DERIVA_DEFAULT_PPB      = 50000;            ///< cristal sin medir (±50 ppm)
+
+    /** Registra una sincronización: @p epochUs hora NTP, @p monoUs reloj monótono en ese momento. */
+    void sincronizar(int64_t epochUs, int64_t monoUs);
+
+    bool     sincronizado() const { return anclado; }
+    int64_t  epochUs(int64_t monoUs) const;     ///< 0 si nunca se sincronizó
+    int64_t  edadUs(int64_t monoUs) const;      ///< -1 si nunca se sincronizó
+    uint32_t errorUs(int64_t monoUs) const;     ///< cota estimada del error actual
+    int32_t  derivaPpb() const { return deriva; }
+
+private:
+    bool    anclado = false;
+    bool    derivaMedida = false;
+    int64_t anclaEpochUs = 0;
+    int64_t anclaMonoUs  = 0;
+    int32_t deriva       = 0;   ///< corrección en ppb que se suma al avance del monótono
+    int32_t incertidumbre = DERIVA_DEFAULT_PPB;
+};
+
+#endif
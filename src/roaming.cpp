@@ -0,0 +1,43 @@
+/**
+ * @file    roaming.cpp
+ * @brief   Promedio de RSSI e histéresis para el roaming entre AP del mismo SSID.
+ */
+
+#include "roaming.h"
+
+void MonitorRoaming::reiniciar() {
+    muestras = 0;
+    suavizadoX4 = 0;
+}
+
+void MonitorRoaming::registrarRssi(int8_t rssi) {
+    if (rssi == 0) return;                        // el driver devuelve 0 sin enlace
+    int16_t x4 = static_cast<int16_t>(rssi) * 4;
+    suavizadoX4 = muestras ? static_cast<int16_t>((suavizadoX4 * 3 + x4) / 4) : x4;
+    ++muestras;
+}
+
+int8_t MonitorRoaming::rssiSuavizado() const {
+    return static_cast<int8_t>(suavizadoX4 / 4);
+}
+
+bool MonitorRoaming::debeEscanear(uint32_t ahoraMs) const {
+    if (!muestras || rssiSuavizado() >= config.umbralDbm) return false;
+    return !escaneado || ahoraMs - ultimoEscaneo >= config.esperaScanMs;
+}
+
+void MonitorRoaming::escaneoIniciado(uint32_t ahoraMs) {
+    escaneado = true;
+    ultimoEscaneo = ahoraMs;
+    ++totalEscaneos;
+}
+
+bool MonitorRoaming::mejora(int8_t rssiCandidato) const {
+    return muestras && rssiCandidato >= rssiSuavizado() + config.histeresisDb;
+}
+
+void MonitorRoaming::registrarCambio(bool ok, uint32_t duracionMs) {
+    if (ok) ++cambiosOk;
+    else    ++cambiosMal;
+    ultimaDuracion = duracionMs;
+}
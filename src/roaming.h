@@ -0,0 +1,64 @@
+#ifndef ROAMING_H
+#define ROAMING_H
+
+#include <stdint.h>
+
+/**
+ * @struct ConfigRoaming
+ * @brief Cuándo buscar otro AP del mismo SSID y cuándo vale la pena cambiar.
+ */
+struct ConfigRoaming {
+    int8_t   umbralDbm    = -72;      ///< con la señal suavizada por debajo se busca otro AP
+    uint8_t  histeresisDb = 8;        ///< el candidato tiene que superar al actual por este margen
+    uint32_t muestreoMs   = 1000;     ///< cada cuánto se lee el RSSI
+    uint32_t esperaScanMs = 30000;    ///< mínimo entre escaneos dirigidos
+};
+
+/**
+ * @class MonitorRoaming
+ * @brief Decide el roaming entre BSSID de un mismo SSID.
+ *
+ * Suaviza el RSSI 3:1 (como la latencia de TablaRedes) para no reaccionar a
+ * un pozo aislado. Cuando el promedio cae debajo del umbral pide un escaneo
+ * dirigido, como mucho uno cada esperaScanMs, y sólo acepta un candidato que
+ * supere al promedio actual por la histéresis: así dos AP parejos no se
+ * alternan. Lleva los contadores y la duración de cada cambio. No depende de
+ * Arduino.
+ */
+class MonitorRoaming {
+public:
+    void configurar(const ConfigRoaming& nueva) { config = nueva; }
+    const ConfigRoaming& configuracion() const { return config; }
+
+    void reiniciar();                             ///< asociación nueva: olvida el promedio
+    void registrarRssi(int8_t rssi);
+    bool muestreado() const { return muestras > 0; }
+    int8_t rssiSuavizado() const;
+
+    bool debeEscanear(uint32_t ahoraMs) const;
+    void escaneoIniciado(uint32_t ahoraMs);
+    /** ¿Conviene pasar a un AP que se escucha con @p rssiCandidato? */
+    bool mejora(int8_t rssiCandidato) const;
+    void sinCandidato() { ++sinMejora; }          ///< el escaneo no trajo nada mejor
+    void registrarCambio(bool ok, uint32_t duracionMs);
+
+    uint32_t escaneos() const          { return totalEscaneos; }
+    uint32_t escaneosSinMejora() const { return sinMejora; }
+    uint32_t cambios() const           { return cambiosOk; }
+    uint32_t cambiosFallidos() const   { return cambiosMal; }
+    uint32_t ultimoCambioMs() const    { return ultimaDuracion; }   ///< 0 = nunca
+
+private:
+    ConfigRoaming config;
+    int16_t  suavizadoX4    = 0;      ///< RSSI·4 para no perder los decimales del promedio
+    uint32_t muestras       = 0;
+    bool     escaneado      = false;
+    uint32_t ultimoEscaneo  = 0;
+    uint32_t totalEscaneos  = 0;
+    uint32_t sinMejora      = 0;
+    uint32_t cambiosOk      = 0;
+    uint32_t cambiosMal     = 0;
+    uint32_t ultimaDuracion = 0;
+};
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file    seguidorenlace.cpp
+ * @brief   Estado del enlace WiFi a partir de los eventos del driver.
+ */
+
+#include "seguidorenlace.h"
+
+void SeguidorEnlace::staAsociada(uint32_t ahoraMs) {
+    uint32_t p = palabra.load(std::memory_order_relaxed);
+    publicar((p | BIT_ASOCIADA) & ~MASK_MOTIVO, TipoEventoEnlace::STA_ASOCIADA, 0, ahoraMs);
+}
+
+void SeguidorEnlace::staDesconectada(uint8_t motivo, uint32_t ahoraMs) {
+    uint32_t p = palabra.load(std::memory_order_relaxed);
+    p &= ~(BIT_ASOCIADA | BIT_IP | MASK_MOTIVO);
+    publicar(p | (static_cast<uint32_t>(motivo) << POS_MOTIVO),
+             TipoEventoEnlace::STA_DESCONECTADA, motivo, ahoraMs);
+}
+
+void SeguidorEnlace::staIp(bool obtenida, uint32_t ahoraMs) {
+    uint32_t p = palabra.load(std::memory_order_relaxed);
+    publicar(obtenida ? p | BIT_IP : p & ~BIT_IP,
+             obtenida ? TipoEventoEnlace::STA_IP : TipoEventoEnlace::STA_SIN_IP, 0, ahoraMs);
+}
+
+void SeguidorEnlace::clienteAp(bool entra, uint32_t ahoraMs) {
+    uint32_t p = palabra.load(std::memory_order_relaxed);
+    uint32_t n = (p & MASK_CLIENTES) >> POS_CLIENTES;
+    if (entra && n < (MASK_CLIENTES >> POS_CLIENTES)) ++n;
+    else if (!entra && n > 0) --n;
+    publicar((p & ~MASK_CLIENTES) | (n << POS_CLIENTES),
+             entra ? TipoEventoEnlace::AP_CLIENTE_ENTRA : TipoEventoEnlace::AP_CLIENTE_SALE, 0, ahoraMs);
+}
+
+// Un solo productor: leer-modificar-guardar no necesita compare-exchange.
+// El estado se publica antes de encolar, así quien despacha el evento ya lo ve.
+void SeguidorEnlace::publicar(uint32_t nuevo, TipoEventoEnlace tipo, uint8_t motivo, uint32_t ahoraMs) {
+    uint32_t cambios = (nuevo >> POS_CAMBIOS) + 1;
+    nuevo = (nuevo & ((1u << POS_CAMBIOS) - 1)) | (cambios << POS_CAMBIOS);
+    palabra.store(nuevo, std::memory_order_release);
+
+    EventoEnlace evento = {tipo, motivo, ahoraMs};
+    if (!cola.poner(evento)) {
+        perdidos.store(perdidos.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+EstadoEnlace SeguidorEnlace::instantanea() const {
+    uint32_t p = palabra.load(std::memory_order_acquire);
+    EstadoEnlace e;
+    e.asociada   = p & BIT_ASOCIADA;
+    e.conIp      = p & BIT_IP;
+    e.clientesAp = static_cast<uint8_t>((p & MASK_CLIENTES) >> POS_CLIENTES);
+    e.motivo     = static_cast<uint8_t>((p & MASK_MOTIVO) >> POS_MOTIVO);
+    e.cambios    = static_cast<uint16_t>(p >> POS_CAMBIOS);
+    return e;
+}
@@ -0,0 +1,82 @@
+#ifndef SEGUIDOR_ENLACE_H
+#define SEGUIDOR_ENLACE_H
+
+#include <stdint.h>
+#include <atomic>
+#include "colaspsc.h"
+
+#ifndef WM_COLA_EVENTOS
+#define WM_COLA_EVENTOS 16      ///< transiciones pendientes de despachar (potencia de 2)
+#endif
+
+/** Transición del enlace informada por el driver WiFi. */
+enum class TipoEventoEnlace : uint8_t {
+    STA_ASOCIADA,       ///< la estación se asoció al AP
+    STA_DESCONECTADA,   ///< se perdió (o no se logró) la asociación; ver motivo
+    STA_IP,             ///< DHCP (o IP fija) lista
+    STA_SIN_IP,         ///< se perdió la IP sin perder la asociación
+    AP_CLIENTE_ENTRA,   ///< un cliente se unió al AP del portal
+    AP_CLIENTE_SALE
+};
+
+struct EventoEnlace {
+    TipoEventoEnlace tipo;
+    uint8_t          motivo;     ///< wifi_err_reason_t en STA_DESCONECTADA; 0 en el resto
+    uint32_t         momento;    ///< ms en que llegó el evento
+};
+
+/**
+ * @struct EstadoEnlace
+ * @brief Instantánea del enlace, coherente (sale de una sola lectura atómica).
+ */
+struct EstadoEnlace {
+    bool     asociada;      ///< STA asociada al AP
+    bool     conIp;         ///< STA con IP: recién ahí se puede usar la red
+    uint8_t  clientesAp;    ///< clientes conectados al AP del portal
+    uint8_t  motivo;        ///< último motivo de desconexión del driver (0 = ninguno)
+    uint16_t cambios;       ///< cuenta eventos; sirve para notar que algo pasó
+};
+
+/**
+ * @class SeguidorEnlace
+ * @brief Estado del enlace alimentado por los eventos del driver.
+ *
+ * La tarea de eventos escribe (un solo productor) y cualquier tarea lee con
+ * instantanea() en O(1) y sin cerrojos: todo el estado entra en una palabra
+ * atómica de 32 bits. Además cada transición se encola para que la tarea de
+ * loop() la despache a los callbacks de la aplicación. Si la cola se llena se
+ * pierden eventos, no el estado. No depende de Arduino.
+ */
+class SeguidorEnlace {
+public:
+    // -------- productor (tarea de eventos) --------
+    void staAsociada(uint32_t ahoraMs);
+    void staDesconectada(uint8_t motivo, uint32_t ahoraMs);
+    void staIp(bool obtenida, uint32_t ahoraMs);
+    void clienteAp(bool entra, uint32_t ahoraMs);
+
+    // -------- cualquier tarea --------
+    EstadoEnlace instantanea() const;
+    uint32_t     descartados() const { return perdidos.load(std::memory_order_relaxed); }
+
+    // -------- consumidor (tarea de loop) --------
+    bool siguienteEvento(EventoEnlace& evento) { return cola.sacar(evento); }
+
+private:
+    // Distribución de los bits de la palabra de estado
+    static constexpr uint32_t BIT_ASOCIADA  = 1u << 0;
+    static constexpr uint32_t BIT_IP        = 1u << 1;
+    static constexpr uint8_t  POS_CLIENTES  = 2;        ///< 6 bits
+    static constexpr uint32_t MASK_CLIENTES = 0x3Fu << POS_CLIENTES;
+    static constexpr uint8_t  POS_MOTIVO    = 8;        ///< 8 bits
+    static constexpr uint32_t MASK_MOTIVO   = 0xFFu << POS_MOTIVO;
+    static constexpr uint8_t  POS_CAMBIOS   = 16;       ///< 16 bits
+
+    void publicar(uint32_t nuevo, TipoEventoEnlace tipo, uint8_t motivo, uint32_t ahoraMs);
+
+    std::atomic<uint32_t> palabra{0};
+    std::atomic<uint32_t> perdidos{0};
+    ColaSPSC<EventoEnlace, WM_COLA_EVENTOS> cola;
+};
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file    tablaredes.cpp
+ * @brief   Redes WiFi conocidas con historial de éxitos y orden por tiempo esperado de conexión.
+ */
+
+#include "tablaredes.h"
+
+int8_t TablaRedes::indice(const char* ssid) const {
+    for (uint8_t i = 0; i < n; ++i) {
+        if (strcmp(redes[i].ssid, ssid) == 0) return i;
+    }
+    return -1;
+}
+
+// Alta o actualización de contraseña. Con la tabla llena se reemplaza la peor red.
+bool TablaRedes::agregar(const char* ssid, const char* password) {
+    if (!ssid || !*ssid || strlen(ssid) > 32 || !password || strlen(password) > 64) return false;
+
+    int8_t i = indice(ssid);
+    if (i < 0) {
+        i = (n < WM_MAX_REDES) ? n++ : peorIndice();
+        memset(&redes[i], 0, sizeof(RedGuardada));
+        strcpy(redes[i].ssid, ssid);
+    } else {
+        redes[i].fallos = 0;       // contraseña nueva: el historial de fallos ya no aplica
+    }
+    strcpy(redes[i].password, password);
+    return true;
+}
+
+bool TablaRedes::quitar(const char* ssid) {
+    int8_t i = indice(ssid);
+    if (i < 0) return false;
+    for (uint8_t j = i; j + 1 < n; ++j) redes[j] = redes[j + 1];
+    --n;
+    return true;
+}
+
+bool TablaRedes::restaurar(const RedGuardada& red) {
+    if (n >= WM_MAX_REDES || red.ssid[0] == '\0' || indice(red.ssid) >= 0) return false;
+    redes[n] = red;
+    redes[n].ssid[sizeof(red.ssid) - 1] = '\0';
+    redes[n].password[sizeof(red.password) - 1] = '\0';
+    ++n;
+    return true;
+}
+
+void TablaRedes::registrarExito(uint8_t i, uint32_t latenciaMs, uint32_t cuando) {
+    if (i >= n) return;
+    RedGuardada& red = redes[i];
+    uint32_t lat = red.latenciaMs ? (red.latenciaMs * 3u + latenciaMs) / 4u : latenciaMs;
+    red.latenciaMs  = lat > 0xFFFF ? 0xFFFF : (lat ? lat : 1);
+    red.fallos      = 0;
+    red.ultimoExito = cuando ? cuando : 1;
+}
+
+void TablaRedes::registrarFallo(uint8_t i) {
+    if (i < n && redes[i].fallos < 0xFFFF) ++redes[i].fallos;
+}
+
+// Tiempo esperado hasta tener IP: latencia / probabilidad de éxito.
+// La probabilidad cae con los fallos consecutivos y con la señal del último
+// escaneo; una red que no aparece en un escaneo vigente casi no cuenta.
+float TablaRedes::costoEsperado(const RedGuardada& red, ConsultaRssi rssi, void* contexto) const {
+    float p = 1.0f / (1.0f + red.fallos);
+
+    if (rssi) {
+        int8_t senal = rssi(red.ssid, contexto);
+        if (senal == RSSI_AUSENTE) {
+            p *= 0.05f;
+        } else {
+            float q = (senal + 95) / 40.0f;     // -95 dBm → 0, -55 dBm → 1
+            p *= q < 0.1f ? 0.1f : (q > 1.0f ? 1.0f : q);
+        }
+    }
+
+    float latencia = red.latenciaMs ? red.latenciaMs : LATENCIA_DESCONOCIDA_MS;
+    return latencia / p;
+}
+
+uint8_t TablaRedes::ordenar(uint8_t* orden, ConsultaRssi rssi, void* contexto) const {
+    float costo[WM_MAX_REDES];
+    for (uint8_t i = 0; i < n; ++i) {
+        orden[i] = i;
+        costo[i] = costoEsperado(redes[i], rssi, contexto);
+    }
+
+    // Inserción: n es chico. A igual costo va primero el éxito más reciente.
+    for (uint8_t i = 1; i < n; ++i) {
+        uint8_t k = orden[i];
+        int8_t j = i - 1;
+        while (j >= 0 && (costo[orden[j]] > costo[k] ||
+                          (costo[orden[j]] == costo[k] &&
+                           redes[orden[j]].ultimoExito < redes[k].ultimoExito))) {
+            orden[j + 1] = orden[j];
+            --j;
+        }
+        orden[j + 1] = k;
+    }
+    return n;
+}
+
+// Candidata a reemplazo: más fallos y, a igualdad, el éxito más antiguo
+uint8_t TablaRedes::peorIndice() const {
+    uint8_t peor = 0;
+    for (uint8_t i = 1; i < n; ++i) {
+        if (redes[i].fallos > redes[peor].fallos ||
+            (redes[i].fallos == redes[peor].fallos && redes[i].ultimoExito < redes[peor].ultimoExito)) {
+            peor = i;
+        }
+    }
+    return peor;
+}
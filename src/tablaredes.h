@@ -0,0 +1,66 @@
+#ifndef TABLA_REDES_H
+#define TABLA_REDES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef WM_MAX_REDES
+#define WM_MAX_REDES 5          ///< redes que se pueden recordar a la vez
+#endif
+
+/**
+ * @struct RedGuardada
+ * @brief Credenciales de una red más su historial de conexiones.
+ */
+struct RedGuardada {
+    char     ssid[33];
+    char     password[65];
+    uint32_t ultimoExito;       ///< time() del último éxito; 0 = nunca
+    uint16_t fallos;            ///< fallos consecutivos desde el último éxito
+    uint16_t latenciaMs;        ///< promedio móvil del tiempo hasta tener IP; 0 = sin datos
+};
+
+/**
+ * @class TablaRedes
+ * @brief Tabla acotada de redes conocidas, ordenable por tiempo esperado de conexión.
+ */
+class TablaRedes {
+public:
+    static constexpr uint16_t LATENCIA_DESCONOCIDA_MS = 5000;
+    static constexpr int8_t   RSSI_AUSENTE            = -128;   ///< SSID fuera del escaneo
+
+    /** RSSI actual de un SSID según el último escaneo (o RSSI_AUSENTE). */
+    typedef int8_t (*ConsultaRssi)(const char* ssid, void* contexto);
+
+    uint8_t cantidad() const { return n; }
+    const RedGuardada& red(uint8_t i) const { return redes[i]; }
+    int8_t  indice(const char* ssid) const;            ///< -1 si no está
+
+    bool agregar(const char* ssid, const char* password);
+    bool quitar(const char* ssid);
+    void limpiar() { n = 0; }
+
+    /** Carga una entrada tal cual (al leer desde flash). */
+    bool restaurar(const RedGuardada& red);
+
+    void registrarExito(uint8_t i, uint32_t latenciaMs, uint32_t cuando);
+    void registrarFallo(uint8_t i);
+
+    /**
+     * Llena @p orden con los índices de las redes, de menor a mayor tiempo
+     * esperado de conexión. Combina fallos recientes, latencia promedio y, si
+     * se pasa @p rssi (hay un escaneo vigente), la señal actual de cada SSID.
+     * @return cantidad de índices escritos
+     */
+    uint8_t ordenar(uint8_t* orden, ConsultaRssi rssi = nullptr, void* contexto = nullptr) const;
+
+private:
+    float costoEsperado(const RedGuardada& red, ConsultaRssi rssi, void* contexto) const;
+    uint8_t peorIndice() const;
+
+    RedGuardada redes[WM_MAX_REDES];
+    uint8_t     n = 0;
+};
+
+#endif
@@ -21,21 +21,148 @@
 #include "WifiManager.h"
 #include <ArduinoJson.h>
 #include <time.h>
+#include <sys/time.h>
+#include <esp_sntp.h>
+#include <esp_random.h>
+#include <esp_wifi.h>
 #include <cstdint>
-#include <HTTPClient.h>
+#include <atomic>
+#if WM_PORTAL_EMBEBIDO
+#include "wifimanager_portal.h"
+#endif
 
 #define DEFAULT_LED_PIN 2
 #define DEFAULT_BUTTON_PIN 0
 #define DEFAULT_AP_SSID "WiFi Manager"
 #define DEFAULT_AP_PASS "123456789"
 #define DNS_PORT 53
+// RSSI del último escaneo para ordenar las redes conocidas
+static int8_t rssiDesdeEscaner(const char* ssid, void* contexto) {
+    return static_cast<const WifiScanner*>(contexto)->mejorRssi(ssid);
+}
+
+#define CREDENCIALES_PATH   "/wifi.bin"
+#define CREDENCIALES_JSON    "/wifi.json"         // formato anterior, sólo para migrar
+#define CACHE_CONEXION_JSON  "/wifi_cache.json"   // formato anterior, sólo para migrar
+#define WM_CHUNK_SIZE 1024   // bloque de lectura/envío de archivos del portal
+#define ESPACIO_PARAMETROS  "setup"             // donde quedan los parámetros propios del portal
 
 static bool autoReconnect = true; 
 
+// Hora NTP anclada a esp_timer. SNTP avisa desde la tarea de lwIP y el
+// callback no recibe contexto, así que el reloj es uno solo por dispositivo.
+// Sólo esa tarea escribe: arma la copia nueva en la ranura libre y después
+// publica el contador, así cualquier tarea lee una ranura estable sin
+// cerrojos ni reintentos (SNTP no sincroniza dos veces durante una copia).
+struct HoraPublicada {
+    RelojNtp reloj;
+    int64_t  pisoUs = 0;    ///< hora a la que ya había llegado el reloj anterior
+};
+static RelojNtp              relojNtp;
+static HoraPublicada         horasNtp[2];
+static std::atomic<uint32_t> sincronizacionesNtp{0};
+
+static HoraPublicada horaPublicada() {
+    return horasNtp[sincronizacionesNtp.load(std::memory_order_acquire) & 1];
+}
+
+static uint32_t aleatorioHardware(void*) {
+    return esp_random();
+}
+
+static const char* nombreMotivo(MotivoFallo motivo) {
+    switch (motivo) {
+        case MotivoFallo::TIMEOUT:          return "sin respuesta";
+        case MotivoFallo::CLAVE_INCORRECTA: return "contraseña rechazada";
+        case MotivoFallo::AP_NO_ENCONTRADO: return "red no encontrada";
+        case MotivoFallo::ENLACE_PERDIDO:   return "enlace perdido";
+        default:                            return "?";
+    }
+}
+
+// Sólo los motivos que dicen algo del intento; el resto (incluido el
+// ASSOC_LEAVE de nuestro propio disconnect()) no cambia la decisión.
+static MotivoFallo motivoDesdeDesconexion(uint8_t motivo) {
+    switch (motivo) {
+        case WIFI_REASON_NO_AP_FOUND:
+            return MotivoFallo::AP_NO_ENCONTRADO;
+        case WIFI_REASON_AUTH_FAIL:
+        case WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT:
+        case WIFI_REASON_HANDSHAKE_TIMEOUT:
+        case WIFI_REASON_MIC_FAILURE:
+            return MotivoFallo::CLAVE_INCORRECTA;
+        default:
+            return MotivoFallo::NINGUNO;
+    }
+}
+
+struct AjustesEnergia {
+    wifi_ps_type_t sueno;
+    uint16_t       listenInterval;    ///< en beacons; 0 = el del driver (3)
+    wifi_power_t   potencia;
+};
+
+// Indexada por PerfilEnergia. Con beacons de 102,4 ms, LOW_POWER puede
+// demorar ~1 s en recibir; BALANCED, lo que tarde el próximo DTIM.
+static const AjustesEnergia AJUSTES_ENERGIA[] = {
+    { WIFI_PS_NONE,      0,  WIFI_POWER_19_5dBm },
+    { WIFI_PS_MIN_MODEM, 0,  WIFI_POWER_17dBm   },
+    { WIFI_PS_MAX_MODEM, 10, WIFI_POWER_13dBm   },
+};
+
+// WebServer recibe los nombres de cabecera como const String&: un literal arma
+// un String temporal por pedido, y si pasa de 11 caracteres va al heap. Éstos
+// se arman una sola vez.
+static const String ACCEPT_ENCODING("Accept-Encoding");
+static const String IF_NONE_MATCH("If-None-Match");
+static const String CONTENT_ENCODING("Content-Encoding");
+static const String CACHE_CONTROL("Cache-Control");
+static const String X_SCAN_GENERATION("X-Scan-Generation");
+static const String X_SCAN_PENDING("X-Scan-Pending");
+static const String X_SCAN_TRUNCATED("X-Scan-Truncated");
+
+// Indexada por EstadoWiFi; el botón apretado tiene los suyos.
+static const PatronLed PATRONES_LED[] = {
+    { 0x0000, 1,  100 },    // IDLE: apagado
+    { 0x0001, 2,  100 },    // ASSOCIATING: parpadeo rápido
+    { 0x0001, 1,  100 },    // GOT_IP: fijo
+    { 0x0001, 1,  100 },    // ONLINE: fijo
+    { 0x0005, 16, 100 },    // BACKOFF: dos destellos cada 1,6 s
+    { 0x0001, 2,  500 },    // PORTAL: parpadeo lento
+};
+static const PatronLed LED_BOTON      = { 0x0001, 2, 50 };   // contando la pulsación larga
+static const PatronLed LED_BOTON_FIJO = { 0x0001, 1, 100 };  // ya se borran las credenciales
+
+static void alSincronizarHora(struct timeval* tv) {
+    int64_t epochUs = static_cast<int64_t>(tv->tv_sec) * 1000000 + tv->tv_usec;
+    int64_t monoUs  = static_cast<int64_t>(wmMicros());
+
+    uint32_t n = sincronizacionesNtp.load(std::memory_order_relaxed);
+    int64_t piso = horasNtp[n & 1].pisoUs;
+    if (relojNtp.sincronizado() && relojNtp.epochUs(monoUs) > piso) piso = relojNtp.epochUs(monoUs);
+    relojNtp.sincronizar(epochUs, monoUs);
+
+    HoraPublicada& libre = horasNtp[(n + 1) & 1];
+    libre.reloj  = relojNtp;
+    libre.pisoUs = piso;
+    sincronizacionesNtp.store(n + 1, std::memory_order_release);
+}
+
 
-// Constructor con pines configurables para LED y botón
-WifiManager::WifiManager(uint8_t ledPin, uint8_t buttonPin)
-: server(80), ledPin(ledPin), buttonPin(buttonPin), connected(false), ultimoIntentoWiFi(0) {}
+// Constructor con pines configurables para LED y botón. server y
+// ultimoIntentoWiFi ya se inicializan en la declaración; la lista sigue el
+// orden de wifimanager.h
+WifiManager::WifiManager(uint8_t ledPin, uint8_t buttonPin, ServidorPortal servidor)
+: modoServidor(servidor), ledPin(ledPin), buttonPin(buttonPin) {
+    plan.setAleatorio(aleatorioHardware, nullptr);
+    almacen.espacio("setup", true);
+    almacen.espacio("iporton", true);
+    for (uint8_t i = 0; i < sizeof(patronesLed) / sizeof(patronesLed[0]); ++i) patronesLed[i] = PATRONES_LED[i];
+}
+
+WifiManager::~WifiManager() {
+    if (idEventos) WiFi.removeEvent(idEventos);
+}
 
 // Inicializa pines, monta el sistema de archivos y carga credenciales si existen
 void WifiManager::begin() {
@@ -44,71 +171,53 @@ void WifiManager::begin() {
 
     pinMode(buttonPin, INPUT_PULLUP);
 
+    // Antes de cualquier WiFi.begin(), para no perder la primera asociación
+    if (!idEventos) {
+        idEventos = WiFi.onEvent([this](arduino_event_id_t evento, arduino_event_info_t info) {
+            alEventoWiFi(evento, info);
+        });
+    }
+    // Los reintentos los decide PlanReconexion: el auto-reconnect del core
+    // reasociaría sin jitter ni freno, también con la clave incorrecta
+    WiFi.setAutoReconnect(false);
+
+#if !WM_ASYNC_SERVER
+    if (modoServidor == ServidorPortal::ASINCRONO) {
+        Serial.println("⚠️ Servidor asíncrono no compilado (WM_ASYNC_SERVER=0). Se usa WebServer.");
+        modoServidor = ServidorPortal::SINCRONO;
+    }
+#endif
+
     if (!LittleFS.begin(true)) {
         Serial.println("Error montando LittleFS");
         return;
     }
+    fsMontado = true;
+    indexarPortal();
+    for (uint8_t e = 0; e < almacen.cantidadEspacios(); ++e) cargarConfig(e);
 
     loadCredentials();
 }
 
-// Ejecuta la lógica principal: chequea botón, intenta conexión o lanza portal cautivo
+// Ejecuta la lógica principal: intenta conexión o lanza portal cautivo. El
+// botón de borrado ya no tiene ventana propia: lo atiende update() (y la
+// espera de connectToWiFi()) mientras la conexión avanza.
 void WifiManager::run() {
-    unsigned long startTime = millis();
-    bool botonPresionado = false;
-
-    // Indicación visual para permitir al usuario resetear configuración
-    Serial.println("🔔 Mantené presionado el botón para borrar WiFi (parpadeo LED).");
-
-    while (millis() - startTime < 2000) {
-        digitalWrite(ledPin, HIGH);
-        delay(100);
-        digitalWrite(ledPin, LOW);
-        delay(100);
-
-        if (digitalRead(buttonPin) == LOW) {
-            botonPresionado = true;
-            break;
-        }
-    }
-
-    // Si el botón se mantiene presionado por 5 segundos, se eliminan las credenciales
-    if (botonPresionado) {
-        Serial.println("⏳ Manteniendo presionado...");
+    Serial.printf("🔔 Mantené presionado el botón %lu s para borrar WiFi.\n",
+                  (unsigned long)(boton.configuracion().mantenerMs / 1000));
 
-        unsigned long confirmStart = millis();
-        while (digitalRead(buttonPin) == LOW) {
-            if (millis() - confirmStart >= 5000) {
-                Serial.println("🩹 Botón presionado por 5 segundos. Borrando credenciales WiFi.");
-                eraseCredentials();
-                ESP.restart();
-                return;
-            }
-            delay(100);
-        }
-
-        Serial.println("❌ Botón soltado antes de tiempo. No se borraron las credenciales.");
-    }
-
-    // Si hay credenciales, intenta conectar a WiFi
+    // Si hay credenciales, intenta conectar a WiFi; la hora llega en segundo plano
     if (connectToWiFi()) {
         Serial.println("✅ Conexión WiFi exitosa.");
-        sincronizarHoraNTP();
-        digitalWrite(ledPin, HIGH);
-        connected = true;
         return;
     }
 
-    digitalWrite(ledPin, LOW);
     if (!tieneCredenciales()) {
         Serial.println("🟡 No hay credenciales guardadas. Iniciando configuración WiFi...");
         setupAP();
-
-        server.on("/", std::bind(&WifiManager::handleRoot, this));
-        server.on("/save", std::bind(&WifiManager::handleSave, this));
-        server.on("/scan", std::bind(&WifiManager::handleScan, this));
-        server.onNotFound(std::bind(&WifiManager::handleNotFound, this));
-        server.begin();
+        portalActivo = true;
+        cambiarEstado(EstadoWiFi::PORTAL);
+        iniciarServidor(true);
 
         Serial.println("🌐 Servidor web iniciado en 192.168.4.1");
     } else {
@@ -116,99 +225,992 @@ void WifiManager::run() {
     }
 }
 
-// Devuelve true si existe el archivo y las credenciales no están vacías
+// Devuelve true si hay al menos una red guardada (la tabla refleja /wifi.bin)
 bool WifiManager::tieneCredenciales() const {
-    return LittleFS.exists("/wifi.json") && !ssid.isEmpty() && !password.isEmpty();
+    return redes.cantidad() > 0;
 }
 
-// Carga las credenciales desde el archivo JSON en LittleFS
+// Carga las credenciales desde el registro binario en LittleFS con un único
+// read(), sin JSON ni memoria dinámica. Si todavía no existe pero hay un
+// /wifi.json de versiones anteriores, lo migra una sola vez.
 void WifiManager::loadCredentials() {
-    if (!LittleFS.exists("/wifi.json")) {
+    if (!LittleFS.exists(CREDENCIALES_PATH)) {
+        if (LittleFS.exists(CREDENCIALES_JSON) && migrarCredencialesJson()) return;
         Serial.println("Archivo de credenciales no existe.");
         return;
     }
 
-    File file = LittleFS.open("/wifi.json", "r");
+    File file = LittleFS.open(CREDENCIALES_PATH, "r");
     if (!file) {
         Serial.println("No se pudo abrir el archivo de credenciales.");
         return;
     }
 
-    StaticJsonDocument<192> doc;
+    RegistroWifi::Archivo registro;
+    size_t leidos = file.read(reinterpret_cast<uint8_t*>(&registro), sizeof(registro));
+    file.close();
+
+    if (!RegistroWifi::desempaquetar(registro, leidos, redes, cacheConexion)) {
+        Serial.println("Archivo de credenciales inválido (CRC/versión). Ignorando.");
+        return;
+    }
+    if (redes.cantidad() == 0) {
+        Serial.println("Credenciales vacías en el archivo. Ignorando.");
+        return;
+    }
+
+    ssid = redes.red(0).ssid;
+    password = redes.red(0).password;
+    Serial.printf("Credenciales cargadas correctamente (%u redes).\n", redes.cantidad());
+}
+
+// Importa /wifi.json (y su caché) al registro binario y borra los JSON.
+// Formato: "ssid"/"password" de la última red guardada y, opcionalmente,
+// "redes" con la tabla completa y su historial.
+bool WifiManager::migrarCredencialesJson() {
+    File file = LittleFS.open(CREDENCIALES_JSON, "r");
+    if (!file) {
+        Serial.println("No se pudo abrir el archivo de credenciales.");
+        return false;
+    }
+
+    DynamicJsonDocument doc(256 + WM_MAX_REDES * 192);
     DeserializationError error = deserializeJson(doc, file);
+    file.close();
     if (error) {
         Serial.println("Error al deserializar JSON.");
-        return;
+        return false;
     }
 
-    String loadedSsid = doc["ssid"].as<String>();
-    String loadedPassword = doc["password"].as<String>();
+    redes.limpiar();
+    JsonArray lista = doc["redes"];
+    for (JsonObject obj : lista) {
+        RedGuardada red = {};
+        strlcpy(red.ssid, obj["ssid"] | "", sizeof(red.ssid));
+        strlcpy(red.password, obj["password"] | "", sizeof(red.password));
+        red.ultimoExito = obj["ok"] | 0;
+        red.fallos      = obj["fallos"] | 0;
+        red.latenciaMs  = obj["lat"] | 0;
+        if (red.password[0] != '\0') redes.restaurar(red);
+    }
+
+    const char* loadedSsid = doc["ssid"] | "";
+    const char* loadedPassword = doc["password"] | "";
+    if (*loadedSsid && *loadedPassword && redes.indice(loadedSsid) < 0) {
+        redes.agregar(loadedSsid, loadedPassword);
+    }
 
-    if (loadedSsid.isEmpty() || loadedPassword.isEmpty()) {
+    if (redes.cantidad() == 0) {
         Serial.println("Credenciales vacías en el archivo. Ignorando.");
+        return false;
+    }
+
+    ssid = redes.red(0).ssid;
+    password = redes.red(0).password;
+    loadCacheConexionJson();
+
+    if (!saveCredentials()) return false;
+    LittleFS.remove(CREDENCIALES_JSON);
+    LittleFS.remove(CACHE_CONEXION_JSON);
+    Serial.printf("Credenciales migradas a " CREDENCIALES_PATH " (%u redes).\n", redes.cantidad());
+    return true;
+}
+
+// Escribe tabla de redes y caché de conexión en /wifi.bin. Se escribe primero
+// un temporal y después se renombra, así un corte de energía no deja el
+// registro a medias.
+bool WifiManager::saveCredentials() {
+    RegistroWifi::Archivo registro;
+    RegistroWifi::empaquetar(redes, cacheConexion, registro);
+
+    File file = LittleFS.open(CREDENCIALES_PATH ".tmp", "w");
+    if (!file) {
+        Serial.println("No se pudo abrir archivo para guardar.");
+        return false;
+    }
+    size_t escritos = file.write(reinterpret_cast<const uint8_t*>(&registro), registro.longitud);
+    file.close();
+
+    if (escritos != registro.longitud || !LittleFS.rename(CREDENCIALES_PATH ".tmp", CREDENCIALES_PATH)) {
+        Serial.println("Error al guardar credenciales.");
+        LittleFS.remove(CREDENCIALES_PATH ".tmp");
+        return false;
+    }
+    return true;
+}
+
+// Lee la caché de conexión del formato JSON anterior (sólo durante la migración)
+void WifiManager::loadCacheConexionJson() {
+    cacheConexion.valida = false;
+    if (!LittleFS.exists(CACHE_CONEXION_JSON)) return;
+
+    File file = LittleFS.open(CACHE_CONEXION_JSON, "r");
+    if (!file) return;
+
+    StaticJsonDocument<384> doc;
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+    if (error) return;
+    strlcpy(cacheConexion.ssid, doc["ssid"] | "", sizeof(cacheConexion.ssid));
+
+    JsonArray bssid = doc["bssid"];
+    if (bssid.size() != 6) return;
+    for (uint8_t i = 0; i < 6; ++i) cacheConexion.bssid[i] = bssid[i];
+
+    cacheConexion.canal   = doc["canal"] | 0;
+    cacheConexion.ip      = doc["ip"]    | 0;
+    cacheConexion.gateway = doc["gw"]    | 0;
+    cacheConexion.mascara = doc["mask"]  | 0;
+    cacheConexion.dns1    = doc["dns1"]  | 0;
+    cacheConexion.dns2    = doc["dns2"]  | 0;
+    cacheConexion.valida  = cacheConexion.canal != 0;
+}
+
+// Guarda los datos de la conexión actual; sólo escribe la flash si cambiaron
+void WifiManager::saveCacheConexion() {
+    CacheConexion actual;
+    memcpy(actual.bssid, WiFi.BSSID(), sizeof(actual.bssid));
+    actual.canal   = WiFi.channel();
+    actual.ip      = WiFi.localIP();
+    actual.gateway = WiFi.gatewayIP();
+    actual.mascara = WiFi.subnetMask();
+    actual.dns1    = WiFi.dnsIP(0);
+    actual.dns2    = WiFi.dnsIP(1);
+    actual.valida  = true;
+    strlcpy(actual.ssid, ssid.c_str(), sizeof(actual.ssid));
+
+    if (cacheConexion.valida && strcmp(actual.ssid, cacheConexion.ssid) == 0 &&
+        memcmp(actual.bssid, cacheConexion.bssid, sizeof(actual.bssid)) == 0 &&
+        actual.canal == cacheConexion.canal && actual.ip == cacheConexion.ip &&
+        actual.gateway == cacheConexion.gateway && actual.mascara == cacheConexion.mascara &&
+        actual.dns1 == cacheConexion.dns1 && actual.dns2 == cacheConexion.dns2) {
         return;
     }
 
-    ssid = loadedSsid;
-    password = loadedPassword;
-    Serial.println("Credenciales cargadas correctamente.");
+    cacheConexion = actual;
+    saveCredentials();
 }
 
 // Elimina el archivo de credenciales guardadas
 void WifiManager::eraseCredentials() {
-    LittleFS.remove("/wifi.json");
-    LittleFS.remove("/setup.json");
-    LittleFS.remove("/iporton.json");
-    //LittleFS.remove("/wifi.json");
+    LittleFS.remove(CREDENCIALES_PATH);
+    LittleFS.remove(CREDENCIALES_JSON);
+    LittleFS.remove(CACHE_CONEXION_JSON);
+    redes.limpiar();
+    cacheConexion = CacheConexion();
     Serial.println("Credenciales eliminadas.");
 }
 
+// Credenciales y todos los espacios de configuración. Lo pendiente de guardar
+// se descarta: no tiene sentido escribir lo que se está borrando.
+void WifiManager::eraseAll() {
+    eraseCredentials();
+    wmBloquear(cerrojoConfig);
+    almacen.vaciar();
+    esperaConfig = false;
+    wmDesbloquear(cerrojoConfig);
+
+    char ruta[24];
+    for (uint8_t e = 0; e < almacen.cantidadEspacios(); ++e) {
+        snprintf(ruta, sizeof(ruta), "/%s.json", almacen.nombreEspacio(e));
+        LittleFS.remove(ruta);
+    }
+    Serial.println("Configuración eliminada.");
+}
+
+// -------- configuración de la aplicación --------
+
+bool WifiManager::agregarEspacioConfig(const char* espacio) {
+    wmBloquear(cerrojoConfig);
+    bool existia = almacen.espacio(espacio) != AlmacenConfig::NINGUNO;
+    uint8_t e = almacen.espacio(espacio, true);
+    wmDesbloquear(cerrojoConfig);
+    if (e == AlmacenConfig::NINGUNO) {
+        Serial.println("⚠️ No hay lugar para otro espacio de configuración.");
+        return false;
+    }
+    if (!existia && fsMontado) cargarConfig(e);     // después de begin(): se carga ya
+    return true;
+}
+
+// Todas las variantes de setConfig(). Sólo toca RAM: si el valor cambió, el
+// espacio queda sucio y arranca la espera para escribirlo.
+template <typename T>
+bool WifiManager::ponerConfig(const char* espacio, const char* clave, T valor) {
+    uint32_t ahora = wmMillis();
+    wmBloquear(cerrojoConfig);
+    uint8_t e = almacen.espacio(espacio);
+    bool ok = e != AlmacenConfig::NINGUNO && almacen.set(e, clave, valor);
+    if (almacen.pendiente() && !esperaConfig) {
+        esperaConfig = true;
+        cambioConfigDesde = ahora;
+    }
+    wmDesbloquear(cerrojoConfig);
+    return ok;
+}
+
+bool WifiManager::setConfig(const char* espacio, const char* clave, const char* valor) {
+    return ponerConfig(espacio, clave, valor);
+}
+
+bool WifiManager::setConfig(const char* espacio, const char* clave, int valor) {
+    return ponerConfig(espacio, clave, valor);
+}
+
+bool WifiManager::setConfig(const char* espacio, const char* clave, long valor) {
+    return ponerConfig(espacio, clave, valor);
+}
+
+bool WifiManager::setConfig(const char* espacio, const char* clave, double valor) {
+    return ponerConfig(espacio, clave, valor);
+}
 
+bool WifiManager::setConfig(const char* espacio, const char* clave, bool valor) {
+    return ponerConfig(espacio, clave, valor);
+}
 
-// Intenta conectar al WiFi utilizando las credenciales almacenadas
+ParametrosPortal& WifiManager::parametrosPortal() {
+    return parametrosExtra;
+}
+
+bool WifiManager::borrarConfig(const char* espacio, const char* clave) {
+    uint32_t ahora = wmMillis();
+    wmBloquear(cerrojoConfig);
+    uint8_t e = almacen.espacio(espacio);
+    bool ok = e != AlmacenConfig::NINGUNO && almacen.borrar(e, clave);
+    if (ok && !esperaConfig) {
+        esperaConfig = true;
+        cambioConfigDesde = ahora;
+    }
+    wmDesbloquear(cerrojoConfig);
+    return ok;
+}
+
+int32_t WifiManager::getConfigInt(const char* espacio, const char* clave, int32_t porDefecto) {
+    wmBloquear(cerrojoConfig);
+    int32_t v = almacen.getInt(almacen.espacio(espacio), clave, porDefecto);
+    wmDesbloquear(cerrojoConfig);
+    return v;
+}
+
+float WifiManager::getConfigFloat(const char* espacio, const char* clave, float porDefecto) {
+    wmBloquear(cerrojoConfig);
+    float v = almacen.getFloat(almacen.espacio(espacio), clave, porDefecto);
+    wmDesbloquear(cerrojoConfig);
+    return v;
+}
+
+bool WifiManager::getConfigBool(const char* espacio, const char* clave, bool porDefecto) {
+    wmBloquear(cerrojoConfig);
+    bool v = almacen.getBool(almacen.espacio(espacio), clave, porDefecto);
+    wmDesbloquear(cerrojoConfig);
+    return v;
+}
+
+bool WifiManager::getConfigString(const char* espacio, const char* clave, char* destino, size_t capacidad) {
+    wmBloquear(cerrojoConfig);
+    const char* v = almacen.getString(almacen.espacio(espacio), clave, nullptr);
+    bool ok = v && strlen(v) < capacidad;
+    if (ok) memcpy(destino, v, strlen(v) + 1);
+    wmDesbloquear(cerrojoConfig);
+    return ok;
+}
+
+// Lee /<espacio>.json una sola vez. Sólo se toman valores simples; si algo no
+// entra (anidado, más largo que WM_CONFIG_VALOR, sin lugar en WM_CONFIG_CLAVES
+// o un archivo más grande que el documento) el espacio queda de sólo lectura
+// para no reescribir el archivo sin eso.
+void WifiManager::cargarConfig(uint8_t e) {
+    char ruta[24];
+    snprintf(ruta, sizeof(ruta), "/%s.json", almacen.nombreEspacio(e));
+    if (!LittleFS.exists(ruta)) return;
+
+    File file = LittleFS.open(ruta, "r");
+    if (!file) return;
+    DynamicJsonDocument doc(WM_CONFIG_CLAVES * 128);
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+    if (error.code() == DeserializationError::NoMemory) {
+        wmBloquear(cerrojoConfig);
+        almacen.proteger(e);
+        wmDesbloquear(cerrojoConfig);
+        Serial.printf("⚠️ %s no entra en memoria. Queda de sólo lectura.\n", ruta);
+        return;
+    }
+    if (error) {
+        Serial.printf("⚠️ %s inválido. Se ignora.\n", ruta);
+        return;
+    }
+
+    char texto[WM_CONFIG_VALOR];
+    uint8_t omitidas = 0;
+    wmBloquear(cerrojoConfig);
+    for (JsonPair par : doc.as<JsonObject>()) {
+        JsonVariant v = par.value();
+        TipoValor tipo;
+        if (v.is<bool>()) {
+            tipo = TipoValor::BOOLEANO;
+            snprintf(texto, sizeof(texto), "%s", v.as<bool>() ? "true" : "false");
+        } else if (v.is<long>()) {
+            tipo = TipoValor::ENTERO;
+            snprintf(texto, sizeof(texto), "%ld", v.as<long>());
+        } else if (v.is<double>()) {
+            tipo = TipoValor::REAL;
+            snprintf(texto, sizeof(texto), "%.9g", v.as<double>());
+        } else if (v.is<const char*>() && strlen(v.as<const char*>()) < sizeof(texto)) {
+            tipo = TipoValor::TEXTO;
+            memcpy(texto, v.as<const char*>(), strlen(v.as<const char*>()) + 1);
+        } else {
+            ++omitidas;
+            continue;
+        }
+        if (!almacen.cargar(e, par.key().c_str(), tipo, texto)) ++omitidas;
+    }
+    if (omitidas) almacen.proteger(e);
+    wmDesbloquear(cerrojoConfig);
+    if (omitidas) Serial.printf("⚠️ %s: %u claves no entran en la configuración. Queda de sólo lectura.\n", ruta, omitidas);
+}
+
+// Escribe un espacio entero en un temporal y lo renombra. Las entradas se
+// copian de a una bajo el cerrojo para no tocar la flash con él tomado.
+bool WifiManager::escribirConfig(uint8_t e) {
+    char ruta[24];
+    char temporal[28];
+    snprintf(ruta, sizeof(ruta), "/%s.json", almacen.nombreEspacio(e));
+    snprintf(temporal, sizeof(temporal), "%s.tmp", ruta);
+
+    File file = LittleFS.open(temporal, "w");
+    if (!file) return false;
+    bool ok = file.write('{') == 1;
+    bool primera = true;
+    char linea[(sizeof(EntradaConfig::clave) + WM_CONFIG_VALOR) * 6 + 8];   // todo escapado
+    for (uint8_t i = 0; i < WM_CONFIG_CLAVES && ok; ++i) {
+        EntradaConfig entrada;
+        wmBloquear(cerrojoConfig);
+        bool usada = almacen.copiar(i, entrada);
+        wmDesbloquear(cerrojoConfig);
+        if (!usada || entrada.espacio != e) continue;
+        size_t n = AlmacenConfig::comoJson(entrada, primera, linea, sizeof(linea));
+        ok = file.write(reinterpret_cast<const uint8_t*>(linea), n) == n;
+        primera = false;
+    }
+    ok = ok && file.write('}') == 1;
+    file.close();
+
+    if (!ok || !LittleFS.rename(temporal, ruta)) {
+        LittleFS.remove(temporal);
+        return false;
+    }
+    return true;
+}
+
+// Escribe los espacios sucios. Se marcan limpios antes de escribir: un
+// setConfig() que llegue mientras tanto los vuelve a ensuciar.
+bool WifiManager::guardarConfig() {
+    bool ok = true;
+    wmBloquear(cerrojoConfig);
+    esperaConfig = false;
+    wmDesbloquear(cerrojoConfig);
+
+    for (uint8_t e = 0; e < almacen.cantidadEspacios(); ++e) {
+        wmBloquear(cerrojoConfig);
+        bool sucio = almacen.sucio(e);
+        if (sucio) almacen.empezarGuardado(e);
+        wmDesbloquear(cerrojoConfig);
+        if (!sucio) continue;
+
+        if (escribirConfig(e)) {
+            ++metrics.configEscrituras;
+            continue;
+        }
+        Serial.printf("⚠️ No se pudo guardar /%s.json.\n", almacen.nombreEspacio(e));
+        ok = false;
+        wmBloquear(cerrojoConfig);
+        almacen.guardadoFallido(e);
+        wmDesbloquear(cerrojoConfig);
+    }
+
+    // Lo que se ensució durante la escritura (o falló) espera su turno
+    wmBloquear(cerrojoConfig);
+    if (almacen.pendiente() && !esperaConfig) {
+        esperaConfig = true;
+        cambioConfigDesde = wmMillis();
+    }
+    wmDesbloquear(cerrojoConfig);
+    return ok;
+}
+
+void WifiManager::atenderConfig(uint32_t ahora) {
+    if (esperaConfig && ahora - cambioConfigDesde >= WM_CONFIG_DEMORA_MS) guardarConfig();
+}
+
+
+
+// Intenta conectar al WiFi utilizando las credenciales almacenadas.
+// Envoltorio bloqueante sobre la máquina de estados: espera el enlace (máx. 30 s)
+// y deja la sincronización NTP corriendo en segundo plano.
 bool WifiManager::connectToWiFi() {
+    if (desdeOtraTarea()) {
+        // La asociación la avanza la tarea propia; acá sólo se espera el enlace
+        if (!tieneCredenciales() || !pedirConexion()) return false;
+        unsigned long inicio = wmMillis();
+        while (!isConnected() && wmMillis() - inicio < CONNECT_TIMEOUT_MS) wmDelay(10);
+        return isConnected();
+    }
+    if (!conectarAsync()) return false;
+
+    while (estado == EstadoWiFi::ASSOCIATING) {
+        avanzarConexion();
+        atenderIndicadores(wmMillis());
+        wmDelay(10);
+    }
+    if (estado == EstadoWiFi::GOT_IP) avanzarConexion();
+
+    return isConnected();
+}
+
+// Inicia la asociación sin bloquear; update() completa el resto
+bool WifiManager::conectarAsync() {
     if (!tieneCredenciales()) return false;
+    iniciarAsociacion(CONNECT_TIMEOUT_MS);
+    return true;
+}
+
+EstadoWiFi WifiManager::getEstado() const {
+    return estado;
+}
+
+const char* WifiManager::nombreEstado(EstadoWiFi e) {
+    switch (e) {
+        case EstadoWiFi::IDLE:        return "IDLE";
+        case EstadoWiFi::ASSOCIATING: return "ASSOCIATING";
+        case EstadoWiFi::GOT_IP:      return "GOT_IP";
+        case EstadoWiFi::ONLINE:      return "ONLINE";
+        case EstadoWiFi::BACKOFF:     return "BACKOFF";
+        case EstadoWiFi::PORTAL:      return "PORTAL";
+    }
+    return "?";
+}
+
+// true mientras haya un intento que todavía no llegó a ONLINE ni falló
+bool WifiManager::conexionEnCurso() const {
+    return estado == EstadoWiFi::ASSOCIATING ||
+           estado == EstadoWiFi::GOT_IP;
+}
+
+void WifiManager::cambiarEstado(EstadoWiFi nuevo) {
+    if (nuevo == estado) return;
+    estado = nuevo;
+    estadoDesde = wmMillis();
+}
+
+// Corre en la tarea de eventos de WiFi: sólo actualiza la instantánea y
+// encola. Nada de Serial, flash ni callbacks de la aplicación acá.
+void WifiManager::alEventoWiFi(arduino_event_id_t evento, arduino_event_info_t info) {
+    uint32_t ahora = wmMillis();
+    switch (evento) {
+        case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+            enlace.staAsociada(ahora);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            enlace.staDesconectada(info.wifi_sta_disconnected.reason, ahora);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            enlace.staIp(true, ahora);
+            break;
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+            enlace.staIp(false, ahora);
+            break;
+        case ARDUINO_EVENT_WIFI_AP_STACONNECTED:
+            enlace.clienteAp(true, ahora);
+            break;
+        case ARDUINO_EVENT_WIFI_AP_STADISCONNECTED:
+            enlace.clienteAp(false, ahora);
+            break;
+        default:
+            return;
+    }
+    if (tarea) xTaskNotifyGive(tarea);    // que la tarea propia lo atienda ya
+}
+
+// Vacía la cola de transiciones en la tarea de loop(): anota lo que sirve al
+// intento en curso y recién después avisa a la aplicación.
+void WifiManager::despacharEventosEnlace() {
+    EventoEnlace evento;
+    while (enlace.siguienteEvento(evento)) {
+        bool delIntento = estado == EstadoWiFi::ASSOCIATING &&
+                          static_cast<int32_t>(evento.momento - inicioIntento) >= 0;
+        if (delIntento && evento.tipo == TipoEventoEnlace::STA_ASOCIADA && tiempos.asociacionMs == 0) {
+            tiempos.asociacionMs = evento.momento - inicioIntento;
+        } else if (delIntento && evento.tipo == TipoEventoEnlace::STA_DESCONECTADA) {
+            MotivoFallo motivo = motivoDesdeDesconexion(evento.motivo);
+            if (motivo != MotivoFallo::NINGUNO) motivoAsociacion = motivo;
+        }
+        if (oyenteEnlace) oyenteEnlace(evento, contextoOyente);
+        emitir(TipoEventoWiFi::ENLACE, &evento);
+    }
+}
 
-    WiFi.mode(WIFI_AP_STA);
-    WiFi.begin(ssid.c_str(), password.c_str());
+// Ordena las redes conocidas por tiempo esperado de conexión y arranca con la
+// primera; si falla, avanzarConexion() pasa a la siguiente sin esperar el backoff.
+void WifiManager::iniciarAsociacion(unsigned long timeoutMs, bool reconexion) {
+    esReconexion = reconexion;
+    motivosRonda = 0;
+    if (reconexion) ++metrics.reconexionIntentos;
+    cantCandidatos = redes.ordenar(ordenCandidatos,
+                                   escaner.vigente() ? rssiDesdeEscaner : nullptr, &escaner);
+    candidatoActual = 0;
+    timeoutCompleto = timeoutMs;
+    asociarCandidato();
+}
+
+// Pasa a la próxima red del orden. false si ya se probaron todas.
+bool WifiManager::siguienteCandidato() {
+    if (candidatoActual + 1 >= cantCandidatos) return false;
+    ++candidatoActual;
+    WiFi.disconnect();
+    asociarCandidato();
+    return true;
+}
+
+// Emite WiFi.begin() para la red candidata y pasa a ASSOCIATING; no espera el
+// resultado. Si hay caché de la última conexión a esa red, primero se intenta
+// directo contra ese BSSID y canal (y su IP, si se habilitó); si no responde
+// se cae al camino completo.
+void WifiManager::asociarCandidato() {
+    if (enRoaming) terminarRoaming(false, wmMillis());
+    const RedGuardada& red = redes.red(ordenCandidatos[candidatoActual]);
+    ssid = red.ssid;
+    password = red.password;
+
+    // El modem-sleep no funciona con el AP encendido: fuera del portal, los
+    // perfiles de bajo consumo dejan sólo la STA
+    WiFi.mode(portalActivo || perfil == PerfilEnergia::LOW_LATENCY ? WIFI_AP_STA : WIFI_STA);
+
+    unsigned long timeoutMs = timeoutCompleto;
+    tiempos = TiemposConexion();
+    intentoRapido = fastReconnect && cacheConexion.valida &&
+                    strcmp(cacheConexion.ssid, red.ssid) == 0;
+
+    if (intentoRapido) {
+        if (fastReutilizarIp && cacheConexion.ip != 0) {
+            WiFi.config(IPAddress(cacheConexion.ip), IPAddress(cacheConexion.gateway),
+                        IPAddress(cacheConexion.mascara), IPAddress(cacheConexion.dns1),
+                        IPAddress(cacheConexion.dns2));
+        }
+        iniciarBegin(cacheConexion.canal, cacheConexion.bssid);
+        Serial.printf("Conexión rápida a %s (canal %u)\n", ssid.c_str(), cacheConexion.canal);
+        timeoutAsociacion = timeoutMs < FAST_CONNECT_TIMEOUT_MS ? timeoutMs : FAST_CONNECT_TIMEOUT_MS;
+    } else {
+        iniciarBegin();
+        Serial.print("Conectando a ");
+        Serial.println(ssid.c_str());
+        timeoutAsociacion = timeoutMs;
+    }
 
-    Serial.print("Conectando a ");
-    Serial.println(ssid);
+    tiempos.rapida = intentoRapido;
+    motivoAsociacion = MotivoFallo::NINGUNO;
+    inicioIntento = ultimoIntentoWiFi = wmMillis();
+    estado = EstadoWiFi::ASSOCIATING;
+    estadoDesde = inicioIntento;
+}
+
+// Actualiza el historial de la red conectada y lo persiste sólo si cambió algo
+// relevante, para no escribir la flash en cada arranque.
+void WifiManager::registrarExitoRed() {
+    uint8_t i = ordenCandidatos[candidatoActual];
+    if (i >= redes.cantidad() || strcmp(redes.red(i).ssid, ssid.c_str()) != 0) return;
+
+    RedGuardada antes = redes.red(i);
+    time_t ahora = time(nullptr);                       // sin NTP se conserva el anterior
+    uint32_t cuando = ahora > 100000 ? static_cast<uint32_t>(ahora) : antes.ultimoExito;
+    redes.registrarExito(i, tiempos.enlaceMs, cuando);
+
+    const RedGuardada& despues = redes.red(i);
+    uint32_t delta = despues.latenciaMs > antes.latenciaMs ? despues.latenciaMs - antes.latenciaMs
+                                                           : antes.latenciaMs - despues.latenciaMs;
+    bool cambio = antes.fallos != 0 || antes.latenciaMs == 0 ||
+                  delta * 4 > antes.latenciaMs ||
+                  despues.ultimoExito - antes.ultimoExito > 86400;
+    if (cambio) saveCredentials();
+}
 
-    for (int i = 0; i < 30; i++) {
-        if (WiFi.status() == WL_CONNECTED) {
+// El intento rápido no respondió: DHCP y barrido completo dentro del mismo estado
+void WifiManager::caerAConexionCompleta() {
+    if (enRoaming) terminarRoaming(false, wmMillis());
+    Serial.println("⚠️ Conexión rápida fallida. Probando conexión completa...");
+    WiFi.disconnect();
+    if (fastReutilizarIp) WiFi.config(IPAddress(), IPAddress(), IPAddress());
+    iniciarBegin();
+
+    intentoRapido = false;
+    tiempos.fallback = true;
+    tiempos.asociacionMs = 0;
+    motivoAsociacion = MotivoFallo::NINGUNO;
+    timeoutAsociacion = timeoutCompleto;
+    estadoDesde = wmMillis();
+}
+
+// Un paso de la máquina de estados. Nunca bloquea: sólo lee la instantánea del
+// enlace y compara tiempos, por lo que puede llamarse en cada vuelta de loop().
+void WifiManager::avanzarConexion() {
+    despacharEventosEnlace();
+    unsigned long ahora = wmMillis();
+    EstadoEnlace e = enlace.instantanea();
+
+    switch (estado) {
+    case EstadoWiFi::IDLE:
+    case EstadoWiFi::PORTAL:
+        break;
+
+    case EstadoWiFi::ASSOCIATING:
+        // Al hacer roaming la instantánea todavía dice "con IP" hasta que llega
+        // la desconexión del AP anterior: se exige algún evento posterior
+        if (e.conIp && (!enRoaming || e.cambios != cambiosAlAsociar)) {
             Serial.println("Conectado a WiFi.");
-            WiFi.setSleep(false);
-            return true;
+            tiempos.enlaceMs = ahora - inicioIntento;
+            if (!enRoaming) {
+                metrics.conexion.registrar(tiempos.enlaceMs);
+                ++metrics.conexionesOk;
+                if (esReconexion) ++metrics.reconexionesOk;
+            }
+            cambiarEstado(EstadoWiFi::GOT_IP);
+        } else if (intentoRapido && (ahora - estadoDesde >= timeoutAsociacion ||
+                                     motivoAsociacion == MotivoFallo::AP_NO_ENCONTRADO)) {
+            caerAConexionCompleta();
+        } else if (ahora - estadoDesde >= timeoutAsociacion ||
+                   (candidatoActual + 1 < cantCandidatos && motivoAsociacion != MotivoFallo::NINGUNO)) {
+            // Con más redes por probar no se espera el timeout si el driver ya se rindió
+            MotivoFallo delCandidato = motivoAsociacion != MotivoFallo::NINGUNO ? motivoAsociacion
+                                                                                 : MotivoFallo::TIMEOUT;
+            motivosRonda |= 1 << static_cast<uint8_t>(delCandidato);
+            redes.registrarFallo(ordenCandidatos[candidatoActual]);
+            if (siguienteCandidato()) break;
+            Serial.println("Tiempo agotado. No se pudo conectar.");
+            ++metrics.conexionesFallidas;
+            if (esReconexion) ++metrics.reconexionesFallidas;
+
+            // Clave o AP ausente sólo cuentan si fue así con todas las redes probadas
+            MotivoFallo motivo = MotivoFallo::TIMEOUT;
+            if (motivosRonda == 1 << static_cast<uint8_t>(MotivoFallo::CLAVE_INCORRECTA)) {
+                motivo = MotivoFallo::CLAVE_INCORRECTA;
+            } else if (motivosRonda == 1 << static_cast<uint8_t>(MotivoFallo::AP_NO_ENCONTRADO)) {
+                motivo = MotivoFallo::AP_NO_ENCONTRADO;
+            }
+            if (portalActivo) {
+                // Con el portal abierto no se reintenta solo: lo decide la app
+                plan.registrarFallo(motivo);
+                cambiarEstado(EstadoWiFi::PORTAL);
+            } else {
+                entrarEnBackoff(motivo);
+            }
+        }
+        break;
+
+    case EstadoWiFi::GOT_IP:
+        aplicarPerfilEnergia();
+        plan.registrarExito();
+        roamer.reiniciar();
+        monitor.setEnlace(true);
+        if (fastReconnect) saveCacheConexion();
+        if (enRoaming) {
+            terminarRoaming(true, ahora);             // misma red: la hora sigue valiendo
+        } else {
+            sincronizarHoraNTP();
+            esperandoNtp = true;
+            inicioNtp = ahora;
+        }
+
+        tiempos.totalMs = ahora - inicioIntento;
+        registrarExitoRed();
+        Serial.printf("⏱️ Conexión %s: asociación %lu ms, enlace %lu ms, total %lu ms\n",
+                      tiempos.rapida ? (tiempos.fallback ? "rápida→completa" : "rápida") : "completa",
+                      (unsigned long)tiempos.asociacionMs, (unsigned long)tiempos.enlaceMs,
+                      (unsigned long)tiempos.totalMs);
+        cambiarEstado(EstadoWiFi::ONLINE);
+        break;
+
+    case EstadoWiFi::ONLINE:
+        if (!e.conIp) {
+            Serial.printf("📴 Enlace WiFi perdido (motivo %u).\n", e.motivo);
+            monitor.setEnlace(false);
+            entrarEnBackoff(MotivoFallo::ENLACE_PERDIDO);
+        }
+        break;
+
+    case EstadoWiFi::BACKOFF:
+        if (e.conIp) {
+            // El enlace volvió sin un intento nuestro (otro WiFi.begin())
+            Serial.println("Conectado a WiFi.");
+            tiempos = TiemposConexion();
+            inicioIntento = ahora;
+            cambiarEstado(EstadoWiFi::GOT_IP);
+        } else if (autoReconnect && tieneCredenciales() && !plan.detenido() &&
+            ahora - estadoDesde >= esperaReconexion) {
+            Serial.println("🔁 Intentando reconexión WiFi...");
+            iniciarAsociacion(RECONNECT_TIMEOUT_MS, true);
         }
-        delay(1000);
+        break;
     }
+}
 
-    Serial.println("Tiempo agotado. No se pudo conectar.");
-    return false;
+// Pide al plan la espera para el próximo intento y pasa a BACKOFF. Con la
+// clave rechazada varias veces el plan se detiene: no se reintenta hasta que
+// cambien las credenciales o la app llame a forzarReconexion().
+void WifiManager::entrarEnBackoff(MotivoFallo motivo) {
+    esperaReconexion = plan.registrarFallo(motivo);
+    if (plan.detenido()) {
+        Serial.println("🔑 La red rechazó la contraseña varias veces. Reconexión automática detenida.");
+    } else {
+        Serial.printf("⏳ Reintento en %lu ms (%s, fallo %lu)\n", (unsigned long)esperaReconexion,
+                      nombreMotivo(motivo), (unsigned long)plan.fallosSeguidos());
+    }
+    cambiarEstado(EstadoWiFi::BACKOFF);
+}
+
+// Con la conexión estable muestrea el RSSI y, si el promedio cae, busca otros
+// AP del mismo SSID con un escaneo dirigido. Sólo cambia si el mejor candidato
+// supera la histéresis; si no, espera hasta el próximo escaneo permitido.
+void WifiManager::atenderRoaming(unsigned long ahora) {
+    if (!roamingHabilitado || estado != EstadoWiFi::ONLINE) {
+        esperandoScanRoaming = false;
+        return;
+    }
+
+    if (ahora - ultimaMuestraRoaming >= roamer.configuracion().muestreoMs) {
+        ultimaMuestraRoaming = ahora;
+        roamer.registrarRssi(WiFi.RSSI());
+    }
+
+    if (esperandoScanRoaming) {
+        if (escaner.enCurso()) return;
+        esperandoScanRoaming = false;
+        if (escaner.generacion() == genScanRoaming) return;   // falló o se descartó
+
+        const uint8_t* actual = WiFi.BSSID();
+        int16_t mejor = -1;
+        for (uint8_t i = 0; i < escaner.cantidad(); ++i) {
+            const RedEscaneada& r = escaner.red(i);
+            if (strcmp(r.ssid, ssid.c_str()) != 0) continue;
+            if (actual && memcmp(r.bssid, actual, sizeof(r.bssid)) == 0) continue;
+            if (mejor < 0 || r.rssi > escaner.red(mejor).rssi) mejor = i;
+        }
+        if (mejor >= 0 && roamer.mejora(escaner.red(mejor).rssi)) cambiarBssid(escaner.red(mejor));
+        else roamer.sinCandidato();
+        return;
+    }
+
+    if (roamer.debeEscanear(ahora) && !escaner.enCurso() && escaner.solicitar(ssid.c_str())) {
+        roamer.escaneoIniciado(ahora);
+        genScanRoaming = escaner.generacion();
+        esperandoScanRoaming = true;
+    }
 }
 
-// Configura el ESP32 como Access Point
+// Asocia directo contra el BSSID elegido. Reusa el camino de la conexión
+// rápida: si el AP nuevo no responde se cae a la conexión completa.
+void WifiManager::cambiarBssid(const RedEscaneada& destino) {
+    Serial.printf("📶 Roaming: %d dBm → %d dBm (%02X:%02X:%02X:%02X:%02X:%02X, canal %u)\n",
+                  roamer.rssiSuavizado(), destino.rssi,
+                  destino.bssid[0], destino.bssid[1], destino.bssid[2],
+                  destino.bssid[3], destino.bssid[4], destino.bssid[5], destino.canal);
+    cambiosAlAsociar = enlace.instantanea().cambios;
+    iniciarBegin(destino.canal, destino.bssid);
+
+    tiempos = TiemposConexion();
+    tiempos.rapida = true;
+    intentoRapido = true;
+    enRoaming = true;
+    esReconexion = false;
+    motivoAsociacion = MotivoFallo::NINGUNO;
+    timeoutCompleto = RECONNECT_TIMEOUT_MS;
+    timeoutAsociacion = FAST_CONNECT_TIMEOUT_MS;
+    inicioIntento = wmMillis();
+    estado = EstadoWiFi::ASSOCIATING;
+    estadoDesde = inicioIntento;
+}
+
+// WiFi.begin() arma la configuración de la STA desde cero (listen interval en
+// 0), así que se llama sin conectar, se ajusta el intervalo del perfil y
+// recién ahí se conecta.
+void WifiManager::iniciarBegin(int32_t canal, const uint8_t* bssid) {
+    WiFi.begin(ssid.c_str(), password.c_str(), canal, bssid, false);
+    uint16_t intervalo = AJUSTES_ENERGIA[static_cast<uint8_t>(perfil)].listenInterval;
+    if (intervalo) {
+        wifi_config_t conf;
+        if (esp_wifi_get_config(WIFI_IF_STA, &conf) == ESP_OK) {
+            conf.sta.listen_interval = intervalo;
+            esp_wifi_set_config(WIFI_IF_STA, &conf);
+        }
+    }
+    esp_wifi_connect();
+}
+
+void WifiManager::aplicarPerfilEnergia() {
+    const AjustesEnergia& ajustes = AJUSTES_ENERGIA[static_cast<uint8_t>(perfil)];
+    if (!WiFi.setSleep(ajustes.sueno)) {
+        Serial.println("⚠️ El driver no aceptó el modo de sueño del perfil (¿AP activo?).");
+    }
+    WiFi.setTxPower(ajustes.potencia);
+}
+
+void WifiManager::terminarRoaming(bool ok, unsigned long ahora) {
+    enRoaming = false;
+    uint32_t duracion = ahora - inicioIntento;
+    roamer.registrarCambio(ok, duracion);
+    if (ok) {
+        metrics.roaming.registrar(duracion);
+        ++metrics.roamingOk;
+        Serial.printf("📶 Roaming completado en %lu ms.\n", (unsigned long)duracion);
+    } else {
+        ++metrics.roamingFallidos;
+        Serial.println("⚠️ Roaming fallido.");
+    }
+    emitir(TipoEventoWiFi::ROAMING, nullptr, ok);
+}
+
+// Configura el ESP32 como Access Point, levanta el DNS cautivo y precarga la
+// lista de redes para /scan
 void WifiManager::setupAP() {
     WiFi.mode(WIFI_AP);
     WiFi.softAP(DEFAULT_AP_SSID, DEFAULT_AP_PASS);
     Serial.println("Access Point creado: " DEFAULT_AP_SSID);
+    IPAddress ip = WiFi.softAPIP();
+    char url[24];
+    snprintf(url, sizeof(url), "http://%u.%u.%u.%u/", ip[0], ip[1], ip[2], ip[3]);
+    urlPortal = url;
+    if (dns.begin(ip, DNS_PORT)) {
+        Serial.println("📡 DNS cautivo activo: todos los nombres apuntan al portal.");
+    } else {
+        Serial.println("⚠️ No se pudo iniciar el DNS cautivo.");
+    }
+    escaner.solicitar();
 }
 
 // Manejador para servir el archivo index.html desde LittleFS
 void WifiManager::handleRoot() {
-    String path = htmlPathPrefix + "index.html";
-    if (!LittleFS.exists(path)) {
+    if (!servirArchivo("index.html", 200)) {
         server.send(500, "text/html", "<h1>Error: index.html no encontrado</h1>");
-        return;
     }
-    File file = LittleFS.open(path, "r");
-    if (!file || file.isDirectory()) {
-        server.send(500, "text/html", "<h1>Error abriendo index.html</h1>");
-        return;
+}
+
+// ¿El navegador acepta respuestas comprimidas con gzip?
+bool WifiManager::aceptaGzip() {
+    return server.header(ACCEPT_ENCODING).indexOf("gzip") >= 0;
+}
+
+// Envía una página del portal. Por defecto sale de la copia embebida en flash;
+// con usarPortalEmbebido(false) se busca primero en LittleFS, en bloques de
+// WM_CHUNK_SIZE bytes y sin cargarla entera en RAM. Si existe el hermano ".gz"
+// y el navegador lo acepta, se envía ese con Content-Encoding: gzip. Las
+// respuestas 200 llevan ETag y Cache-Control, y si el navegador ya tiene esa
+// versión se contesta 304 sin cuerpo. Devuelve false si no hay ninguna variante.
+bool WifiManager::servirArchivo(const char* nombre, int codigo) {
+#if WM_PORTAL_EMBEBIDO
+    if (portalEmbebido) return servirEmbebido(nombre, codigo);
+#endif
+
+    char ruta[96];
+    bool gzip = false;
+    File file;
+
+    if (aceptaGzip()) {
+        snprintf(ruta, sizeof(ruta), "%s%s.gz", htmlPathPrefix.c_str(), nombre);
+        if (LittleFS.exists(ruta)) {
+            file = LittleFS.open(ruta, "r");
+            gzip = true;
+        }
+    }
+    if (!file) {
+        snprintf(ruta, sizeof(ruta), "%s%s", htmlPathPrefix.c_str(), nombre);
+        if (LittleFS.exists(ruta)) file = LittleFS.open(ruta, "r");
+        gzip = false;
+    }
+    if (!file || file.isDirectory()) return servirEmbebido(nombre, codigo);
+
+    if (codigo == 200 && responderCache(nombre, cachePortal.etag(ruta), file.size())) {
+        file.close();
+        return true;
+    }
+    server.setContentLength(file.size());
+    if (gzip) server.sendHeader(CONTENT_ENCODING, "gzip");
+    server.send(codigo, "text/html", "");
+
+    uint8_t buf[WM_CHUNK_SIZE];
+    size_t n;
+    while ((n = file.read(buf, sizeof(buf))) > 0) {
+        server.sendContent(reinterpret_cast<const char*>(buf), n);
     }
-    server.send(200, "text/html", file.readString());
     file.close();
+    return true;
+}
+
+// Busca una página compilada en flash. También la usa el portal asíncrono.
+static bool recursoEmbebido(const char* nombre, const uint8_t** datos, size_t* longitud,
+                            const char** tipo, const char** etag) {
+#if WM_PORTAL_EMBEBIDO
+    for (const RecursoPortal& r : wm_portal::RECURSOS) {
+        if (strcmp(r.nombre, nombre) != 0) continue;
+        *datos = r.datos;
+        *longitud = r.longitud;
+        *tipo = r.tipo;
+        *etag = r.etag;
+        return true;
+    }
+#endif
+    return false;
+}
+
+// Envía la página compilada en flash directamente desde su arreglo (sin copias)
+bool WifiManager::servirEmbebido(const char* nombre, int codigo) {
+    const uint8_t* datos;
+    size_t longitud;
+    const char* tipo;
+    const char* etag;
+    if (!recursoEmbebido(nombre, &datos, &longitud, &tipo, &etag)) return false;
+    if (codigo == 200 && responderCache(nombre, etag, longitud)) return true;
+    server.sendHeader(CONTENT_ENCODING, "gzip");
+    server.send_P(codigo, tipo, reinterpret_cast<PGM_P>(datos), longitud);
+    return true;
+}
+
+// Agrega ETag y Cache-Control a una respuesta 200. Si If-None-Match ya trae
+// esa ETag responde 304 y devuelve true: el cuerpo no hace falta.
+bool WifiManager::responderCache(const char* nombre, const char* etag, size_t longitud) {
+    if (!etag) return false;
+    char control[24];
+    cachePortal.cacheControl(nombre, control, sizeof(control));
+    server.sendHeader("ETag", etag);
+    server.sendHeader(CACHE_CONTROL, control);
+    if (!CachePortal::coincide(server.header(IF_NONE_MATCH).c_str(), etag)) return false;
+
+    server.send(304);
+    metrics.registrarNoModificado(longitud);
+    return true;
+}
+
+// Hashea una sola vez las páginas de LittleFS (y sus ".gz") para tener las
+// ETags listas; se repite si cambia el prefijo.
+void WifiManager::indexarPortal() {
+    static const char* paginas[] = { "index.html", "success.html", "error.html" };
+    cachePortal.limpiar();
+    if (!fsMontado) return;
+
+    char ruta[96];
+    uint8_t buf[WM_CHUNK_SIZE];
+    for (const char* pagina : paginas) {
+        for (uint8_t gz = 0; gz < 2; ++gz) {
+            snprintf(ruta, sizeof(ruta), gz ? "%s%s.gz" : "%s%s", htmlPathPrefix.c_str(), pagina);
+            if (!LittleFS.exists(ruta)) continue;
+            File file = LittleFS.open(ruta, "r");
+            if (!file || file.isDirectory()) continue;
+            uint32_t hash = CachePortal::FNV_INICIAL;
+            size_t n;
+            while ((n = file.read(buf, sizeof(buf))) > 0) hash = CachePortal::fnv1a(buf, n, hash);
+            cachePortal.registrar(ruta, hash, file.size());
+            file.close();
+        }
+    }
 }
 
 // Manejador para guardar credenciales enviadas desde el formulario web
@@ -218,125 +1220,642 @@ void WifiManager::handleSave() {
         return;
     }
 
-    String ssid = server.arg("ssid");
-    String password = server.arg("password");
+    // Una sola pasada por el formulario. En el core 3.x argName(i) y arg(i)
+    // devuelven const String& y esto no copia nada; en 2.x devuelven un String
+    // que la referencia mantiene vivo sólo hasta el final de la vuelta, así
+    // que las credenciales se copian a búferes fijos antes de seguir.
+    CadenaSsid  nuevoSsid;
+    CadenaClave nuevoPassword;
+    bool entran = true;
+    for (int i = 0; i < server.args(); ++i) {
+        const String& nombre = server.argName(i);
+        const String& valor = server.arg(i);
+        if (nombre == "ssid")          entran = nuevoSsid.asignar(valor.c_str()) && entran;
+        else if (nombre == "password") entran = nuevoPassword.asignar(valor.c_str()) && entran;
+        recibirParametro(this, nombre.c_str(), valor.c_str());
+    }
 
-    if (ssid.isEmpty() || password.isEmpty()) {
+    if (!entran || nuevoSsid.isEmpty() || nuevoPassword.isEmpty()) {
+        descartarParametros();
         mostrarPaginaError("Faltan datos para guardar.");
         return;
     }
+    if (parametroInvalido) {
+        descartarParametros();
+        mostrarPaginaError("Hay parámetros inválidos.");
+        return;
+    }
 
-    StaticJsonDocument<192> doc;
-    doc["ssid"] = ssid;
-    doc["password"] = password;
-
-    File file = LittleFS.open("/wifi.json", "w");
-    if (!file) {
+    if (!agregarRed(nuevoSsid.c_str(), nuevoPassword.c_str())) {
+        descartarParametros();
         mostrarPaginaError("Error al guardar credenciales.");
         return;
     }
+    wmBloquear(cerrojoPendientes);
+    parametrosExtra.completar();
+    wmDesbloquear(cerrojoPendientes);
+    aplicarParametros();
 
-    serializeJson(doc, file);
-    file.close();
-
-    File success = LittleFS.open(htmlPathPrefix + "success.html", "r");
-    if (!success) {
+    if (!servirArchivo("success.html", 200)) {
         server.send(200, "text/html", "<h1>Guardado. Reiniciando...</h1>");
+    }
+    programarReinicio();
+}
+
+// Botón por sondeo con antirrebote y LED según el estado, sin bloquear. Una
+// pulsación larga borra las credenciales y deja programado el reinicio.
+void WifiManager::atenderIndicadores(uint32_t ahora) {
+    switch (boton.actualizar(digitalRead(buttonPin) == LOW, ahora)) {
+    case EventoBoton::PRESIONADO:
+        Serial.println("⏳ Manteniendo presionado...");
+        break;
+    case EventoBoton::SOLTADO:
+        Serial.println("❌ Botón soltado antes de tiempo. No se borraron las credenciales.");
+        break;
+    case EventoBoton::MANTENIDO:
+        Serial.printf("🩹 Botón presionado por %lu segundos. Borrando credenciales WiFi.\n",
+                      (unsigned long)(boton.configuracion().mantenerMs / 1000));
+        eraseAll();
+        programarReinicio();
+        break;
+    default:
+        break;
+    }
+
+    if (boton.presionado()) {
+        motorLed.setPatron(boton.presionadoMs(ahora) >= boton.configuracion().mantenerMs ? LED_BOTON_FIJO : LED_BOTON, ahora);
     } else {
-        server.send(200, "text/html", success.readString());
-        success.close();
+        motorLed.setPatron(patronesLed[static_cast<uint8_t>(estado)], ahora);
+    }
+    bool nivel = motorLed.nivel(ahora);
+    if (nivel != ledEncendido) {
+        ledEncendido = nivel;
+        digitalWrite(ledPin, nivel ? HIGH : LOW);
+    }
+}
+
+// El reinicio lo hace update() un rato después, así la respuesta llega al
+// navegador sin frenar al resto de los clientes con un delay()
+void WifiManager::programarReinicio() {
+    reinicioPendiente = true;
+    reinicioDesde = wmMillis();
+}
+
+// Llamada desde la tarea de AsyncTCP: sólo valida y copia; la escritura en
+// flash la hace atenderPedidosPortal() desde update()
+bool WifiManager::recibirCredenciales(void* contexto, const char* nuevoSsid, const char* nuevoPassword) {
+    WifiManager& wm = *static_cast<WifiManager*>(contexto);
+    size_t lenSsid = strlen(nuevoSsid);
+    size_t lenPassword = strlen(nuevoPassword);
+    bool valido = lenSsid > 0 && lenSsid < sizeof(wm.ssidPendiente) &&
+                  lenPassword > 0 && lenPassword < sizeof(wm.passwordPendiente);
+
+    // Cualquier rechazo descarta también los parámetros ya recibidos, para que
+    // no se apliquen con el próximo envío
+    wmBloquear(wm.cerrojoPendientes);
+    if (!valido || wm.parametroInvalido) {
+        wm.parametrosExtra.descartar();
+        wm.parametroInvalido = false;
+        wmDesbloquear(wm.cerrojoPendientes);
+        return false;
+    }
+    wm.parametrosExtra.completar();
+    memcpy(wm.ssidPendiente, nuevoSsid, lenSsid + 1);
+    memcpy(wm.passwordPendiente, nuevoPassword, lenPassword + 1);
+    wm.credencialesPendientes = true;
+    wmDesbloquear(wm.cerrojoPendientes);
+    return true;
+}
+
+// Un campo del formulario de /save (cualquiera de las dos tareas). Se valida
+// al llegar y queda en el lugar ya reservado del parámetro; un valor inválido
+// marca el envío para que se descarte entero.
+bool WifiManager::recibirParametro(void* contexto, const char* nombre, const char* valor) {
+    WifiManager& wm = *static_cast<WifiManager*>(contexto);
+    wmBloquear(wm.cerrojoPendientes);
+    bool ok = wm.parametrosExtra.recibir(nombre, valor);
+    if (!ok) wm.parametroInvalido = true;
+    wmDesbloquear(wm.cerrojoPendientes);
+    return ok;
+}
+
+void WifiManager::descartarParametros() {
+    wmBloquear(cerrojoPendientes);
+    parametrosExtra.descartar();
+    parametroInvalido = false;
+    wmDesbloquear(cerrojoPendientes);
+}
+
+// Pasa lo recibido a la configuración con su tipo; la escritura en flash la
+// hace atenderConfig() (o el guardado previo al reinicio).
+void WifiManager::aplicarParametros() {
+    for (uint8_t i = 0; i < parametrosExtra.cantidad(); ++i) {
+        char valor[WM_CONFIG_VALOR];
+        wmBloquear(cerrojoPendientes);
+        bool hay = parametrosExtra.pendiente(i);
+        if (hay) {
+            memcpy(valor, parametrosExtra.parametro(i).recibido, sizeof(valor));
+            parametrosExtra.aplicado(i);
+        }
+        wmDesbloquear(cerrojoPendientes);
+        if (!hay) continue;
+
+        const ParametroPortal& p = parametrosExtra.parametro(i);
+        switch (p.tipo) {
+        case TipoParametro::ENTERO:
+            setConfig(ESPACIO_PARAMETROS, p.id, strtol(valor, nullptr, 10));
+            break;
+        case TipoParametro::BOOLEANO:
+            setConfig(ESPACIO_PARAMETROS, p.id, strcmp(valor, "true") == 0);
+            break;
+        default:
+            setConfig(ESPACIO_PARAMETROS, p.id, static_cast<const char*>(valor));
+            break;
+        }
+    }
+}
+
+// Parámetro i como JSON, con el valor guardado si lo hay (para /params)
+size_t WifiManager::parametroJson(void* contexto, uint8_t i, bool primero, char* destino, size_t capacidad) {
+    WifiManager& wm = *static_cast<WifiManager*>(contexto);
+    if (i >= wm.parametrosExtra.cantidad()) return 0;
+    char actual[WM_CONFIG_VALOR];
+    bool hay = wm.getConfigString(ESPACIO_PARAMETROS, wm.parametrosExtra.parametro(i).id, actual, sizeof(actual));
+    return wm.parametrosExtra.comoJson(i, hay ? actual : nullptr, primero, destino, capacidad);
+}
+
+// Completa en la tarea de loop() lo que los manejadores asíncronos dejaron
+// pedido, y el reinicio diferido de /save
+void WifiManager::atenderPedidosPortal() {
+    if (scanPedido) {
+        scanPedido = false;
+        escaner.solicitarSiVencido();
+    }
+
+    if (credencialesPendientes) {
+        char nuevoSsid[sizeof(ssidPendiente)];
+        char nuevoPassword[sizeof(passwordPendiente)];
+        wmBloquear(cerrojoPendientes);
+        memcpy(nuevoSsid, ssidPendiente, sizeof(nuevoSsid));
+        memcpy(nuevoPassword, passwordPendiente, sizeof(nuevoPassword));
+        credencialesPendientes = false;
+        wmDesbloquear(cerrojoPendientes);
+
+        if (agregarRed(nuevoSsid, nuevoPassword)) {
+            Serial.println("💾 Credenciales guardadas desde el portal.");
+            aplicarParametros();
+            programarReinicio();
+        } else {
+            descartarParametros();
+            Serial.println("Error al guardar credenciales.");
+        }
     }
 
-    delay(1000);
-    ESP.restart();
+    if (reinicioPendiente && wmMillis() - reinicioDesde >= REINICIO_DIFERIDO_MS) {
+        Serial.println("🔄 Reiniciando para aplicar la configuración...");
+        guardarConfig();
+        ESP.restart();
+    }
 }
 
 // Muestra una página de error o un mensaje HTML básico si el archivo no existe
-void WifiManager::mostrarPaginaError(const String& mensajeFallback) {
-    File errorFile = LittleFS.open(htmlPathPrefix + "error.html", "r");
-    if (!errorFile) {
-        server.send(500, "text/html", "<h1>Error: " + mensajeFallback + "</h1>");
-    } else {
-        server.send(500, "text/html", errorFile.readString());
-        errorFile.close();
+void WifiManager::mostrarPaginaError(const char* mensajeFallback) {
+    if (!servirArchivo("error.html", 500)) {
+        server.send(500, "text/html", arena.formatear("<h1>Error: %s</h1>", mensajeFallback));
     }
 }
 
-// Escanea redes WiFi disponibles y devuelve un JSON con SSID, RSSI y seguridad
-void WifiManager::handleScan() {
-    Serial.println("🔍 Escaneando redes WiFi...");
+namespace {
+// Cuerpo de respuesta con Transfer-Encoding: chunked. Junta lo escrito en un
+// búfer fijo y lo envía de a WM_CHUNK_SIZE bytes, así la memoria no depende
+// del tamaño de la respuesta y no sale un paquete por cada línea.
+class EnvioChunked {
+public:
+    explicit EnvioChunked(WebServer& server) : server(server) {}
+
+    void escribir(const char* texto, size_t longitud) {
+        if (usado + longitud > sizeof(buf)) vaciar();
+        if (longitud > sizeof(buf)) {
+            server.sendContent(texto, longitud);
+            return;
+        }
+        memcpy(buf + usado, texto, longitud);
+        usado += longitud;
+    }
 
-    WiFi.mode(WIFI_AP_STA);  // Mantenemos el AP activo
-    delay(200);
+    void terminar() {
+        vaciar();
+        server.sendContent("");             // chunk de longitud 0: fin del cuerpo
+    }
 
-    WiFi.scanDelete();
-    int n = WiFi.scanNetworks();
-    Serial.printf("📱 %d redes encontradas\n", n);
+    // Adaptador para WifiMetrics::exportarPrometheus()
+    static void escritor(const char* texto, size_t longitud, void* contexto) {
+        static_cast<EnvioChunked*>(contexto)->escribir(texto, longitud);
+    }
 
-    DynamicJsonDocument doc(1024);
-    JsonArray arr = doc.to<JsonArray>();
+private:
+    void vaciar() {
+        if (usado) server.sendContent(buf, usado);
+        usado = 0;
+    }
 
-    for (int i = 0; i < n; ++i) {
-        JsonObject obj = arr.createNestedObject();
-        obj["ssid"] = WiFi.SSID(i);
-        obj["rssi"] = WiFi.RSSI(i);
-        obj["secure"] = (WiFi.encryptionType(i) != WIFI_AUTH_OPEN);
+    WebServer& server;
+    size_t     usado = 0;
+    char       buf[WM_CHUNK_SIZE];
+};
+}
+
+// Devuelve al instante la caché de redes (SSID, RSSI y seguridad) en JSON.
+// CursorJsonScan lo escribe red por red con codificación chunked: no hay
+// documento intermedio ni tope de tamaño, y la memoria usada es la misma con 3
+// redes que con 60.
+// Si la caché venció lanza un escaneo en segundo plano y lo avisa con
+// X-Scan-Pending para que el portal vuelva a consultar.
+void WifiManager::handleScan() {
+    escaner.solicitarSiVencido();
+
+    server.sendHeader(X_SCAN_GENERATION, arena.formatear("%lu", (unsigned long)escaner.generacion()));
+    if (escaner.enCurso()) server.sendHeader(X_SCAN_PENDING, "1");
+    if (escaner.descartadas()) {
+        server.sendHeader(X_SCAN_TRUNCATED, arena.formatear("%u", (unsigned)escaner.descartadas()));
+    }
+    FiltroScan filtro;
+    static const char* parametros[] = { "min_rssi", "limit", "secure" };
+    for (const char* p : parametros) {
+        if (server.hasArg(p)) filtro.leer(p, server.arg(p).c_str());
     }
 
-    WiFi.scanDelete();
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "application/json", "");
+
+    CursorJsonScan cursor(escaner, filtro);
+    uint8_t buf[WM_CHUNK_SIZE];
+    size_t n;
+    while ((n = cursor.leer(buf, sizeof(buf))) > 0) {
+        server.sendContent(reinterpret_cast<const char*>(buf), n);
+    }
+    server.sendContent("");
+}
 
-    String output;
-    serializeJson(doc, output);
-    server.send(200, "application/json", output);
+// Esquema de los parámetros propios, con su valor actual, para que la página
+// arme los campos. Sale de a un objeto, sin armar el arreglo entero en RAM.
+void WifiManager::handleParams() {
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "application/json", "");
+
+    char buf[WM_PARAMETRO_JSON];
+    server.sendContent("[");
+    size_t n;
+    for (uint8_t i = 0; (n = parametroJson(this, i, i == 0, buf, sizeof(buf))) > 0; ++i) {
+        server.sendContent(buf, n);
+    }
+    server.sendContent("]");
+    server.sendContent("");
 }
 
 
 
-// Redirecciona al inicio si se accede a una ruta no válida
+// Redirecciona al inicio si se accede a una ruta no válida. Con el DNS
+// cautivo acá llegan las pruebas de conectividad de los teléfonos
+// (generate_204, hotspot-detect…); la URL absoluta hace que abran el portal.
 void WifiManager::handleNotFound() {
-    server.sendHeader("Location", "/", true);
+    server.sendHeader("Location", urlPortal, true);
     server.send(302, "text/plain", "");
 }
 
-// Sincroniza la hora local con servidores NTP
+// Registra las rutas que falten y arranca el servidor una sola vez. Las del
+// portal sólo se agregan con el AP activo: en la red del usuario se expone
+// únicamente /metrics, y sólo si se pidió con habilitarMetricas().
+void WifiManager::iniciarServidor(bool portal) {
+#if WM_ASYNC_SERVER
+    if (modoServidor == ServidorPortal::ASINCRONO) {
+        PuentePortal puente = { &escaner, &metrics, htmlPathPrefix.c_str(), urlPortal.c_str(),
+                                &portalEmbebido, &scanPedido,
+                                &cachePortal,
+                                &WifiManager::recibirCredenciales, &WifiManager::recibirParametro,
+                                &WifiManager::parametroJson, &recursoEmbebido, this };
+        portalAsync.iniciar(puente, portal, metricasHttp);
+        servidorActivo = true;
+        return;
+    }
+#endif
+    if (portal && !rutasPortal) {
+        server.on("/", [this]() { atenderRuta(RutaHttp::RAIZ, &WifiManager::handleRoot); });
+        server.on("/save", [this]() { atenderRuta(RutaHttp::SAVE, &WifiManager::handleSave); });
+        server.on("/scan", [this]() { atenderRuta(RutaHttp::SCAN, &WifiManager::handleScan); });
+        server.on("/params", HTTP_GET, [this]() { atenderRuta(RutaHttp::PARAMS, &WifiManager::handleParams); });
+        server.onNotFound([this]() { atenderRuta(RutaHttp::NOT_FOUND, &WifiManager::handleNotFound); });
+        rutasPortal = true;
+    }
+    if (metricasHttp && !rutaMetricas) {
+        server.on("/metrics", HTTP_GET, [this]() { atenderRuta(RutaHttp::METRICS, &WifiManager::handleMetrics); });
+        rutaMetricas = true;
+    }
+    if (servidorActivo) return;
+
+    static const char* cabeceras[] = { "Accept-Encoding", "If-None-Match" };
+    server.collectHeaders(cabeceras, 2);
+    server.begin();
+    servidorActivo = true;
+}
+
+// Ejecuta un manejador y suma su duración al histograma de la ruta
+void WifiManager::atenderRuta(RutaHttp ruta, void (WifiManager::*manejador)()) {
+    uint64_t inicio = wmMicros();
+    (this->*manejador)();
+    arena.reiniciar();
+    uint64_t us = wmMicros() - inicio;
+    metrics.registrarRuta(ruta, static_cast<uint32_t>((us + 999) / 1000));
+}
+
+// Exporta las métricas en formato de texto de Prometheus, con codificación
+// chunked para no armar el documento entero en RAM
+void WifiManager::handleMetrics() {
+    metrics.muestrearHeap(ESP.getFreeHeap(), ESP.getMinFreeHeap(), ESP.getMaxAllocHeap());
+
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "text/plain; version=0.0.4", "");
+
+    EnvioChunked envio(server);
+    metrics.exportarPrometheus(&EnvioChunked::escritor, &envio);
+    envio.terminar();
+}
+
+// Lanza la sincronización NTP sin esperarla: SNTP sigue en segundo plano y
+// cada respuesta (la primera y las periódicas) llega a alSincronizarHora()
 void WifiManager::sincronizarHoraNTP() {
+    sntp_set_time_sync_notification_cb(alSincronizarHora);
     configTime(0, 0, "pool.ntp.org", "time.nist.gov");
-    for (int j = 0; j < 20; j++) {
-        time_t now = time(nullptr);
-        if (now > 100000) {
-            Serial.print("Hora sincronizada: ");
-            Serial.println(ctime(&now));
-            return;
-        }
-        delay(200);
-    }
-    Serial.println("⚠️ NTP no respondió. Continuando sin sincronizar.");
 }
 
-// Devuelve timestamp actual en milisegundos si la hora fue sincronizada
-uint64_t WifiManager::getTimestamp() {
+// Registra la primera hora tras conectar (métrica y log). Se llama desde update().
+void WifiManager::atenderSincronizacionNtp() {
+    uint32_t n = sincronizacionesNtp.load(std::memory_order_acquire);
+    if (n == syncVistas) return;
+    syncVistas = n;
+    if (!esperandoNtp) return;
+
+    esperandoNtp = false;
+    tiempos.ntpMs = wmMillis() - inicioNtp;
+    metrics.ntp.registrar(tiempos.ntpMs);
     time_t now = time(nullptr);
-    return (now > 100000) ? static_cast<uint64_t>(now) * 1000ULL : 0;
+    Serial.printf("🕒 Hora sincronizada en %lu ms: %s", (unsigned long)tiempos.ntpMs, ctime(&now));
+}
+
+// Devuelve timestamp actual en milisegundos desde epoch. Con NTP se calcula
+// desde el ancla en esp_timer corregida por deriva (resolución real de 1 ms);
+// si la hora vino de otro lado se usa gettimeofday(). No toma cerrojos, así
+// que se puede llamar desde cualquier tarea. Nunca retrocede: si una
+// sincronización atrasa el reloj, se mantiene la hora a la que había llegado
+// el anterior hasta que la nueva la alcance.
+uint64_t WifiManager::getTimestamp() {
+    HoraPublicada hora = horaPublicada();
+    if (hora.reloj.sincronizado()) {
+        int64_t us = hora.reloj.epochUs(static_cast<int64_t>(wmMicros()));
+        if (us < hora.pisoUs) us = hora.pisoUs;
+        return static_cast<uint64_t>(us / 1000);
+    }
+
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    if (tv.tv_sec <= 100000) return 0;
+    return static_cast<uint64_t>(tv.tv_sec) * 1000ULL + tv.tv_usec / 1000;
+}
+
+bool WifiManager::horaSincronizada() const {
+    return horaPublicada().reloj.sincronizado();
+}
+
+uint32_t WifiManager::edadSincronizacionMs() const {
+    int64_t edad = horaPublicada().reloj.edadUs(static_cast<int64_t>(wmMicros()));
+    if (edad < 0 || edad / 1000 > UINT32_MAX) return UINT32_MAX;
+    return static_cast<uint32_t>(edad / 1000);
 }
 
-// Verifica si el dispositivo está conectado al WiFi
-bool WifiManager::isConnected() {
-    return connected && WiFi.status() == WL_CONNECTED;
+uint32_t WifiManager::errorEstimadoMs() const {
+    uint32_t us = horaPublicada().reloj.errorUs(static_cast<int64_t>(wmMicros()));
+    return us == UINT32_MAX ? UINT32_MAX : (us + 999) / 1000;
 }
 
-// Devuelve el nivel de señal RSSI de la red actual
+// Verifica si el dispositivo está conectado al WiFi. La instantánea la mantienen
+// los eventos del driver, así que no hace falta consultar WiFi.status().
+bool WifiManager::isConnected() const {
+    return enlace.instantanea().conIp;
+}
+
+EstadoEnlace WifiManager::estadoEnlace() const {
+    return enlace.instantanea();
+}
+
+void WifiManager::onEnlace(OyenteEnlace oyente, void* contexto) {
+    oyenteEnlace = oyente;
+    contextoOyente = contexto;
+}
+
+/* ==============================================================
+   Modo tarea: update() en su propia tarea, comandos y eventos por colas
+   ============================================================== */
+bool WifiManager::iniciarTarea(BaseType_t nucleo, UBaseType_t prioridad, uint32_t pilaBytes) {
+    if (tarea) return true;
+    estadoEmitido = estado;
+    if (xTaskCreatePinnedToCore(&WifiManager::bucleTarea, "wm_manager", pilaBytes, this,
+                                prioridad, &tarea, nucleo) != pdPASS) {
+        tarea = nullptr;
+        Serial.println("⚠️ No se pudo crear la tarea del WifiManager.");
+        return false;
+    }
+    Serial.printf("🧵 WifiManager en su propia tarea (núcleo %d).\n", (int)nucleo);
+    return true;
+}
+
+bool WifiManager::enTarea() const {
+    return tarea != nullptr;
+}
+
+// En modo tarea sólo la tarea propia avanza la máquina de estados y vacía las
+// colas del enlace; desde cualquier otra hay que pasar por un comando
+bool WifiManager::desdeOtraTarea() const {
+    return tarea && xTaskGetCurrentTaskHandle() != tarea;
+}
+
+// Duerme hasta el próximo turno o hasta que llegue un comando o un evento del driver
+void WifiManager::bucleTarea(void* arg) {
+    WifiManager* manager = static_cast<WifiManager*>(arg);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PERIODO_TAREA_MS));
+        manager->update();
+    }
+}
+
+bool WifiManager::encolarComando(TipoComandoWiFi tipo, const char* nuevoSsid, const char* nuevoPassword) {
+    ComandoWiFi comando = {};
+    comando.tipo = tipo;
+    if (nuevoSsid) strlcpy(comando.ssid, nuevoSsid, sizeof(comando.ssid));
+    if (nuevoPassword) strlcpy(comando.password, nuevoPassword, sizeof(comando.password));
+    if (!comandos.poner(comando)) return false;
+    if (tarea) xTaskNotifyGive(tarea);
+    return true;
+}
+
+bool WifiManager::pedirConexion() {
+    return encolarComando(TipoComandoWiFi::CONECTAR);
+}
+
+bool WifiManager::pedirEscaneo() {
+    return encolarComando(TipoComandoWiFi::ESCANEAR);
+}
+
+bool WifiManager::pedirGuardarRed(const char* nuevoSsid, const char* nuevoPassword) {
+    if (!nuevoSsid || !nuevoSsid[0]) return false;
+    return encolarComando(TipoComandoWiFi::GUARDAR_RED, nuevoSsid, nuevoPassword ? nuevoPassword : "");
+}
+
+bool WifiManager::pedirOlvidarRed(const char* viejoSsid) {
+    if (!viejoSsid || !viejoSsid[0]) return false;
+    return encolarComando(TipoComandoWiFi::OLVIDAR_RED, viejoSsid);
+}
+
+bool WifiManager::pedirReconexion() {
+    return encolarComando(TipoComandoWiFi::RECONECTAR);
+}
+
+bool WifiManager::siguienteEvento(EventoWiFi& evento) {
+    return eventos.sacar(evento);
+}
+
+void WifiManager::atenderComandos() {
+    ComandoWiFi comando;
+    while (comandos.sacar(comando)) {
+        switch (comando.tipo) {
+        case TipoComandoWiFi::CONECTAR:
+            if (!conexionEnCurso()) conectarAsync();
+            break;
+        case TipoComandoWiFi::ESCANEAR:
+            escaner.solicitar();
+            break;
+        case TipoComandoWiFi::GUARDAR_RED:
+            emitir(TipoEventoWiFi::RED_GUARDADA, nullptr, agregarRed(comando.ssid, comando.password));
+            break;
+        case TipoComandoWiFi::OLVIDAR_RED:
+            olvidarRed(comando.ssid);
+            break;
+        case TipoComandoWiFi::RECONECTAR:
+            forzarReconexion();
+            break;
+        case TipoComandoWiFi::REINTENTAR:
+            reintentarConexionSiNecesario();
+            break;
+        }
+    }
+}
+
+// Sin tarea propia nadie vacía la cola, así que sólo se emite en ese modo.
+// Si la app no lee a tiempo, los eventos nuevos se pierden.
+void WifiManager::emitir(TipoEventoWiFi tipo, const EventoEnlace* transicion, bool ok) {
+    if (!tarea) return;
+    EventoWiFi evento = {};
+    evento.tipo = tipo;
+    evento.estado = estado;
+    evento.ok = ok;
+    if (tipo == TipoEventoWiFi::ESCANEO) {
+        evento.redes = escaner.cantidad();
+        evento.generacion = escaner.generacion();
+    }
+    if (transicion) evento.enlace = *transicion;
+    eventos.poner(evento);
+}
+
+// Devuelve el nivel de señal RSSI de la red actual. En modo tarea no se toca el
+// driver desde la tarea que llama: se devuelve la muestra que toma update().
 int WifiManager::getSignalStrength() {
+    if (tarea) return rssiMuestreado.load(std::memory_order_relaxed);
     return WiFi.RSSI();
 }
 
-// Maneja las peticiones entrantes del cliente HTTP
+// Avanza la máquina de conexión y maneja las peticiones entrantes del cliente HTTP.
+// En modo tarea sólo la corre la tarea propia; llamarla desde otra no hace nada.
 void WifiManager::update() {
-    server.handleClient();
+    if (desdeOtraTarea()) return;
+
+    atenderComandos();
+    avanzarConexion();
+    atenderRoaming(wmMillis());
+    atenderIndicadores(wmMillis());
+    atenderConfig(wmMillis());
+    escaner.update();
+    dns.update();
+    atenderSincronizacionNtp();
+
+    if (escaner.generacion() != scanGenMedida) {
+        scanGenMedida = escaner.generacion();
+        metrics.scan.registrar(escaner.duracionMs());
+        emitir(TipoEventoWiFi::ESCANEO);
+    }
+    if (estado != estadoEmitido) {
+        estadoEmitido = estado;
+        emitir(TipoEventoWiFi::ESTADO);
+    }
+    EstadoAlcance alcance = monitor.estado();
+    if (alcance.secuencia != alcanceVisto) {
+        alcanceVisto = alcance.secuencia;
+        if (alcance.alcance != Alcance::DESCONOCIDO) {
+            metrics.internet.registrar(alcance.latenciaMs);
+            if (alcance.alcance == Alcance::ONLINE) ++metrics.internetOk;
+            else                                    ++metrics.internetFallos;
+        }
+    }
+
+    unsigned long ahora = wmMillis();
+    if (ahora - ultimoMuestreoHeap >= HEAP_MUESTREO_MS) {
+        ultimoMuestreoHeap = ahora;
+        metrics.muestrearHeap(ESP.getFreeHeap(), ESP.getMinFreeHeap(), ESP.getMaxAllocHeap());
+        rssiMuestreado.store(isConnected() ? WiFi.RSSI() : 0, std::memory_order_relaxed);
+    }
+    if (metricasHttp && !servidorActivo && estado == EstadoWiFi::ONLINE) iniciarServidor(false);
+
+    atenderPedidosPortal();
+    if (servidorActivo && modoServidor == ServidorPortal::SINCRONO) server.handleClient();
 }
 
 // Define el prefijo de ruta para buscar archivos HTML
 void WifiManager::setHtmlPathPrefix(const String& prefix) {
-    htmlPathPrefix = prefix.endsWith("/") ? prefix : prefix + "/";
+    htmlPathPrefix = prefix.c_str();
+    if (htmlPathPrefix.ultimo() != '/' && !htmlPathPrefix.agregar("/")) {
+        Serial.println("⚠️ Prefijo de rutas demasiado largo. Se usa \"/\".");
+        htmlPathPrefix = "/";
+    }
+    indexarPortal();
+}
+
+void WifiManager::setFastReconnect(bool habilitado, bool reutilizarIp) {
+    fastReconnect = habilitado;
+    fastReutilizarIp = reutilizarIp;
+}
+
+const TiemposConexion& WifiManager::getTiemposConexion() const {
+    return tiempos;
+}
+
+const WifiMetrics& WifiManager::metricas() const {
+    return metrics;
+}
+
+// Si el servidor ya está corriendo (portal) la ruta se agrega al momento;
+// si no, update() lo levanta al quedar ONLINE
+void WifiManager::habilitarMetricas(bool habilitado) {
+    metricasHttp = habilitado;
+    if (habilitado && servidorActivo) iniciarServidor(false);
+}
+
+// Elige entre las páginas embebidas (por defecto) y las de LittleFS
+void WifiManager::usarPortalEmbebido(bool habilitado) {
+    portalEmbebido = habilitado;
+}
+
+void WifiManager::setCacheControl(const char* pagina, uint32_t maxAgeSegundos) {
+    if (!cachePortal.setMaxAge(pagina, maxAgeSegundos)) {
+        Serial.println("⚠️ Sin lugar para más políticas de caché.");
+    }
 }
 
 // Reintenta conectar a WiFi si está desconectado, cada 10 segundos
@@ -362,40 +1881,30 @@ void WifiManager::setHtmlPathPrefix(const String& prefix) {
 //     }
 // }
 
+// Ya no bloquea: si no hay intento en curso, programa uno según el plan de
+// reintentos y deja que la máquina de estados lo complete desde update().
 void WifiManager::reintentarConexionSiNecesario() {
     if (!autoReconnect) return;  // ← si se deshabilitó, no reconecta
-    if (connected) return;
-    unsigned long ahora = millis();
-    if (ahora - ultimoIntentoWiFi < 10000) return;
-    ultimoIntentoWiFi = ahora;
-
-    if (!ssid.isEmpty() && !password.isEmpty()) {
-        Serial.println("🔁 Intentando reconexión WiFi...");
-        WiFi.mode(WIFI_AP_STA);
-        WiFi.begin(ssid.c_str(), password.c_str());
-        for (int i = 0; i < 10; i++) {
-            if (WiFi.status() == WL_CONNECTED) {
-                Serial.println("🔌 Reconectado a WiFi.");
-                sincronizarHoraNTP();
-                connected = true;
-                return;
-            }
-            delay(500);
-        }
-        Serial.println("❌ Reconexión WiFi fallida.");
+    if (desdeOtraTarea()) {
+        encolarComando(TipoComandoWiFi::REINTENTAR);
+        return;
     }
+    if (estado == EstadoWiFi::IDLE && !isConnected()) cambiarEstado(EstadoWiFi::BACKOFF);
+    avanzarConexion();
 }
 
-// Verifica si hay conexión real a Internet usando un endpoint de Google
+// Verifica si hay conexión real a Internet. Devuelve el último resultado del
+// monitor, que sondea en su propia tarea (por defecto generate_204 de Google),
+// así que se puede llamar en cada vuelta de loop() sin costo. La primera
+// llamada arranca esa tarea; hasta que termina la primera sonda devuelve false.
 bool WifiManager::hayInternet() {
-    if (WiFi.status() != WL_CONNECTED) return false;
-    WiFiClient client;
-    HTTPClient http;
-    http.begin(client, "http://clients3.google.com/generate_204");
-    http.setConnectTimeout(3000);
-    int httpCode = http.GET();
-    http.end();
-    return (httpCode == 204);
+    monitor.activar();
+    if (!isConnected()) return false;
+    return monitor.alcance() == Alcance::ONLINE;
+}
+
+MonitorInternet& WifiManager::monitorInternet() {
+    return monitor;
 }
 
 // Nuevo método para habilitar/deshabilitar reconexión automática
@@ -407,27 +1916,111 @@ void WifiManager::setAutoReconnect(bool habilitado) {
    Detección de que la red preferida volvió a aparecer (modo AP)
    ============================================================== */
 bool WifiManager::scanRedDetectada() {
-    unsigned long ahora = millis();
-    if (ahora - ultimoScan < SCAN_INTERVAL_MS) return false;   // evita spam
-    ultimoScan = ahora;
+    if (desdeOtraTarea()) return false;     // en modo tarea: pedirEscaneo() y evento ESCANEO
+    unsigned long ahora = wmMillis();
+    if (ahora - ultimoScan >= SCAN_INTERVAL_MS) {               // evita spam
+        ultimoScan = ahora;
+        escaner.solicitarSiVencido();   // comparte caché con /scan
+    }
 
-    int n = WiFi.scanNetworks(/*async=*/false, /*show_hidden=*/false);
-    bool encontrada = false;
-    for (int i = 0; i < n; ++i) {
-        if (WiFi.SSID(i) == ssid) { encontrada = true; break; }
+    // Sólo se informa una vez por cada resultado nuevo del escáner
+    if (escaner.generacion() == scanGenVista) return false;
+    scanGenVista = escaner.generacion();
+    for (uint8_t i = 0; i < redes.cantidad(); ++i) {
+        if (escaner.contiene(redes.red(i).ssid)) return true;
     }
-    WiFi.scanDelete();              // libera RAM
-    return encontrada;
+    return false;
+}
+
+// Agrega una red (o cambia su contraseña) y la persiste. Una red ya guardada
+// se actualiza en su lugar: conserva latencia y último éxito y sólo olvida los
+// fallos. Si el SSID o la clave no son válidos la tabla queda como estaba.
+bool WifiManager::agregarRed(const char* nuevoSsid, const char* nuevoPassword) {
+    if (desdeOtraTarea()) return pedirGuardarRed(nuevoSsid, nuevoPassword);
+    int8_t previa = nuevoSsid ? redes.indice(nuevoSsid) : -1;
+    bool claveNueva = previa < 0 || !nuevoPassword || strcmp(redes.red(previa).password, nuevoPassword) != 0;
+    if (!redes.agregar(nuevoSsid, nuevoPassword)) return false;
+    plan.reanudar();                                  // la clave nueva merece otra oportunidad
+    if (claveNueva && strcmp(cacheConexion.ssid, nuevoSsid) == 0) {
+        cacheConexion.valida = false;                 // la caché era con la clave anterior
+    }
+    return saveCredentials();
+}
+
+bool WifiManager::agregarRed(const String& nuevoSsid, const String& nuevoPassword) {
+    return agregarRed(nuevoSsid.c_str(), nuevoPassword.c_str());
+}
+
+bool WifiManager::olvidarRed(const char* viejoSsid) {
+    if (desdeOtraTarea()) return pedirOlvidarRed(viejoSsid);
+    if (!redes.quitar(viejoSsid)) return false;
+    return saveCredentials();
+}
+
+bool WifiManager::olvidarRed(const String& viejoSsid) {
+    return olvidarRed(viejoSsid.c_str());
+}
+
+void WifiManager::configurarReconexion(const ConfigReconexion& config) {
+    plan.configurar(config);
+}
+
+const PlanReconexion& WifiManager::planReconexion() const {
+    return plan;
+}
+
+void WifiManager::setPerfilEnergia(PerfilEnergia nuevo) {
+    perfil = nuevo;
+    if (isConnected()) aplicarPerfilEnergia();
+}
+
+PerfilEnergia WifiManager::perfilEnergia() const {
+    return perfil;
+}
+
+void WifiManager::habilitarRoaming(bool habilitado) {
+    roamingHabilitado = habilitado;
+}
+
+void WifiManager::configurarRoaming(const ConfigRoaming& config) {
+    roamer.configurar(config);
+}
+
+const MonitorRoaming& WifiManager::roaming() const {
+    return roamer;
+}
+
+void WifiManager::configurarBoton(const ConfigBoton& config) {
+    boton.configurar(config);
+}
+
+void WifiManager::setPatronLed(EstadoWiFi e, const PatronLed& patron) {
+    patronesLed[static_cast<uint8_t>(e)] = patron;
+}
+
+const TablaRedes& WifiManager::redesGuardadas() const {
+    return redes;
+}
+
+WifiScanner& WifiManager::scanner() {
+    return escaner;
+}
+
+DnsCautivo& WifiManager::dnsCautivo() {
+    return dns;
 }
 
 /* ==============================================================
    Fuerza reconexión STA manteniendo (por ahora) el AP
    ============================================================== */
 void WifiManager::forzarReconexion() {
+    if (desdeOtraTarea()) {
+        encolarComando(TipoComandoWiFi::RECONECTAR);
+        return;
+    }
     Serial.println("🔄  Forzando reconexión STA…");
-    WiFi.mode(WIFI_AP_STA);                     // mantiene portal activo
-    WiFi.begin(ssid.c_str(), password.c_str());
-    ultimoIntentoWiFi = millis();
+    plan.reanudar();
+    iniciarAsociacion(RECONNECT_TIMEOUT_MS, true);  // WIFI_AP_STA: mantiene portal activo
 }
 
 
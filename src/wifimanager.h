@@ -4,6 +4,120 @@
 #include <WiFi.h>
 #include <WebServer.h>
 #include <LittleFS.h>
+#include "wifimanager_hal.h"
+#include "wifiscanner.h"
+#include "tablaredes.h"
+#include "registrowifi.h"
+#include "wifimetrics.h"
+#include "dnscautivo.h"
+#include "portalasync.h"
+#include "monitorinternet.h"
+#include "relojntp.h"
+#include "planreconexion.h"
+#include "seguidorenlace.h"
+#include "roaming.h"
+#include "cadenafija.h"
+#include "arenafija.h"
+#include "cacheportal.h"
+#include "boton.h"
+#include "patronled.h"
+#include "almacenconfig.h"
+#include "parametrosportal.h"
+
+#ifndef WM_PORTAL_EMBEBIDO
+#define WM_PORTAL_EMBEBIDO 1    ///< 0 = no compilar las páginas del portal en flash
+#endif
+
+#ifndef WM_ARENA_PEDIDO
+#define WM_ARENA_PEDIDO 256     ///< bytes para armar textos durante cada pedido HTTP
+#endif
+
+#ifndef WM_CONFIG_DEMORA_MS
+#define WM_CONFIG_DEMORA_MS 2000  ///< espera tras el primer cambio de configuración antes de escribir
+#endif
+
+#ifndef WM_COLA_COMANDOS
+#define WM_COLA_COMANDOS 4      ///< pedidos de la app pendientes (potencia de 2)
+#endif
+
+/**
+ * @enum EstadoWiFi
+ * @brief Estados de la máquina de conexión. Se avanza un paso por cada update().
+ */
+enum class EstadoWiFi : uint8_t {
+    IDLE,         ///< sin intento en curso
+    ASSOCIATING,  ///< WiFi.begin() emitido, esperando enlace
+    GOT_IP,       ///< enlace e IP obtenidos
+    ONLINE,       ///< conectado y operativo (NTP sigue en segundo plano)
+    BACKOFF,      ///< esperando para reintentar
+    PORTAL        ///< portal AP de configuración activo
+};
+
+/**
+ * @struct TiemposConexion
+ * @brief Duración de cada fase del último intento de conexión (ms).
+ */
+struct TiemposConexion {
+    bool     rapida    = false;  ///< se intentó con BSSID/canal guardados
+    bool     fallback  = false;  ///< el intento rápido falló y se hizo el completo
+    uint32_t asociacionMs = 0;   ///< WiFi.begin() → asociado al AP, antes de DHCP (0 = sin dato)
+    uint32_t enlaceMs  = 0;      ///< WiFi.begin() → enlace con IP
+    uint32_t ntpMs     = 0;      ///< IP → primera hora NTP; llega después de ONLINE (0 = todavía no)
+    uint32_t totalMs   = 0;      ///< WiFi.begin() → ONLINE
+};
+
+/** Pedido de la app al manager (ver WifiManager::pedirConexion() y afines). */
+enum class TipoComandoWiFi : uint8_t {
+    CONECTAR,       ///< conectarAsync()
+    ESCANEAR,       ///< lanza un escaneo; el resultado sale como evento ESCANEO
+    GUARDAR_RED,    ///< agregarRed(); el resultado sale como evento RED_GUARDADA
+    OLVIDAR_RED,    ///< olvidarRed()
+    RECONECTAR,     ///< forzarReconexion()
+    REINTENTAR      ///< reintentarConexionSiNecesario()
+};
+
+struct ComandoWiFi {
+    TipoComandoWiFi tipo;
+    char            ssid[33];
+    char            password[65];
+};
+
+/** Aviso del manager a la app (ver WifiManager::siguienteEvento()). */
+enum class TipoEventoWiFi : uint8_t {
+    ESTADO,         ///< cambió la máquina de conexión
+    ENLACE,         ///< transición del driver (la misma que recibe onEnlace())
+    ESCANEO,        ///< hay resultados nuevos en scanner()
+    RED_GUARDADA,   ///< terminó un GUARDAR_RED
+    ROAMING         ///< terminó un cambio de BSSID (ok indica si se logró)
+};
+
+struct EventoWiFi {
+    TipoEventoWiFi tipo;
+    EstadoWiFi     estado;       ///< estado de la máquina al emitir el evento
+    bool           ok;           ///< RED_GUARDADA: si se pudo persistir
+    uint8_t        redes;        ///< ESCANEO: redes encontradas
+    uint32_t       generacion;   ///< ESCANEO: generación del escáner
+    EventoEnlace   enlace;       ///< ENLACE
+};
+
+/**
+ * @enum ServidorPortal
+ * @brief Backend HTTP del portal, elegido al construir WifiManager.
+ */
+enum class ServidorPortal : uint8_t {
+    SINCRONO,     ///< WebServer de Arduino: un cliente por vez desde update()
+    ASINCRONO     ///< ESPAsyncWebServer (compilar con WM_ASYNC_SERVER=1)
+};
+
+/**
+ * @enum PerfilEnergia
+ * @brief Compromiso entre consumo de la radio y latencia para recibir.
+ */
+enum class PerfilEnergia : uint8_t {
+    LOW_LATENCY,  ///< radio siempre despierta, TX máxima (como hasta ahora)
+    BALANCED,     ///< modem-sleep mínimo: despierta en cada DTIM
+    LOW_POWER     ///< modem-sleep máximo: despierta cada listen interval, TX reducida
+};
 
 /**
  * @class WifiManager
@@ -14,56 +128,333 @@ public:
     /** Constructor
      *  @param ledPin    Pin LED de estado
      *  @param buttonPin Pin botón borrado de credenciales
+     *  @param servidor  Backend HTTP del portal
      */
-    WifiManager(uint8_t ledPin = 2, uint8_t buttonPin = 0);
+    WifiManager(uint8_t ledPin = 2, uint8_t buttonPin = 0,
+                ServidorPortal servidor = ServidorPortal::SINCRONO);
+    ~WifiManager();
 
     // -------- ciclo de vida ----------
     void begin();
-    void run();
-    void update();                        // atiende servidor HTTP
+    void run();                           // envoltorio bloqueante (compatibilidad)
+    void update();                        // avanza la máquina de estados y atiende HTTP
 
     // -------- utilidades -------------
     void setHtmlPathPrefix(const String& prefix);
-    bool isConnected();
-    int  getSignalStrength();
-    uint64_t getTimestamp();
+    void usarPortalEmbebido(bool habilitado);  ///< false = priorizar archivos de LittleFS
+    /** max-age de una página ("index.html"); 0 = no-cache: revalida con ETag y responde 304. */
+    void setCacheControl(const char* pagina, uint32_t maxAgeSegundos);
+    bool isConnected() const;             ///< O(1): lee la instantánea del enlace
+    int  getSignalStrength();             ///< en modo tarea, última muestra (1 s)
+    uint64_t getTimestamp();              ///< ms desde epoch, nunca retrocede; 0 sin hora
     bool connectToWiFi();
     void reintentarConexionSiNecesario();
-    bool hayInternet();
+    bool hayInternet();                   ///< último resultado del monitor, no bloquea
     bool tieneCredenciales() const;
     void setAutoReconnect(bool habilitado);
 
+    /* ===== Conexión no bloqueante ===== */
+    bool conectarAsync();         ///< inicia la asociación y vuelve de inmediato
+    EstadoWiFi getEstado() const; ///< estado actual de la máquina
+    static const char* nombreEstado(EstadoWiFi estado);
+
+    /* ===== Tarea propia ===== */
+    /** Mueve update() a una tarea fijada a @p nucleo. Desde entonces la app no
+     *  llama update(): pide cosas con pedir*() y lee siguienteEvento(). Los
+     *  ajustes (set*, configurar*, on*) se hacen antes de iniciarla; los
+     *  callbacks pasan a correr en esa tarea. Llamadas desde otra tarea,
+     *  connectToWiFi(), reintentarConexionSiNecesario(), forzarReconexion(),
+     *  agregarRed() y olvidarRed() se encolan como comandos (agregarRed() y
+     *  olvidarRed() devuelven si entró el pedido) y scanRedDetectada()
+     *  devuelve false: se usa pedirEscaneo() y el evento ESCANEO. */
+    bool iniciarTarea(BaseType_t nucleo = 0, UBaseType_t prioridad = 2, uint32_t pilaBytes = 6144);
+    bool enTarea() const;
+
+    // Un solo productor: llamar siempre desde la misma tarea. Funcionan también
+    // sin tarea propia; se atienden en el próximo update().
+    bool pedirConexion();
+    bool pedirEscaneo();
+    bool pedirGuardarRed(const char* ssid, const char* password);
+    bool pedirOlvidarRed(const char* ssid);
+    bool pedirReconexion();
+    /** Un solo consumidor. Sólo se emiten eventos en modo tarea. */
+    bool siguienteEvento(EventoWiFi& evento);
+
+    /* ===== Eventos de enlace ===== */
+    /** Callback por cada transición del driver (asociación, IP, clientes del AP).
+     *  Se llama desde update(), nunca desde la tarea de eventos de WiFi. */
+    typedef void (*OyenteEnlace)(const EventoEnlace& evento, void* contexto);
+    void onEnlace(OyenteEnlace oyente, void* contexto = nullptr);
+    EstadoEnlace estadoEnlace() const;    ///< sin cerrojos, desde cualquier tarea
+
     /* ===== NUEVO: recuperación automática tras caída de Wi‑Fi ===== */
     bool scanRedDetectada();      ///< ¿el SSID guardado volvió a aparecer?
     void forzarReconexion();      ///< llama WiFi.begin() manteniendo el AP
 
+    /* ===== Varias redes conocidas ===== */
+    bool agregarRed(const char* ssid, const char* password);      ///< alta o cambio de clave
+    bool agregarRed(const String& ssid, const String& password);
+    bool olvidarRed(const char* ssid);
+    bool olvidarRed(const String& ssid);
+    const TablaRedes& redesGuardadas() const;
+
+    /* ===== Reintentos ===== */
+    /** Backoff exponencial con jitter; la espera depende del motivo del fallo. */
+    void configurarReconexion(const ConfigReconexion& config);
+    const PlanReconexion& planReconexion() const;   ///< contadores, motivo y si quedó detenido
+
+    /* ===== Energía ===== */
+    /** Modo de sueño y potencia se aplican enseguida si hay enlace; el listen
+     *  interval viaja en la asociación, así que rige desde la próxima. */
+    void setPerfilEnergia(PerfilEnergia perfil);
+    PerfilEnergia perfilEnergia() const;
+
+    /* ===== Roaming ===== */
+    /** Con varios AP del mismo SSID, pasa al que se escucha mejor cuando la
+     *  señal cae. Apagado por defecto. */
+    void habilitarRoaming(bool habilitado);
+    void configurarRoaming(const ConfigRoaming& config);
+    const MonitorRoaming& roaming() const;   ///< RSSI suavizado, escaneos y cambios
+
+    /* ===== Botón y LED ===== */
+    /** Antirrebote y tiempo de pulsación larga que borra las credenciales.
+     *  El botón se atiende en update(), en cualquier estado. */
+    void configurarBoton(const ConfigBoton& config);
+    /** Reemplaza el parpadeo con que el LED muestra un estado. */
+    void setPatronLed(EstadoWiFi estado, const PatronLed& patron);
+
+    /* ===== Reconexión rápida ===== */
+    /** Guarda BSSID y canal (y opcionalmente la IP de DHCP) junto a las
+     *  credenciales para asociar sin barrer todos los canales en el próximo arranque. */
+    void setFastReconnect(bool habilitado, bool reutilizarIp = false);
+    const TiemposConexion& getTiemposConexion() const;
+
+    /* ===== Escaneo asíncrono compartido ===== */
+    WifiScanner& scanner();       ///< caché de la última búsqueda de redes
+    DnsCautivo&  dnsCautivo();    ///< DNS del portal (p. ej. para excluir nombres)
+
+    /* ===== Configuración de la aplicación ===== */
+    /** Pares clave-valor por espacio; cada espacio es un JSON plano en
+     *  /<espacio>.json. "setup" e "iporton" vienen registrados. Se cargan en
+     *  begin() y se leen de RAM; los cambios se juntan y update() los escribe
+     *  WM_CONFIG_DEMORA_MS después del primero (temporal + rename). Un
+     *  archivo que no entra entero deja su espacio de sólo lectura: set y
+     *  borrar devuelven false hasta eraseAll(). */
+    bool agregarEspacioConfig(const char* espacio);
+    bool setConfig(const char* espacio, const char* clave, const char* valor);
+    bool setConfig(const char* espacio, const char* clave, int valor);
+    bool setConfig(const char* espacio, const char* clave, long valor);
+    bool setConfig(const char* espacio, const char* clave, double valor);
+    bool setConfig(const char* espacio, const char* clave, bool valor);
+    bool borrarConfig(const char* espacio, const char* clave);
+    int32_t getConfigInt(const char* espacio, const char* clave, int32_t porDefecto = 0);
+    float   getConfigFloat(const char* espacio, const char* clave, float porDefecto = 0);
+    bool    getConfigBool(const char* espacio, const char* clave, bool porDefecto = false);
+    /** Copia el valor como texto. false si no existe o no entra en @p destino. */
+    bool    getConfigString(const char* espacio, const char* clave, char* destino, size_t capacidad);
+    bool    guardarConfig();      ///< escribe ya lo pendiente (p. ej. antes de dormir)
+    /** Campos propios del formulario del portal (registrar antes de begin()).
+     *  La página los pide a /params; al guardar, cada valor queda en el
+     *  espacio "setup" con su id como clave. */
+    ParametrosPortal& parametrosPortal();
+    void    eraseAll();           ///< credenciales y toda la configuración, en RAM y en flash
+
+    /* ===== Verificación de Internet en segundo plano ===== */
+    MonitorInternet& monitorInternet();   ///< sonda, intervalos y estado con su antigüedad
+
+    /* ===== Hora ===== */
+    bool     horaSincronizada() const;
+    uint32_t edadSincronizacionMs() const;  ///< UINT32_MAX si NTP nunca respondió
+    uint32_t errorEstimadoMs() const;       ///< cota del error de getTimestamp()
+
+    /* ===== Métricas ===== */
+    const WifiMetrics& metricas() const;   ///< histogramas y contadores acumulados
+    /** Publica /metrics (formato Prometheus). Con WiFi conectado levanta el
+     *  servidor HTTP sólo con esa ruta; en modo portal se suma a las demás. */
+    void habilitarMetricas(bool habilitado);
+
 private:
     // -------- portal AP -------------
     void setupAP();
     void handleRoot();
     void handleSave();
     void handleScan();
+    void handleParams();
     void handleNotFound();
-    void mostrarPaginaError(const String& mensajeFallback);
+    void handleMetrics();
+    void atenderRuta(RutaHttp ruta, void (WifiManager::*manejador)());
+    void iniciarServidor(bool portal);
+    void atenderPedidosPortal();
+    void programarReinicio();
+    static bool recibirCredenciales(void* contexto, const char* ssid, const char* password);
+    static bool recibirParametro(void* contexto, const char* nombre, const char* valor);
+    static size_t parametroJson(void* contexto, uint8_t i, bool primero, char* destino, size_t capacidad);
+    void descartarParametros();
+    void aplicarParametros();
+    void mostrarPaginaError(const char* mensajeFallback);
+    void atenderIndicadores(uint32_t ahora);
+    bool servirArchivo(const char* nombre, int codigo);
+    bool aceptaGzip();
+    bool servirEmbebido(const char* nombre, int codigo);
+    bool responderCache(const char* nombre, const char* etag, size_t longitud);
+    void indexarPortal();
 
     // -------- credenciales ----------
     void loadCredentials();
-    void saveCredentials(String ssid, String password);
+    bool saveCredentials();
     void eraseCredentials();
+    template <typename T> bool ponerConfig(const char* espacio, const char* clave, T valor);
+    void cargarConfig(uint8_t espacio);
+    bool escribirConfig(uint8_t espacio);
+    void atenderConfig(uint32_t ahora);
+    bool migrarCredencialesJson();
+    void loadCacheConexionJson();
+    void saveCacheConexion();
 
     // -------- NTP -------------------
     void sincronizarHoraNTP();
+    void atenderSincronizacionNtp();
+
+    // -------- máquina de estados ----
+    void alEventoWiFi(arduino_event_id_t evento, arduino_event_info_t info);
+    static void bucleTarea(void* arg);
+    bool desdeOtraTarea() const;
+    bool encolarComando(TipoComandoWiFi tipo, const char* ssid = nullptr, const char* password = nullptr);
+    void atenderComandos();
+    void emitir(TipoEventoWiFi tipo, const EventoEnlace* enlace = nullptr, bool ok = false);
+    void despacharEventosEnlace();
+    void avanzarConexion();
+    void iniciarAsociacion(unsigned long timeoutMs, bool reconexion = false);
+    void asociarCandidato();
+    bool siguienteCandidato();
+    void caerAConexionCompleta();
+    void registrarExitoRed();
+    void cambiarEstado(EstadoWiFi nuevo);
+    void entrarEnBackoff(MotivoFallo motivo);
+    void atenderRoaming(unsigned long ahora);
+    void cambiarBssid(const RedEscaneada& destino);
+    void terminarRoaming(bool ok, unsigned long ahora);
+    void iniciarBegin(int32_t canal = 0, const uint8_t* bssid = nullptr);
+    void aplicarPerfilEnergia();
+    bool conexionEnCurso() const;
 
     // -------- datos -----------------
-    String ssid, password;
-    String htmlPathPrefix = "/";
+    CadenaSsid  ssid;                   ///< red que se está intentando / usando
+    CadenaClave password;
+    TablaRedes redes;
+    uint8_t    ordenCandidatos[WM_MAX_REDES] = {0};
+    uint8_t    cantCandidatos  = 0;
+    uint8_t    candidatoActual = 0;
+    CadenaFija<63> htmlPathPrefix = "/";
+    String         urlPortal;          ///< Location de los redireccionamientos, armada en setupAP()
+    bool   portalEmbebido = WM_PORTAL_EMBEBIDO;
+    bool   fsMontado      = false;
+    CachePortal cachePortal;            ///< ETags de LittleFS (al montar) y max-age por página
 
     unsigned long ultimoIntentoWiFi = 0;
     unsigned long ultimoScan       = 0;                 ///< NUEVO
     static constexpr unsigned long SCAN_INTERVAL_MS = 15000; ///< NUEVO
+    uint32_t      scanGenVista     = 0;   ///< última generación leída por scanRedDetectada()
+    WifiScanner   escaner;
+    DnsCautivo    dns;
+    MonitorInternet monitor;
+    uint32_t      alcanceVisto     = 0;   ///< última secuencia volcada a las métricas
+
+    static constexpr unsigned long CONNECT_TIMEOUT_MS    = 30000; ///< primer intento
+    static constexpr unsigned long RECONNECT_TIMEOUT_MS  = 5000;  ///< reintentos
+
+    EstadoWiFi    estado             = EstadoWiFi::IDLE;
+    unsigned long estadoDesde        = 0;
+    unsigned long timeoutAsociacion  = CONNECT_TIMEOUT_MS;
+    bool          portalActivo       = false;
+    PlanReconexion plan;
+    uint32_t      esperaReconexion   = 0;   ///< ms a esperar en BACKOFF desde estadoDesde
+    uint8_t       motivosRonda       = 0;   ///< bits de MotivoFallo de los candidatos fallidos
+    MotivoFallo   motivoAsociacion   = MotivoFallo::NINGUNO;   ///< lo que informó el driver en este intento
+
+    // -------- eventos de enlace -----
+    SeguidorEnlace  enlace;
+    wifi_event_id_t idEventos          = 0;
+    OyenteEnlace    oyenteEnlace       = nullptr;
+    void*           contextoOyente     = nullptr;
+
+    PerfilEnergia   perfil             = PerfilEnergia::LOW_LATENCY;
+
+    // -------- roaming ---------------
+    MonitorRoaming  roamer;
+    bool            roamingHabilitado  = false;
+    bool            enRoaming          = false;   ///< asociando contra otro BSSID del mismo SSID
+    bool            esperandoScanRoaming = false;
+    uint32_t        genScanRoaming     = 0;
+    unsigned long   ultimaMuestraRoaming = 0;
+    uint16_t        cambiosAlAsociar   = 0;       ///< EstadoEnlace::cambios al emitir WiFi.begin()
+
+    // -------- tarea propia ----------
+    static constexpr unsigned long PERIODO_TAREA_MS = 10;   ///< vuelta de update() sin avisos
+
+    TaskHandle_t    tarea              = nullptr;
+    ColaSPSC<ComandoWiFi, WM_COLA_COMANDOS> comandos;
+    ColaSPSC<EventoWiFi, WM_COLA_EVENTOS>   eventos;
+    EstadoWiFi      estadoEmitido      = EstadoWiFi::IDLE;
+    std::atomic<int32_t> rssiMuestreado{0};
+
+    // -------- reconexión rápida -----
+    static constexpr unsigned long FAST_CONNECT_TIMEOUT_MS = 4000;
+
+    CacheConexion   cacheConexion;
+    bool            fastReconnect      = true;
+    bool            fastReutilizarIp   = false;
+    bool            intentoRapido      = false;
+    unsigned long   inicioIntento      = 0;
+    unsigned long   timeoutCompleto    = CONNECT_TIMEOUT_MS;
+    TiemposConexion tiempos;
+    bool            esReconexion       = false;
+    bool            esperandoNtp       = false;
+    unsigned long   inicioNtp          = 0;
+    uint32_t        syncVistas         = 0;   ///< sincronizaciones NTP ya atendidas
+
+    // -------- métricas --------------
+    static constexpr unsigned long HEAP_MUESTREO_MS = 1000;
+
+    WifiMetrics     metrics;
+    bool            metricasHttp       = false;
+    bool            rutasPortal        = false;
+    bool            rutaMetricas       = false;
+    bool            servidorActivo     = false;
+    uint32_t        scanGenMedida      = 0;
+    unsigned long   ultimoMuestreoHeap = 0;
+
+    // -------- servidor del portal ---
+    static constexpr unsigned long REINICIO_DIFERIDO_MS = 1000;  ///< deja salir la respuesta de /save
+
+    ServidorPortal  modoServidor;
+#if WM_ASYNC_SERVER
+    PortalAsync     portalAsync;
+#endif
+    volatile bool   scanPedido         = false;
+    WmCerrojo       cerrojoPendientes;
+    bool            credencialesPendientes = false;
+    char            ssidPendiente[33]      = {0};
+    char            passwordPendiente[65]  = {0};
+    bool            reinicioPendiente  = false;
+    unsigned long   reinicioDesde      = 0;
+
+    // -------- configuración ---------
+    AlmacenConfig   almacen;
+    WmCerrojo       cerrojoConfig;            ///< setConfig() puede llegar desde otra tarea
+    bool            esperaConfig       = false;   ///< hay cambios contando WM_CONFIG_DEMORA_MS
+    uint32_t        cambioConfigDesde  = 0;
+    ParametrosPortal parametrosExtra;         ///< lo recibido se protege con cerrojoPendientes
+    bool            parametroInvalido  = false;
+
+    // -------- botón y LED -----------
+    Boton           boton;
+    MotorLed        motorLed;
+    PatronLed       patronesLed[6];           ///< indexado por EstadoWiFi
+    bool            ledEncendido       = false;
 
     WebServer server{80};
-    bool connected = false;
+    ArenaFija<WM_ARENA_PEDIDO> arena;   ///< se vacía al terminar cada manejador
 
     uint8_t ledPin, buttonPin;
 };
@@ -0,0 +1,45 @@
+#ifndef WIFI_MANAGER_HAL_H
+#define WIFI_MANAGER_HAL_H
+
+/**
+ * @file  wifimanager_hal.h
+ * @brief Reloj, espera y cerrojo que usa la librería.
+ *
+ * En el ESP32 son millis(), micros() y delay() de Arduino, y el cerrojo es un
+ * portMUX de FreeRTOS (sección crítica corta, válida entre núcleos). Para
+ * compilar la lógica fuera del dispositivo (por ejemplo en Linux, con un reloj
+ * virtual que avanza a mano) se define WM_HAL_EXTERNO y se implementan estas funciones;
+ * WiFi, LittleFS y WebServer se reemplazan poniendo delante, en la ruta de
+ * includes, cabeceras propias con esos mismos nombres.
+ */
+
+#include <stdint.h>
+
+#ifdef WM_HAL_EXTERNO
+
+unsigned long wmMillis();
+uint64_t      wmMicros();
+void          wmDelay(unsigned long ms);
+
+struct WmCerrojo { volatile uint32_t ocupado = 0; };
+void wmBloquear(WmCerrojo& cerrojo);
+void wmDesbloquear(WmCerrojo& cerrojo);
+
+#else
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+inline unsigned long wmMillis()             { return millis(); }
+inline uint64_t      wmMicros()             { return static_cast<uint64_t>(esp_timer_get_time()); }
+inline void          wmDelay(unsigned long ms) { delay(ms); }
+
+/** Protege datos compartidos con la tarea del servidor asíncrono. No anidar ni llamar al driver adentro. */
+struct WmCerrojo { portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED; };
+inline void wmBloquear(WmCerrojo& cerrojo)    { portENTER_CRITICAL(&cerrojo.mux); }
+inline void wmDesbloquear(WmCerrojo& cerrojo) { portEXIT_CRITICAL(&cerrojo.mux); }
+
+#endif
+
+#endif
@@ -0,0 +1,227 @@
+// Generado por tools/embed_portal.py a partir de data/wifimanager/.
+// No editar a mano: modificar los HTML y volver a ejecutar el script.
+#ifndef WIFI_MANAGER_PORTAL_H
+#define WIFI_MANAGER_PORTAL_H
+
+#include <Arduino.h>
+
+/**
+ * @struct RecursoPortal
+ * @brief Página del portal embebida en flash, ya minificada y comprimida con gzip.
+ */
+struct RecursoPortal {
+    const char*    nombre;    ///< nombre relativo, p. ej. "index.html"
+    const char*    tipo;      ///< Content-Type
+    const uint8_t* datos;     ///< cuerpo gzip en flash
+    size_t         longitud;  ///< bytes de datos
+    uint32_t       hash;      ///< FNV-1a 32 de los bytes gzip
+    const char*    etag;      ///< hash entre comillas, listo para la cabecera ETag
+};
+
+namespace wm_portal {
+
+// index.html: 10525 bytes -> 5690 minificado -> 2136 gzip
+constexpr uint8_t index_html_gz[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xbd, 0x58, 0xdb, 0x72, 0xdc, 0xb6,
+    0x19, 0xbe, 0xd7, 0x53, 0x20, 0xd4, 0x05, 0x97, 0x93, 0x25, 0xf7, 0xa0, 0xc8, 0x76, 0xf6, 0x94,
+    0x71, 0x2c, 0xb9, 0xf5, 0x8c, 0x1c, 0x6b, 0x22, 0xb5, 0x69, 0xa7, 0x93, 0xe9, 0x60, 0x49, 0x90,
+    0x44, 0x0d, 0x02, 0x0c, 0x40, 0xee, 0x4a, 0xdd, 0xe8, 0x25, 0xda, 0xde, 0x77, 0xfc, 0x08, 0x9d,
+    0x3e, 0x82, 0x5e, 0xa8, 0x8f, 0xd0, 0x1f, 0x00, 0x8f, 0xbb, 0x2b, 0xc5, 0xcd, 0x45, 0x67, 0xc7,
+    0x5a, 0x2e, 0xf0, 0x9f, 0xf1, 0xfd, 0x1f, 0x7e, 0x7a, 0xf1, 0xc5, 0xc5, 0x87, 0x37, 0xb7, 0x7f,
+    0xbc, 0xbe, 0x44, 0x69, 0x91, 0xb1, 0xd5, 0x42, 0xff, 0x45, 0x0c, 0xf3, 0x64, 0xe9, 0x10, 0xe5,
+    0xc0, 0x6f, 0x82, 0xa3, 0xd5, 0x22, 0x23, 0x05, 0x46, 0x61, 0x8a, 0xa5, 0x22, 0xc5, 0xd2, 0xf9,
+    0xdd, 0xed, 0x5b, 0xff, 0x95, 0x53, 0xad, 0x72, 0x9c, 0x91, 0xa5, 0xb3, 0xa1, 0x64, 0x9b, 0x0b,
+    0x59, 0x38, 0x28, 0x14, 0xbc, 0x20, 0x1c, 0xa4, 0xb6, 0x34, 0x2a, 0xd2, 0x65, 0x44, 0x36, 0x34,
+    0x24, 0xbe, 0xf9, 0x31, 0x44, 0x94, 0xd3, 0x82, 0x62, 0xe6, 0xab, 0x10, 0x33, 0xb2, 0x9c, 0x04,
+    0xe3, 0x21, 0x2a, 0x15, 0x91, 0xe6, 0x37, 0x5e, 0xc3, 0x12, 0x17, 0x60, 0xb7, 0xa0, 0x05, 0x23,
+    0xab, 0x1f, 0x68, 0x4c, 0x11, 0xf8, 0x2b, 0xf3, 0xc5, 0xc8, 0xae, 0x2c, 0x54, 0x71, 0x0f, 0x5f,
+    0x6b, 0x11, 0xdd, 0xef, 0xd6, 0x38, 0xfc, 0x98, 0x48, 0x51, 0xf2, 0xc8, 0x0f, 0x05, 0x13, 0x72,
+    0x76, 0x1a, 0x61, 0xfd, 0x99, 0xc7, 0xe0, 0xdf, 0x8f, 0x71, 0x46, 0xd9, 0xfd, 0xec, 0xf7, 0x44,
+    0x46, 0x98, 0xe3, 0xa1, 0xc2, 0x5c, 0xf9, 0xe0, 0x87, 0xc6, 0x0f, 0x41, 0x88, 0xd7, 0x24, 0x24,
+    0x12, 0xef, 0x72, 0x1c, 0x45, 0x94, 0x27, 0xb3, 0xf3, 0xfc, 0x0e, 0x8d, 0xf3, 0xbb, 0xf9, 0x5a,
+    0xc8, 0x08, 0x42, 0x91, 0x38, 0xa2, 0xa5, 0xd2, 0xab, 0xf3, 0x03, 0x1f, 0x32, 0x59, 0x0f, 0xa6,
+    0x67, 0xc3, 0xb3, 0xb3, 0xe1, 0x64, 0xf2, 0xb5, 0x37, 0x2f, 0xc8, 0x5d, 0xe1, 0x63, 0x46, 0x13,
+    0x3e, 0x0b, 0x21, 0x65, 0x22, 0xe7, 0x55, 0x28, 0x71, 0x1c, 0xcf, 0x33, 0x2c, 0x13, 0xca, 0x8d,
+    0x75, 0x5c, 0x16, 0xa2, 0x75, 0x8c, 0xd2, 0xc9, 0xce, 0x04, 0xa9, 0xe8, 0x5f, 0xc9, 0x6c, 0xaa,
+    0x5d, 0x57, 0xb2, 0xf0, 0xd8, 0x15, 0x9b, 0x76, 0xc4, 0x26, 0x2f, 0xf6, 0xc5, 0x4c, 0x99, 0x49,
+    0x24, 0xe4, 0x2e, 0xa2, 0x2a, 0x67, 0xf8, 0x7e, 0x16, 0x33, 0x72, 0x37, 0xd7, 0x7f, 0xfc, 0x88,
+    0x4a, 0x12, 0x16, 0x54, 0x40, 0x5c, 0x82, 0x95, 0x19, 0x9f, 0x9b, 0x20, 0x7d, 0x5a, 0x90, 0x4c,
+    0xd5, 0xa1, 0x66, 0xf8, 0xce, 0x9e, 0xca, 0xec, 0xc5, 0x78, 0x7c, 0x2c, 0x59, 0x93, 0x45, 0x5d,
+    0x24, 0x1d, 0x26, 0x3a, 0x3f, 0xa8, 0xd2, 0xa4, 0x1b, 0xbd, 0xc9, 0x13, 0x04, 0xee, 0x7c, 0x95,
+    0xe2, 0x48, 0x6c, 0x61, 0xe5, 0x2b, 0xd0, 0x7a, 0x05, 0xff, 0xa0, 0x70, 0x78, 0x30, 0x1e, 0x9a,
+    0x4f, 0xf0, 0xc2, 0x7b, 0x08, 0x62, 0x21, 0xb3, 0x92, 0x61, 0x49, 0xc5, 0xe7, 0x84, 0x9f, 0xe0,
+    0xdc, 0xb8, 0x7a, 0x08, 0x20, 0x76, 0x70, 0x8d, 0xfb, 0x4a, 0xf5, 0xf6, 0x91, 0x34, 0x1b, 0x0d,
+    0xc0, 0xf4, 0x9a, 0xb0, 0x9d, 0x8d, 0xd5, 0x5f, 0x8b, 0xa2, 0x10, 0x99, 0x39, 0xe4, 0x83, 0x43,
+    0x6c, 0x55, 0x28, 0xcf, 0xcb, 0xe2, 0x4f, 0xc5, 0x7d, 0x0e, 0x00, 0xd7, 0x62, 0xce, 0x8f, 0xc3,
+    0xa3, 0x7b, 0xbc, 0xcc, 0xd6, 0x44, 0x76, 0x77, 0x15, 0x61, 0x90, 0xc1, 0x71, 0xe9, 0x1c, 0x2b,
+    0xb5, 0x85, 0x2a, 0x3a, 0x3f, 0xee, 0x52, 0x42, 0x93, 0xb4, 0xb0, 0x18, 0xd0, 0x99, 0xcc, 0xa6,
+    0xf3, 0x0e, 0x2a, 0xab, 0x5a, 0xcf, 0x26, 0x50, 0x40, 0x25, 0x18, 0x8d, 0xd0, 0x69, 0xf8, 0x52,
+    0x7f, 0x0e, 0xa1, 0xfa, 0x10, 0x48, 0x12, 0x11, 0x05, 0x07, 0x1a, 0xd3, 0xbd, 0x1c, 0xa7, 0x67,
+    0xfd, 0x6d, 0x54, 0xb2, 0x1d, 0xa3, 0x0a, 0x70, 0xa5, 0x9b, 0xc9, 0xd7, 0x31, 0xcd, 0xb8, 0xe0,
+    0xa4, 0xf1, 0x3c, 0xae, 0x0e, 0xd4, 0x2f, 0x04, 0x94, 0x55, 0xc7, 0x51, 0x17, 0x3b, 0x91, 0x34,
+    0x9a, 0xeb, 0x3f, 0x3e, 0x54, 0x18, 0x56, 0x0a, 0xe2, 0xdb, 0x03, 0x02, 0x20, 0xc4, 0xb2, 0x73,
+    0x4a, 0x1d, 0x6f, 0x8c, 0xee, 0xc2, 0x52, 0x2a, 0xc0, 0x53, 0x2e, 0xa8, 0x01, 0x5e, 0x2f, 0xc3,
+    0x06, 0x74, 0x00, 0xb7, 0x89, 0xfe, 0x1c, 0x69, 0xc3, 0xc3, 0x13, 0x3a, 0x2d, 0x44, 0x92, 0x40,
+    0xf0, 0x75, 0x29, 0x77, 0x16, 0xc8, 0xa6, 0x8e, 0x4d, 0x1a, 0xfd, 0x2e, 0xf1, 0x63, 0x21, 0x40,
+    0xf5, 0xff, 0xde, 0xf5, 0x95, 0xdb, 0x43, 0xa5, 0x4e, 0x6f, 0x4f, 0x21, 0xd4, 0xd3, 0xa4, 0xc4,
+    0x40, 0x56, 0xd2, 0x5f, 0x97, 0x70, 0x6c, 0xfc, 0x90, 0xdf, 0xd6, 0xac, 0x24, 0x95, 0xa7, 0x6d,
+    0x0a, 0x10, 0xaf, 0xd1, 0xd1, 0x3b, 0x3b, 0x5d, 0x7e, 0x64, 0xe1, 0x74, 0x8c, 0x3a, 0xcc, 0x91,
+    0x4e, 0x8f, 0xa7, 0xbd, 0x77, 0x4a, 0x80, 0x5b, 0xae, 0xa8, 0x69, 0xc2, 0xfd, 0x50, 0xd0, 0x38,
+    0x38, 0x53, 0x88, 0x60, 0x45, 0xf6, 0xa3, 0x9e, 0xa5, 0x62, 0x03, 0xc9, 0x1e, 0xad, 0xe0, 0x64,
+    0xf2, 0x62, 0x38, 0x79, 0xf5, 0x6a, 0x38, 0x9d, 0x4c, 0xbd, 0x79, 0x9d, 0x12, 0x08, 0x3e, 0x04,
+    0x1b, 0xc1, 0x40, 0xeb, 0xc9, 0xc4, 0x4f, 0xcf, 0xcf, 0xcf, 0x7f, 0x7d, 0xe2, 0x7b, 0x69, 0xed,
+    0xd7, 0xc1, 0x9c, 0x4b, 0x44, 0x42, 0x21, 0xb1, 0xc9, 0xd5, 0x18, 0xad, 0xf1, 0x4e, 0x39, 0xa3,
+    0x9c, 0xf8, 0x6b, 0x26, 0xc2, 0x8f, 0x9f, 0x59, 0x90, 0x7e, 0x32, 0x4f, 0xd5, 0xe3, 0xf4, 0xe5,
+    0xcb, 0x97, 0x0f, 0x01, 0x24, 0x41, 0xc2, 0x54, 0xa8, 0x0e, 0xcd, 0x7f, 0xdd, 0xd2, 0xa9, 0x0e,
+    0xef, 0x61, 0x31, 0xb2, 0x57, 0xde, 0x62, 0x64, 0xef, 0x61, 0x7d, 0xf5, 0xad, 0x16, 0x11, 0xdd,
+    0xa0, 0x90, 0x01, 0xf6, 0x97, 0x4e, 0x07, 0xe0, 0xf5, 0xc5, 0x51, 0x5d, 0xda, 0x44, 0x36, 0x32,
+    0x9d, 0x8d, 0x09, 0x5c, 0xab, 0x6f, 0x29, 0x7a, 0x0f, 0xb7, 0x62, 0x42, 0x24, 0x98, 0x9d, 0xc0,
+    0xe2, 0x74, 0xf5, 0xfa, 0x5e, 0x12, 0xc5, 0x49, 0x01, 0x0b, 0xd3, 0xca, 0x19, 0x91, 0xf0, 0x00,
+    0x9e, 0x9e, 0x70, 0x07, 0xc6, 0x34, 0x87, 0x23, 0x98, 0x01, 0x52, 0x11, 0x2d, 0x9d, 0xeb, 0x0f,
+    0x37, 0xb7, 0x0e, 0xc2, 0x86, 0xb6, 0x97, 0xce, 0x48, 0xe1, 0x0d, 0x71, 0x7a, 0xaa, 0x2d, 0xe3,
+    0xf7, 0xd7, 0x5b, 0xae, 0x80, 0x75, 0x43, 0xd2, 0x08, 0x44, 0xf5, 0xf8, 0x10, 0x53, 0x5f, 0x13,
+    0x95, 0xb3, 0xfa, 0x5e, 0x8b, 0x20, 0x13, 0xf8, 0x05, 0x1c, 0x8d, 0xe0, 0x14, 0x46, 0x05, 0x35,
+    0x5b, 0x8c, 0x8c, 0xf8, 0x6a, 0x51, 0x32, 0x44, 0xa3, 0x9e, 0xc6, 0x62, 0x54, 0xb2, 0x23, 0xe1,
+    0x57, 0x74, 0x7c, 0xc4, 0x91, 0x52, 0x34, 0x76, 0x56, 0x37, 0x37, 0xef, 0x2e, 0x5a, 0xb3, 0x86,
+    0xb4, 0x51, 0x87, 0xfe, 0xab, 0x59, 0x07, 0x64, 0x23, 0xa7, 0xf5, 0x68, 0x55, 0xff, 0x17, 0x67,
+    0xcd, 0x0d, 0xb0, 0xba, 0x7e, 0x7d, 0x73, 0xf3, 0xc3, 0x87, 0xef, 0x9f, 0x70, 0xda, 0xc8, 0x55,
+    0x8e, 0xdb, 0xdf, 0x8d, 0xf3, 0xd6, 0xd4, 0x73, 0x01, 0x74, 0x8d, 0x86, 0x29, 0x09, 0x3f, 0xc2,
+    0x25, 0x6d, 0x8d, 0xa8, 0x54, 0x6c, 0xbb, 0x46, 0x3a, 0xa1, 0xee, 0x6d, 0xbd, 0x17, 0x0a, 0xcc,
+    0x49, 0x33, 0xdf, 0x49, 0x80, 0xfa, 0xe3, 0xbf, 0x70, 0x13, 0x74, 0xeb, 0x5a, 0xdb, 0xcc, 0xb1,
+    0x84, 0x70, 0x0b, 0x29, 0x94, 0x73, 0xf4, 0xf0, 0xad, 0x74, 0x37, 0x26, 0x55, 0xae, 0x33, 0x0a,
+    0xf5, 0xdd, 0x60, 0x20, 0xb9, 0xa5, 0xf3, 0x1b, 0x4b, 0x2a, 0x36, 0xc2, 0x3e, 0xc3, 0x34, 0xea,
+    0x23, 0x6d, 0xf2, 0x59, 0x84, 0x56, 0x8c, 0x6f, 0x80, 0xaa, 0x1f, 0xda, 0x58, 0xaa, 0xe5, 0x7c,
+    0x35, 0x08, 0x3d, 0x20, 0x8d, 0xe9, 0x57, 0xc8, 0x47, 0x17, 0x98, 0x53, 0xc8, 0xfc, 0x06, 0xb3,
+    0x04, 0x66, 0x17, 0x58, 0xd8, 0x4c, 0x02, 0x98, 0x4f, 0x17, 0xa3, 0xdc, 0xf8, 0xd2, 0x2a, 0xb5,
+    0xb7, 0xbc, 0xb6, 0x54, 0x37, 0xb0, 0xb3, 0x42, 0x97, 0xac, 0x1a, 0x7c, 0x29, 0x28, 0x47, 0x04,
+    0x11, 0x05, 0xa3, 0x71, 0xfe, 0xf8, 0x09, 0x3a, 0x19, 0xa3, 0x2d, 0x59, 0xeb, 0x85, 0xc7, 0x4f,
+    0x28, 0x97, 0x60, 0x28, 0xd1, 0x32, 0x30, 0x2c, 0xa3, 0x5a, 0x5f, 0x2b, 0xe8, 0xdb, 0x42, 0x06,
+    0xe8, 0x06, 0xf8, 0x01, 0xa6, 0x07, 0x94, 0x13, 0x09, 0x15, 0x21, 0x48, 0x95, 0x30, 0x20, 0x0b,
+    0x6d, 0x1b, 0x41, 0x74, 0x4a, 0xc4, 0xc5, 0x16, 0x4b, 0xa2, 0x15, 0x12, 0xb0, 0x48, 0x1f, 0xff,
+    0xcd, 0xa1, 0x2f, 0x7c, 0x68, 0x0c, 0xe8, 0x10, 0x2c, 0xa5, 0x60, 0x0c, 0x57, 0xc6, 0xf7, 0x12,
+    0xba, 0x47, 0x75, 0x8f, 0x07, 0xc8, 0x24, 0xa5, 0x42, 0x49, 0xf3, 0x62, 0x15, 0x89, 0xb0, 0xcc,
+    0x00, 0x29, 0x01, 0x10, 0xe9, 0xe5, 0x06, 0x1e, 0xae, 0xa0, 0x81, 0xa0, 0x80, 0x72, 0xe0, 0x5e,
+    0x7c, 0x78, 0xff, 0xc6, 0x0e, 0xf3, 0x57, 0x02, 0xf8, 0x20, 0x72, 0x87, 0x28, 0x2e, 0xb9, 0xe9,
+    0x70, 0x34, 0xf0, 0xd0, 0xee, 0x64, 0x03, 0x70, 0x30, 0xed, 0x6b, 0x46, 0xf5, 0x25, 0x6a, 0x6c,
+    0x25, 0xa4, 0xb8, 0x64, 0x44, 0x3f, 0x7e, 0x7b, 0xff, 0x2e, 0x1a, 0xb8, 0x4d, 0x67, 0xba, 0xde,
+    0xfc, 0xa4, 0xb1, 0x11, 0x02, 0xd1, 0x61, 0x69, 0x9a, 0xdb, 0x98, 0x8b, 0x49, 0x11, 0xa6, 0x03,
+    0x77, 0x04, 0x2f, 0x03, 0xdc, 0xf5, 0x4e, 0x82, 0x22, 0x25, 0x7c, 0x00, 0x31, 0x43, 0xc3, 0x43,
+    0x45, 0x96, 0xab, 0xca, 0x63, 0x4e, 0x78, 0x44, 0xf5, 0x1d, 0x0a, 0x1e, 0xeb, 0xdd, 0xc0, 0x32,
+    0x96, 0xd2, 0x9e, 0x07, 0xee, 0x1f, 0xfc, 0x1b, 0x30, 0xe1, 0x5f, 0x6b, 0x41, 0x9e, 0xb8, 0x1e,
+    0x5a, 0x2e, 0x97, 0xc8, 0x9d, 0xb8, 0xf3, 0x13, 0x09, 0xaf, 0x13, 0x92, 0xb7, 0x6a, 0x7f, 0x51,
+    0x82, 0x0f, 0x3c, 0xeb, 0x29, 0xc2, 0x70, 0x64, 0xc6, 0x4b, 0x93, 0x53, 0x40, 0x39, 0x54, 0xe2,
+    0xb7, 0xb7, 0xef, 0xaf, 0xc0, 0x97, 0x0b, 0xfa, 0x5a, 0x46, 0xcf, 0xae, 0x97, 0x18, 0x22, 0x05,
+    0x31, 0x2b, 0xcf, 0x48, 0x01, 0x73, 0x4e, 0xb7, 0x00, 0xa1, 0x24, 0x30, 0x1d, 0x55, 0x35, 0x18,
+    0xb8, 0x8c, 0xea, 0xc4, 0x19, 0x0d, 0xb4, 0x3e, 0xbc, 0xd2, 0x04, 0x9a, 0x42, 0x4c, 0xf8, 0x91,
+    0x79, 0x34, 0x7b, 0x9a, 0x62, 0xaa, 0x7a, 0x77, 0xb6, 0xd0, 0x97, 0x68, 0x60, 0x9e, 0x09, 0xdc,
+    0x64, 0x04, 0x7d, 0x83, 0x1c, 0xf4, 0x9f, 0x7f, 0xfe, 0xe3, 0x6f, 0x0e, 0x9a, 0xd9, 0xa7, 0xbf,
+    0x3b, 0x1e, 0x88, 0x38, 0x00, 0x58, 0x07, 0xbe, 0xb5, 0xa4, 0x04, 0x35, 0xb3, 0x14, 0x7d, 0x9b,
+    0xc1, 0xda, 0x89, 0x51, 0xc7, 0xb9, 0x42, 0x2b, 0x34, 0x31, 0xfa, 0x83, 0x5a, 0x52, 0x2f, 0x6a,
+    0xc1, 0xd7, 0xd7, 0x9e, 0xb1, 0xe7, 0x78, 0xf3, 0x4e, 0xee, 0x38, 0xd7, 0x95, 0x7e, 0x93, 0x52,
+    0x16, 0x0d, 0x18, 0x85, 0xad, 0x07, 0xf8, 0x47, 0x63, 0x34, 0x68, 0x0e, 0xc0, 0xd3, 0xaf, 0x67,
+    0xb7, 0x34, 0x23, 0xa2, 0x2c, 0x06, 0x9d, 0xd3, 0x1c, 0xa2, 0xc9, 0xf9, 0x78, 0x5c, 0x69, 0x3c,
+    0xc0, 0x49, 0x86, 0x58, 0x9f, 0x2c, 0x01, 0x7c, 0x4a, 0x5b, 0x31, 0xc0, 0x33, 0x4c, 0xb4, 0x24,
+    0x30, 0x4b, 0x03, 0xf7, 0xd2, 0xec, 0x88, 0xb5, 0xee, 0x1f, 0x30, 0x2e, 0x2c, 0xaa, 0x0c, 0xe3,
+    0xcf, 0x00, 0x75, 0x46, 0xaa, 0x36, 0x77, 0xd2, 0x83, 0xcd, 0x01, 0x9c, 0xae, 0x1b, 0xf2, 0xe9,
+    0x61, 0xca, 0x70, 0x92, 0x3a, 0x8a, 0xaa, 0x3d, 0x30, 0xd4, 0x22, 0x1a, 0xae, 0x15, 0x1e, 0x74,
+    0xd2, 0x5f, 0x98, 0xdf, 0x01, 0x23, 0x3c, 0x29, 0x52, 0x0f, 0x59, 0x20, 0xcd, 0x0d, 0x20, 0x5b,
+    0xca, 0x79, 0xae, 0x07, 0x5a, 0x56, 0xb4, 0x58, 0x50, 0x1d, 0x24, 0xe5, 0x2d, 0x8e, 0x62, 0xca,
+    0xf0, 0x33, 0x48, 0x02, 0x02, 0x32, 0x3d, 0x04, 0x52, 0x81, 0x61, 0xa1, 0xef, 0xc0, 0xa8, 0x06,
+    0x67, 0x45, 0xf6, 0x80, 0x51, 0x6d, 0x85, 0x14, 0xf4, 0xa7, 0x52, 0xbf, 0x9d, 0x3f, 0x83, 0x49,
+    0x4d, 0xdd, 0xda, 0x56, 0x2d, 0x1b, 0xe8, 0x57, 0xff, 0xb7, 0x26, 0x09, 0x1b, 0xac, 0xef, 0x02,
+    0x3a, 0xf2, 0x40, 0xc3, 0xb3, 0x91, 0xe9, 0x83, 0x34, 0x0f, 0xec, 0x7d, 0xf1, 0x25, 0x72, 0x67,
+    0x95, 0xe7, 0x10, 0x67, 0xb9, 0xa8, 0x70, 0x12, 0x68, 0x76, 0xb7, 0xcd, 0x47, 0xe0, 0x1d, 0xc9,
+    0xd5, 0x07, 0x62, 0xf6, 0x9f, 0x09, 0xcb, 0xbe, 0x39, 0xe9, 0xb8, 0xf2, 0x40, 0xe4, 0xfa, 0x60,
+    0x55, 0x00, 0xd3, 0x18, 0x85, 0xad, 0x9f, 0x5d, 0xaf, 0xa9, 0x98, 0x68, 0x2b, 0x26, 0xf2, 0x50,
+    0x1f, 0xff, 0xd3, 0x26, 0xad, 0x19, 0x6d, 0xd2, 0x8a, 0x06, 0xe6, 0x9a, 0x01, 0x85, 0xea, 0x67,
+    0x3f, 0x27, 0xd1, 0x88, 0xd9, 0x50, 0x74, 0x93, 0x23, 0x61, 0xb2, 0xc8, 0xad, 0xe6, 0xdc, 0x26,
+    0xd1, 0x6b, 0x10, 0xab, 0x52, 0x63, 0x14, 0xb8, 0x1a, 0xb0, 0xf5, 0xcb, 0xc9, 0x9a, 0x3b, 0xd0,
+    0xf5, 0x0e, 0xcb, 0xb5, 0x16, 0x82, 0xb5, 0xe5, 0xaa, 0x36, 0x90, 0x5b, 0xdf, 0xdd, 0x6e, 0x1d,
+    0x42, 0x9d, 0x89, 0x21, 0x37, 0xbb, 0x64, 0x64, 0x4c, 0xd0, 0x4d, 0xb8, 0x55, 0x3c, 0xfb, 0x4e,
+    0x60, 0x22, 0x3e, 0xe2, 0xc3, 0xbe, 0xcc, 0x36, 0xe6, 0x32, 0xca, 0x8d, 0x29, 0xf8, 0x6e, 0x96,
+    0xf0, 0x9d, 0x5d, 0xc2, 0x77, 0xfb, 0x71, 0xec, 0xbb, 0xdc, 0x37, 0xae, 0x4b, 0xed, 0x76, 0xec,
+    0x5c, 0x99, 0x76, 0x6a, 0xad, 0xd9, 0x10, 0xb5, 0xcf, 0x15, 0x1a, 0xb7, 0xb1, 0xc1, 0x42, 0x57,
+    0xb2, 0x0d, 0x45, 0x92, 0x9f, 0x4a, 0x6a, 0x78, 0x18, 0x15, 0xd2, 0xf8, 0x7d, 0x32, 0xa0, 0x66,
+    0x8b, 0xdb, 0x8e, 0xb1, 0xc0, 0xb6, 0x4b, 0x86, 0x8c, 0x0f, 0x40, 0x6f, 0x9a, 0xac, 0x7b, 0xc8,
+    0x75, 0x17, 0x78, 0x47, 0xf6, 0x8c, 0x21, 0xd8, 0x68, 0xc9, 0xa0, 0xb7, 0xad, 0xe5, 0x2b, 0x74,
+    0x68, 0xcc, 0xc2, 0x8c, 0x1f, 0xe2, 0xcf, 0x01, 0x86, 0x11, 0x6c, 0xca, 0x97, 0xd2, 0x28, 0x22,
+    0xdc, 0xad, 0x97, 0xab, 0x4c, 0xdc, 0x6d, 0xf6, 0xe7, 0x8a, 0xdf, 0xea, 0x9d, 0x3e, 0x2e, 0x8e,
+    0x87, 0x64, 0x24, 0x7f, 0x2d, 0x41, 0x83, 0xbf, 0xc7, 0x4f, 0x96, 0xce, 0x9e, 0x62, 0xe8, 0x2e,
+    0x13, 0xf7, 0xee, 0x95, 0x83, 0x41, 0x23, 0x64, 0x34, 0xfc, 0xd8, 0x9b, 0x2e, 0x88, 0x16, 0xf0,
+    0x2a, 0xea, 0x35, 0x3f, 0x82, 0x02, 0x8c, 0x12, 0xfd, 0x95, 0x58, 0xca, 0xd3, 0x08, 0xbe, 0x7a,
+    0x67, 0x00, 0xfc, 0xfc, 0xdc, 0xa1, 0xe7, 0x73, 0x60, 0x8e, 0xba, 0x24, 0x3d, 0x6b, 0xdd, 0xfb,
+    0xd8, 0x60, 0xc4, 0xb3, 0x94, 0xae, 0x67, 0xdf, 0xeb, 0x6a, 0xf4, 0x7d, 0x53, 0x35, 0xdd, 0x73,
+    0xe4, 0xde, 0x9b, 0x95, 0xdd, 0xca, 0x48, 0xfd, 0xfb, 0x9d, 0x99, 0x74, 0x7f, 0x69, 0x3c, 0xea,
+    0x6a, 0x1f, 0x73, 0x7f, 0xac, 0x6e, 0x29, 0xe6, 0x09, 0x39, 0x18, 0xcb, 0x7a, 0x7e, 0x6b, 0xec,
+    0x1c, 0x35, 0x59, 0x73, 0xc5, 0x37, 0x55, 0x67, 0xc2, 0x10, 0xe0, 0x36, 0x71, 0xd4, 0xd7, 0xf7,
+    0x1c, 0x5e, 0x42, 0xed, 0xac, 0xb8, 0x18, 0xd9, 0xf7, 0xcf, 0x91, 0xf9, 0xaf, 0xe2, 0xff, 0x02,
+    0x9a, 0x33, 0xd6, 0xb5, 0x3a, 0x16, 0x00, 0x00,
+};
+
+// success.html: 797 bytes -> 535 minificado -> 377 gzip
+constexpr uint8_t success_html_gz[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x55, 0x52, 0x5d, 0x6b, 0xdc, 0x30,
+    0x10, 0xfc, 0x2b, 0x8a, 0x21, 0x90, 0x80, 0x75, 0x3e, 0x27, 0x5c, 0x49, 0x6c, 0xd9, 0x2f, 0x6d,
+    0xf3, 0xda, 0x42, 0x3e, 0x4a, 0x1e, 0xf7, 0xa4, 0xb5, 0xbd, 0x41, 0x96, 0x8c, 0xb4, 0xbd, 0x9c,
+    0x09, 0xf9, 0xef, 0xd5, 0x9d, 0x5d, 0x68, 0x1f, 0x34, 0xda, 0x5d, 0x96, 0xd9, 0xd9, 0x91, 0xd4,
+    0xc5, 0xb7, 0x1f, 0x5f, 0x9f, 0x5e, 0x7f, 0x7e, 0x17, 0x03, 0x8f, 0xb6, 0x55, 0x27, 0x14, 0x16,
+    0x5c, 0xdf, 0x64, 0xe8, 0xb2, 0x94, 0x23, 0x98, 0x56, 0x8d, 0xc8, 0x20, 0xf4, 0x00, 0x21, 0x22,
+    0x37, 0xd9, 0xf3, 0xd3, 0x83, 0xbc, 0xcb, 0xd6, 0xaa, 0x83, 0x11, 0x9b, 0xec, 0x40, 0xf8, 0x3e,
+    0xf9, 0xc0, 0x99, 0xd0, 0xde, 0x31, 0xba, 0xd4, 0xf5, 0x4e, 0x86, 0x87, 0xc6, 0xe0, 0x81, 0x34,
+    0xca, 0x73, 0x92, 0x0b, 0x72, 0xc4, 0x04, 0x56, 0x46, 0x0d, 0x16, 0x9b, 0x72, 0xb3, 0x4d, 0x2c,
+    0x4c, 0x6c, 0xb1, 0x7d, 0x04, 0xa6, 0xd8, 0x81, 0x66, 0x1f, 0xc8, 0xab, 0x62, 0x29, 0xaa, 0xc8,
+    0x73, 0xba, 0xf6, 0xde, 0xcc, 0x1f, 0x03, 0x52, 0x3f, 0x70, 0x55, 0x6e, 0xb7, 0x97, 0xf5, 0x08,
+    0xa1, 0x27, 0x57, 0x95, 0xbb, 0xe9, 0x58, 0x1b, 0x8a, 0x93, 0x85, 0xb9, 0xea, 0x2c, 0x1e, 0xeb,
+    0xb7, 0xdf, 0x91, 0xa9, 0x9b, 0xe5, 0x2a, 0xa2, 0xd2, 0x09, 0x30, 0xd4, 0x60, 0xa9, 0x77, 0x92,
+    0x18, 0xc7, 0xb8, 0x96, 0x3e, 0x37, 0x23, 0xba, 0x08, 0x6f, 0xf8, 0xb1, 0x70, 0x49, 0xf6, 0x53,
+    0xb5, 0xdb, 0x26, 0xbe, 0xbd, 0x0f, 0x06, 0x43, 0x55, 0x4e, 0x47, 0x11, 0xbd, 0x25, 0x23, 0x42,
+    0xbf, 0xbf, 0xba, 0xb9, 0x29, 0xf3, 0xf5, 0x5c, 0xaf, 0x1d, 0xd2, 0x62, 0xc7, 0xd5, 0xee, 0xbf,
+    0xb6, 0xf2, 0x36, 0x2f, 0xef, 0xbf, 0xe4, 0xe5, 0xed, 0x75, 0x3d, 0x81, 0x31, 0xe4, 0xfa, 0xa4,
+    0x37, 0x71, 0x32, 0x1e, 0x59, 0x9e, 0x45, 0xfc, 0x55, 0xd4, 0x25, 0x81, 0xb2, 0x83, 0x91, 0xec,
+    0x5c, 0xbd, 0x60, 0x30, 0xe0, 0x20, 0x8f, 0xe0, 0xa2, 0x8c, 0x18, 0xa8, 0xfb, 0x54, 0xc5, 0xb2,
+    0xb9, 0x2a, 0x16, 0xff, 0x4f, 0x0e, 0xb4, 0xca, 0xd0, 0x41, 0x68, 0x0b, 0x31, 0x36, 0xd9, 0xaa,
+    0x3e, 0xd9, 0x37, 0xb5, 0x8f, 0x28, 0x74, 0x40, 0x08, 0xde, 0xa5, 0x87, 0x8b, 0xa7, 0xd8, 0xa0,
+    0xd3, 0xc9, 0x66, 0x8c, 0xc2, 0xa0, 0x15, 0xbf, 0xe8, 0x81, 0x52, 0x20, 0x46, 0x70, 0x18, 0x40,
+    0xc4, 0x7f, 0x9c, 0x06, 0x55, 0x4c, 0x69, 0x48, 0x22, 0x4e, 0xb8, 0x0c, 0x29, 0xce, 0xff, 0xe0,
+    0x0f, 0x24, 0xdf, 0xf5, 0xc4, 0x17, 0x02, 0x00, 0x00,
+};
+
+// error.html: 785 bytes -> 523 minificado -> 372 gzip
+constexpr uint8_t error_html_gz[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x55, 0x91, 0x51, 0x6b, 0xdc, 0x30,
+    0x0c, 0xc7, 0xbf, 0x8a, 0x17, 0x18, 0xac, 0x10, 0x37, 0x49, 0x21, 0x30, 0x12, 0x27, 0x2f, 0xed,
+    0xfa, 0xba, 0x41, 0xbb, 0x8d, 0x3d, 0xea, 0x62, 0x25, 0xd1, 0xe1, 0xd8, 0xc6, 0xd6, 0x5d, 0x2f,
+    0x94, 0x7e, 0xf7, 0xf9, 0x2e, 0xd9, 0xc3, 0x1e, 0xfc, 0xb7, 0x24, 0xc4, 0x8f, 0xbf, 0x24, 0xf5,
+    0xe9, 0xe9, 0xfb, 0xe3, 0xeb, 0x9f, 0x1f, 0xdf, 0xc4, 0xcc, 0x8b, 0xe9, 0xd5, 0x55, 0x85, 0x01,
+    0x3b, 0x75, 0x19, 0xda, 0x2c, 0xe5, 0x08, 0xba, 0x57, 0x0b, 0x32, 0x88, 0x61, 0x86, 0x10, 0x91,
+    0xbb, 0xec, 0xe7, 0xeb, 0xb3, 0xfc, 0x9a, 0xed, 0x55, 0x0b, 0x0b, 0x76, 0xd9, 0x99, 0xf0, 0xcd,
+    0xbb, 0xc0, 0x99, 0x18, 0x9c, 0x65, 0xb4, 0xa9, 0xeb, 0x8d, 0x34, 0xcf, 0x9d, 0xc6, 0x33, 0x0d,
+    0x28, 0x6f, 0x49, 0x2e, 0xc8, 0x12, 0x13, 0x18, 0x19, 0x07, 0x30, 0xd8, 0x55, 0xf7, 0x65, 0xa2,
+    0x30, 0xb1, 0xc1, 0xfe, 0x05, 0x98, 0xe2, 0x08, 0x03, 0xbb, 0x40, 0x4e, 0x15, 0x5b, 0x51, 0x45,
+    0x5e, 0xd3, 0x77, 0x70, 0x7a, 0x7d, 0x9f, 0x91, 0xa6, 0x99, 0x9b, 0xaa, 0x2c, 0x3f, 0xb7, 0x0b,
+    0x84, 0x89, 0x6c, 0x53, 0xd5, 0xfe, 0xd2, 0x6a, 0x8a, 0xde, 0xc0, 0xda, 0x8c, 0x06, 0x2f, 0xed,
+    0xf1, 0x14, 0x99, 0xc6, 0x55, 0xee, 0x26, 0x9a, 0x21, 0x09, 0x86, 0x16, 0x0c, 0x4d, 0x56, 0x12,
+    0xe3, 0x12, 0xf7, 0xd2, 0xc7, 0xfd, 0x82, 0x36, 0xc2, 0x11, 0xdf, 0x37, 0x96, 0x64, 0xe7, 0x9b,
+    0xba, 0x4c, 0xbc, 0x83, 0x0b, 0x1a, 0x43, 0x53, 0xf9, 0x8b, 0x88, 0xce, 0x90, 0x16, 0x61, 0x3a,
+    0x7c, 0x79, 0x78, 0xa8, 0xf2, 0xfd, 0xdd, 0xed, 0x1d, 0xd2, 0xe0, 0xc8, 0x4d, 0xfd, 0x7f, 0x5b,
+    0x5d, 0xe7, 0x65, 0x5e, 0xde, 0xb5, 0x1e, 0xb4, 0x26, 0x3b, 0x25, 0xb7, 0x89, 0xc8, 0x78, 0x61,
+    0x79, 0xb3, 0xf0, 0xcf, 0xcf, 0x98, 0xec, 0xc9, 0x11, 0x16, 0x32, 0x6b, 0xf3, 0x0b, 0x83, 0x06,
+    0x0b, 0x79, 0x04, 0x1b, 0x65, 0xc4, 0x40, 0xe3, 0x87, 0x2a, 0xb6, 0xb9, 0x55, 0xb1, 0x6d, 0xff,
+    0x3a, 0x7f, 0xaf, 0x34, 0x9d, 0xc5, 0x60, 0x20, 0xc6, 0x2e, 0xdb, 0xbd, 0xa7, 0xe5, 0xf9, 0xfe,
+    0x05, 0x85, 0x0f, 0x4e, 0x9f, 0x8e, 0x4e, 0x9c, 0xac, 0xc0, 0x10, 0x5c, 0x10, 0x60, 0xc4, 0x10,
+    0x10, 0x42, 0x3a, 0x64, 0xbc, 0x46, 0x1a, 0xed, 0x90, 0xd6, 0x8e, 0x51, 0xfc, 0xa6, 0x67, 0x52,
+    0x85, 0x4f, 0xe8, 0x84, 0x4b, 0xba, 0xa1, 0x8b, 0xdb, 0xed, 0xff, 0x02, 0xd3, 0x2e, 0xde, 0xe2,
+    0x0b, 0x02, 0x00, 0x00,
+};
+
+constexpr RecursoPortal RECURSOS[] = {
+    { "index.html", "text/html", index_html_gz, sizeof(index_html_gz), 0x6c127947u, "\"6c127947\"" },
+    { "success.html", "text/html", success_html_gz, sizeof(success_html_gz), 0x25e5aee6u, "\"25e5aee6\"" },
+    { "error.html", "text/html", error_html_gz, sizeof(error_html_gz), 0xfbb1b24au, "\"fbb1b24a\"" },
+};
+
+constexpr size_t CANTIDAD = sizeof(RECURSOS) / sizeof(RECURSOS[0]);
+
+} // namespace wm_portal
+
+#endif
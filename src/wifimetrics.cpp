@@ -0,0 +1,140 @@
+/**
+ * @file    wifimetrics.cpp
+ * @brief   Histogramas de latencia y exportación en formato Prometheus.
+ */
+
+#include "wifimetrics.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* const NOMBRE_RUTA[] = { "/", "/save", "/scan", "/params", "/metrics", "other" };
+
+// Cubeta i cubre (2^(i-1), 2^i] ms; la 0 incluye el 0
+void Histograma::registrar(uint32_t ms) {
+    uint8_t i = 0;
+    while (i < WM_HIST_CUBETAS && ms > (1u << i)) ++i;
+    ++cubetas[i];
+    ++cantidad;
+    sumaMs += ms;
+}
+
+void WifiMetrics::muestrearHeap(uint32_t libre, uint32_t minimo, uint32_t bloqueMax) {
+    heapLibre = libre;
+    heapBloqueMax = bloqueMax;
+    if (heapMinimo == 0 || minimo < heapMinimo) heapMinimo = minimo;
+}
+
+void WifiMetrics::registrarRuta(RutaHttp ruta, uint32_t ms) {
+    wmBloquear(cerrojo);
+    rutas[static_cast<uint8_t>(ruta)].registrar(ms);
+    wmDesbloquear(cerrojo);
+}
+
+void WifiMetrics::registrarNoModificado(uint32_t bytesAhorrados) {
+    wmBloquear(cerrojo);
+    ++httpNoModificado;
+    httpBytesAhorrados += bytesAhorrados;
+    wmDesbloquear(cerrojo);
+}
+
+namespace {
+
+struct Salida {
+    WifiMetrics::Escritor escribir;
+    void* contexto;
+    char  linea[160];
+
+    void emitir(const char* formato, ...) __attribute__((format(printf, 2, 3)));
+};
+
+void Salida::emitir(const char* formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    int n = vsnprintf(linea, sizeof(linea), formato, args);
+    va_end(args);
+    if (n > 0) escribir(linea, n < (int)sizeof(linea) ? n : sizeof(linea) - 1, contexto);
+}
+
+void cabecera(Salida& s, const char* nombre, const char* tipo, const char* ayuda) {
+    s.emitir("# HELP %s %s\n# TYPE %s %s\n", nombre, ayuda, nombre, tipo);
+}
+
+// Serie de un histograma; las cubetas de Prometheus son acumulativas
+void serie(Salida& s, const char* nombre, const char* etiquetas, const Histograma& h) {
+    const char* sep = etiquetas[0] ? "," : "";
+    uint32_t acumulado = 0;
+    for (uint8_t i = 0; i < WM_HIST_CUBETAS; ++i) {
+        acumulado += h.cubetas[i];
+        s.emitir("%s_bucket{%s%sle=\"%.3f\"} %lu\n", nombre, etiquetas, sep,
+                 (1u << i) / 1000.0, (unsigned long)acumulado);
+    }
+    s.emitir("%s_bucket{%s%sle=\"+Inf\"} %lu\n", nombre, etiquetas, sep, (unsigned long)h.cantidad);
+    const char* abre = etiquetas[0] ? "{" : "";
+    const char* cierra = etiquetas[0] ? "}" : "";
+    s.emitir("%s_sum%s%s%s %.3f\n", nombre, abre, etiquetas, cierra, h.sumaMs / 1000.0);
+    s.emitir("%s_count%s%s%s %lu\n", nombre, abre, etiquetas, cierra, (unsigned long)h.cantidad);
+}
+
+void histograma(Salida& s, const char* nombre, const char* ayuda, const Histograma& h) {
+    cabecera(s, nombre, "histogram", ayuda);
+    serie(s, nombre, "", h);
+}
+
+void contador(Salida& s, const char* nombre, const char* ayuda, uint32_t valor) {
+    cabecera(s, nombre, "counter", ayuda);
+    s.emitir("%s %lu\n", nombre, (unsigned long)valor);
+}
+
+void medidor(Salida& s, const char* nombre, const char* ayuda, uint32_t valor) {
+    cabecera(s, nombre, "gauge", ayuda);
+    s.emitir("%s %lu\n", nombre, (unsigned long)valor);
+}
+
+} // namespace
+
+void WifiMetrics::exportarPrometheus(Escritor escribir, void* contexto) const {
+    Salida s{escribir, contexto, {0}};
+
+    // Copia de lo que escribe la tarea del servidor; se emite sin el cerrojo
+    Histograma copiaRutas[static_cast<uint8_t>(RutaHttp::CANTIDAD)];
+    wmBloquear(cerrojo);
+    memcpy(copiaRutas, rutas, sizeof(copiaRutas));
+    uint32_t noModificado = httpNoModificado;
+    uint32_t bytesAhorrados = httpBytesAhorrados;
+    wmDesbloquear(cerrojo);
+
+    histograma(s, "wm_connect_duration_seconds", "Tiempo de WiFi.begin() hasta obtener IP.", conexion);
+    histograma(s, "wm_scan_duration_seconds", "Duracion de cada escaneo WiFi.", scan);
+    histograma(s, "wm_ntp_sync_seconds", "Tiempo hasta obtener hora valida por NTP.", ntp);
+    histograma(s, "wm_internet_check_seconds", "Latencia de la verificacion de Internet.", internet);
+    histograma(s, "wm_roam_duration_seconds", "Tiempo de cada cambio de BSSID hasta tener IP.", roaming);
+
+    cabecera(s, "wm_http_handler_seconds", "histogram", "Tiempo de cada manejador HTTP.");
+    char etiqueta[32];
+    for (uint8_t i = 0; i < static_cast<uint8_t>(RutaHttp::CANTIDAD); ++i) {
+        snprintf(etiqueta, sizeof(etiqueta), "route=\"%s\"", NOMBRE_RUTA[i]);
+        serie(s, "wm_http_handler_seconds", etiqueta, copiaRutas[i]);
+    }
+
+    cabecera(s, "wm_connect_total", "counter", "Intentos de conexion por resultado.");
+    s.emitir("wm_connect_total{result=\"ok\"} %lu\n", (unsigned long)conexionesOk);
+    s.emitir("wm_connect_total{result=\"fail\"} %lu\n", (unsigned long)conexionesFallidas);
+    contador(s, "wm_reconnect_attempts_total", "Intentos de reconexion lanzados.", reconexionIntentos);
+    cabecera(s, "wm_reconnect_total", "counter", "Reconexiones terminadas por resultado.");
+    s.emitir("wm_reconnect_total{result=\"ok\"} %lu\n", (unsigned long)reconexionesOk);
+    s.emitir("wm_reconnect_total{result=\"fail\"} %lu\n", (unsigned long)reconexionesFallidas);
+    cabecera(s, "wm_internet_check_total", "counter", "Verificaciones de Internet por resultado.");
+    s.emitir("wm_internet_check_total{result=\"ok\"} %lu\n", (unsigned long)internetOk);
+    s.emitir("wm_internet_check_total{result=\"fail\"} %lu\n", (unsigned long)internetFallos);
+    cabecera(s, "wm_roam_total", "counter", "Cambios de BSSID por resultado.");
+    s.emitir("wm_roam_total{result=\"ok\"} %lu\n", (unsigned long)roamingOk);
+    s.emitir("wm_roam_total{result=\"fail\"} %lu\n", (unsigned long)roamingFallidos);
+    contador(s, "wm_http_not_modified_total", "Respuestas 304 del portal.", noModificado);
+    contador(s, "wm_http_bytes_saved_total", "Bytes de paginas que no se reenviaron por el 304.", bytesAhorrados);
+    contador(s, "wm_config_writes_total", "Archivos de configuracion escritos en flash.", configEscrituras);
+
+    medidor(s, "wm_heap_free_bytes", "Heap libre en el ultimo muestreo.", heapLibre);
+    medidor(s, "wm_heap_min_free_bytes", "Minimo de heap libre desde el arranque.", heapMinimo);
+    medidor(s, "wm_heap_max_alloc_bytes", "Mayor bloque de heap asignable.", heapBloqueMax);
+}
@@ -0,0 +1,73 @@
+#ifndef WIFI_METRICS_H
+#define WIFI_METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "wifimanager_hal.h"
+
+#define WM_HIST_CUBETAS 16      ///< límites 1, 2, 4 … 32768 ms, más +Inf
+
+/**
+ * @struct Histograma
+ * @brief Histograma de latencias en memoria fija con cubetas en escala log2 (ms).
+ */
+struct Histograma {
+    uint32_t cubetas[WM_HIST_CUBETAS + 1] = {0};   ///< la última es +Inf
+    uint32_t cantidad = 0;
+    uint64_t sumaMs   = 0;
+
+    void registrar(uint32_t ms);
+};
+
+/** Rutas HTTP del portal con histograma propio. */
+enum class RutaHttp : uint8_t { RAIZ, SAVE, SCAN, PARAMS, METRICS, NOT_FOUND, CANTIDAD };
+
+/**
+ * @struct WifiMetrics
+ * @brief Contadores e histogramas de WifiManager, sin memoria dinámica.
+ *
+ * Los campos HTTP (rutas, httpNoModificado, httpBytesAhorrados) los escribe
+ * también la tarea del servidor asíncrono: se actualizan con registrarRuta() y
+ * registrarNoModificado(), bajo el cerrojo, y exportarPrometheus() los copia
+ * con el cerrojo tomado antes de escribirlos.
+ */
+struct WifiMetrics {
+    Histograma conexion;        ///< WiFi.begin() → IP
+    Histograma scan;            ///< duración de cada escaneo
+    Histograma ntp;             ///< configTime() → hora válida
+    Histograma internet;        ///< latencia de hayInternet()
+    Histograma roaming;         ///< WiFi.begin() hacia el BSSID nuevo → IP
+    Histograma rutas[static_cast<uint8_t>(RutaHttp::CANTIDAD)];
+
+    uint32_t conexionesOk         = 0;
+    uint32_t conexionesFallidas   = 0;
+    uint32_t reconexionIntentos   = 0;
+    uint32_t reconexionesOk       = 0;
+    uint32_t reconexionesFallidas = 0;
+    uint32_t internetOk           = 0;
+    uint32_t internetFallos       = 0;
+    uint32_t roamingOk            = 0;
+    uint32_t roamingFallidos      = 0;
+    uint32_t httpNoModificado     = 0;  ///< respuestas 304 del portal
+    uint32_t httpBytesAhorrados   = 0;  ///< cuerpos que no se enviaron gracias a la caché
+    uint32_t configEscrituras     = 0;  ///< archivos de configuración escritos
+
+    uint32_t heapLibre    = 0;  ///< último muestreo
+    uint32_t heapMinimo   = 0;  ///< marca de agua baja desde el arranque
+    uint32_t heapBloqueMax = 0; ///< mayor bloque asignable (fragmentación)
+
+    void muestrearHeap(uint32_t libre, uint32_t minimo, uint32_t bloqueMax);
+    void registrarRuta(RutaHttp ruta, uint32_t ms);
+    void registrarNoModificado(uint32_t bytesAhorrados);   ///< una respuesta 304
+
+    /** Destino de la exportación: recibe trozos de texto en orden. */
+    typedef void (*Escritor)(const char* texto, size_t longitud, void* contexto);
+
+    /** Escribe todo en formato de texto de Prometheus (versión 0.0.4). */
+    void exportarPrometheus(Escritor escribir, void* contexto) const;
+
+private:
+    mutable WmCerrojo cerrojo;
+};
+
+#endif
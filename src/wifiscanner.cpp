@@ -0,0 +1,278 @@
+/**
+ * @file    wifiscanner.cpp
+ * @brief   Escaneo WiFi asíncrono con caché de tamaño fijo para el portal y la recuperación.
+ */
+
+#include "wifiscanner.h"
+#include "almacenconfig.h"
+#include <climits>
+#include <stdlib.h>
+#include <string.h>
+
+static_assert(WM_SCAN_MAX < 255, "los grupos se indexan con uint8_t y 255 marca lugar libre");
+
+// Lanza un escaneo asíncrono. Si ya hay uno en curso no hace nada (coalescencia).
+bool WifiScanner::solicitar() {
+    return solicitar(nullptr);
+}
+
+bool WifiScanner::solicitar(const char* soloSsid) {
+    if (escaneando) return true;
+
+    // El escaneo necesita la interfaz STA; el AP se mantiene activo
+    wifi_mode_t modo = WiFi.getMode();
+    if (modo != WIFI_AP_STA && modo != WIFI_STA) {
+        WiFi.mode(modo == WIFI_AP ? WIFI_AP_STA : WIFI_STA);
+    }
+
+    WiFi.scanDelete();
+    if (WiFi.scanNetworks(/*async=*/true, false, false, 300, 0, soloSsid) == WIFI_SCAN_FAILED) {
+        Serial.println("⚠️ No se pudo iniciar el escaneo WiFi.");
+        return false;
+    }
+
+    if (soloSsid) Serial.printf("🔍 Buscando otros AP de %s...\n", soloSsid);
+    else          Serial.println("🔍 Escaneando redes WiFi...");
+    escaneando = true;
+    dirigido = soloSsid != nullptr;
+    inicio = wmMillis();
+    return true;
+}
+
+bool WifiScanner::solicitarSiVencido() {
+    if (vigente()) return false;
+    return solicitar();
+}
+
+// Consulta al driver sin bloquear; cuando termina copia a la caché y libera su RAM
+void WifiScanner::update() {
+    if (!escaneando) return;
+
+    int16_t r = WiFi.scanComplete();
+    if (r == WIFI_SCAN_RUNNING) {
+        if (wmMillis() - inicio >= SCAN_TIMEOUT_MS) {
+            Serial.println("⚠️ Escaneo WiFi sin respuesta. Se descarta.");
+            WiFi.scanDelete();
+            escaneando = false;
+        }
+        return;
+    }
+
+    escaneando = false;
+    if (r < 0) {
+        WiFi.scanDelete();
+        return;
+    }
+
+    copiarResultados(r);
+    WiFi.scanDelete();
+    Serial.printf("📱 %d redes encontradas\n", r);
+}
+
+// Llena y agrupa la caché que nadie lee sin tomar el cerrojo (el driver y la
+// agrupación pueden tardar); el cerrojo sólo cubre el cambio de caché vigente.
+// Sólo update() escribe, así que la inactiva no la toca ninguna otra tarea.
+void WifiScanner::copiarResultados(int16_t total) {
+    Cache& nueva = caches[activa ^ 1];
+    uint8_t n = 0;
+    for (int16_t i = 0; i < total && n < WM_SCAN_MAX; ++i) {
+        const wifi_ap_record_t* ap = static_cast<const wifi_ap_record_t*>(WiFi.getScanInfoByIndex(i));
+        if (!ap) continue;
+
+        RedEscaneada& dst = nueva.redes[n++];
+        // El SSID del driver puede ocupar los 32 bytes sin terminador
+        size_t largo = strnlen(reinterpret_cast<const char*>(ap->ssid), sizeof(dst.ssid) - 1);
+        memcpy(dst.ssid, ap->ssid, largo);
+        dst.ssid[largo] = '\0';
+        memcpy(dst.bssid, ap->bssid, sizeof(dst.bssid));
+        dst.rssi  = ap->rssi;
+        dst.canal = ap->primary;
+        dst.auth  = static_cast<uint8_t>(ap->authmode);
+    }
+    nueva.n = n;
+    nueva.sobrantes = total > n ? total - n : 0;
+    agrupar(nueva);
+
+    wmBloquear(cerrojo);
+    activa ^= 1;
+    ++gen;
+    wmDesbloquear(cerrojo);
+    ultimoResultado = wmMillis();
+    duracion = ultimoResultado - inicio;
+}
+
+static uint32_t hashSsid(const char* ssid) {
+    uint32_t h = 0x811C9DC5u;
+    while (*ssid) {
+        h ^= static_cast<uint8_t>(*ssid++);
+        h *= 0x01000193u;
+    }
+    return h;
+}
+
+// Agrupa los BSSID por SSID con una tabla de direccionamiento abierto (FNV-1a
+// y sondeo lineal, al doble de WM_SCAN_MAX para que las cadenas sean cortas) y
+// deja los grupos ordenados por señal. Cada grupo lleva sus canales como
+// máscara de bits, así contar los distintos no recorre las redes anteriores.
+// Los SSID ocultos no se listan: no hay nombre que elegir.
+static uint16_t bitCanal(uint8_t canal) {
+    return static_cast<uint16_t>(1u << (canal < 15 ? canal : 15));
+}
+
+void WifiScanner::agrupar(Cache& c) {
+    static constexpr uint16_t LUGARES = 2 * WM_SCAN_MAX;
+    static constexpr uint8_t  LIBRE = 0xFF;
+    uint8_t tabla[LUGARES];
+    memset(tabla, LIBRE, sizeof(tabla));
+    c.nGrupos = 0;
+
+    for (uint8_t i = 0; i < c.n; ++i) {
+        const RedEscaneada& r = c.redes[i];
+        if (!r.ssid[0]) continue;
+        uint16_t lugar = hashSsid(r.ssid) % LUGARES;
+        while (tabla[lugar] != LIBRE && strcmp(c.redes[c.grupos[tabla[lugar]].mejor].ssid, r.ssid) != 0) {
+            if (++lugar == LUGARES) lugar = 0;
+        }
+        if (tabla[lugar] == LIBRE) {
+            tabla[lugar] = c.nGrupos;
+            c.grupos[c.nGrupos++] = { i, 1, bitCanal(r.canal) };
+            continue;
+        }
+
+        Grupo& g = c.grupos[tabla[lugar]];
+        g.canales |= bitCanal(r.canal);
+        ++g.aps;
+        if (r.rssi > c.redes[g.mejor].rssi) g.mejor = i;
+    }
+
+    // Inserción: son pocos y suelen venir casi ordenados del driver
+    for (uint8_t i = 1; i < c.nGrupos; ++i) {
+        Grupo g = c.grupos[i];
+        uint8_t j = i;
+        for (; j > 0 && c.redes[c.grupos[j - 1].mejor].rssi < c.redes[g.mejor].rssi; --j) c.grupos[j] = c.grupos[j - 1];
+        c.grupos[j] = g;
+    }
+}
+
+bool WifiScanner::vigente() const {
+    return gen != 0 && !dirigido && wmMillis() - ultimoResultado < ttlMs;
+}
+
+unsigned long WifiScanner::edadMs() const {
+    return gen == 0 ? ULONG_MAX : wmMillis() - ultimoResultado;
+}
+
+bool WifiScanner::contiene(const char* ssid) const {
+    return mejorRssi(ssid) != RSSI_AUSENTE;
+}
+
+bool WifiScanner::copiarRed(uint8_t i, uint32_t generacion, RedEscaneada& destino) const {
+    wmBloquear(cerrojo);
+    const Cache& c = caches[activa];
+    bool ok = generacion == gen && i < c.n;
+    if (ok) destino = c.redes[i];
+    wmDesbloquear(cerrojo);
+    return ok;
+}
+
+bool WifiScanner::copiarGrupo(uint8_t i, uint32_t generacion, RedAgrupada& destino) const {
+    wmBloquear(cerrojo);
+    const Cache& c = caches[activa];
+    bool ok = generacion == gen && i < c.nGrupos;
+    if (ok) {
+        destino.mejor   = c.redes[c.grupos[i].mejor];
+        destino.aps     = c.grupos[i].aps;
+        destino.canales = static_cast<uint8_t>(__builtin_popcount(c.grupos[i].canales));
+    }
+    wmDesbloquear(cerrojo);
+    return ok;
+}
+
+// Mejor señal entre todos los BSSID que anuncian el SSID
+int8_t WifiScanner::mejorRssi(const char* ssid) const {
+    int8_t mejor = RSSI_AUSENTE;
+    if (!ssid || !*ssid) return mejor;
+    const Cache& c = caches[activa];
+    for (uint8_t i = 0; i < c.n; ++i) {
+        if (c.redes[i].rssi > mejor && strcmp(c.redes[i].ssid, ssid) == 0) mejor = c.redes[i].rssi;
+    }
+    return mejor;
+}
+
+// Valores fuera de rango se recortan; los que no son números cuentan como 0
+bool FiltroScan::leer(const char* parametro, const char* valor) {
+    if (strcmp(parametro, "min_rssi") == 0) {
+        long v = strtol(valor, nullptr, 10);
+        minRssi = static_cast<int8_t>(v < -128 ? -128 : (v > 0 ? 0 : v));
+    } else if (strcmp(parametro, "limit") == 0) {
+        long v = strtol(valor, nullptr, 10);
+        limite = static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+    } else if (strcmp(parametro, "secure") == 0) {
+        segura = (strcmp(valor, "1") == 0 || strcmp(valor, "true") == 0) ? 1 : 0;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Serializa un SSID agrupado como objeto JSON. El SSID se escapa a mano: puede
+// traer comillas, barras o bytes de control.
+static size_t redComoJson(const RedAgrupada& grupo, bool primera, char* destino, size_t capacidad) {
+    const RedEscaneada& red = grupo.mejor;
+    size_t n = snprintf(destino, capacidad, "%s{\"ssid\":\"", primera ? "" : ",");
+    n += AlmacenConfig::escaparJson(red.ssid, destino + n, capacidad - n);
+    n += snprintf(destino + n, capacidad - n,
+                  "\",\"rssi\":%d,\"secure\":%s,\"auth\":%u,\"channel\":%u,\"aps\":%u,\"channels\":%u}",
+                  red.rssi, red.auth != WIFI_AUTH_OPEN ? "true" : "false", red.auth, red.canal,
+                  grupo.aps, grupo.canales);
+    return n < capacidad ? n : capacidad - 1;
+}
+
+CursorJsonScan::CursorJsonScan(const WifiScanner& escaner, const FiltroScan& filtro)
+: escaner(escaner), filtro(filtro), gen(escaner.generacion()) {}
+
+// Prepara el siguiente fragmento ('[', una red o ']'). false al terminar.
+bool CursorJsonScan::siguientePieza() {
+    posPieza = 0;
+    switch (fase) {
+    case 0:
+        pieza[0] = '[';
+        lenPieza = 1;
+        fase = 1;
+        return true;
+    case 1: {
+        // Los grupos vienen por señal: el primero bajo min_rssi corta la lista
+        RedAgrupada grupo;
+        while ((!filtro.limite || enviadas < filtro.limite) && escaner.copiarGrupo(siguiente++, gen, grupo)) {
+            if (grupo.mejor.rssi < filtro.minRssi) break;
+            if (filtro.segura >= 0 && (grupo.mejor.auth != WIFI_AUTH_OPEN) != (filtro.segura == 1)) continue;
+            lenPieza = redComoJson(grupo, enviadas == 0, pieza, sizeof(pieza));
+            ++enviadas;
+            return true;
+        }
+        fase = 2;
+    }
+    // fall through
+    case 2:
+        pieza[0] = ']';
+        lenPieza = 1;
+        fase = 3;
+        return true;
+    default:
+        lenPieza = 0;
+        return false;
+    }
+}
+
+size_t CursorJsonScan::leer(uint8_t* destino, size_t capacidad) {
+    size_t escritos = 0;
+    while (escritos < capacidad) {
+        if (posPieza == lenPieza && !siguientePieza()) break;
+        size_t n = lenPieza - posPieza;
+        if (n > capacidad - escritos) n = capacidad - escritos;
+        memcpy(destino + escritos, pieza + posPieza, n);
+        posPieza += n;
+        escritos += n;
+    }
+    return escritos;
+}
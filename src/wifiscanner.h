@@ -0,0 +1,153 @@
+#ifndef WIFI_SCANNER_H
+#define WIFI_SCANNER_H
+
+#include <WiFi.h>
+#include "wifimanager_hal.h"
+
+#ifndef WM_SCAN_MAX
+#define WM_SCAN_MAX 64          ///< redes por caché de escaneo (hay dos: la vigente y la que se llena)
+#endif
+
+/**
+ * @struct RedEscaneada
+ * @brief Una entrada de la caché de escaneo (copiada del driver, sin String).
+ */
+struct RedEscaneada {
+    char    ssid[33];
+    uint8_t bssid[6];
+    int8_t  rssi;
+    uint8_t canal;
+    uint8_t auth;               ///< wifi_auth_mode_t
+};
+
+/**
+ * @struct RedAgrupada
+ * @brief Un SSID con todos sus BSSID resumidos; es lo que lista /scan.
+ */
+struct RedAgrupada {
+    RedEscaneada mejor;         ///< BSSID con más señal: de ahí salen rssi, canal y auth
+    uint8_t      aps;           ///< BSSID que anuncian el SSID
+    uint8_t      canales;       ///< canales distintos entre ellos
+};
+
+/**
+ * @struct FiltroScan
+ * @brief Filtros de /scan: ?min_rssi=, ?limit= y ?secure=.
+ */
+struct FiltroScan {
+    int8_t  minRssi = -128;     ///< descarta las redes más débiles
+    uint8_t limite  = 0;        ///< máximo de redes; 0 = todas
+    int8_t  segura  = -1;       ///< -1 todas, 1 sólo con clave, 0 sólo abiertas
+
+    /** Interpreta un parámetro de la consulta. false si no es de este filtro. */
+    bool leer(const char* parametro, const char* valor);
+};
+
+/**
+ * @class WifiScanner
+ * @brief Motor de escaneo asíncrono compartido por /scan y scanRedDetectada().
+ *
+ * Usa WiFi.scanNetworks(async=true) y guarda el último resultado en una caché
+ * de tamaño fijo con TTL y contador de generación. Las solicitudes que llegan
+ * con un escaneo en curso se unen a ese mismo escaneo.
+ *
+ * La caché es doble: update() copia del driver y agrupa en la que no se está
+ * leyendo, sin cerrojo, y después sólo cambia cuál es la vigente con el
+ * cerrojo tomado. Así el servidor asíncrono nunca espera al driver. Los
+ * métodos que devuelven referencias (red(), mejorRssi(), contiene()) son para
+ * la tarea de update(); desde otra tarea se usan copiarRed()/copiarGrupo().
+ */
+class WifiScanner {
+public:
+    static constexpr unsigned long TTL_MS_DEFAULT  = 10000;
+    static constexpr unsigned long SCAN_TIMEOUT_MS = 15000;
+    static constexpr int8_t        RSSI_AUSENTE    = -128;   ///< igual que TablaRedes::RSSI_AUSENTE
+
+    bool solicitar();             ///< lanza un escaneo salvo que ya haya uno en curso
+    /** Escaneo dirigido a un solo SSID (roaming). Su resultado no cuenta como
+     *  vigente para /scan ni para ordenar redes: no trae las demás. */
+    bool solicitar(const char* soloSsid);
+    bool solicitarSiVencido();    ///< idem, sólo si la caché venció
+    void update();                ///< recoge resultados; llamar desde loop
+
+    bool enCurso() const   { return escaneando; }
+    bool vigente() const;
+    bool parcial() const   { return dirigido; }   ///< la caché es de un escaneo dirigido
+    uint32_t generacion() const { return gen; }
+    uint8_t  cantidad() const   { return caches[activa].n; }
+    uint16_t descartadas() const { return caches[activa].sobrantes; }   ///< no entraron en la caché
+    const RedEscaneada& red(uint8_t i) const { return caches[activa].redes[i]; }
+    uint8_t  cantidadGrupos() const { return caches[activa].nGrupos; }   ///< SSID distintos (sin ocultos)
+    unsigned long edadMs() const;
+    unsigned long duracionMs() const { return duracion; }   ///< del último escaneo completo
+    bool contiene(const char* ssid) const;
+    int8_t mejorRssi(const char* ssid) const;   ///< RSSI_AUSENTE si no aparece
+
+    /** Copia la red @p i si la caché sigue en la generación @p gen. Segura
+     *  desde otra tarea (servidor asíncrono) mientras update() la reescribe. */
+    bool copiarRed(uint8_t i, uint32_t gen, RedEscaneada& destino) const;
+    /** Igual que copiarRed() pero por SSID; los grupos están ordenados por señal. */
+    bool copiarGrupo(uint8_t i, uint32_t gen, RedAgrupada& destino) const;
+
+    void setTtl(unsigned long ms) { ttlMs = ms; }
+
+private:
+    struct Grupo {
+        uint8_t  mejor;         ///< índice en redes[]
+        uint8_t  aps;
+        uint16_t canales;       ///< bit c = canal c (1–14; los de 5 GHz caen en el bit 15)
+    };
+    struct Cache {
+        RedEscaneada redes[WM_SCAN_MAX];
+        uint8_t      n = 0;
+        Grupo        grupos[WM_SCAN_MAX];
+        uint8_t      nGrupos = 0;
+        uint16_t     sobrantes = 0;
+    };
+
+    void copiarResultados(int16_t total);
+    static void agrupar(Cache& c);
+
+    Cache         caches[2];
+    uint8_t       activa = 0;                 ///< la que leen /scan y los demás; cambia bajo cerrojo
+    uint32_t      gen = 0;
+    bool          escaneando = false;
+    bool          dirigido = false;           ///< el escaneo en curso (o el último) fue dirigido
+    unsigned long inicio = 0;
+    unsigned long ultimoResultado = 0;
+    unsigned long duracion = 0;
+    unsigned long ttlMs = TTL_MS_DEFAULT;
+    mutable WmCerrojo cerrojo;
+};
+
+/**
+ * @class CursorJsonScan
+ * @brief Serializa las redes agrupadas por SSID como arreglo JSON a pedido:
+ *        cada leer() llena el búfer que le dan y continúa donde quedó.
+ *
+ * Sirve tanto para WebServer (bucle con sendContent) como para las respuestas
+ * chunked del servidor asíncrono, que piden bytes desde su propia tarea. Si
+ * llega un escaneo nuevo a mitad de camino se cierra el arreglo con lo enviado.
+ */
+class CursorJsonScan {
+public:
+    explicit CursorJsonScan(const WifiScanner& escaner, const FiltroScan& filtro = FiltroScan());
+
+    /** @return bytes escritos en @p destino; 0 cuando ya se envió todo */
+    size_t leer(uint8_t* destino, size_t capacidad);
+
+private:
+    bool siguientePieza();
+
+    const WifiScanner& escaner;
+    FiltroScan filtro;
+    uint32_t gen;
+    uint8_t  siguiente = 0;
+    uint8_t  enviadas = 0;
+    uint8_t  fase = 0;                ///< 0 '[', 1 redes, 2 ']', 3 fin
+    char     pieza[320];              ///< peor caso: SSID de 32 bytes todos escapados
+    size_t   lenPieza = 0;
+    size_t   posPieza = 0;
+};
+
+#endif
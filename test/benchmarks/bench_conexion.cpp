@@ -0,0 +1,98 @@
+// Arranque hasta conectado y reconexión, en tiempo virtual, con latencia de
+// asociación variable y AP que a veces no responden.
+
+#include "prueba.h"
+#include "escenario.h"
+
+namespace {
+
+struct Condicion {
+    const char* nombre;
+    uint32_t    variacionMs;
+    double      probFallo;
+};
+
+const Condicion CONDICIONES[] = {
+    { "ideal",     0,   0.0 },
+    { "variable",  300, 0.0 },
+    { "saturado",  300, 0.2 },
+};
+
+void configurar(const Condicion& c, uint32_t semilla) {
+    sim::reiniciar();
+    sim::semilla(semilla);
+    sim::radio().variacionMs = c.variacionMs;
+    sim::radio().probFallo = c.probFallo;
+    sim::agregarAp("Casa", "clave1234", 6, -55);
+    sim::agregarAp("Vecino", "xyz", 1, -70);
+}
+
+void informar(const char* prueba, const Condicion& c, std::vector<double>& ms, uint32_t fallidos) {
+    char nombre[96];
+    snprintf(nombre, sizeof(nombre), "%s.%s.p50", prueba, c.nombre);
+    prueba::medir(nombre, sim::percentil(ms, 50), "ms");
+    snprintf(nombre, sizeof(nombre), "%s.%s.p99", prueba, c.nombre);
+    prueba::medir(nombre, sim::percentil(ms, 99), "ms");
+    snprintf(nombre, sizeof(nombre), "%s.%s.fallidos", prueba, c.nombre);
+    prueba::medir(nombre, fallidos, "intentos");
+}
+
+} // namespace
+
+// Encendido en frío (sin caché de BSSID) y con la caché de la conexión anterior
+PRUEBA(arranque_hasta_conectado) {
+    int n = prueba::repeticiones(20);
+    for (const Condicion& c : CONDICIONES) {
+        std::vector<double> frio, tibio;
+        uint32_t fallidos = 0;
+        for (int i = 0; i < n; ++i) {
+            configurar(c, 1000 + i);
+            escenario::guardarRed("Casa", "clave1234");
+            for (int arranque = 0; arranque < 2; ++arranque) {
+                WifiManager wm;
+                wm.setFastReconnect(true);
+                wm.begin();
+                wm.conectarAsync();
+                int32_t ms = escenario::hastaOnline(wm, 120000);
+                if (ms < 0) ++fallidos;
+                else (arranque ? tibio : frio).push_back(ms);
+            }
+        }
+        VERIFICAR(!frio.empty() && !tibio.empty());
+        informar("arranque.frio", c, frio, fallidos);
+        informar("arranque.cache", c, tibio, 0);
+        if (c.probFallo == 0) VERIFICAR(sim::percentil(tibio, 50) < sim::percentil(frio, 50));
+    }
+}
+
+// Se apaga el AP con la conexión establecida y vuelve 5 s después: cuenta
+// desde que vuelve hasta quedar ONLINE otra vez
+PRUEBA(reconexion) {
+    int n = prueba::repeticiones(20);
+    for (const Condicion& c : CONDICIONES) {
+        std::vector<double> ms;
+        uint32_t fallidos = 0;
+        for (int i = 0; i < n; ++i) {
+            configurar(c, 2000 + i);
+            escenario::guardarRed("Casa", "clave1234");
+            WifiManager wm;
+            wm.setFastReconnect(true);
+            wm.begin();
+            wm.conectarAsync();
+            if (escenario::hastaOnline(wm, 120000) < 0) {
+                ++fallidos;
+                continue;
+            }
+            sim::encenderAp(0, false);
+            sim::hasta([]() { return false; }, [&wm]() { wm.update(); }, 5000);
+            sim::encenderAp(0, true);
+            int32_t t = escenario::hastaOnline(wm, 300000);
+            if (t < 0) ++fallidos;
+            else ms.push_back(t);
+        }
+        VERIFICAR(!ms.empty());
+        informar("reconexion", c, ms, fallidos);
+    }
+}
+
+PRUEBAS_MAIN()
@@ -0,0 +1,95 @@
+// Amplificación de escritura de setConfig(): bytes que llegan a la flash por
+// cada byte de valor que cambió. Se compara guardar en cada cambio (lo que
+// hacía la librería antes de AlmacenConfig) con la escritura diferida de
+// update(), en una ráfaga de cambios y con valores que se repiten.
+
+#include "prueba.h"
+#include "escenario.h"
+
+namespace {
+
+const int CLAVES = 8;                   ///< claves de la aplicación en "iporton"
+const int CAMBIOS = 200;                ///< setConfig() de la ráfaga
+const uint32_t ENTRE_CAMBIOS_MS = 5;    ///< la ráfaga entra entera en WM_CONFIG_DEMORA_MS
+
+struct Escritura {
+    uint32_t archivos = 0;              ///< archivos de configuración escritos
+    uint32_t bytesFlash = 0;
+    uint32_t bytesCambiados = 0;        ///< largo de los valores que cambiaron
+};
+
+void llenar(WifiManager& wm) {
+    char clave[8];
+    for (int i = 0; i < CLAVES; ++i) {
+        snprintf(clave, sizeof(clave), "k%d", i);
+        VERIFICAR(wm.setConfig("iporton", clave, "valor-inicial"));
+    }
+    VERIFICAR(wm.guardarConfig());
+}
+
+// CAMBIOS setConfig() sobre las CLAVES; con @p alInstante guarda tras cada uno.
+// Con @p repetir vuelve a poner el valor que ya tenía.
+Escritura rafaga(bool alInstante, bool repetir) {
+    sim::reiniciar();
+    WifiManager wm;
+    wm.begin();
+    llenar(wm);
+
+    Escritura r;
+    uint32_t archivosAntes = wm.metricas().configEscrituras;
+    uint32_t bytesAntes = sim::fs().bytesEscritos;
+    char clave[8];
+    char valor[16];
+    for (int i = 0; i < CAMBIOS; ++i) {
+        snprintf(clave, sizeof(clave), "k%d", i % CLAVES);
+        if (repetir) snprintf(valor, sizeof(valor), "valor-inicial");
+        else snprintf(valor, sizeof(valor), "v%d", i);
+        if (!repetir) r.bytesCambiados += strlen(valor);
+        VERIFICAR(wm.setConfig("iporton", clave, static_cast<const char*>(valor)));
+        if (alInstante) wm.guardarConfig();
+        wm.update();
+        sim::avanzar(ENTRE_CAMBIOS_MS);
+    }
+    for (uint32_t t = 0; t < WM_CONFIG_DEMORA_MS * 2; t += 10) {     // lo que quedó esperando
+        wm.update();
+        sim::avanzar(10);
+    }
+
+    r.archivos = wm.metricas().configEscrituras - archivosAntes;
+    r.bytesFlash = sim::fs().bytesEscritos - bytesAntes;
+    return r;
+}
+
+void informar(const char* nombre, const Escritura& r) {
+    char clave[64];
+    snprintf(clave, sizeof(clave), "config.%s.archivos", nombre);
+    prueba::medir(clave, r.archivos, "archivos");
+    snprintf(clave, sizeof(clave), "config.%s.bytes_flash", nombre);
+    prueba::medir(clave, r.bytesFlash, "bytes");
+    if (r.bytesCambiados) {
+        snprintf(clave, sizeof(clave), "config.%s.amplificacion", nombre);
+        prueba::medir(clave, static_cast<double>(r.bytesFlash) / r.bytesCambiados, "x");
+    }
+}
+
+} // namespace
+
+PRUEBA(amplificacion_de_escritura_de_set_config) {
+    Escritura inmediata = rafaga(true, false);
+    Escritura diferida = rafaga(false, false);
+    Escritura repetida = rafaga(false, true);
+    informar("inmediata", inmediata);
+    informar("diferida", diferida);
+    informar("repetida", repetida);
+
+    // Cada cambio reescribe el archivo entero: la ráfaga cuesta CAMBIOS archivos
+    VERIFICAR_IGUAL(inmediata.archivos, static_cast<uint32_t>(CAMBIOS));
+    // Diferida, la ráfaga entera es una sola escritura de "iporton"
+    VERIFICAR_IGUAL(diferida.archivos, 1u);
+    VERIFICAR(diferida.bytesFlash * CAMBIOS <= inmediata.bytesFlash * 2);
+    // Poner lo que ya estaba no llega a la flash
+    VERIFICAR_IGUAL(repetida.archivos, 0u);
+    VERIFICAR_IGUAL(repetida.bytesFlash, 0u);
+}
+
+PRUEBAS_MAIN()
@@ -0,0 +1,172 @@
+// DNS cautivo: consultas por segundo del armado en el lugar (responder()) y
+// del camino completo sobre un socket UDP real en loopback (update()), y
+// garantía de que ningún paquete reserva memoria dinámica.
+
+#include "prueba.h"
+#include "dnscautivo.h"
+
+#include <lwip/sockets.h>
+#include <chrono>
+#include <errno.h>
+
+namespace {
+
+const uint8_t IP_AP[4] = { 192, 168, 4, 1 };
+
+// Consulta como la mandan los teléfonos: RD, una pregunta y, opcionalmente, EDNS
+size_t armarConsulta(uint8_t* p, uint16_t id, const char* nombre, uint16_t tipo, bool edns) {
+    size_t n = 0;
+    p[n++] = id >> 8; p[n++] = id & 0xFF;
+    p[n++] = 0x01; p[n++] = 0x00;                       // RD
+    p[n++] = 0; p[n++] = 1;                             // una pregunta
+    p[n++] = 0; p[n++] = 0; p[n++] = 0; p[n++] = 0;
+    p[n++] = 0; p[n++] = edns ? 1 : 0;
+    while (*nombre) {
+        const char* punto = strchr(nombre, '.');
+        size_t l = punto ? static_cast<size_t>(punto - nombre) : strlen(nombre);
+        p[n++] = static_cast<uint8_t>(l);
+        memcpy(p + n, nombre, l);
+        n += l;
+        nombre += l + (punto ? 1 : 0);
+    }
+    p[n++] = 0;
+    p[n++] = tipo >> 8; p[n++] = tipo & 0xFF;
+    p[n++] = 0; p[n++] = 1;                             // IN
+    if (edns) {
+        const uint8_t opt[] = { 0, 0, 41, 0x10, 0, 0, 0, 0, 0, 0, 0 };
+        memcpy(p + n, opt, sizeof(opt));
+        n += sizeof(opt);
+    }
+    return n;
+}
+
+struct Consulta {
+    const char* nombre;
+    uint16_t    tipo;
+    bool        edns;
+};
+
+// Lo que pregunta un Android/iOS al conectarse al AP
+const Consulta MEZCLA[] = {
+    { "connectivitycheck.gstatic.com", 1,  true  },
+    { "connectivitycheck.gstatic.com", 28, true  },
+    { "captive.apple.com",             1,  false },
+    { "www.msftconnecttest.com",       65, true  },
+    { "ota.ejemplo.com",               1,  false },     // excluido: NXDOMAIN
+};
+const size_t CONSULTAS = sizeof(MEZCLA) / sizeof(MEZCLA[0]);
+
+uint32_t ipAp() {
+    uint32_t ip;
+    memcpy(&ip, IP_AP, sizeof(ip));
+    return ip;
+}
+
+void verificarRespuesta(const uint8_t* r, size_t largo, uint16_t id, const Consulta& c) {
+    VERIFICAR(largo >= 12);
+    VERIFICAR_IGUAL((r[0] << 8) | r[1], id);
+    VERIFICAR(r[2] & 0x80);                             // QR
+    bool nx = strcmp(c.nombre, "ota.ejemplo.com") == 0;
+    VERIFICAR_IGUAL(r[3] & 0x0F, nx ? 3 : 0);
+    bool conA = !nx && c.tipo == 1;
+    VERIFICAR_IGUAL(r[7], conA ? 1 : 0);
+    if (conA) VERIFICAR(memcmp(r + largo - 4, IP_AP, 4) == 0);
+}
+
+} // namespace
+
+PRUEBA(responder_en_el_lugar) {
+    DnsCautivo dns;
+    dns.excluir("ota.ejemplo.com");
+    dns.begin(ipAp(), 0);                               // sólo fija la IP; el socket no se usa
+
+    uint8_t consultas[CONSULTAS][DnsCautivo::TAM_PAQUETE];
+    size_t largos[CONSULTAS];
+    for (size_t i = 0; i < CONSULTAS; ++i) {
+        largos[i] = armarConsulta(consultas[i], static_cast<uint16_t>(i), MEZCLA[i].nombre, MEZCLA[i].tipo,
+                                  MEZCLA[i].edns);
+    }
+
+    const int n = prueba::repeticiones(20000) * 10;
+    uint8_t paquete[DnsCautivo::TAM_PAQUETE];
+    uint64_t antes = sim::asignaciones();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        size_t k = static_cast<size_t>(i) % CONSULTAS;
+        memcpy(paquete, consultas[k], largos[k]);
+        size_t largo = dns.responder(paquete, largos[k], sizeof(paquete));
+        if (i < static_cast<int>(CONSULTAS)) verificarRespuesta(paquete, largo, static_cast<uint16_t>(k), MEZCLA[k]);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double s = std::chrono::duration<double>(t1 - t0).count();
+
+    prueba::medir("dns.responder.consultas_por_s", n / s, "q/s");
+    prueba::medir("dns.responder.asignaciones", static_cast<double>(sim::asignaciones() - antes), "");
+    VERIFICAR_IGUAL(sim::asignaciones() - antes, 0u);
+}
+
+PRUEBA(update_sobre_udp_en_loopback) {
+    DnsCautivo dns;
+    dns.excluir("ota.ejemplo.com");
+    uint16_t puerto = 0;
+    for (uint16_t p = 15353; p < 15373 && !puerto; ++p) {
+        if (dns.begin(ipAp(), p)) puerto = p;
+    }
+    VERIFICAR(puerto != 0);
+    if (!puerto) return;
+
+    int cliente = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    VERIFICAR(cliente >= 0);
+    fcntl(cliente, F_SETFL, fcntl(cliente, F_GETFL, 0) | O_NONBLOCK);
+    sockaddr_in destino;
+    memset(&destino, 0, sizeof(destino));
+    destino.sin_family = AF_INET;
+    destino.sin_port = htons(puerto);
+    destino.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    // Ráfagas de 32 consultas: caben en el búfer del socket sin perder ninguna
+    const int RAFAGA = 32;
+    const int rafagas = prueba::repeticiones(200);
+    uint8_t paquete[DnsCautivo::TAM_PAQUETE];
+    uint64_t asignaciones = 0, respondidas = 0;
+    std::vector<double> latenciasUs;
+    double totalS = 0;
+
+    for (int r = 0; r < rafagas; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < RAFAGA; ++i) {
+            const Consulta& c = MEZCLA[i % CONSULTAS];
+            size_t largo = armarConsulta(paquete, static_cast<uint16_t>(i), c.nombre, c.tipo, c.edns);
+            sendto(cliente, paquete, largo, 0, reinterpret_cast<sockaddr*>(&destino), sizeof(destino));
+        }
+
+        int recibidas = 0;
+        for (int vueltas = 0; recibidas < RAFAGA && vueltas < 100000; ++vueltas) {
+            uint64_t antes = sim::asignaciones();
+            dns.update();
+            asignaciones += sim::asignaciones() - antes;
+
+            int n;
+            while ((n = static_cast<int>(recv(cliente, paquete, sizeof(paquete), 0))) > 0) {
+                uint16_t id = static_cast<uint16_t>((paquete[0] << 8) | paquete[1]);
+                if (r == 0) verificarRespuesta(paquete, static_cast<size_t>(n), id, MEZCLA[id % CONSULTAS]);
+                ++recibidas;
+            }
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        VERIFICAR_IGUAL(recibidas, RAFAGA);
+        respondidas += recibidas;
+        double s = std::chrono::duration<double>(t1 - t0).count();
+        totalS += s;
+        latenciasUs.push_back(s * 1e6 / RAFAGA);
+    }
+    close(cliente);
+
+    prueba::medir("dns.udp.consultas_por_s", respondidas / totalS, "q/s");
+    prueba::medir("dns.udp.por_consulta_p50", sim::percentil(latenciasUs, 50), "us");
+    prueba::medir("dns.udp.asignaciones", static_cast<double>(asignaciones), "");
+    VERIFICAR_IGUAL(asignaciones, 0u);
+    VERIFICAR_IGUAL(dns.respondidas(), respondidas);
+}
+
+PRUEBAS_MAIN()
@@ -0,0 +1,112 @@
+// Latencia para recibir contra corriente media de cada PerfilEnergia. El
+// WifiManager real conecta con cada perfil y de la radio simulada se leen el
+// modo de sueño, el listen interval y la potencia que quedaron aplicados; con
+// eso un modelo de la radio del ESP32 estima:
+// - latencia: un paquete que llega al azar espera al próximo despertar (cada
+//   DTIM con modem-sleep mínimo, cada listen interval con el máximo);
+// - corriente: radio escuchando todo el tiempo, o dormida salvo la ventana de
+//   cada beacon, más un paquete de subida por segundo a la potencia elegida.
+// Los consumos son los típicos de la hoja de datos, no una medición.
+
+#include "prueba.h"
+#include "escenario.h"
+
+namespace {
+
+const double BEACON_MS        = 102.4;
+const double VENTANA_BEACON_MS = 2.5;    ///< radio encendida para recibir cada beacon
+const double RX_MA            = 95.0;   ///< radio escuchando, CPU a 80 MHz
+const double MODEM_SUENO_MA   = 25.0;   ///< radio apagada, CPU a 80 MHz
+const double SUBIDA_MS_POR_S  = 0.6;    ///< un paquete de ~500 B por segundo
+const uint16_t LISTEN_DRIVER  = 3;      ///< lo que usa el driver con listen interval 0
+
+const PerfilEnergia PERFILES[] = { PerfilEnergia::LOW_LATENCY, PerfilEnergia::BALANCED, PerfilEnergia::LOW_POWER };
+const char* const NOMBRES[] = { "low_latency", "balanced", "low_power" };
+
+struct Ajustes {
+    uint8_t  sueno;
+    uint16_t listenInterval;
+    uint8_t  potencia;
+};
+
+struct Modelo {
+    double latenciaP50Ms;
+    double latenciaP99Ms;
+    double corrienteMa;
+};
+
+// Conecta con @p perfil y devuelve lo que el driver terminó aplicando
+Ajustes conectarCon(PerfilEnergia perfil, uint8_t dtim) {
+    sim::reiniciar();
+    sim::radio().dtim = dtim;
+    sim::agregarAp("Casa", "clave1234", 6, -55);
+    escenario::guardarRed("Casa", "clave1234");
+
+    WifiManager wm;
+    wm.setPerfilEnergia(perfil);
+    wm.begin();
+    wm.conectarAsync();
+    VERIFICAR(escenario::hastaOnline(wm, 10000) >= 0);
+    return Ajustes{ sim::modoSueno(), sim::listenInterval(), sim::potenciaTx() };
+}
+
+// Corriente de TX según la potencia (en 0,25 dBm), interpolada entre ~150 mA
+// a 13 dBm y ~240 mA a 19,5 dBm
+double corrienteTx(uint8_t potencia) {
+    double dbm = potencia / 4.0;
+    return 150.0 + (dbm - 13.0) * (240.0 - 150.0) / (19.5 - 13.0);
+}
+
+Modelo modelar(const Ajustes& a, uint8_t dtim, int muestras) {
+    double periodoMs = 0;
+    if (a.sueno == WIFI_PS_MIN_MODEM) {
+        periodoMs = dtim * BEACON_MS;
+    } else if (a.sueno == WIFI_PS_MAX_MODEM) {
+        uint16_t intervalo = a.listenInterval ? a.listenInterval : LISTEN_DRIVER;
+        periodoMs = (intervalo > dtim ? intervalo : dtim) * BEACON_MS;
+    }
+
+    std::vector<double> latencias;
+    latencias.reserve(muestras);
+    for (int i = 0; i < muestras; ++i) {
+        double fase = (sim::aleatorio() % 1000000) / 1000000.0;
+        latencias.push_back(periodoMs * (1.0 - fase));     // hasta el próximo despertar
+    }
+
+    double escucha = periodoMs > 0 ? VENTANA_BEACON_MS / periodoMs : 1.0;
+    double subida = SUBIDA_MS_POR_S / 1000.0;
+    Modelo m;
+    m.latenciaP50Ms = sim::percentil(latencias, 50);
+    m.latenciaP99Ms = sim::percentil(latencias, 99);
+    m.corrienteMa = RX_MA * escucha + MODEM_SUENO_MA * (1.0 - escucha - subida) + corrienteTx(a.potencia) * subida;
+    return m;
+}
+
+} // namespace
+
+PRUEBA(latencia_de_despertar_contra_corriente) {
+    const int muestras = prueba::repeticiones(20) * 500;
+    const uint8_t DTIMS[] = { 1, 3 };
+    for (uint8_t dtim : DTIMS) {
+        Modelo anterior = { -1, -1, 1e9 };
+        for (size_t p = 0; p < sizeof(PERFILES) / sizeof(PERFILES[0]); ++p) {
+            Ajustes a = conectarCon(PERFILES[p], dtim);
+            Modelo m = modelar(a, dtim, muestras);
+
+            char nombre[80];
+            snprintf(nombre, sizeof(nombre), "energia.dtim%u.%s.latencia_p50", dtim, NOMBRES[p]);
+            prueba::medir(nombre, m.latenciaP50Ms, "ms");
+            snprintf(nombre, sizeof(nombre), "energia.dtim%u.%s.latencia_p99", dtim, NOMBRES[p]);
+            prueba::medir(nombre, m.latenciaP99Ms, "ms");
+            snprintf(nombre, sizeof(nombre), "energia.dtim%u.%s.corriente", dtim, NOMBRES[p]);
+            prueba::medir(nombre, m.corrienteMa, "mA");
+
+            // Cada perfil cambia latencia por consumo: más espera, menos corriente
+            VERIFICAR(m.latenciaP99Ms >= anterior.latenciaP99Ms);
+            VERIFICAR(m.corrienteMa < anterior.corrienteMa);
+            anterior = m;
+        }
+    }
+}
+
+PRUEBAS_MAIN()
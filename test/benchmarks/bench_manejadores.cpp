@@ -0,0 +1,56 @@
+// Latencia real (reloj del host) de cada manejador del portal, medida desde
+// que el servidor lo llama hasta que devuelve, y memoria que reserva.
+
+#include "prueba.h"
+#include "escenario.h"
+
+namespace {
+
+void medirRuta(sim::ClienteHttp& cliente, const char* nombre, const char* uri, bool gzip,
+               const std::vector<std::pair<std::string, std::string>>* formulario = nullptr) {
+    int n = prueba::repeticiones(200);
+    std::vector<double> us;
+    uint64_t asignaciones = 0;
+    int codigo = 0;
+    for (int i = 0; i < n; ++i) {
+        if (gzip) cliente.cabecera("Accept-Encoding", "gzip, deflate");
+        sim::RespuestaHttp r = formulario ? cliente.post(uri, *formulario) : cliente.get(uri);
+        us.push_back(r.totalNs / 1000.0);
+        asignaciones += r.asignaciones;
+        codigo = r.codigo;
+    }
+    VERIFICAR(codigo > 0);
+    char t[96];
+    snprintf(t, sizeof(t), "manejador.%s.p50", nombre);
+    prueba::medir(t, sim::percentil(us, 50), "us");
+    snprintf(t, sizeof(t), "manejador.%s.p99", nombre);
+    prueba::medir(t, sim::percentil(us, 99), "us");
+    snprintf(t, sizeof(t), "manejador.%s.asignaciones", nombre);
+    prueba::medir(t, static_cast<double>(asignaciones) / n, "por_pedido");
+}
+
+} // namespace
+
+PRUEBA(latencia_por_manejador) {
+    for (uint8_t i = 0; i < 30; ++i) {
+        char ssid[24];
+        snprintf(ssid, sizeof(ssid), "Red-%02u", i);
+        sim::agregarRedFantasma(ssid, 1 + i % 11, -40 - i, 3);
+    }
+    WifiManager wm;
+    wm.habilitarMetricas(true);
+    escenario::abrirPortal(wm);
+    sim::hasta([&wm]() { return wm.scanner().vigente(); }, [&wm]() { wm.update(); }, 10000);
+
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+    medirRuta(cliente, "raiz", "/", true);
+    medirRuta(cliente, "scan", "/scan", false);
+    medirRuta(cliente, "params", "/params", false);
+    medirRuta(cliente, "metrics", "/metrics", false);
+    medirRuta(cliente, "no_encontrado", "/generate_204", false);
+    std::vector<std::pair<std::string, std::string>> invalido;
+    invalido.push_back(std::make_pair(std::string("ssid"), std::string("")));
+    medirRuta(cliente, "save_invalido", "/save", false, &invalido);
+}
+
+PRUEBAS_MAIN()
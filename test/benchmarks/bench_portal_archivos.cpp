@@ -0,0 +1,106 @@
+// Páginas del portal servidas desde LittleFS: pico de memoria dinámica y
+// tiempo hasta el primer byte del envío en bloques (con y sin el hermano
+// .gz) contra el camino anterior, que cargaba el archivo entero con
+// File::readString(). La flash se modela a 1 MB/s.
+
+#include "prueba.h"
+#include "escenario.h"
+#include "wifimanager_portal.h"
+
+namespace {
+
+const uint32_t US_POR_KB_FLASH = 1000;
+
+struct Resultado {
+    std::vector<double> ttfbUs;
+    int64_t  picoBytes = 0;
+    uint64_t asignaciones = 0;
+    size_t   bytes = 0;
+    int      codigo = 0;
+};
+
+void medir(sim::ClienteHttp& cliente, bool gzip, Resultado& r) {
+    int n = prueba::repeticiones(50);
+    for (int i = 0; i < n; ++i) {
+        if (gzip) cliente.cabecera("Accept-Encoding", "gzip, deflate");
+        sim::RespuestaHttp resp = cliente.get("/");
+        r.ttfbUs.push_back(static_cast<double>(resp.primerByteUs));
+        if (resp.picoBytes > r.picoBytes) r.picoBytes = resp.picoBytes;
+        r.asignaciones += resp.asignaciones;
+        r.bytes = resp.cuerpo.size();
+        r.codigo = resp.codigo;
+    }
+    r.asignaciones /= n;
+}
+
+void informar(const char* caso, Resultado& r) {
+    char t[96];
+    snprintf(t, sizeof(t), "portal_archivo.%s.pico_heap", caso);
+    prueba::medir(t, static_cast<double>(r.picoBytes), "bytes");
+    snprintf(t, sizeof(t), "portal_archivo.%s.ttfb_p50", caso);
+    prueba::medir(t, sim::percentil(r.ttfbUs, 50), "us");
+    snprintf(t, sizeof(t), "portal_archivo.%s.enviados", caso);
+    prueba::medir(t, static_cast<double>(r.bytes), "bytes");
+}
+
+void cargarPortal() {
+    sim::escribirArchivo("/index.html", escenario::paginaDelRepo("index.html"));
+    for (const RecursoPortal& recurso : wm_portal::RECURSOS) {
+        if (strcmp(recurso.nombre, "index.html") != 0) continue;
+        sim::escribirArchivo("/index.html.gz",
+                             std::string(reinterpret_cast<const char*>(recurso.datos), recurso.longitud));
+    }
+    sim::fs().usPorKb = US_POR_KB_FLASH;
+}
+
+} // namespace
+
+PRUEBA(readstring_contra_bloques) {
+    cargarPortal();
+    size_t largo = sim::leerArchivo("/index.html").size();
+    VERIFICAR(largo > 4096);
+    VERIFICAR(sim::existeArchivo("/index.html.gz"));
+
+    // Camino anterior: todo el archivo en un String y después send()
+    Resultado anterior;
+    {
+        WebServer viejo(8080);
+        viejo.on("/", [&viejo]() {
+            File f = LittleFS.open("/index.html", "r");
+            String html = f.readString();
+            f.close();
+            viejo.send(200, "text/html", html);
+        });
+        viejo.begin();
+        sim::ClienteHttp cliente([&viejo]() { viejo.handleClient(); }, 8080);
+        medir(cliente, false, anterior);
+    }
+
+    Resultado plano, comprimido;
+    {
+        WifiManager wm;
+        wm.usarPortalEmbebido(false);
+        escenario::abrirPortal(wm);
+        sim::ClienteHttp cliente([&wm]() { wm.update(); });
+        medir(cliente, false, plano);
+        medir(cliente, true, comprimido);
+    }
+
+    informar("readstring", anterior);
+    informar("bloques", plano);
+    informar("bloques_gzip", comprimido);
+
+    VERIFICAR_IGUAL(anterior.codigo, 200);
+    VERIFICAR_IGUAL(plano.codigo, 200);
+    VERIFICAR_IGUAL(comprimido.codigo, 200);
+    VERIFICAR_IGUAL(plano.bytes, largo);
+    VERIFICAR(comprimido.bytes < plano.bytes);
+    // El String del camino anterior ocupa el archivo entero; los bloques van
+    // en la pila y los nombres de cabecera ya están armados
+    VERIFICAR(anterior.picoBytes >= static_cast<int64_t>(largo));
+    VERIFICAR_IGUAL(plano.picoBytes, 0);
+    VERIFICAR_IGUAL(comprimido.picoBytes, 0);
+    VERIFICAR(sim::percentil(plano.ttfbUs, 50) < sim::percentil(anterior.ttfbUs, 50));
+}
+
+PRUEBAS_MAIN()
@@ -0,0 +1,128 @@
+// Carga sobre el portal asíncrono: 20 teléfonos con un pedido siempre en
+// vuelo cada uno, mezclando /, /scan, /params, /metrics y las pruebas de
+// conectividad. Se mide el rendimiento y la latencia p50/p99 en tiempo
+// virtual (el aire del AP a ~5 Mbit/s y update() cada 200 us) y el CPU real
+// por pedido, y se verifica que al terminar no quede memoria tomada.
+
+#include "prueba.h"
+#include "escenario.h"
+
+#include <ArduinoJson.h>
+#include <chrono>
+
+namespace {
+
+const int      CLIENTES = 20;
+const uint32_t AIRE_US_POR_KB = 1600;
+const uint32_t VUELTA_US = 200;
+
+struct Cliente {
+    sim::PedidoHttp    pedido;
+    sim::RespuestaHttp respuesta;
+    int                tipo = 0;
+    bool               esperando = false;
+};
+
+const char* const RUTAS[] = { "/", "/", "/", "/", "/scan", "/scan", "/scan", "/params", "/metrics", "/generate_204" };
+const int CANT_RUTAS = sizeof(RUTAS) / sizeof(RUTAS[0]);
+
+// Lo que reserva el teléfono no es del servidor: no cuenta
+void pedir(sim::ServidorHttp& servidor, Cliente& c, int n) {
+    sim::SinContar sinContar;
+    c.tipo = n % CANT_RUTAS;
+    c.pedido = sim::PedidoHttp();
+    c.pedido.ruta = RUTAS[c.tipo];
+    if (c.tipo < 4) c.pedido.cabeceras.push_back(std::make_pair(std::string("Accept-Encoding"), std::string("gzip")));
+    c.respuesta = sim::RespuestaHttp();
+    c.esperando = true;
+    servidor.entregar(c.pedido, c.respuesta);
+}
+
+struct Totales {
+    std::vector<double> latenciaUs;
+    std::vector<double> ttfbUs;
+    uint64_t cpuNs = 0;
+    uint64_t bytes = 0;
+    int      errores = 0;
+};
+
+void registrar(const Cliente& c, Totales& t) {
+    const sim::RespuestaHttp& r = c.respuesta;
+    t.latenciaUs.push_back(static_cast<double>(r.totalUs));
+    t.ttfbUs.push_back(static_cast<double>(r.primerByteUs));
+    t.cpuNs += r.totalNs;
+    t.bytes += r.cuerpo.size();
+
+    int esperado = strcmp(RUTAS[c.tipo], "/generate_204") == 0 ? 302 : 200;
+    if (r.codigo != esperado) ++t.errores;
+    if (strcmp(RUTAS[c.tipo], "/scan") == 0) {
+        DynamicJsonDocument doc(16384);
+        if (deserializeJson(doc, r.cuerpo.c_str()) || doc.as<JsonArray>().size() == 0) ++t.errores;
+    }
+}
+
+// Atiende @p cantidad pedidos con cada cliente siempre esperando uno
+void correr(WifiManager& wm, std::vector<Cliente>& clientes, int cantidad, Totales* t) {
+    sim::ServidorHttp& servidor = *sim::servidor(80);
+    int pedidos = 0, terminados = 0;
+    for (Cliente& c : clientes) {
+        if (pedidos < cantidad) pedir(servidor, c, pedidos++);
+    }
+    uint64_t limiteUs = sim::ahoraUs() + 600ull * 1000 * 1000;
+    while (terminados < cantidad && sim::ahoraUs() < limiteUs) {
+        sim::atenderServidores();
+        wm.update();
+        sim::avanzarUs(VUELTA_US);
+        for (Cliente& c : clientes) {
+            if (!c.esperando || !c.respuesta.completa) continue;
+            c.esperando = false;
+            ++terminados;
+            if (t) registrar(c, *t);
+            if (pedidos < cantidad) pedir(servidor, c, pedidos++);
+        }
+    }
+    VERIFICAR_IGUAL(terminados, cantidad);
+}
+
+} // namespace
+
+PRUEBA(veinte_clientes_concurrentes) {
+    for (int i = 0; i < 30; ++i) {
+        char ssid[16];
+        snprintf(ssid, sizeof(ssid), "Red-%02d", i);
+        sim::agregarRedFantasma(ssid, 1 + i % 11, -40 - i, 3);
+    }
+    WifiManager wm(2, 0, ServidorPortal::ASINCRONO);
+    wm.habilitarMetricas(true);
+    escenario::abrirPortal(wm);
+    sim::hasta([&wm]() { return wm.scanner().vigente(); }, [&wm]() { wm.update(); }, 10000);
+    sim::radio().apUsPorKb = AIRE_US_POR_KB;
+
+    std::vector<Cliente> clientes(CLIENTES);
+    const int total = prueba::repeticiones(50) * CLIENTES;
+    Totales t;
+    t.latenciaUs.reserve(total);
+    t.ttfbUs.reserve(total);
+
+    // Una vuelta de calentamiento arma lo que se crea una sola vez
+    correr(wm, clientes, CLIENTES, nullptr);
+    int64_t vivos = sim::memoria().bytesVivos;
+    uint64_t inicioUs = sim::ahoraUs();
+    auto inicioReal = std::chrono::steady_clock::now();
+    correr(wm, clientes, total, &t);
+    double virtualS = (sim::ahoraUs() - inicioUs) / 1e6;
+    double realS = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicioReal).count();
+
+    prueba::medir("portal_async.20_clientes.pedidos_por_s", total / virtualS, "req/s");
+    prueba::medir("portal_async.20_clientes.latencia_p50", sim::percentil(t.latenciaUs, 50) / 1000.0, "ms");
+    prueba::medir("portal_async.20_clientes.latencia_p99", sim::percentil(t.latenciaUs, 99) / 1000.0, "ms");
+    prueba::medir("portal_async.20_clientes.ttfb_p99", sim::percentil(t.ttfbUs, 99) / 1000.0, "ms");
+    prueba::medir("portal_async.20_clientes.cpu_por_pedido", t.cpuNs / 1000.0 / total, "us");
+    prueba::medir("portal_async.20_clientes.pedidos_por_s_cpu_host", total / realS, "req/s");
+    prueba::medir("portal_async.20_clientes.kb_enviados", t.bytes / 1024.0, "KB");
+
+    VERIFICAR_IGUAL(t.errores, 0);
+    VERIFICAR_IGUAL(sim::memoria().bytesVivos, vivos);   // ni cursores ni respuestas colgados
+}
+
+PRUEBAS_MAIN()
@@ -0,0 +1,228 @@
+// Carga de credenciales al arrancar: el registro binario /wifi.bin contra el
+// camino anterior, que parseaba /wifi.json con un DynamicJsonDocument y la
+// caché de conexión /wifi_cache.json con un StaticJsonDocument<384>. Se mide
+// tiempo real del decodificado, tiempo virtual de flash (1 MB/s), bytes
+// leídos, memoria dinámica y pila.
+//
+// El JSON lo parsea el ArduinoJson simulado: su tiempo es orientativo, pero
+// las reservas (el pool del documento) y la pila (el StaticJsonDocument) son
+// las mismas que en el dispositivo.
+
+#include "prueba.h"
+#include "registrowifi.h"
+
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <chrono>
+
+namespace {
+
+const uint32_t US_POR_KB_FLASH = 1000;
+
+struct Carga {
+    TablaRedes    redes;
+    CacheConexion cache;
+};
+
+TablaRedes tablaDePrueba(uint8_t cantidad) {
+    TablaRedes tabla;
+    char ssid[33], clave[65];
+    for (uint8_t i = 0; i < cantidad; ++i) {
+        snprintf(ssid, sizeof(ssid), "Red-de-la-casa-%u", i);
+        snprintf(clave, sizeof(clave), "clave-bastante-larga-%u-xxxxxxxx", i);
+        RedGuardada red = {};
+        strlcpy(red.ssid, ssid, sizeof(red.ssid));
+        strlcpy(red.password, clave, sizeof(red.password));
+        red.ultimoExito = 1700000000u + i;
+        red.fallos = i;
+        red.latenciaMs = static_cast<uint16_t>(900 + 100 * i);
+        tabla.restaurar(red);
+    }
+    return tabla;
+}
+
+CacheConexion cacheDePrueba() {
+    CacheConexion cache;
+    cache.valida = true;
+    strlcpy(cache.ssid, "Red-de-la-casa-0", sizeof(cache.ssid));
+    for (uint8_t i = 0; i < 6; ++i) cache.bssid[i] = static_cast<uint8_t>(0x10 + i);
+    cache.canal = 6;
+    cache.ip = 0x6401A8C0;
+    cache.gateway = 0x0101A8C0;
+    cache.mascara = 0x00FFFFFF;
+    cache.dns1 = 0x0101A8C0;
+    return cache;
+}
+
+// Mismos archivos que escribían las versiones anteriores
+void escribirJson(const TablaRedes& tabla, const CacheConexion& cache) {
+    std::string json = "{\"ssid\":\"";
+    json += tabla.red(0).ssid;
+    json += "\",\"password\":\"";
+    json += tabla.red(0).password;
+    json += "\",\"redes\":[";
+    char campo[160];
+    for (uint8_t i = 0; i < tabla.cantidad(); ++i) {
+        const RedGuardada& red = tabla.red(i);
+        snprintf(campo, sizeof(campo), "%s{\"ssid\":\"%s\",\"password\":\"%s\",\"ok\":%u,\"fallos\":%u,\"lat\":%u}",
+                 i ? "," : "", red.ssid, red.password, red.ultimoExito, red.fallos, red.latenciaMs);
+        json += campo;
+    }
+    json += "]}";
+    sim::escribirArchivo("/wifi.json", json);
+
+    snprintf(campo, sizeof(campo),
+             "{\"ssid\":\"%s\",\"bssid\":[%u,%u,%u,%u,%u,%u],\"canal\":%u,\"ip\":%u,\"gw\":%u,\"mask\":%u,\"dns1\":%u,\"dns2\":%u}",
+             cache.ssid, cache.bssid[0], cache.bssid[1], cache.bssid[2], cache.bssid[3], cache.bssid[4],
+             cache.bssid[5], cache.canal, cache.ip, cache.gateway, cache.mascara, cache.dns1, cache.dns2);
+    sim::escribirArchivo("/wifi_cache.json", campo);
+}
+
+void escribirBinario(const TablaRedes& tabla, const CacheConexion& cache) {
+    RegistroWifi::Archivo registro;
+    RegistroWifi::empaquetar(tabla, cache, registro);
+    sim::escribirArchivo("/wifi.bin", std::string(reinterpret_cast<const char*>(&registro), registro.longitud));
+}
+
+// Copia de WifiManager::loadCredentials()
+__attribute__((noinline)) bool cargarBinario(Carga& c) {
+    File file = LittleFS.open("/wifi.bin", "r");
+    if (!file) return false;
+    RegistroWifi::Archivo registro;
+    size_t leidos = file.read(reinterpret_cast<uint8_t*>(&registro), sizeof(registro));
+    file.close();
+    return RegistroWifi::desempaquetar(registro, leidos, c.redes, c.cache);
+}
+
+// Copia del loadCredentials() y loadCacheConexion() anteriores
+__attribute__((noinline)) bool cargarJson(Carga& c) {
+    File file = LittleFS.open("/wifi.json", "r");
+    if (!file) return false;
+    DynamicJsonDocument doc(256 + WM_MAX_REDES * 192);
+    DeserializationError error = deserializeJson(doc, file);
+    file.close();
+    if (error) return false;
+
+    c.redes.limpiar();
+    JsonArray lista = doc["redes"];
+    for (JsonObject obj : lista) {
+        RedGuardada red = {};
+        strlcpy(red.ssid, obj["ssid"] | "", sizeof(red.ssid));
+        strlcpy(red.password, obj["password"] | "", sizeof(red.password));
+        red.ultimoExito = obj["ok"] | 0;
+        red.fallos      = obj["fallos"] | 0;
+        red.latenciaMs  = obj["lat"] | 0;
+        if (red.password[0] != '\0') c.redes.restaurar(red);
+    }
+
+    File archivoCache = LittleFS.open("/wifi_cache.json", "r");
+    if (!archivoCache) return true;
+    StaticJsonDocument<384> docCache;
+    error = deserializeJson(docCache, archivoCache);
+    archivoCache.close();
+    if (error) return true;
+    strlcpy(c.cache.ssid, docCache["ssid"] | "", sizeof(c.cache.ssid));
+    JsonArray bssid = docCache["bssid"];
+    if (bssid.size() != 6) return true;
+    for (uint8_t i = 0; i < 6; ++i) c.cache.bssid[i] = bssid[i];
+    c.cache.canal   = docCache["canal"] | 0;
+    c.cache.ip      = docCache["ip"]    | 0;
+    c.cache.gateway = docCache["gw"]    | 0;
+    c.cache.mascara = docCache["mask"]  | 0;
+    c.cache.dns1    = docCache["dns1"]  | 0;
+    c.cache.dns2    = docCache["dns2"]  | 0;
+    c.cache.valida  = c.cache.canal != 0;
+    return true;
+}
+
+struct Resultado {
+    std::vector<double> ns;
+    uint64_t asignaciones = 0;
+    int64_t  picoBytes = 0;
+    size_t   pila = 0;
+    uint32_t bytesLeidos = 0;
+    uint64_t flashUs = 0;
+};
+
+Resultado medirCarga(bool (*cargar)(Carga&), const TablaRedes& esperada) {
+    Resultado r;
+    int n = prueba::repeticiones(200);
+    r.ns.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        Carga c;
+        uint32_t leidosAntes = sim::fs().bytesLeidos;
+        uint64_t virtualAntes = sim::ahoraUs();
+        uint64_t antes = sim::asignaciones();
+        int64_t vivos = sim::marcarPico();
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = cargar(c);
+        auto t1 = std::chrono::steady_clock::now();
+        r.asignaciones = sim::asignaciones() - antes;
+        r.picoBytes = sim::memoria().pico - vivos;
+        r.bytesLeidos = sim::fs().bytesLeidos - leidosAntes;
+        r.flashUs = sim::ahoraUs() - virtualAntes;
+        // Después de leer los contadores: el vector no cuenta como carga
+        r.ns.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+
+        VERIFICAR(ok);
+        VERIFICAR_IGUAL(c.redes.cantidad(), esperada.cantidad());
+        for (uint8_t k = 0; k < esperada.cantidad(); ++k) {
+            VERIFICAR_TEXTO(c.redes.red(k).password, esperada.red(k).password);
+            VERIFICAR_IGUAL(c.redes.red(k).latenciaMs, esperada.red(k).latenciaMs);
+        }
+        VERIFICAR(c.cache.valida);
+    }
+    r.pila = prueba::pilaUsada([&] { Carga c; cargar(c); });
+    return r;
+}
+
+void informar(const char* caso, Resultado& r) {
+    char t[96];
+    snprintf(t, sizeof(t), "registro.%s.decodificar_p50", caso);
+    prueba::medir(t, sim::percentil(r.ns, 50), "ns");
+    snprintf(t, sizeof(t), "registro.%s.flash", caso);
+    prueba::medir(t, static_cast<double>(r.flashUs), "us");
+    snprintf(t, sizeof(t), "registro.%s.bytes_leidos", caso);
+    prueba::medir(t, r.bytesLeidos, "bytes");
+    snprintf(t, sizeof(t), "registro.%s.asignaciones", caso);
+    prueba::medir(t, static_cast<double>(r.asignaciones), "");
+    snprintf(t, sizeof(t), "registro.%s.pico_heap", caso);
+    prueba::medir(t, static_cast<double>(r.picoBytes), "bytes");
+    snprintf(t, sizeof(t), "registro.%s.pila", caso);
+    prueba::medir(t, static_cast<double>(r.pila), "bytes");
+}
+
+void comparar(uint8_t cantidad) {
+    TablaRedes tabla = tablaDePrueba(cantidad);
+    CacheConexion cache = cacheDePrueba();
+    escribirJson(tabla, cache);
+    escribirBinario(tabla, cache);
+    sim::fs().usPorKb = US_POR_KB_FLASH;
+
+    Resultado json = medirCarga(cargarJson, tabla);
+    Resultado binario = medirCarga(cargarBinario, tabla);
+
+    char caso[32];
+    snprintf(caso, sizeof(caso), "json_%u_redes", cantidad);
+    informar(caso, json);
+    snprintf(caso, sizeof(caso), "binario_%u_redes", cantidad);
+    informar(caso, binario);
+
+    // El registro binario no toca el heap y pesa menos en pila que el JSON
+    VERIFICAR_IGUAL(binario.asignaciones, 0u);
+    VERIFICAR(binario.picoBytes <= 0);
+    VERIFICAR(json.asignaciones > 0);
+    VERIFICAR(binario.pila < json.pila);
+}
+
+} // namespace
+
+PRUEBA(una_red) {
+    comparar(1);
+}
+
+PRUEBA(tabla_llena) {
+    comparar(WM_MAX_REDES);
+}
+
+PRUEBAS_MAIN()
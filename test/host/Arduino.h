@@ -0,0 +1,73 @@
+#ifndef WM_HOST_ARDUINO_H
+#define WM_HOST_ARDUINO_H
+
+/**
+ * @file  Arduino.h
+ * @brief Núcleo de Arduino-ESP32 para compilar la librería en Linux.
+ *
+ * Sólo lo que usan la librería y las pruebas. Tiempo, pines, Serial y ESP los
+ * atiende el simulador (ver simulador.h): el reloj es virtual y Serial no
+ * escribe nada salvo que se defina WM_HOST_LOG en el entorno.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "WString.h"
+#include "IPAddress.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define PROGMEM
+#define PGM_P const char*
+#define pgm_read_byte(p) (*reinterpret_cast<const uint8_t*>(p))
+
+#define HIGH 1
+#define LOW  0
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+// glibc trae strlcpy recién desde 2.38
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+size_t strlcpy(char* destino, const char* origen, size_t capacidad);
+#endif
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t modo);
+void digitalWrite(uint8_t pin, uint8_t nivel);
+int  digitalRead(uint8_t pin);
+
+/** Serial silencioso: con WM_HOST_LOG definido en el entorno escribe en stderr. */
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    size_t print(const char* texto);
+    size_t print(const String& texto) { return print(texto.c_str()); }
+    size_t print(long v);
+    size_t println(const char* texto = "");
+    size_t println(const String& texto) { return println(texto.c_str()); }
+    size_t println(long v);
+    size_t printf(const char* formato, ...) __attribute__((format(printf, 2, 3)));
+};
+extern HardwareSerial Serial;
+
+/** Heap: el que mide memoria.cpp sobre un ESP32 de 320 KB. */
+class EspClass {
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    void     restart();           ///< no reinicia: lo cuenta sim::reinicios()
+};
+extern EspClass ESP;
+
+#endif
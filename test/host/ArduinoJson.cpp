@@ -0,0 +1,201 @@
+/**
+ * @file  ArduinoJson.cpp
+ * @brief Parser del subconjunto de ArduinoJson del host. Estima el uso de
+ *        memoria como ArduinoJson 6 en 32 bits (16 bytes por valor más los
+ *        textos copiados) para que la capacidad del documento pese igual.
+ */
+
+#include "ArduinoJson.h"
+
+namespace {
+
+const size_t TAM_VALOR = 16;
+const int    PROFUNDIDAD_MAX = 10;
+
+class Parser {
+public:
+    Parser(std::vector<wm_json::Nodo>& nodos, const char* p, size_t largo, size_t capacidad)
+    : nodos(nodos), p(p), fin(p + largo), capacidad(capacidad) {}
+
+    DeserializationError::Code parsear(size_t& usado) {
+        espacios();
+        if (p >= fin) return DeserializationError::EmptyInput;
+        DeserializationError::Code c = valor(0);
+        usado = this->usado;
+        return c;
+    }
+
+private:
+    void espacios() {
+        while (p < fin && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+    }
+
+    // Como en ArduinoJson, la raíz vive en el documento y cada miembro ocupa
+    // un único slot (clave y valor juntos): la clave no cuesta un valor aparte.
+    int nuevo(wm_json::Nodo::Tipo tipo, bool esClave = false) {
+        if (!nodos.empty() && !esClave) usado += TAM_VALOR;
+        nodos.push_back(wm_json::Nodo());
+        nodos.back().tipo = tipo;
+        return static_cast<int>(nodos.size() - 1);
+    }
+
+    bool cabe() const { return usado <= capacidad; }
+
+    DeserializationError::Code texto(std::string& destino) {
+        ++p;                                            // comilla de apertura
+        while (p < fin && *p != '"') {
+            char c = *p++;
+            if (c == '\\') {
+                if (p >= fin) return DeserializationError::IncompleteInput;
+                char esc = *p++;
+                switch (esc) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'u': {
+                    if (fin - p < 4) return DeserializationError::IncompleteInput;
+                    unsigned v = static_cast<unsigned>(strtoul(std::string(p, 4).c_str(), nullptr, 16));
+                    p += 4;
+                    if (v < 0x80) {
+                        destino += static_cast<char>(v);
+                    } else if (v < 0x800) {
+                        destino += static_cast<char>(0xC0 | (v >> 6));
+                        destino += static_cast<char>(0x80 | (v & 0x3F));
+                    } else {
+                        destino += static_cast<char>(0xE0 | (v >> 12));
+                        destino += static_cast<char>(0x80 | ((v >> 6) & 0x3F));
+                        destino += static_cast<char>(0x80 | (v & 0x3F));
+                    }
+                    continue;
+                }
+                default: c = esc; break;
+                }
+            }
+            destino += c;
+        }
+        if (p >= fin) return DeserializationError::IncompleteInput;
+        ++p;
+        usado += destino.size() + 1;
+        return DeserializationError::Ok;
+    }
+
+    DeserializationError::Code valor(int profundidad) {
+        if (profundidad > PROFUNDIDAD_MAX) return DeserializationError::TooDeep;
+        espacios();
+        if (p >= fin) return DeserializationError::IncompleteInput;
+
+        if (*p == '{' || *p == '[') {
+            bool objeto = *p == '{';
+            int yo = nuevo(objeto ? wm_json::Nodo::OBJETO : wm_json::Nodo::ARREGLO);
+            ++p;
+            espacios();
+            if (p < fin && *p == (objeto ? '}' : ']')) {
+                ++p;
+                return cabe() ? DeserializationError::Ok : DeserializationError::NoMemory;
+            }
+            for (;;) {
+                int hijo;
+                if (objeto) {
+                    espacios();
+                    if (p >= fin) return DeserializationError::IncompleteInput;
+                    if (*p != '"') return DeserializationError::InvalidInput;
+                    hijo = nuevo(wm_json::Nodo::NULO, true);
+                    std::string clave;
+                    DeserializationError::Code c = texto(clave);
+                    if (c) return c;
+                    nodos[hijo].s = clave;
+                    espacios();
+                    if (p >= fin) return DeserializationError::IncompleteInput;
+                    if (*p++ != ':') return DeserializationError::InvalidInput;
+                    int valorIdx = static_cast<int>(nodos.size());
+                    c = valor(profundidad + 1);
+                    if (c) return c;
+                    nodos[hijo].hijos.push_back(valorIdx);
+                } else {
+                    hijo = static_cast<int>(nodos.size());
+                    DeserializationError::Code c = valor(profundidad + 1);
+                    if (c) return c;
+                }
+                nodos[yo].hijos.push_back(hijo);
+                if (!cabe()) return DeserializationError::NoMemory;
+                espacios();
+                if (p >= fin) return DeserializationError::IncompleteInput;
+                char c = *p++;
+                if (c == ',') continue;
+                if (c == (objeto ? '}' : ']')) return DeserializationError::Ok;
+                return DeserializationError::InvalidInput;
+            }
+        }
+
+        if (*p == '"') {
+            int yo = nuevo(wm_json::Nodo::TEXTO);
+            std::string s;
+            DeserializationError::Code c = texto(s);
+            if (c) return c;
+            nodos[yo].s = s;
+            return cabe() ? DeserializationError::Ok : DeserializationError::NoMemory;
+        }
+
+        if (fin - p >= 4 && strncmp(p, "true", 4) == 0) {
+            nodos[nuevo(wm_json::Nodo::BOOLEANO)].b = true;
+            p += 4;
+            return DeserializationError::Ok;
+        }
+        if (fin - p >= 5 && strncmp(p, "false", 5) == 0) {
+            nuevo(wm_json::Nodo::BOOLEANO);
+            p += 5;
+            return DeserializationError::Ok;
+        }
+        if (fin - p >= 4 && strncmp(p, "null", 4) == 0) {
+            nuevo(wm_json::Nodo::NULO);
+            p += 4;
+            return DeserializationError::Ok;
+        }
+
+        const char* inicio = p;
+        bool real = false;
+        if (p < fin && (*p == '-' || *p == '+')) ++p;
+        while (p < fin && ((*p >= '0' && *p <= '9') || *p == '.' || *p == 'e' || *p == 'E' ||
+                           ((*p == '-' || *p == '+') && (p[-1] == 'e' || p[-1] == 'E')))) {
+            if (*p == '.' || *p == 'e' || *p == 'E') real = true;
+            ++p;
+        }
+        if (p == inicio) return DeserializationError::InvalidInput;
+        std::string numero(inicio, p);
+        if (real) {
+            nodos[nuevo(wm_json::Nodo::REAL)].d = strtod(numero.c_str(), nullptr);
+        } else {
+            int yo = nuevo(wm_json::Nodo::ENTERO);
+            nodos[yo].i = strtoll(numero.c_str(), nullptr, 10);
+        }
+        return DeserializationError::Ok;
+    }
+
+    std::vector<wm_json::Nodo>& nodos;
+    const char* p;
+    const char* fin;
+    size_t capacidad;
+    size_t usado = 0;
+};
+
+} // namespace
+
+DeserializationError deserializarJson(JsonDocument& doc, const char* texto, size_t largo) {
+    sim::SinContar sinContar;
+    doc.clear();
+    Parser parser(doc.nodos, texto, largo, doc.capacidad);
+    DeserializationError::Code c = parser.parsear(doc.usado);
+    if (c) doc.clear();
+    return DeserializationError(c);
+}
+
+DeserializationError deserializeJson(JsonDocument& doc, File& archivo) {
+    sim::SinContar sinContar;
+    std::string contenido;
+    uint8_t bloque[128];
+    size_t n;
+    while ((n = archivo.read(bloque, sizeof(bloque))) > 0) contenido.append(reinterpret_cast<char*>(bloque), n);
+    return deserializarJson(doc, contenido.data(), contenido.size());
+}
@@ -0,0 +1,294 @@
+#ifndef WM_HOST_ARDUINOJSON_H
+#define WM_HOST_ARDUINOJSON_H
+
+/**
+ * @file  ArduinoJson.h
+ * @brief Subconjunto de ArduinoJson 6 para el host: sólo deserializar y leer,
+ *        que es lo que hace la librería (migración de /wifi.json y carga de la
+ *        configuración). Respeta la capacidad del documento: si el contenido
+ *        no entra devuelve NoMemory, como el original.
+ *
+ * La memoria se parece a la del original: el documento dinámico reserva su
+ * capacidad en el heap y el estático la ocupa en la pila. Los nodos del árbol
+ * son del simulador y no se cuentan (sim::SinContar). El tiempo de parseo es
+ * el de este parser, no el de ArduinoJson.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <climits>
+#include <string>
+#include <vector>
+#include "LittleFS.h"
+#include "simulador.h"
+
+class JsonDocument;
+class JsonObject;
+class JsonArray;
+
+class DeserializationError {
+public:
+    enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory, TooDeep };
+    DeserializationError(Code c = Ok) : codigo(c) {}
+    explicit operator bool() const { return codigo != Ok; }
+    Code code() const { return codigo; }
+    const char* c_str() const {
+        static const char* const NOMBRES[] = { "Ok", "EmptyInput", "IncompleteInput", "InvalidInput",
+                                               "NoMemory", "TooDeep" };
+        return NOMBRES[codigo];
+    }
+
+private:
+    Code codigo;
+};
+
+namespace wm_json {
+struct Nodo {
+    enum Tipo : uint8_t { NULO, BOOLEANO, ENTERO, REAL, TEXTO, ARREGLO, OBJETO } tipo = NULO;
+    bool        b = false;
+    long long   i = 0;
+    double      d = 0;
+    std::string s;                  ///< texto, o clave del hijo dentro de un objeto
+    std::vector<int> hijos;
+};
+}
+
+class JsonString {
+public:
+    explicit JsonString(const char* s) : s(s) {}
+    const char* c_str() const { return s; }
+private:
+    const char* s;
+};
+
+class JsonVariant {
+public:
+    JsonVariant() {}
+    JsonVariant(const JsonDocument* doc, int nodo) : doc(doc), nodo(nodo) {}
+
+    bool isNull() const;
+    JsonVariant operator[](const char* clave) const;
+    JsonVariant operator[](int i) const;
+    size_t size() const;
+
+    template <typename T> bool is() const;
+    template <typename T> T as() const;
+    template <typename T> operator T() const { return as<T>(); }
+
+    const char* operator|(const char* porDefecto) const;
+    int         operator|(int porDefecto) const;
+    bool        operator|(bool porDefecto) const;
+
+protected:
+    friend class JsonArray;
+    friend class JsonObject;
+    friend class JsonPair;
+    const wm_json::Nodo* n() const;
+    const JsonDocument* doc = nullptr;
+    int nodo = -1;
+};
+
+template <> bool JsonVariant::is<bool>() const;
+template <> bool JsonVariant::is<long>() const;
+template <> bool JsonVariant::is<int>() const;
+template <> bool JsonVariant::is<double>() const;
+template <> bool JsonVariant::is<const char*>() const;
+template <> bool JsonVariant::is<JsonObject>() const;
+template <> bool JsonVariant::is<JsonArray>() const;
+template <> bool JsonVariant::as<bool>() const;
+template <> const char* JsonVariant::as<const char*>() const;
+template <> JsonObject JsonVariant::as<JsonObject>() const;
+template <> JsonArray JsonVariant::as<JsonArray>() const;
+
+class JsonPair {
+public:
+    JsonPair(const JsonDocument* doc, int nodo) : valor(doc, nodo) {}
+    JsonString  key() const;
+    JsonVariant value() const;
+private:
+    JsonVariant valor;              ///< el nodo de la clave; su único hijo es el valor
+};
+
+template <typename E>
+class JsonIterador {
+public:
+    JsonIterador(const JsonDocument* doc, const std::vector<int>* hijos, size_t i) : doc(doc), hijos(hijos), i(i) {}
+    E operator*() const { return E(doc, (*hijos)[i]); }
+    JsonIterador& operator++() { ++i; return *this; }
+    bool operator!=(const JsonIterador& o) const { return i != o.i; }
+private:
+    const JsonDocument* doc;
+    const std::vector<int>* hijos;
+    size_t i;
+};
+
+class JsonObject : public JsonVariant {
+public:
+    JsonObject() {}
+    JsonObject(const JsonDocument* doc, int nodo) : JsonVariant(doc, nodo) {}
+    JsonObject(const JsonVariant& v);
+    JsonIterador<JsonPair> begin() const;
+    JsonIterador<JsonPair> end() const;
+};
+
+class JsonArray : public JsonVariant {
+public:
+    JsonArray() {}
+    JsonArray(const JsonVariant& v);
+    JsonIterador<JsonObject> begin() const;
+    JsonIterador<JsonObject> end() const;
+};
+
+class JsonDocument {
+public:
+    explicit JsonDocument(size_t capacidad) : capacidad(capacidad) {}
+    ~JsonDocument() { sim::SinContar sinContar; std::vector<wm_json::Nodo>().swap(nodos); }
+
+    JsonVariant operator[](const char* clave) const { return raiz()[clave]; }
+    template <typename T> T as() const { return raiz().as<T>(); }
+    size_t memoryUsage() const { return usado; }
+    void clear() { nodos.clear(); usado = 0; }
+
+private:
+    friend class JsonVariant;
+    friend class JsonPair;
+    friend DeserializationError deserializarJson(JsonDocument& doc, const char* texto, size_t largo);
+
+    JsonVariant raiz() const { return JsonVariant(this, nodos.empty() ? -1 : 0); }
+
+    std::vector<wm_json::Nodo> nodos;
+    size_t capacidad;
+    size_t usado = 0;
+};
+
+/** Como el original, reserva toda la capacidad en el heap al construirse. */
+class DynamicJsonDocument : public JsonDocument {
+public:
+    explicit DynamicJsonDocument(size_t capacidad) : JsonDocument(capacidad), pool(new char[capacidad]) {}
+    ~DynamicJsonDocument() { delete[] pool; }
+private:
+    DynamicJsonDocument(const DynamicJsonDocument&);
+    char* pool;
+};
+
+/** Como el original, ocupa su capacidad en la pila. */
+template <size_t N>
+class StaticJsonDocument : public JsonDocument {
+public:
+    StaticJsonDocument() : JsonDocument(N) { pool[0] = 0; }
+private:
+    volatile char pool[N];
+};
+
+DeserializationError deserializarJson(JsonDocument& doc, const char* texto, size_t largo);
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const char* texto) {
+    return deserializarJson(doc, texto, strlen(texto));
+}
+inline DeserializationError deserializeJson(JsonDocument& doc, const String& texto) {
+    return deserializarJson(doc, texto.c_str(), texto.length());
+}
+DeserializationError deserializeJson(JsonDocument& doc, File& archivo);
+
+// -------- JsonVariant --------
+inline const wm_json::Nodo* JsonVariant::n() const {
+    return doc && nodo >= 0 ? &doc->nodos[nodo] : nullptr;
+}
+
+inline bool JsonVariant::isNull() const {
+    return !n() || n()->tipo == wm_json::Nodo::NULO;
+}
+
+inline JsonVariant JsonVariant::operator[](const char* clave) const {
+    const wm_json::Nodo* p = n();
+    if (!p || p->tipo != wm_json::Nodo::OBJETO) return JsonVariant();
+    for (int h : p->hijos) {
+        if (doc->nodos[h].s == clave) return JsonVariant(doc, doc->nodos[h].hijos[0]);
+    }
+    return JsonVariant();
+}
+
+inline JsonVariant JsonVariant::operator[](int i) const {
+    const wm_json::Nodo* p = n();
+    if (!p || p->tipo != wm_json::Nodo::ARREGLO || i < 0 || static_cast<size_t>(i) >= p->hijos.size()) {
+        return JsonVariant();
+    }
+    return JsonVariant(doc, p->hijos[i]);
+}
+
+inline size_t JsonVariant::size() const {
+    const wm_json::Nodo* p = n();
+    return p && (p->tipo == wm_json::Nodo::ARREGLO || p->tipo == wm_json::Nodo::OBJETO) ? p->hijos.size() : 0;
+}
+
+template <> inline bool JsonVariant::is<bool>() const { return n() && n()->tipo == wm_json::Nodo::BOOLEANO; }
+template <> inline bool JsonVariant::is<long>() const { return n() && n()->tipo == wm_json::Nodo::ENTERO; }
+template <> inline bool JsonVariant::is<int>() const {
+    return is<long>() && n()->i >= INT_MIN && n()->i <= INT_MAX;
+}
+template <> inline bool JsonVariant::is<double>() const {
+    return n() && (n()->tipo == wm_json::Nodo::REAL || n()->tipo == wm_json::Nodo::ENTERO);
+}
+template <> inline bool JsonVariant::is<const char*>() const { return n() && n()->tipo == wm_json::Nodo::TEXTO; }
+template <> inline bool JsonVariant::is<JsonObject>() const { return n() && n()->tipo == wm_json::Nodo::OBJETO; }
+template <> inline bool JsonVariant::is<JsonArray>() const { return n() && n()->tipo == wm_json::Nodo::ARREGLO; }
+
+template <typename T> inline T JsonVariant::as() const {
+    const wm_json::Nodo* p = n();
+    if (!p) return T();
+    switch (p->tipo) {
+    case wm_json::Nodo::BOOLEANO: return static_cast<T>(p->b);
+    case wm_json::Nodo::ENTERO:   return static_cast<T>(p->i);
+    case wm_json::Nodo::REAL:     return static_cast<T>(p->d);
+    default:                      return T();
+    }
+}
+template <> inline bool JsonVariant::as<bool>() const {
+    const wm_json::Nodo* p = n();
+    return p && p->tipo == wm_json::Nodo::BOOLEANO && p->b;
+}
+template <> inline const char* JsonVariant::as<const char*>() const {
+    return is<const char*>() ? n()->s.c_str() : nullptr;
+}
+template <> inline JsonObject JsonVariant::as<JsonObject>() const { return JsonObject(*this); }
+template <> inline JsonArray JsonVariant::as<JsonArray>() const { return JsonArray(*this); }
+
+inline const char* JsonVariant::operator|(const char* porDefecto) const {
+    return is<const char*>() ? as<const char*>() : porDefecto;
+}
+inline int JsonVariant::operator|(int porDefecto) const {
+    return is<int>() ? as<int>() : porDefecto;
+}
+inline bool JsonVariant::operator|(bool porDefecto) const {
+    return is<bool>() ? as<bool>() : porDefecto;
+}
+
+inline JsonObject::JsonObject(const JsonVariant& v) : JsonVariant(v.is<JsonObject>() ? v : JsonVariant()) {}
+inline JsonArray::JsonArray(const JsonVariant& v) : JsonVariant(v.is<JsonArray>() ? v : JsonVariant()) {}
+
+inline JsonString JsonPair::key() const {
+    return JsonString(valor.doc->nodos[valor.nodo].s.c_str());
+}
+
+inline JsonVariant JsonPair::value() const {
+    return JsonVariant(valor.doc, valor.doc->nodos[valor.nodo].hijos[0]);
+}
+
+inline JsonIterador<JsonPair> JsonObject::begin() const {
+    static const std::vector<int> vacio;
+    return JsonIterador<JsonPair>(doc, n() ? &n()->hijos : &vacio, 0);
+}
+inline JsonIterador<JsonPair> JsonObject::end() const {
+    static const std::vector<int> vacio;
+    return JsonIterador<JsonPair>(doc, n() ? &n()->hijos : &vacio, n() ? n()->hijos.size() : 0);
+}
+inline JsonIterador<JsonObject> JsonArray::begin() const {
+    static const std::vector<int> vacio;
+    return JsonIterador<JsonObject>(doc, n() ? &n()->hijos : &vacio, 0);
+}
+inline JsonIterador<JsonObject> JsonArray::end() const {
+    static const std::vector<int> vacio;
+    return JsonIterador<JsonObject>(doc, n() ? &n()->hijos : &vacio, n() ? n()->hijos.size() : 0);
+}
+
+#endif
@@ -0,0 +1,376 @@
+/**
+ * @file  ESPAsyncWebServer.cpp
+ * @brief ESPAsyncWebServer simulado: conexiones abiertas a la vez, atendidas de
+ *        a una ventana por vuelta de la tarea de AsyncTCP.
+ */
+
+#include "ESPAsyncWebServer.h"
+
+#include <chrono>
+#include <stdarg.h>
+#include <strings.h>
+
+namespace {
+
+uint64_t ahoraRealNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+const String& vacio() {
+    static const String nada;
+    return nada;
+}
+
+int tareaAsyncTcp;                      // su dirección hace de handle de la tarea
+
+class RespuestaTexto : public AsyncWebServerResponse {
+public:
+    RespuestaTexto(int c, const char* t, const char* contenido) : contenido(contenido ? contenido : "") {
+        codigo = c;
+        strlcpy(tipo, t ? t : "", sizeof(tipo));
+        largo = this->contenido.length();
+    }
+
+protected:
+    size_t llenar(uint8_t* destino, size_t capacidad, size_t indice) override {
+        if (indice >= largo) return 0;
+        size_t n = largo - indice < capacidad ? largo - indice : capacidad;
+        memcpy(destino, contenido.c_str() + indice, n);
+        return n;
+    }
+
+private:
+    String contenido;
+};
+
+class RespuestaProgmem : public AsyncWebServerResponse {
+public:
+    RespuestaProgmem(int c, const char* t, const uint8_t* datos, size_t l) : datos(datos) {
+        codigo = c;
+        strlcpy(tipo, t, sizeof(tipo));
+        largo = l;
+    }
+
+protected:
+    size_t llenar(uint8_t* destino, size_t capacidad, size_t indice) override {
+        if (indice >= largo) return 0;
+        size_t n = largo - indice < capacidad ? largo - indice : capacidad;
+        memcpy(destino, datos + indice, n);
+        return n;
+    }
+
+private:
+    const uint8_t* datos;
+};
+
+// Como AsyncFileResponse: si no existe la ruta pero sí su ".gz", manda ese
+class RespuestaArchivo : public AsyncWebServerResponse {
+public:
+    RespuestaArchivo(FS& fs, const String& ruta, const String& t) {
+        strlcpy(tipo, t.c_str(), sizeof(tipo));
+        if (!fs.exists(ruta) && fs.exists(ruta + ".gz")) {
+            archivo = fs.open(ruta + ".gz", "r");
+            addHeader("Content-Encoding", "gzip");
+        } else {
+            archivo = fs.open(ruta, "r");
+        }
+        if (!archivo) codigo = 404;
+        largo = archivo ? archivo.size() : 0;
+    }
+
+protected:
+    size_t llenar(uint8_t* destino, size_t capacidad, size_t) override {
+        return archivo ? archivo.read(destino, capacidad) : 0;
+    }
+
+private:
+    File archivo;
+};
+
+class RespuestaChunked : public AsyncWebServerResponse {
+public:
+    RespuestaChunked(const char* t, AwsResponseFiller relleno) : relleno(relleno) {
+        strlcpy(tipo, t, sizeof(tipo));
+        largo = LARGO_DESCONOCIDO;
+    }
+
+protected:
+    size_t llenar(uint8_t* destino, size_t capacidad, size_t indice) override {
+        return relleno(destino, capacidad, indice);
+    }
+
+private:
+    AwsResponseFiller relleno;
+};
+
+} // namespace
+
+// ---------------------------------------------------------------- respuesta
+
+void AsyncWebServerResponse::addHeader(const String& nombre, const String& valor) {
+    if (nCabeceras >= sizeof(cabeceras) / sizeof(cabeceras[0])) return;
+    strlcpy(cabeceras[nCabeceras].nombre, nombre.c_str(), sizeof(cabeceras[0].nombre));
+    strlcpy(cabeceras[nCabeceras].valor, valor.c_str(), sizeof(cabeceras[0].valor));
+    ++nCabeceras;
+}
+
+AsyncResponseStream::AsyncResponseStream(const char* tipoContenido) {
+    strlcpy(tipo, tipoContenido, sizeof(tipo));
+}
+
+size_t AsyncResponseStream::write(const uint8_t* datos, size_t n) {
+    cuerpo.append(reinterpret_cast<const char*>(datos), n);
+    largo = cuerpo.size();
+    return n;
+}
+
+size_t AsyncResponseStream::printf(const char* formato, ...) {
+    char linea[256];
+    va_list args;
+    va_start(args, formato);
+    int n = vsnprintf(linea, sizeof(linea), formato, args);
+    va_end(args);
+    if (n <= 0) return 0;
+    return write(reinterpret_cast<const uint8_t*>(linea), n < (int)sizeof(linea) ? n : sizeof(linea) - 1);
+}
+
+size_t AsyncResponseStream::llenar(uint8_t* destino, size_t capacidad, size_t indice) {
+    if (indice >= cuerpo.size()) return 0;
+    size_t n = cuerpo.size() - indice < capacidad ? cuerpo.size() - indice : capacidad;
+    memcpy(destino, cuerpo.data() + indice, n);
+    return n;
+}
+
+// ---------------------------------------------------------------- pedido
+
+AsyncWebServerRequest::AsyncWebServerRequest(const sim::PedidoHttp& pedido)
+: metodo(pedido.metodo == sim::Metodo::POST ? HTTP_POST : HTTP_GET), ruta(pedido.ruta.c_str()) {
+    for (size_t i = 0; i < pedido.args.size() && nParams < MAX_PARAMS; ++i) {
+        parametros[nParams++] = new AsyncWebParameter(pedido.args[i].first.c_str(), pedido.args[i].second.c_str(),
+                                                      metodo == HTTP_POST);
+    }
+    for (size_t i = 0; i < pedido.cabeceras.size() && nCabeceras < MAX_CABECERAS; ++i) {
+        cabeceras[nCabeceras++] = new AsyncWebHeader(pedido.cabeceras[i].first.c_str(),
+                                                     pedido.cabeceras[i].second.c_str());
+    }
+}
+
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+    for (size_t i = 0; i < nParams; ++i) delete parametros[i];
+    for (size_t i = 0; i < nCabeceras; ++i) delete cabeceras[i];
+    delete respuesta;
+}
+
+const AsyncWebParameter* AsyncWebServerRequest::getParam(const char* nombre, bool post) const {
+    for (size_t i = 0; i < nParams; ++i) {
+        if (parametros[i]->isPost() == post && parametros[i]->name() == nombre) return parametros[i];
+    }
+    return nullptr;
+}
+
+const String& AsyncWebServerRequest::arg(const char* nombre) const {
+    for (size_t i = 0; i < nParams; ++i) {
+        if (parametros[i]->name() == nombre) return parametros[i]->value();
+    }
+    return vacio();
+}
+
+bool AsyncWebServerRequest::hasArg(const char* nombre) const {
+    for (size_t i = 0; i < nParams; ++i) {
+        if (parametros[i]->name() == nombre) return true;
+    }
+    return false;
+}
+
+const AsyncWebHeader* AsyncWebServerRequest::getHeader(const char* nombre) const {
+    for (size_t i = 0; i < nCabeceras; ++i) {
+        if (strcasecmp(cabeceras[i]->name().c_str(), nombre) == 0) return cabeceras[i];
+    }
+    return nullptr;
+}
+
+// Como el original, la primera respuesta gana
+void AsyncWebServerRequest::send(AsyncWebServerResponse* r) {
+    if (respuesta) {
+        delete r;
+        return;
+    }
+    respuesta = r;
+}
+
+void AsyncWebServerRequest::send(int codigo, const char* tipo, const char* contenido) {
+    send(beginResponse(codigo, tipo, contenido));
+}
+
+void AsyncWebServerRequest::redirect(const char* url) {
+    AsyncWebServerResponse* r = beginResponse(302);
+    r->addHeader("Location", url);
+    send(r);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int codigo, const char* tipo, const char* contenido) {
+    return new RespuestaTexto(codigo, tipo, contenido);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(FS& fs, const String& r, const String& tipo, bool) {
+    return new RespuestaArchivo(fs, r, tipo);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse_P(int codigo, const String& tipo, const uint8_t* datos,
+                                                              size_t largo) {
+    return new RespuestaProgmem(codigo, tipo.c_str(), datos, largo);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginChunkedResponse(const String& tipo, AwsResponseFiller relleno) {
+    return new RespuestaChunked(tipo.c_str(), relleno);
+}
+
+AsyncResponseStream* AsyncWebServerRequest::beginResponseStream(const String& tipo, size_t) {
+    return new AsyncResponseStream(tipo.c_str());
+}
+
+// ---------------------------------------------------------------- servidor
+
+AsyncWebServer::~AsyncWebServer() {
+    sim::retirarServidor(this);
+    while (nConexiones) cerrar(nConexiones - 1);
+}
+
+void AsyncWebServer::begin() {
+    iniciado = true;
+    sim::publicarServidor(puerto, this);
+}
+
+void AsyncWebServer::on(const char* uri, WebRequestMethodComposite metodo, ArRequestHandlerFunction manejador) {
+    if (nRutas >= MAX_RUTAS) {
+        fprintf(stderr, "AsyncWebServer: demasiadas rutas (%s)\n", uri);
+        return;
+    }
+    Ruta& r = rutas[nRutas++];
+    strlcpy(r.uri, uri, sizeof(r.uri));
+    r.metodo = metodo;
+    r.manejador = manejador;
+}
+
+void AsyncWebServer::entregar(const sim::PedidoHttp& pedido, sim::RespuestaHttp& respuesta) {
+    if (!iniciado || nConexiones >= MAX_CONEXIONES) {
+        respuesta.codigo = -1;
+        respuesta.completa = true;
+        return;
+    }
+    conexiones[nConexiones++] = { &pedido, &respuesta, nullptr, 0, sim::ahoraUs(), 0 };
+}
+
+void AsyncWebServer::abandonar(sim::RespuestaHttp& respuesta) {
+    for (size_t i = 0; i < nConexiones; ++i) {
+        if (conexiones[i].respuesta == &respuesta) {
+            cerrar(i);
+            return;
+        }
+    }
+}
+
+// Los manejadores de los pedidos nuevos y una ventana para cada conexión. El
+// aire se cobra al final, fuera de la tarea: avanzar el reloj entrega eventos
+// del driver, que no corren en AsyncTCP.
+void AsyncWebServer::atender() {
+    if (!nConexiones) return;
+    uint64_t aireUs = 0;
+    {
+        sim::ComoTarea como(&tareaAsyncTcp);
+        for (size_t i = 0; i < nConexiones;) {
+            Conexion& c = conexiones[i];
+            if (!c.request) correrManejador(c);
+            size_t bytes = enviar(c);
+            aireUs += static_cast<uint64_t>(bytes) * sim::radio().apUsPorKb / 1024;
+            sim::RespuestaHttp& r = *c.respuesta;
+            if (!r.primerByteUs) r.primerByteUs = sim::ahoraUs() + aireUs - c.llegadaUs;
+            if (r.completa) {
+                r.totalUs = sim::ahoraUs() + aireUs - c.llegadaUs;
+                r.totalNs = c.cpuNs;
+                cerrar(i);
+            } else {
+                ++i;
+            }
+        }
+    }
+    if (aireUs) sim::avanzarUs(aireUs);
+}
+
+void AsyncWebServer::correrManejador(Conexion& c) {
+    {
+        sim::SinContar sinContar;
+        c.request = new AsyncWebServerRequest(*c.pedido);
+    }
+    ArRequestHandlerFunction* manejador = nullptr;
+    for (size_t i = 0; i < nRutas && !manejador; ++i) {
+        if (c.request->url() == rutas[i].uri && (rutas[i].metodo & c.request->method())) {
+            manejador = &rutas[i].manejador;
+        }
+    }
+    if (!manejador && noEncontrado) manejador = &noEncontrado;
+
+    uint64_t antes = sim::asignaciones();
+    int64_t vivos = sim::marcarPico();
+    uint64_t inicio = ahoraRealNs();
+    if (manejador) (*manejador)(c.request);
+    else c.request->send(404, "text/plain", "Not found");
+    if (!c.request->respuesta) c.request->send(500, "text/plain", "");   // el manejador no respondió
+    c.cpuNs += ahoraRealNs() - inicio;
+    c.respuesta->asignaciones = sim::asignaciones() - antes;
+    c.respuesta->picoBytes = sim::memoria().pico - vivos;
+}
+
+size_t AsyncWebServer::enviar(Conexion& c) {
+    AsyncWebServerResponse& r = *c.request->respuesta;
+    sim::RespuestaHttp& destino = *c.respuesta;
+    uint64_t inicio = ahoraRealNs();
+    size_t bytes = 0;
+
+    if (!destino.codigo) {
+        destino.codigo = r.codigo;
+        strlcpy(destino.tipo, r.tipo, sizeof(destino.tipo));
+        for (uint8_t i = 0; i < r.nCabeceras; ++i) {
+            destino.agregarCabecera(r.cabeceras[i].nombre, r.cabeceras[i].valor);
+            bytes += strlen(r.cabeceras[i].nombre) + strlen(r.cabeceras[i].valor) + 4;
+        }
+        if (r.largo == AsyncWebServerResponse::LARGO_DESCONOCIDO) destino.chunked = true;
+        else destino.largoDeclarado = r.largo;
+        bytes += 64;                                    // línea de estado y cabeceras fijas
+        destino.primerByteNs = c.cpuNs + (ahoraRealNs() - inicio);
+    }
+
+    uint8_t bloque[VENTANA];
+    bool fin = false;
+    while (bytes < VENTANA) {
+        size_t n = r.llenar(bloque, VENTANA - bytes, c.enviados);
+        if (!n) {
+            fin = true;
+            break;
+        }
+        ++destino.trozos;
+        {
+            sim::SinContar sinContar;
+            destino.cuerpo.append(reinterpret_cast<char*>(bloque), n);
+        }
+        c.enviados += n;
+        bytes += n;
+    }
+    if (fin || (r.largo != AsyncWebServerResponse::LARGO_DESCONOCIDO && c.enviados >= r.largo)) {
+        destino.completa = true;
+    }
+    c.cpuNs += ahoraRealNs() - inicio;
+    return bytes;
+}
+
+// Como el original: al cerrarse la conexión avisa a onDisconnect() y borra el
+// pedido junto con su respuesta
+void AsyncWebServer::cerrar(size_t i) {
+    AsyncWebServerRequest* request = conexiones[i].request;
+    for (size_t k = i + 1; k < nConexiones; ++k) conexiones[k - 1] = conexiones[k];
+    --nConexiones;
+    if (!request) return;
+    if (request->alDesconectar) request->alDesconectar();
+    delete request;
+}
@@ -0,0 +1,195 @@
+#ifndef WM_HOST_ESPASYNCWEBSERVER_H
+#define WM_HOST_ESPASYNCWEBSERVER_H
+
+/**
+ * @file  ESPAsyncWebServer.h
+ * @brief ESPAsyncWebServer sobre el cliente HTTP en proceso, con varias
+ *        conexiones abiertas a la vez.
+ *
+ * Cada atender() es una vuelta de la tarea de AsyncTCP: corre los manejadores
+ * de los pedidos nuevos y manda a cada conexión abierta hasta VENTANA bytes,
+ * como cuando llega el ACK del teléfono. Los manejadores corren con el handle
+ * de esa tarea (sim::ComoTarea). El aire del AP se cobra en el reloj virtual
+ * según sim::radio().apUsPorKb, compartido por todas las conexiones.
+ *
+ * Los objetos de la respuesta se crean con new, como en el original, y cuentan
+ * en memoria.cpp; el armado del pedido y lo recibido por el cliente no.
+ */
+
+#include <functional>
+#include "Arduino.h"
+#include "LittleFS.h"
+#include "WiFi.h"
+#include "simulador.h"
+
+enum WebRequestMethod : uint8_t {
+    HTTP_GET     = 0x01,
+    HTTP_POST    = 0x02,
+    HTTP_DELETE  = 0x04,
+    HTTP_PUT     = 0x08,
+    HTTP_PATCH   = 0x10,
+    HTTP_HEAD    = 0x20,
+    HTTP_OPTIONS = 0x40,
+    HTTP_ANY     = 0x7F
+};
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerRequest;
+typedef std::function<void(AsyncWebServerRequest*)>      ArRequestHandlerFunction;
+typedef std::function<size_t(uint8_t*, size_t, size_t)> AwsResponseFiller;
+typedef std::function<void()>                            ArDisconnectHandler;
+
+class AsyncWebParameter {
+public:
+    AsyncWebParameter(const String& nombre, const String& valor, bool post)
+    : nombre(nombre), valor(valor), post(post) {}
+    const String& name() const  { return nombre; }
+    const String& value() const { return valor; }
+    bool isPost() const         { return post; }
+
+private:
+    String nombre, valor;
+    bool   post;
+};
+
+class AsyncWebHeader {
+public:
+    AsyncWebHeader(const String& nombre, const String& valor) : nombre(nombre), valor(valor) {}
+    const String& name() const  { return nombre; }
+    const String& value() const { return valor; }
+
+private:
+    String nombre, valor;
+};
+
+class AsyncWebServerResponse {
+public:
+    virtual ~AsyncWebServerResponse() {}
+    void setCode(int c) { codigo = c; }
+    void addHeader(const String& nombre, const String& valor);
+
+protected:
+    friend class AsyncWebServer;
+    static constexpr size_t LARGO_DESCONOCIDO = static_cast<size_t>(-1);
+
+    /** Escribe desde el byte @p indice del cuerpo. @return 0 al terminar. */
+    virtual size_t llenar(uint8_t* destino, size_t capacidad, size_t indice) = 0;
+
+    int               codigo = 200;
+    char              tipo[64] = {0};
+    sim::CabeceraHttp cabeceras[16];
+    uint8_t           nCabeceras = 0;
+    size_t            largo = 0;          ///< LARGO_DESCONOCIDO = chunked
+};
+
+/** Cuerpo armado con write()/printf() antes de enviar, como el original (cbuf). */
+class AsyncResponseStream : public AsyncWebServerResponse {
+public:
+    explicit AsyncResponseStream(const char* tipoContenido);
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t* datos, size_t n);
+    size_t printf(const char* formato, ...) __attribute__((format(printf, 2, 3)));
+
+protected:
+    size_t llenar(uint8_t* destino, size_t capacidad, size_t indice) override;
+
+private:
+    std::string cuerpo;
+};
+
+class AsyncWebServerRequest {
+public:
+    WebRequestMethodComposite method() const { return metodo; }
+    const String& url() const                { return ruta; }
+
+    size_t params() const { return nParams; }
+    const AsyncWebParameter* getParam(size_t i) const { return i < nParams ? parametros[i] : nullptr; }
+    const AsyncWebParameter* getParam(const char* nombre, bool post = false) const;
+    bool hasParam(const char* nombre, bool post = false) const { return getParam(nombre, post) != nullptr; }
+    const String& arg(const char* nombre) const;
+    bool hasArg(const char* nombre) const;
+
+    const AsyncWebHeader* getHeader(const char* nombre) const;
+    bool hasHeader(const char* nombre) const { return getHeader(nombre) != nullptr; }
+
+    void send(AsyncWebServerResponse* respuesta);
+    void send(int codigo, const char* tipo = "", const char* contenido = "");
+    void send(int codigo, const String& tipo, const String& contenido) { send(codigo, tipo.c_str(), contenido.c_str()); }
+    void redirect(const char* url);
+
+    AsyncWebServerResponse* beginResponse(int codigo, const char* tipo = "", const char* contenido = "");
+    AsyncWebServerResponse* beginResponse(FS& fs, const String& ruta, const String& tipo = String(),
+                                          bool descarga = false);
+    AsyncWebServerResponse* beginResponse_P(int codigo, const String& tipo, const uint8_t* datos, size_t largo);
+    AsyncWebServerResponse* beginChunkedResponse(const String& tipo, AwsResponseFiller relleno);
+    AsyncResponseStream*    beginResponseStream(const String& tipo, size_t tamBufer = 1460);
+
+    void onDisconnect(ArDisconnectHandler fn) { alDesconectar = fn; }
+
+private:
+    friend class AsyncWebServer;
+    static constexpr size_t MAX_PARAMS = 16;
+    static constexpr size_t MAX_CABECERAS = 16;
+
+    AsyncWebServerRequest(const sim::PedidoHttp& pedido);
+    ~AsyncWebServerRequest();
+
+    WebRequestMethodComposite metodo;
+    String                    ruta;
+    AsyncWebParameter*        parametros[MAX_PARAMS];
+    size_t                    nParams = 0;
+    AsyncWebHeader*           cabeceras[MAX_CABECERAS];
+    size_t                    nCabeceras = 0;
+    AsyncWebServerResponse*   respuesta = nullptr;
+    ArDisconnectHandler       alDesconectar;
+};
+
+class AsyncWebServer : public sim::ServidorHttp {
+public:
+    static constexpr size_t MAX_RUTAS      = 12;
+    static constexpr size_t MAX_CONEXIONES = 32;
+    static constexpr size_t VENTANA        = 2 * 1436;   ///< dos segmentos por ACK
+
+    explicit AsyncWebServer(uint16_t puerto) : puerto(puerto) {}
+    ~AsyncWebServer();
+
+    void begin();
+    void on(const char* uri, WebRequestMethodComposite metodo, ArRequestHandlerFunction manejador);
+    void onNotFound(ArRequestHandlerFunction manejador) { noEncontrado = manejador; }
+
+    size_t abiertas() const { return nConexiones; }   ///< conexiones que todavía no terminaron
+
+    // sim::ServidorHttp
+    void entregar(const sim::PedidoHttp& pedido, sim::RespuestaHttp& respuesta) override;
+    void abandonar(sim::RespuestaHttp& respuesta) override;
+    void atender() override;
+
+private:
+    struct Ruta {
+        char                      uri[32];
+        WebRequestMethodComposite metodo;
+        ArRequestHandlerFunction  manejador;
+    };
+    struct Conexion {
+        const sim::PedidoHttp*  pedido;
+        sim::RespuestaHttp*     respuesta;
+        AsyncWebServerRequest*  request;
+        size_t                  enviados;     ///< bytes de cuerpo ya pedidos a la respuesta
+        uint64_t                llegadaUs;
+        uint64_t                cpuNs;
+    };
+
+    void   correrManejador(Conexion& c);
+    size_t enviar(Conexion& c);               ///< @return bytes enviados en esta vuelta
+    void   cerrar(size_t i);
+
+    uint16_t                 puerto;
+    bool                     iniciado = false;
+    Ruta                     rutas[MAX_RUTAS];
+    size_t                   nRutas = 0;
+    ArRequestHandlerFunction noEncontrado;
+    Conexion                 conexiones[MAX_CONEXIONES];
+    size_t                   nConexiones = 0;
+};
+
+#endif
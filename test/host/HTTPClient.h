@@ -0,0 +1,19 @@
+#ifndef WM_HOST_HTTPCLIENT_H
+#define WM_HOST_HTTPCLIENT_H
+
+#include "WiFi.h"
+
+/** GET de la sonda de Internet: devuelve el código que fija sim::internet(). */
+class HTTPClient {
+public:
+    void setConnectTimeout(int32_t ms) { timeoutMs = ms; }
+    void setTimeout(uint16_t ms)       { timeoutMs = ms; }
+    bool begin(WiFiClient& cliente, const char* host, uint16_t puerto, const char* uri);
+    int  GET();
+    void end() {}
+
+private:
+    int32_t timeoutMs = 5000;
+};
+
+#endif
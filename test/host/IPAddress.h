@@ -0,0 +1,34 @@
+#ifndef WM_HOST_IPADDRESS_H
+#define WM_HOST_IPADDRESS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "WString.h"
+
+/** IPv4 guardada como en el ESP32: uint32_t en orden de red (el primer octeto en el byte bajo). */
+class IPAddress {
+public:
+    IPAddress() : bytes{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+    IPAddress(uint32_t v) {
+        for (uint8_t i = 0; i < 4; ++i) bytes[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+
+    operator uint32_t() const {
+        return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+    uint8_t  operator[](int i) const { return bytes[i]; }
+    uint8_t& operator[](int i)       { return bytes[i]; }
+    bool operator==(const IPAddress& o) const { return static_cast<uint32_t>(*this) == static_cast<uint32_t>(o); }
+
+    String toString() const {
+        char t[16];
+        snprintf(t, sizeof(t), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+        return String(t);
+    }
+
+private:
+    uint8_t bytes[4];
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef WM_HOST_LITTLEFS_H
+#define WM_HOST_LITTLEFS_H
+
+/**
+ * @file  LittleFS.h
+ * @brief LittleFS en memoria (ver sim::fs()). Los archivos abiertos ocupan
+ *        lugares de una tabla fija, así abrir y leer no usa memoria dinámica y
+ *        no ensucia las mediciones de memoria.cpp.
+ */
+
+#include "Arduino.h"
+
+class File {
+public:
+    File() {}
+    File(const File& otro);
+    File& operator=(const File& otro);
+    ~File();
+
+    explicit operator bool() const { return lugar >= 0; }
+    size_t read(uint8_t* destino, size_t n);
+    int    read();
+    int    available();
+    size_t write(const uint8_t* datos, size_t n);
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t size() const;
+    bool   isDirectory() const;
+    String readString();
+    void   close();
+
+private:
+    friend class LittleFSFS;
+    explicit File(int lugar) : lugar(lugar) {}
+    int lugar = -1;
+};
+
+class LittleFSFS {
+public:
+    bool begin(bool formatearSiFalla = false);
+    bool exists(const char* ruta);
+    bool exists(const String& ruta) { return exists(ruta.c_str()); }
+    File open(const char* ruta, const char* modo = "r");
+    File open(const String& ruta, const char* modo = "r") { return open(ruta.c_str(), modo); }
+    bool remove(const char* ruta);
+    bool rename(const char* desde, const char* hacia);
+};
+extern LittleFSFS LittleFS;
+typedef LittleFSFS FS;
+
+#endif
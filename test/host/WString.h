@@ -0,0 +1,139 @@
+#ifndef WM_HOST_WSTRING_H
+#define WM_HOST_WSTRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @class String
+ * @brief String de Arduino para el host, con el mismo comportamiento de
+ *        memoria que el del ESP32: hasta SSO caracteres viven en el objeto y
+ *        recién más largos van al heap (con new[], así los cuenta memoria.cpp).
+ *
+ * Sólo lo que usan la librería y las pruebas.
+ */
+class String {
+public:
+    static constexpr size_t SSO = 11;   ///< caracteres que entran sin memoria dinámica
+
+    String() { sso[0] = '\0'; }
+    String(const char* s) { sso[0] = '\0'; asignar(s ? s : "", s ? strlen(s) : 0); }
+    String(const char* s, size_t n) { sso[0] = '\0'; asignar(s, n); }
+    String(const String& otro) { sso[0] = '\0'; asignar(otro.c_str(), otro.largo); }
+    String(String&& otro) { sso[0] = '\0'; mover(otro); }
+    explicit String(char c) { char t[2] = {c, '\0'}; sso[0] = '\0'; asignar(t, 1); }
+    explicit String(int v)           { desdeFormato("%d", v); }
+    explicit String(unsigned int v)  { desdeFormato("%u", v); }
+    explicit String(long v)          { desdeFormato("%ld", v); }
+    explicit String(unsigned long v) { desdeFormato("%lu", v); }
+    ~String() { liberar(); }
+
+    String& operator=(const String& otro) {
+        if (this != &otro) asignar(otro.c_str(), otro.largo);
+        return *this;
+    }
+    String& operator=(String&& otro) {
+        if (this != &otro) {
+            liberar();
+            mover(otro);
+        }
+        return *this;
+    }
+    String& operator=(const char* s) { asignar(s ? s : "", s ? strlen(s) : 0); return *this; }
+
+    String& operator+=(const String& s) { concatenar(s.c_str(), s.largo); return *this; }
+    String& operator+=(const char* s)   { concatenar(s, strlen(s)); return *this; }
+    String& operator+=(char c)          { concatenar(&c, 1); return *this; }
+
+    const char* c_str() const  { return heap ? heap : sso; }
+    size_t      length() const { return largo; }
+    bool        isEmpty() const { return largo == 0; }
+    char operator[](size_t i) const { return i < largo ? c_str()[i] : '\0'; }
+
+    int indexOf(const char* s) const {
+        const char* p = strstr(c_str(), s);
+        return p ? static_cast<int>(p - c_str()) : -1;
+    }
+    int indexOf(const String& s) const { return indexOf(s.c_str()); }
+    bool startsWith(const char* s) const { return strncmp(c_str(), s, strlen(s)) == 0; }
+    bool endsWith(const char* s) const {
+        size_t n = strlen(s);
+        return n <= largo && memcmp(c_str() + largo - n, s, n) == 0;
+    }
+    long toInt() const { return strtol(c_str(), nullptr, 10); }
+
+    bool operator==(const String& s) const { return largo == s.largo && memcmp(c_str(), s.c_str(), largo) == 0; }
+    bool operator==(const char* s) const   { return strcmp(c_str(), s ? s : "") == 0; }
+    bool operator!=(const String& s) const { return !(*this == s); }
+    bool operator!=(const char* s) const   { return !(*this == s); }
+
+private:
+    template <typename T>
+    void desdeFormato(const char* formato, T v) {
+        char t[24];
+        int n = snprintf(t, sizeof(t), formato, v);
+        sso[0] = '\0';
+        asignar(t, static_cast<size_t>(n));
+    }
+
+    void reservar(size_t n) {
+        if (n <= SSO || n <= capacidad) return;
+        char* nuevo = new char[n + 1];
+        memcpy(nuevo, c_str(), largo + 1);
+        delete[] heap;
+        heap = nuevo;
+        capacidad = n;
+    }
+
+    void asignar(const char* s, size_t n) {
+        if (n > SSO && n > capacidad) {
+            char* nuevo = new char[n + 1];
+            delete[] heap;
+            heap = nuevo;
+            capacidad = n;
+        }
+        char* destino = heap ? heap : sso;
+        memmove(destino, s, n);
+        destino[n] = '\0';
+        largo = n;
+    }
+
+    void concatenar(const char* s, size_t n) {
+        reservar(largo + n);
+        char* destino = heap ? heap : sso;
+        memcpy(destino + largo, s, n);
+        largo += n;
+        destino[largo] = '\0';
+    }
+
+    void mover(String& otro) {
+        heap = otro.heap;
+        capacidad = otro.capacidad;
+        largo = otro.largo;
+        memcpy(sso, otro.sso, sizeof(sso));
+        otro.heap = nullptr;
+        otro.capacidad = 0;
+        otro.largo = 0;
+        otro.sso[0] = '\0';
+    }
+
+    void liberar() {
+        delete[] heap;
+        heap = nullptr;
+        capacidad = 0;
+    }
+
+    char   sso[SSO + 1];
+    char*  heap = nullptr;
+    size_t capacidad = 0;
+    size_t largo = 0;
+};
+
+inline String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, const char* b)   { String r(a); r += b; return r; }
+inline String operator+(const char* a, const String& b)   { String r(a); r += b; return r; }
+
+#endif
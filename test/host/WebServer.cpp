@@ -0,0 +1,224 @@
+/**
+ * @file  WebServer.cpp
+ * @brief WebServer simulado: cola de pedidos del cliente en proceso y
+ *        respuesta escrita directo en sim::RespuestaHttp.
+ *
+ * Armar el pedido y guardar lo enviado es trabajo del servidor, no de la
+ * librería: se hace dentro de sim::SinContar para que las mediciones de
+ * memoria muestren sólo lo que reservan los manejadores.
+ */
+
+#include "WebServer.h"
+
+#include <chrono>
+#include <strings.h>
+
+static uint64_t ahoraRealNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static const String& vacio() {
+    static const String nada;
+    return nada;
+}
+
+WebServer::WebServer(int puerto) : puerto(puerto) {}
+
+WebServer::~WebServer() {
+    sim::retirarServidor(this);
+}
+
+void WebServer::begin() {
+    iniciado = true;
+    sim::publicarServidor(static_cast<uint16_t>(puerto), this);
+}
+
+void WebServer::on(const char* uri, THandlerFunction manejador) {
+    on(uri, HTTP_ANY, manejador);
+}
+
+void WebServer::on(const char* uri, HTTPMethod metodo, THandlerFunction manejador) {
+    if (nRutas >= MAX_RUTAS) {
+        fprintf(stderr, "WebServer: demasiadas rutas (%s)\n", uri);
+        return;
+    }
+    Ruta& r = rutas[nRutas++];
+    strlcpy(r.uri, uri, sizeof(r.uri));
+    r.metodo = metodo;
+    r.manejador = manejador;
+}
+
+void WebServer::onNotFound(THandlerFunction manejador) {
+    noEncontrado = manejador;
+}
+
+void WebServer::collectHeaders(const char* nombres[], size_t cantidad) {
+    nRecolectar = 0;
+    for (size_t i = 0; i < cantidad && nRecolectar < MAX_CABECERAS; ++i) recolectar[nRecolectar++] = nombres[i];
+}
+
+TextoPedido WebServer::arg(int i) const {
+    return i >= 0 && static_cast<size_t>(i) < nArgs ? valoresArgs[i] : vacio();
+}
+
+TextoPedido WebServer::argName(int i) const {
+    return i >= 0 && static_cast<size_t>(i) < nArgs ? nombresArgs[i] : vacio();
+}
+
+TextoPedido WebServer::arg(const String& nombre) const {
+    for (size_t i = 0; i < nArgs; ++i) {
+        if (nombresArgs[i] == nombre) return valoresArgs[i];
+    }
+    return vacio();
+}
+
+bool WebServer::hasArg(const String& nombre) const {
+    for (size_t i = 0; i < nArgs; ++i) {
+        if (nombresArgs[i] == nombre) return true;
+    }
+    return false;
+}
+
+TextoPedido WebServer::header(const String& nombre) const {
+    for (size_t i = 0; i < nRecolectar; ++i) {
+        if (strcasecmp(recolectar[i].c_str(), nombre.c_str()) == 0) return valoresCabeceras[i];
+    }
+    return vacio();
+}
+
+bool WebServer::hasHeader(const String& nombre) const {
+    return header(nombre).length() > 0;
+}
+
+void WebServer::sendHeader(const String& nombre, const String& valor, bool) {
+    if (actual) actual->agregarCabecera(nombre.c_str(), valor.c_str());
+}
+
+void WebServer::marcarPrimerByte() {
+    if (actual->primerByteNs) return;
+    actual->primerByteNs = ahoraRealNs() - inicioNs;
+    actual->primerByteUs = sim::ahoraUs() - inicioUs;
+}
+
+void WebServer::empezar(int codigo, const char* tipo) {
+    if (!actual) return;
+    marcarPrimerByte();
+    actual->codigo = codigo;
+    strlcpy(actual->tipo, tipo ? tipo : "", sizeof(actual->tipo));
+    cabecerasEnviadas = true;
+}
+
+void WebServer::escribirCuerpo(const char* datos, size_t largo) {
+    if (!actual || !largo) return;
+    sim::SinContar sinContar;
+    actual->cuerpo.append(datos, largo);
+}
+
+void WebServer::send(int codigo, const char* tipo, const String& contenido) {
+    send(codigo, tipo, contenido.c_str());
+}
+
+void WebServer::send(int codigo, const char* tipo, const char* contenido) {
+    if (!actual) return;
+    size_t largo = contenido ? strlen(contenido) : 0;
+    empezar(codigo, tipo);
+    if (largoContenido == CONTENT_LENGTH_UNKNOWN) {
+        actual->chunked = true;
+    } else {
+        actual->largoDeclarado = largoContenido == CONTENT_LENGTH_NOT_SET ? largo : largoContenido;
+    }
+    escribirCuerpo(contenido, largo);
+}
+
+void WebServer::send_P(int codigo, PGM_P tipo, PGM_P contenido, size_t largo) {
+    if (!actual) return;
+    empezar(codigo, tipo);
+    actual->largoDeclarado = largo;
+    escribirCuerpo(contenido, largo);
+}
+
+void WebServer::sendContent(const String& contenido) {
+    sendContent(contenido.c_str(), contenido.length());
+}
+
+void WebServer::sendContent(const char* contenido, size_t largo) {
+    if (!actual) return;
+    marcarPrimerByte();
+    ++actual->trozos;
+    escribirCuerpo(contenido, largo);
+}
+
+void WebServer::entregar(const sim::PedidoHttp& pedido, sim::RespuestaHttp& respuesta) {
+    if (!iniciado || nPendientes >= MAX_PENDIENTES) {
+        respuesta.codigo = -1;
+        respuesta.completa = true;
+        return;
+    }
+    pendientes[nPendientes].pedido = &pedido;
+    pendientes[nPendientes].respuesta = &respuesta;
+    ++nPendientes;
+}
+
+void WebServer::abandonar(sim::RespuestaHttp& respuesta) {
+    for (size_t i = 0; i < nPendientes; ++i) {
+        if (pendientes[i].respuesta != &respuesta) continue;
+        for (size_t k = i + 1; k < nPendientes; ++k) pendientes[k - 1] = pendientes[k];
+        --nPendientes;
+        return;
+    }
+}
+
+void WebServer::handleClient() {
+    if (!nPendientes) return;
+    Pendiente p = pendientes[0];
+    for (size_t k = 1; k < nPendientes; ++k) pendientes[k - 1] = pendientes[k];
+    --nPendientes;
+
+    THandlerFunction* manejador = nullptr;
+    {
+        sim::SinContar sinContar;
+        const sim::PedidoHttp& pedido = *p.pedido;
+        metodo = pedido.metodo == sim::Metodo::POST ? HTTP_POST : HTTP_GET;
+        ruta = pedido.ruta.c_str();
+        nArgs = 0;
+        for (size_t i = 0; i < pedido.args.size() && nArgs < MAX_ARGS; ++i, ++nArgs) {
+            nombresArgs[nArgs] = pedido.args[i].first.c_str();
+            valoresArgs[nArgs] = pedido.args[i].second.c_str();
+        }
+        for (size_t i = 0; i < nRecolectar; ++i) {
+            valoresCabeceras[i] = "";
+            for (const auto& c : pedido.cabeceras) {
+                if (strcasecmp(c.first.c_str(), recolectar[i].c_str()) == 0) valoresCabeceras[i] = c.second.c_str();
+            }
+        }
+        for (size_t i = 0; i < nRutas; ++i) {
+            if (strcmp(rutas[i].uri, pedido.ruta.c_str()) != 0) continue;
+            if (rutas[i].metodo != HTTP_ANY && rutas[i].metodo != metodo) continue;
+            manejador = &rutas[i].manejador;
+            break;
+        }
+        if (!manejador && noEncontrado) manejador = &noEncontrado;
+    }
+
+    actual = p.respuesta;
+    largoContenido = CONTENT_LENGTH_NOT_SET;
+    cabecerasEnviadas = false;
+
+    uint64_t antes = sim::asignaciones();
+    int64_t vivos = sim::marcarPico();
+    inicioUs = sim::ahoraUs();
+    inicioNs = ahoraRealNs();
+    if (manejador) (*manejador)();
+    else send(404, "text/plain", "Not found");
+    actual->totalNs = ahoraRealNs() - inicioNs;
+    actual->totalUs = sim::ahoraUs() - inicioUs;
+    actual->asignaciones = sim::asignaciones() - antes;
+    actual->picoBytes = sim::memoria().pico - vivos;
+
+    if (!cabecerasEnviadas) {
+        actual->codigo = 500;                           // el manejador no respondió
+    }
+    actual->completa = true;
+    actual = nullptr;
+}
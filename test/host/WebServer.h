@@ -0,0 +1,123 @@
+#ifndef WM_HOST_WEBSERVER_H
+#define WM_HOST_WEBSERVER_H
+
+/**
+ * @file  WebServer.h
+ * @brief WebServer de Arduino-ESP32 (API 3.x o 2.x) sobre el cliente HTTP en proceso.
+ *
+ * Los pedidos de sim::ClienteHttp quedan en cola y los atiende handleClient(),
+ * uno por llamada, como el original. Las firmas son las de 3.x (arg() y
+ * header() devuelven const String&): lo que se pase como const char* donde se
+ * espera String crea un temporal, igual que en el dispositivo, y memoria.cpp
+ * lo cuenta. Con WM_HOST_CORE2 devuelven un String por valor, como en 2.x:
+ * un c_str() guardado más allá de la expresión apunta a un temporal ya
+ * liberado (memoria.cpp lo pisa al liberar). El guardado interno usa búferes
+ * fijos para que las mediciones de memoria reflejen sólo a quien llama.
+ */
+
+#include <functional>
+#include "Arduino.h"
+#include "simulador.h"
+
+enum HTTPMethod {
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS
+};
+
+#if WM_HOST_CORE2
+typedef String        TextoPedido;      ///< 2.x: arg(), argName() y header() copian
+#else
+typedef const String& TextoPedido;      ///< 3.x: devuelven referencias
+#endif
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+class WebServer : public sim::ServidorHttp {
+public:
+    typedef std::function<void()> THandlerFunction;
+
+    static constexpr size_t MAX_RUTAS = 12;
+    static constexpr size_t MAX_ARGS  = 16;
+    static constexpr size_t MAX_CABECERAS = 8;
+    static constexpr size_t MAX_PENDIENTES = 32;
+
+    explicit WebServer(int puerto = 80);
+    ~WebServer();
+
+    void begin();
+    void handleClient();
+
+    void on(const char* uri, THandlerFunction manejador);
+    void on(const char* uri, HTTPMethod metodo, THandlerFunction manejador);
+    void onNotFound(THandlerFunction manejador);
+    void collectHeaders(const char* nombres[], size_t cantidad);
+
+    HTTPMethod    method() const { return metodo; }
+    const String& uri() const    { return ruta; }
+    int           args() const   { return static_cast<int>(nArgs); }
+    TextoPedido   arg(int i) const;
+    TextoPedido   argName(int i) const;
+    TextoPedido   arg(const String& nombre) const;
+    bool          hasArg(const String& nombre) const;
+    TextoPedido   header(const String& nombre) const;
+    bool          hasHeader(const String& nombre) const;
+
+    void setContentLength(size_t largo) { largoContenido = largo; }
+    void sendHeader(const String& nombre, const String& valor, bool primero = false);
+    void send(int codigo, const char* tipo = nullptr, const String& contenido = String());
+    void send(int codigo, const char* tipo, const char* contenido);
+    void send_P(int codigo, PGM_P tipo, PGM_P contenido, size_t largo);
+    void sendContent(const String& contenido);
+    void sendContent(const char* contenido, size_t largo);
+
+    // sim::ServidorHttp
+    void entregar(const sim::PedidoHttp& pedido, sim::RespuestaHttp& respuesta) override;
+    void abandonar(sim::RespuestaHttp& respuesta) override;
+
+private:
+    struct Ruta {
+        char             uri[32];
+        HTTPMethod       metodo;
+        THandlerFunction manejador;
+    };
+    struct Pendiente {
+        const sim::PedidoHttp* pedido;
+        sim::RespuestaHttp*    respuesta;
+    };
+
+    void escribirCuerpo(const char* datos, size_t largo);
+    void empezar(int codigo, const char* tipo);
+    void marcarPrimerByte();
+
+    int      puerto;
+    bool     iniciado = false;
+    Ruta     rutas[MAX_RUTAS];
+    size_t   nRutas = 0;
+    THandlerFunction noEncontrado;
+    String   recolectar[MAX_CABECERAS];
+    size_t   nRecolectar = 0;
+    Pendiente pendientes[MAX_PENDIENTES];
+    size_t   nPendientes = 0;
+
+    // Pedido en curso (se arma antes de llamar al manejador)
+    HTTPMethod metodo = HTTP_GET;
+    String   ruta;
+    String   nombresArgs[MAX_ARGS];
+    String   valoresArgs[MAX_ARGS];
+    size_t   nArgs = 0;
+    String   valoresCabeceras[MAX_CABECERAS];
+    sim::RespuestaHttp* actual = nullptr;
+    size_t   largoContenido = CONTENT_LENGTH_NOT_SET;
+    bool     cabecerasEnviadas = false;
+    uint64_t inicioNs = 0;
+    uint64_t inicioUs = 0;
+};
+
+#endif
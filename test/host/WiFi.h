@@ -0,0 +1,103 @@
+#ifndef WM_HOST_WIFI_H
+#define WM_HOST_WIFI_H
+
+/**
+ * @file  WiFi.h
+ * @brief WiFi de Arduino-ESP32 sobre la radio simulada.
+ *
+ * Los eventos del driver (asociación, IP, fin de escaneo) no llegan al
+ * llamar: quedan agendados en el reloj virtual y los entrega sim::avanzar(),
+ * como lo haría la tarea de eventos. Tiempos y fallos se ajustan con
+ * sim::radio() y los AP con sim::agregarAp().
+ */
+
+#include <functional>
+#include "Arduino.h"
+#include "esp_wifi_types.h"
+
+typedef size_t wifi_event_id_t;
+
+enum wl_status_t {
+    WL_IDLE_STATUS    = 0,
+    WL_NO_SSID_AVAIL  = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED      = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED   = 6
+};
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED  (-2)
+
+enum wifi_power_t {
+    WIFI_POWER_19_5dBm = 78,
+    WIFI_POWER_17dBm   = 68,
+    WIFI_POWER_13dBm   = 52,
+    WIFI_POWER_2dBm    = 8
+};
+
+typedef enum {
+    WIFI_LOG_NONE,
+    WIFI_LOG_ERROR
+} wifi_log_level_t;
+
+typedef std::function<void(arduino_event_id_t evento, arduino_event_info_t info)> WiFiEventFuncCb;
+
+class WiFiClass {
+public:
+    // -------- modo y STA --------
+    bool        mode(wifi_mode_t modo);
+    wifi_mode_t getMode();
+    wl_status_t begin(const char* ssid, const char* clave = nullptr, int32_t canal = 0,
+                      const uint8_t* bssid = nullptr, bool conectar = true);
+    bool        disconnect(bool apagar = false, bool borrarAp = false);
+    bool        config(IPAddress ip, IPAddress gateway, IPAddress mascara,
+                       IPAddress dns1 = IPAddress(), IPAddress dns2 = IPAddress());
+    wl_status_t status();
+    bool        setAutoReconnect(bool habilitado);
+    bool        getAutoReconnect();
+    bool        setSleep(wifi_ps_type_t modo);
+    bool        setTxPower(wifi_power_t potencia);
+    void        setLogLevel(wifi_log_level_t) {}
+
+    // -------- datos del enlace --------
+    int8_t         RSSI();
+    const uint8_t* BSSID();
+    int32_t        channel();
+    String         SSID();
+    IPAddress      localIP();
+    IPAddress      gatewayIP();
+    IPAddress      subnetMask();
+    IPAddress      dnsIP(uint8_t i = 0);
+
+    // -------- AP --------
+    bool      softAP(const char* ssid, const char* clave = nullptr);
+    IPAddress softAPIP();
+
+    // -------- escaneo --------
+    int16_t scanNetworks(bool async = false, bool ocultas = false, bool pasivo = false,
+                         uint32_t msPorCanal = 300, uint8_t canal = 0, const char* ssid = nullptr,
+                         const uint8_t* bssid = nullptr);
+    int16_t scanComplete();
+    void    scanDelete();
+    void*   getScanInfoByIndex(int i);
+    String  SSID(uint8_t i);
+    int32_t RSSI(uint8_t i);
+    wifi_auth_mode_t encryptionType(uint8_t i);
+
+    // -------- eventos y DNS --------
+    wifi_event_id_t onEvent(WiFiEventFuncCb callback);
+    void            removeEvent(wifi_event_id_t id);
+    int             hostByName(const char* host, IPAddress& resultado);
+};
+extern WiFiClass WiFi;
+
+/** Conexión TCP de la sonda de Internet: responde según sim::internet(). */
+class WiFiClient {
+public:
+    bool connect(const char* host, uint16_t puerto, int32_t timeoutMs = 3000);
+    void stop() {}
+};
+
+#endif
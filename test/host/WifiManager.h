@@ -0,0 +1,4 @@
+// wifimanager.cpp incluye "WifiManager.h" (así se llama en la librería
+// publicada); en un sistema de archivos que distingue mayúsculas hace falta
+// este puente.
+#include "wifimanager.h"
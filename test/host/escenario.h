@@ -0,0 +1,58 @@
+#ifndef WM_HOST_ESCENARIO_H
+#define WM_HOST_ESCENARIO_H
+
+/**
+ * @file  escenario.h
+ * @brief Atajos de las pruebas para armar situaciones con el WifiManager real.
+ */
+
+#include <stdio.h>
+#include <string>
+#include "WifiManager.h"
+#include "simulador.h"
+
+namespace escenario {
+
+/** Deja /wifi.bin con la red guardada, como si se hubiera usado el portal antes. */
+inline void guardarRed(const char* ssid, const char* clave) {
+    WifiManager previo;
+    previo.begin();
+    previo.agregarRed(ssid, clave);
+}
+
+/** Llama update() cada @p pasoMs hasta llegar a ONLINE. @return ms, o -1 */
+inline int32_t hastaOnline(WifiManager& wm, uint32_t maxMs, uint32_t pasoMs = 10) {
+    return sim::hasta([&wm]() { return wm.getEstado() == EstadoWiFi::ONLINE; },
+                      [&wm]() { wm.update(); }, maxMs, pasoMs);
+}
+
+/** Llama update() hasta que la máquina quede en @p estado. @return ms, o -1 */
+inline int32_t hastaEstado(WifiManager& wm, EstadoWiFi estado, uint32_t maxMs, uint32_t pasoMs = 10) {
+    return sim::hasta([&wm, estado]() { return wm.getEstado() == estado; },
+                      [&wm]() { wm.update(); }, maxMs, pasoMs);
+}
+
+/** Portal abierto sin credenciales: AP, DNS y servidor listos para pedidos. */
+inline void abrirPortal(WifiManager& wm) {
+    wm.begin();
+    wm.run();
+}
+
+#ifdef WM_DATOS
+/** Lee una página de data/wifimanager del repositorio (no de LittleFS). */
+inline std::string paginaDelRepo(const char* nombre) {
+    std::string ruta = std::string(WM_DATOS) + "/" + nombre;
+    std::string contenido;
+    FILE* f = fopen(ruta.c_str(), "rb");
+    if (!f) return contenido;
+    char bloque[1024];
+    size_t n;
+    while ((n = fread(bloque, 1, sizeof(bloque), f)) > 0) contenido.append(bloque, n);
+    fclose(f);
+    return contenido;
+}
+#endif
+
+} // namespace escenario
+
+#endif
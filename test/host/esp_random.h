@@ -0,0 +1,8 @@
+#ifndef WM_HOST_ESP_RANDOM_H
+#define WM_HOST_ESP_RANDOM_H
+
+#include <stdint.h>
+
+uint32_t esp_random();      ///< generador del simulador: reproducible con sim::semilla()
+
+#endif
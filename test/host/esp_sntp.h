@@ -0,0 +1,13 @@
+#ifndef WM_HOST_ESP_SNTP_H
+#define WM_HOST_ESP_SNTP_H
+
+#include <sys/time.h>
+
+typedef void (*sntp_sync_time_cb_t)(struct timeval* tv);
+
+/** El simulador guarda el callback; sim::sincronizarNtp() lo dispara. */
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback);
+void configTime(long gmtOffset, int daylightOffset, const char* servidor1,
+                const char* servidor2 = nullptr, const char* servidor3 = nullptr);
+
+#endif
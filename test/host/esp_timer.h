@@ -0,0 +1,8 @@
+#ifndef WM_HOST_ESP_TIMER_H
+#define WM_HOST_ESP_TIMER_H
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time();   ///< µs del reloj virtual
+
+#endif
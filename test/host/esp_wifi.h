@@ -0,0 +1,10 @@
+#ifndef WM_HOST_ESP_WIFI_H
+#define WM_HOST_ESP_WIFI_H
+
+#include "esp_wifi_types.h"
+
+esp_err_t esp_wifi_get_config(wifi_interface_t interfaz, wifi_config_t* config);
+esp_err_t esp_wifi_set_config(wifi_interface_t interfaz, wifi_config_t* config);
+esp_err_t esp_wifi_connect();
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef WM_HOST_FREERTOS_H
+#define WM_HOST_FREERTOS_H
+
+// Tipos y macros de FreeRTOS que usa la librería. Las tareas no corren: el
+// simulador las registra (ver sim::tareas()) y las pruebas deciden qué
+// ejecutar y desde qué tarea (sim::ComoTarea).
+
+#include <stdint.h>
+
+typedef int32_t  BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void*    TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdPASS            1
+#define pdFAIL            0
+#define pdTRUE            1
+#define pdFALSE           0
+#define portMAX_DELAY     0xFFFFFFFFu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) static_cast<TickType_t>(ms)
+#define tskNO_AFFINITY    0x7FFFFFFF
+
+#endif
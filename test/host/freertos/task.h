@@ -0,0 +1,15 @@
+#ifndef WM_HOST_FREERTOS_TASK_H
+#define WM_HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+BaseType_t   xTaskCreate(TaskFunction_t funcion, const char* nombre, uint32_t pila, void* arg,
+                         UBaseType_t prioridad, TaskHandle_t* handle);
+BaseType_t   xTaskCreatePinnedToCore(TaskFunction_t funcion, const char* nombre, uint32_t pila, void* arg,
+                                     UBaseType_t prioridad, TaskHandle_t* handle, BaseType_t nucleo);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+void         xTaskNotifyGive(TaskHandle_t tarea);
+uint32_t     ulTaskNotifyTake(BaseType_t limpiar, TickType_t espera);
+void         vTaskDelete(TaskHandle_t tarea);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef WM_HOST_LWIP_SOCKETS_H
+#define WM_HOST_LWIP_SOCKETS_H
+
+// En Linux la API de sockets de lwIP es la de POSIX: DnsCautivo usa sockets reales.
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#endif
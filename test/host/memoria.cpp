@@ -0,0 +1,93 @@
+/**
+ * @file  memoria.cpp
+ * @brief Reemplaza new/delete globales para contar la memoria dinámica de la
+ *        librería (y de los String que crea). Cada bloque lleva delante su
+ *        tamaño, así se sabe cuánto queda vivo y cuál fue el pico.
+ */
+
+#include <atomic>
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simulador.h"
+
+namespace {
+
+std::atomic<uint64_t> asignacionesTotales(0);
+std::atomic<uint64_t> liberacionesTotales(0);
+std::atomic<int64_t>  vivos(0);
+std::atomic<int64_t>  pico(0);
+thread_local int      sinContar = 0;
+
+const size_t CABECERA = 16;     // mantiene la alineación de malloc
+
+void* reservar(size_t n) {
+    unsigned char* p = static_cast<unsigned char*>(malloc(n + CABECERA));
+    if (!p) return nullptr;
+    *reinterpret_cast<size_t*>(p) = n;
+    // Los bloques del simulador se marcan para no descontarlos al liberar
+    p[sizeof(size_t)] = sinContar ? 0 : 1;
+    if (!sinContar) {
+        ++asignacionesTotales;
+        int64_t ahora = vivos += static_cast<int64_t>(n);
+        int64_t anterior = pico.load();
+        while (ahora > anterior && !pico.compare_exchange_weak(anterior, ahora)) {}
+    }
+    return p + CABECERA;
+}
+
+void liberar(void* q) {
+    if (!q) return;
+    unsigned char* p = static_cast<unsigned char*>(q) - CABECERA;
+    size_t n = *reinterpret_cast<size_t*>(p);
+    if (p[sizeof(size_t)]) {
+        ++liberacionesTotales;
+        vivos -= static_cast<int64_t>(n);
+    }
+    memset(q, 0xA5, n);         // quien lea un bloque ya liberado ve basura, no lo que había
+    free(p);
+}
+
+void* reservarOFallar(size_t n) {
+    void* p = reservar(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+} // namespace
+
+namespace sim {
+
+Memoria memoria() {
+    Memoria m;
+    m.asignaciones = asignacionesTotales.load();
+    m.liberaciones = liberacionesTotales.load();
+    m.bytesVivos   = vivos.load();
+    m.pico         = pico.load();
+    return m;
+}
+
+uint64_t asignaciones() { return asignacionesTotales.load(); }
+
+int64_t marcarPico() {
+    int64_t ahora = vivos.load();
+    pico.store(ahora);
+    return ahora;
+}
+
+SinContar::SinContar()  { ++sinContar; }
+SinContar::~SinContar() { --sinContar; }
+
+} // namespace sim
+
+void* operator new(size_t n)                                 { return reservarOFallar(n); }
+void* operator new[](size_t n)                               { return reservarOFallar(n); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept   { return reservar(n); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { return reservar(n); }
+void  operator delete(void* p) noexcept                      { liberar(p); }
+void  operator delete[](void* p) noexcept                    { liberar(p); }
+void  operator delete(void* p, size_t) noexcept              { liberar(p); }
+void  operator delete[](void* p, size_t) noexcept            { liberar(p); }
+void  operator delete(void* p, const std::nothrow_t&) noexcept   { liberar(p); }
+void  operator delete[](void* p, const std::nothrow_t&) noexcept { liberar(p); }
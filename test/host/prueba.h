@@ -0,0 +1,144 @@
+#ifndef WM_HOST_PRUEBA_H
+#define WM_HOST_PRUEBA_H
+
+/**
+ * @file  prueba.h
+ * @brief Mini marco de pruebas del host: PRUEBA() registra, VERIFICAR*()
+ *        comprueba y medir() publica un resultado de benchmark.
+ *
+ * Cada prueba arranca con sim::reiniciar(). El ejecutable acepta como
+ * argumento un filtro (subcadena del nombre) y devuelve la cantidad de
+ * pruebas fallidas. medir() escribe "BENCH <nombre> <valor> <unidad>" en
+ * stdout y, si está definida WM_BENCH_SALIDA, agrega la línea a ese archivo
+ * (lo junta la CI).
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "simulador.h"
+
+namespace prueba {
+
+typedef void (*Funcion)();
+
+struct Registro {
+    const char* nombre;
+    Funcion     funcion;
+};
+
+inline std::vector<Registro>& registros() {
+    static std::vector<Registro> r;
+    return r;
+}
+
+inline int& fallosActuales() {
+    static int n = 0;
+    return n;
+}
+
+struct Registrar {
+    Registrar(const char* nombre, Funcion f) { registros().push_back(Registro{nombre, f}); }
+};
+
+inline void fallar(const char* archivo, int linea, const char* texto) {
+    printf("    FALLÓ %s:%d: %s\n", archivo, linea, texto);
+    ++fallosActuales();
+}
+
+inline void medir(const char* nombre, double valor, const char* unidad) {
+    printf("BENCH %s %.3f %s\n", nombre, valor, unidad);
+    const char* ruta = getenv("WM_BENCH_SALIDA");
+    if (!ruta) return;
+    FILE* f = fopen(ruta, "a");
+    if (!f) return;
+    fprintf(f, "%s %.3f %s\n", nombre, valor, unidad);
+    fclose(f);
+}
+
+/** Repeticiones de los benchmarks: WM_BENCH_REPETICIONES o @p porDefecto. */
+inline int repeticiones(int porDefecto) {
+    const char* v = getenv("WM_BENCH_REPETICIONES");
+    int n = v ? atoi(v) : 0;
+    return n > 0 ? n : porDefecto;
+}
+
+/**
+ * Pila que usa @p f, aproximada: pinta una zona por debajo del marco actual,
+ * llama @p f y busca hasta dónde se pisó el patrón. Sirve para comparar dos
+ * caminos entre sí (el error es el mismo para ambos), no como valor absoluto.
+ */
+template <typename F>
+__attribute__((noinline)) size_t pilaUsada(F f) {
+    const size_t MARGEN = 512, ZONA = 32 * 1024;
+    volatile uint8_t* bajo = static_cast<uint8_t*>(__builtin_frame_address(0)) - MARGEN - ZONA;
+    for (size_t i = 0; i < ZONA; ++i) bajo[i] = 0xA5;      // sin llamadas: no hay marcos en la zona
+    f();
+    size_t i = 0;
+    while (i < ZONA && bajo[i] == 0xA5) ++i;
+    return ZONA - i;
+}
+
+inline int correr(int argc, char** argv) {
+    const char* filtro = argc > 1 ? argv[1] : nullptr;
+    int fallidas = 0, corridas = 0;
+    for (const Registro& r : registros()) {
+        if (filtro && !strstr(r.nombre, filtro)) continue;
+        sim::reiniciar();
+        fallosActuales() = 0;
+        printf("[ CORRE ] %s\n", r.nombre);
+        fflush(stdout);
+        r.funcion();
+        ++corridas;
+        if (fallosActuales()) {
+            ++fallidas;
+            printf("[ FALLA ] %s\n", r.nombre);
+        } else {
+            printf("[  OK   ] %s\n", r.nombre);
+        }
+    }
+    printf("%d pruebas, %d fallidas\n", corridas, fallidas);
+    return fallidas;
+}
+
+} // namespace prueba
+
+#define PRUEBA(nombre)                                                   \
+    static void nombre();                                                \
+    static prueba::Registrar registro_##nombre(#nombre, &nombre);        \
+    static void nombre()
+
+#define VERIFICAR(cond)                                                  \
+    do {                                                                 \
+        if (!(cond)) prueba::fallar(__FILE__, __LINE__, #cond);          \
+    } while (0)
+
+#define VERIFICAR_IGUAL(a, b)                                            \
+    do {                                                                 \
+        long long va_ = static_cast<long long>(a);                       \
+        long long vb_ = static_cast<long long>(b);                       \
+        if (va_ != vb_) {                                                \
+            char t_[256];                                                \
+            snprintf(t_, sizeof(t_), "%s == %s (%lld != %lld)", #a, #b, va_, vb_); \
+            prueba::fallar(__FILE__, __LINE__, t_);                      \
+        }                                                                \
+    } while (0)
+
+#define VERIFICAR_TEXTO(a, b)                                            \
+    do {                                                                 \
+        const char* ta_ = (a);                                           \
+        const char* tb_ = (b);                                           \
+        if (!ta_ || !tb_ || strcmp(ta_, tb_) != 0) {                     \
+            char t_[512];                                                \
+            snprintf(t_, sizeof(t_), "%s == %s (\"%s\" != \"%s\")", #a, #b, \
+                     ta_ ? ta_ : "(null)", tb_ ? tb_ : "(null)");        \
+            prueba::fallar(__FILE__, __LINE__, t_);                      \
+        }                                                                \
+    } while (0)
+
+#define PRUEBAS_MAIN()                                                   \
+    int main(int argc, char** argv) { return prueba::correr(argc, argv); }
+
+#endif
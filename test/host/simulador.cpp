@@ -0,0 +1,1239 @@
+/**
+ * @file  simulador.cpp
+ * @brief Reloj virtual, radio simulada y las implementaciones de los mocks
+ *        (WiFi, esp_wifi, LittleFS, FreeRTOS, Arduino y la HAL de la librería).
+ *
+ * Lo que la librería llama en su camino normal (getters de WiFi, lectura de
+ * archivos, eventos) no reserva memoria: los eventos y los resultados del
+ * escaneo viven en tablas fijas y el resto se hace dentro de sim::SinContar.
+ */
+
+#include "simulador.h"
+
+#include <stdarg.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <sys/time.h>
+
+#include "Arduino.h"
+#include "WiFi.h"
+#include "esp_wifi.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "esp_sntp.h"
+#include "HTTPClient.h"
+#include "LittleFS.h"
+#include "wifimanager_hal.h"
+
+namespace sim {
+
+namespace {
+
+// -------- eventos agendados --------
+enum class TipoEvento : uint8_t {
+    ASOCIADA,           // a = AP
+    IP,
+    DESCONECTADA,       // a = motivo
+    FIN_ESCANEO,
+    CLIENTE_AP          // a = entra
+};
+
+struct Evento {
+    uint64_t   cuando;
+    uint32_t   orden;
+    uint32_t   intento;     // se descarta si la STA empezó otro intento
+    TipoEvento tipo;
+    int32_t    a;
+};
+
+const size_t MAX_EVENTOS = 64;
+const size_t MAX_RESULTADOS = 128;
+const size_t MAX_CALLBACKS = 4;
+const size_t MAX_ARCHIVOS_ABIERTOS = 8;
+const size_t MAX_SERVIDORES = 4;
+const void*  TAREA_LOOP = reinterpret_cast<void*>(0x100);
+
+enum class EstadoSta : uint8_t { LIBRE, ASOCIANDO, ASOCIADA };
+
+struct Estado {
+    uint64_t relojUs = 0;
+    uint32_t semilla = 12345;
+
+    Evento   eventos[MAX_EVENTOS];
+    size_t   nEventos = 0;
+    uint32_t ordenEventos = 0;
+
+    // Radio
+    ConfigRadio config;
+    std::vector<Ap> aps;
+    std::vector<wifi_ap_record_t> fantasmas;
+    wifi_mode_t modo = WIFI_OFF;
+    wifi_config_t sta;
+    wifi_ps_type_t sueno = WIFI_PS_MIN_MODEM;     // el del driver al arrancar
+    wifi_power_t   potencia = WIFI_POWER_19_5dBm;
+    bool     ipFija = false;
+    uint32_t ipFijaValor = 0;
+    EstadoSta estadoSta = EstadoSta::LIBRE;
+    int      apActual = -1;
+    bool     conIp = false;
+    uint32_t intento = 0;
+    uint32_t asociaciones = 0;
+    uint32_t escaneos = 0;
+    uint32_t desconexiones = 0;
+    bool     autoReconectar = true;               // WiFi.setAutoReconnect(), encendido al arrancar
+    uint32_t reconexionesDriver = 0;
+
+    bool     escaneando = false;
+    int16_t  cantResultados = WIFI_SCAN_FAILED;
+    wifi_ap_record_t resultados[MAX_RESULTADOS];
+    char     ssidEscaneo[33] = {0};
+    uint32_t generacionEscaneo = 0;
+
+    WiFiEventFuncCb callbacks[MAX_CALLBACKS];
+    wifi_event_id_t idsCallbacks[MAX_CALLBACKS] = {0};
+
+    Internet internet;
+    uint32_t sondas = 0;
+    sntp_sync_time_cb_t callbackNtp = nullptr;
+
+    int      pinesEntrada[64];
+    int      pinesSalida[64];
+    uint32_t reinicios = 0;
+
+    std::vector<Tarea> tareas;
+    const void* tareaActual = TAREA_LOOP;
+
+    Fs fs;
+    std::map<std::string, std::string> archivos;
+
+    uint32_t bloqueos = 0;
+    uint32_t cerrojosTomados = 0;
+    uint64_t inicioCerrojoNs = 0;
+    uint64_t cerrojoMaxNs = 0;
+    uint32_t driverBajoCerrojo = 0;
+};
+
+Estado& e() {
+    static Estado* estado = new Estado();
+    return *estado;
+}
+
+wifi_event_id_t siguienteIdCallback = 0;
+
+uint64_t ahoraRealNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Cuenta las llamadas al driver hechas con un cerrojo tomado: en el
+// dispositivo eso es una sección crítica que espera a la radio.
+void driver() {
+    if (e().cerrojosTomados) ++e().driverBajoCerrojo;
+}
+
+void agendar(uint64_t enUs, TipoEvento tipo, int32_t a, uint32_t intento) {
+    Estado& s = e();
+    if (s.nEventos >= MAX_EVENTOS) {
+        fprintf(stderr, "simulador: demasiados eventos agendados\n");
+        abort();
+    }
+    Evento& ev = s.eventos[s.nEventos++];
+    ev.cuando  = s.relojUs + enUs;
+    ev.orden   = s.ordenEventos++;
+    ev.intento = intento;
+    ev.tipo    = tipo;
+    ev.a       = a;
+}
+
+void emitir(arduino_event_id_t id, const arduino_event_info_t& info) {
+    Estado& s = e();
+    for (size_t i = 0; i < MAX_CALLBACKS; ++i) {
+        if (s.idsCallbacks[i]) s.callbacks[i](id, info);
+    }
+}
+
+void emitirDesconexion(uint8_t motivo) {
+    arduino_event_info_t info;
+    memset(&info, 0, sizeof(info));
+    info.wifi_sta_disconnected.reason = motivo;
+    emitir(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, info);
+}
+
+bool aleatorioMenorQue(double prob) {
+    return prob > 0 && (aleatorio() % 1000000) < prob * 1000000;
+}
+
+uint32_t variacion() {
+    uint32_t v = e().config.variacionMs;
+    return v ? aleatorio() % (v + 1) : 0;
+}
+
+// La STA deja lo que estaba haciendo; si estaba asociada avisa con @p motivo
+void soltarSta(uint8_t motivo) {
+    Estado& s = e();
+    bool estabaAsociada = s.estadoSta == EstadoSta::ASOCIADA;
+    ++s.intento;
+    s.estadoSta = EstadoSta::LIBRE;
+    s.apActual = -1;
+    s.conIp = false;
+    if (estabaAsociada) agendar(0, TipoEvento::DESCONECTADA, motivo, s.intento);
+}
+
+int buscarAp(const char* ssid, const uint8_t* bssid, uint8_t canal) {
+    Estado& s = e();
+    int mejor = -1;
+    for (size_t i = 0; i < s.aps.size(); ++i) {
+        const Ap& ap = s.aps[i];
+        if (!ap.encendido || ap.ssid != ssid) continue;
+        if (bssid && memcmp(ap.bssid, bssid, 6) != 0) continue;
+        if (canal && ap.canal != canal) continue;
+        if (mejor < 0 || ap.rssi > s.aps[mejor].rssi) mejor = static_cast<int>(i);
+    }
+    return mejor;
+}
+
+void iniciarAsociacion() {
+    Estado& s = e();
+    ++s.asociaciones;
+    if (s.estadoSta != EstadoSta::LIBRE) soltarSta(WIFI_REASON_ASSOC_LEAVE);
+    ++s.intento;
+    s.estadoSta = EstadoSta::ASOCIANDO;
+    if (aleatorioMenorQue(s.config.probFallo)) return;     // el AP no contesta: vence el timeout
+
+    const char* ssid = reinterpret_cast<const char*>(s.sta.sta.ssid);
+    const uint8_t* bssid = s.sta.sta.bssid_set ? s.sta.sta.bssid : nullptr;
+    uint64_t busqueda = bssid ? 0 : static_cast<uint64_t>(s.config.barridoMs) * 1000;
+    int ap = buscarAp(ssid, bssid, bssid ? s.sta.sta.channel : 0);
+    if (ap < 0) {
+        agendar(busqueda + s.config.asociacionMs * 1000ULL, TipoEvento::DESCONECTADA,
+                WIFI_REASON_NO_AP_FOUND, s.intento);
+        return;
+    }
+    if (s.aps[ap].clave != reinterpret_cast<const char*>(s.sta.sta.password)) {
+        agendar(busqueda + s.config.rechazoMs * 1000ULL, TipoEvento::DESCONECTADA,
+                WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT, s.intento);
+        return;
+    }
+    uint64_t asociada = busqueda + (s.config.asociacionMs + variacion()) * 1000ULL;
+    agendar(asociada, TipoEvento::ASOCIADA, ap, s.intento);
+    if (!aleatorioMenorQue(s.config.probPerdidaIp)) {
+        uint64_t ip = ((s.ipFija ? s.config.ipFijaMs : s.config.dhcpMs) + variacion()) * 1000ULL;
+        agendar(asociada + ip, TipoEvento::IP, 0, s.intento);
+    }
+}
+
+void terminarEscaneo() {
+    Estado& s = e();
+    size_t n = 0;
+    for (size_t i = 0; i < s.aps.size() && n < MAX_RESULTADOS; ++i) {
+        const Ap& ap = s.aps[i];
+        if (!ap.encendido || (s.ssidEscaneo[0] && ap.ssid != s.ssidEscaneo)) continue;
+        wifi_ap_record_t& r = s.resultados[n++];
+        memset(&r, 0, sizeof(r));
+        memcpy(r.bssid, ap.bssid, 6);
+        strlcpy(reinterpret_cast<char*>(r.ssid), ap.ssid.c_str(), sizeof(r.ssid));
+        r.primary  = ap.canal;
+        r.rssi     = ap.rssi;
+        r.authmode = ap.clave.empty() ? WIFI_AUTH_OPEN : WIFI_AUTH_WPA2_PSK;
+    }
+    for (size_t i = 0; i < s.fantasmas.size() && n < MAX_RESULTADOS; ++i) {
+        const wifi_ap_record_t& f = s.fantasmas[i];
+        if (s.ssidEscaneo[0] && strcmp(reinterpret_cast<const char*>(f.ssid), s.ssidEscaneo) != 0) continue;
+        s.resultados[n++] = f;
+    }
+    s.cantResultados = static_cast<int16_t>(n);
+    s.escaneando = false;
+}
+
+void ejecutar(const Evento& ev) {
+    Estado& s = e();
+    arduino_event_info_t info;
+    memset(&info, 0, sizeof(info));
+    switch (ev.tipo) {
+    case TipoEvento::ASOCIADA:
+        if (ev.intento != s.intento) return;
+        s.estadoSta = EstadoSta::ASOCIADA;
+        s.apActual = ev.a;
+        emitir(ARDUINO_EVENT_WIFI_STA_CONNECTED, info);
+        break;
+    case TipoEvento::IP:
+        if (ev.intento != s.intento || s.estadoSta != EstadoSta::ASOCIADA) return;
+        s.conIp = true;
+        emitir(ARDUINO_EVENT_WIFI_STA_GOT_IP, info);
+        break;
+    case TipoEvento::DESCONECTADA:
+        if (ev.intento != s.intento) return;
+        if (s.estadoSta == EstadoSta::ASOCIANDO) {
+            // El driver se rinde con este intento; como el original, no reintenta solo
+            s.estadoSta = EstadoSta::LIBRE;
+        }
+        emitirDesconexion(static_cast<uint8_t>(ev.a));
+        // El core de Arduino, con auto-reconnect, vuelve a asociar enseguida
+        // si se perdieron los beacons o no terminó el handshake
+        if (s.autoReconectar && (s.modo & WIFI_STA) &&
+            (ev.a == WIFI_REASON_AUTH_EXPIRE || ev.a == WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT ||
+             ev.a == WIFI_REASON_BEACON_TIMEOUT || ev.a == WIFI_REASON_HANDSHAKE_TIMEOUT)) {
+            ++s.reconexionesDriver;
+            iniciarAsociacion();
+        }
+        break;
+    case TipoEvento::FIN_ESCANEO:
+        if (static_cast<uint32_t>(ev.a) != s.generacionEscaneo || !s.escaneando) return;
+        terminarEscaneo();
+        emitir(ARDUINO_EVENT_WIFI_SCAN_DONE, info);
+        break;
+    case TipoEvento::CLIENTE_AP:
+        emitir(ev.a ? ARDUINO_EVENT_WIFI_AP_STACONNECTED : ARDUINO_EVENT_WIFI_AP_STADISCONNECTED, info);
+        break;
+    }
+}
+
+// Índice del próximo evento vencido hasta @p limiteUs, o -1
+int proximoEvento(uint64_t limiteUs) {
+    Estado& s = e();
+    int mejor = -1;
+    for (size_t i = 0; i < s.nEventos; ++i) {
+        const Evento& ev = s.eventos[i];
+        if (ev.cuando > limiteUs) continue;
+        if (mejor < 0 || ev.cuando < s.eventos[mejor].cuando ||
+            (ev.cuando == s.eventos[mejor].cuando && ev.orden < s.eventos[mejor].orden)) {
+            mejor = static_cast<int>(i);
+        }
+    }
+    return mejor;
+}
+
+} // namespace
+
+// -------- reloj --------
+uint64_t ahoraUs() { return e().relojUs; }
+uint32_t ahoraMs() { return static_cast<uint32_t>(e().relojUs / 1000); }
+
+void avanzarUs(uint64_t us) {
+    Estado& s = e();
+    uint64_t destino = s.relojUs + us;
+    for (;;) {
+        int i = proximoEvento(destino);
+        if (i < 0) break;
+        Evento ev = s.eventos[i];
+        s.eventos[i] = s.eventos[--s.nEventos];
+        if (ev.cuando > s.relojUs) s.relojUs = ev.cuando;
+        ejecutar(ev);
+    }
+    s.relojUs = destino;
+}
+
+void avanzar(uint32_t ms) { avanzarUs(static_cast<uint64_t>(ms) * 1000); }
+
+int32_t hasta(const std::function<bool()>& listo, const std::function<void()>& vuelta,
+              uint32_t maxMs, uint32_t pasoMs) {
+    uint64_t inicio = ahoraUs();
+    for (;;) {
+        if (vuelta) vuelta();
+        uint32_t transcurrido = static_cast<uint32_t>((ahoraUs() - inicio) / 1000);
+        if (listo()) return static_cast<int32_t>(transcurrido);
+        if (transcurrido >= maxMs) return -1;
+        avanzar(pasoMs);
+    }
+}
+
+void reiniciar() {
+    SinContar sinContar;
+    Estado& s = e();
+    WiFiEventFuncCb callbacks[MAX_CALLBACKS];
+    wifi_event_id_t ids[MAX_CALLBACKS];
+    for (size_t i = 0; i < MAX_CALLBACKS; ++i) {
+        callbacks[i] = s.callbacks[i];
+        ids[i] = s.idsCallbacks[i];
+    }
+    s = Estado();
+    // Los que registró un WifiManager vivo siguen: los quita su destructor
+    for (size_t i = 0; i < MAX_CALLBACKS; ++i) {
+        s.callbacks[i] = callbacks[i];
+        s.idsCallbacks[i] = ids[i];
+    }
+    memset(&s.sta, 0, sizeof(s.sta));
+    for (size_t i = 0; i < 64; ++i) {
+        s.pinesEntrada[i] = HIGH;           // botones con pull-up sin presionar
+        s.pinesSalida[i] = LOW;
+    }
+}
+
+void semilla(uint32_t valor) { e().semilla = valor ? valor : 1; }
+
+uint32_t aleatorio() {
+    // xorshift32: determinista y sin estado oculto
+    uint32_t x = e().semilla;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    e().semilla = x;
+    return x;
+}
+
+// -------- radio --------
+ConfigRadio& radio() { return e().config; }
+
+size_t agregarAp(const char* ssid, const char* clave, uint8_t canal, int8_t rssi, const uint8_t* bssid) {
+    SinContar sinContar;
+    Estado& s = e();
+    Ap ap;
+    ap.ssid = ssid;
+    ap.clave = clave ? clave : "";
+    ap.canal = canal;
+    ap.rssi = rssi;
+    ap.encendido = true;
+    if (bssid) {
+        memcpy(ap.bssid, bssid, 6);
+    } else {
+        const uint8_t base[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x00};
+        memcpy(ap.bssid, base, 6);
+        ap.bssid[4] = static_cast<uint8_t>(s.aps.size() >> 8);
+        ap.bssid[5] = static_cast<uint8_t>(s.aps.size() + 1);
+    }
+    s.aps.push_back(ap);
+    return s.aps.size() - 1;
+}
+
+Ap& ap(size_t i) { return e().aps[i]; }
+size_t cantidadAps() { return e().aps.size(); }
+
+void encenderAp(size_t i, bool encendido) {
+    Estado& s = e();
+    s.aps[i].encendido = encendido;
+    if (!encendido && s.apActual == static_cast<int>(i)) soltarSta(WIFI_REASON_BEACON_TIMEOUT);
+}
+
+void agregarRedFantasma(const char* ssid, uint8_t canal, int8_t rssi, uint8_t auth) {
+    SinContar sinContar;
+    Estado& s = e();
+    wifi_ap_record_t r;
+    memset(&r, 0, sizeof(r));
+    strlcpy(reinterpret_cast<char*>(r.ssid), ssid, sizeof(r.ssid));
+    r.bssid[0] = 0x02;                                  // administrada localmente
+    r.bssid[4] = static_cast<uint8_t>(s.fantasmas.size() >> 8);
+    r.bssid[5] = static_cast<uint8_t>(s.fantasmas.size());
+    r.primary  = canal;
+    r.rssi     = rssi;
+    r.authmode = static_cast<wifi_auth_mode_t>(auth);
+    s.fantasmas.push_back(r);
+}
+
+uint32_t asociacionesIniciadas() { return e().asociaciones; }
+uint32_t escaneosIniciados()     { return e().escaneos; }
+uint32_t desconexiones()         { return e().desconexiones; }
+uint32_t reconexionesDriver()    { return e().reconexionesDriver; }
+bool     staConIp()              { return e().conIp; }
+uint16_t listenInterval()        { return e().sta.sta.listen_interval; }
+uint8_t  modoSueno()             { return e().sueno; }
+uint8_t  potenciaTx()            { return e().potencia; }
+
+void clienteAp(bool entra) {
+    agendar(0, TipoEvento::CLIENTE_AP, entra ? 1 : 0, 0);
+}
+
+// -------- Internet --------
+Internet& internet() { return e().internet; }
+uint32_t  sondasInternet() { return e().sondas; }
+
+// -------- hora --------
+void sincronizarNtp(int64_t epochSegundos) {
+    timeval tv;
+    tv.tv_sec = static_cast<time_t>(epochSegundos);
+    tv.tv_usec = 0;
+    if (e().callbackNtp) e().callbackNtp(&tv);
+}
+
+// -------- pines y reinicio --------
+void     nivelPin(uint8_t pin, int nivel) { e().pinesEntrada[pin & 63] = nivel; }
+int      salidaPin(uint8_t pin)           { return e().pinesSalida[pin & 63]; }
+uint32_t reinicios()                      { return e().reinicios; }
+
+// -------- tareas --------
+const Tarea* tarea(const char* nombre) {
+    for (const Tarea& t : e().tareas) {
+        if (t.nombre == nombre) return &t;
+    }
+    return nullptr;
+}
+
+size_t cantidadTareas() { return e().tareas.size(); }
+
+void* handle(const char* nombreTarea) {
+    std::vector<Tarea>& tareas = e().tareas;
+    for (size_t i = 0; i < tareas.size(); ++i) {
+        if (tareas[i].nombre == nombreTarea) return reinterpret_cast<void*>(i + 1);
+    }
+    return nullptr;
+}
+
+ComoTarea::ComoTarea(void* handle) : anterior(const_cast<void*>(e().tareaActual)) {
+    e().tareaActual = handle;
+}
+
+ComoTarea::~ComoTarea() {
+    e().tareaActual = anterior;
+}
+
+// -------- LittleFS --------
+Fs& fs() { return e().fs; }
+
+void escribirArchivo(const char* ruta, const std::string& contenido) {
+    SinContar sinContar;
+    e().archivos[ruta] = contenido;
+}
+
+bool existeArchivo(const char* ruta) {
+    return e().archivos.count(ruta) != 0;
+}
+
+std::string leerArchivo(const char* ruta) {
+    auto it = e().archivos.find(ruta);
+    return it == e().archivos.end() ? std::string() : it->second;
+}
+
+std::vector<std::string> archivos() {
+    std::vector<std::string> nombres;
+    for (const auto& a : e().archivos) nombres.push_back(a.first);
+    return nombres;
+}
+
+// -------- cerrojos --------
+uint32_t bloqueos()          { return e().bloqueos; }
+uint64_t cerrojoMaxNs()      { return e().cerrojoMaxNs; }
+uint32_t driverBajoCerrojo() { return e().driverBajoCerrojo; }
+
+// -------- estadística --------
+double percentil(std::vector<double>& muestras, double p) {
+    if (muestras.empty()) return 0;
+    std::sort(muestras.begin(), muestras.end());
+    size_t rango = static_cast<size_t>(ceil(p / 100.0 * muestras.size()));
+    if (rango == 0) rango = 1;
+    if (rango > muestras.size()) rango = muestras.size();
+    return muestras[rango - 1];
+}
+
+// -------- HTTP --------
+namespace {
+
+struct Publicado {
+    uint16_t      puerto;
+    ServidorHttp* servidor;
+};
+Publicado publicados[MAX_SERVIDORES];
+
+bool mismoNombre(const char* a, const char* b) {
+    return strcasecmp(a, b) == 0;
+}
+
+int hex(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+std::string decodificar(const std::string& texto) {
+    std::string r;
+    for (size_t i = 0; i < texto.size(); ++i) {
+        char c = texto[i];
+        if (c == '+') {
+            r += ' ';
+        } else if (c == '%' && i + 2 < texto.size() && hex(texto[i + 1]) >= 0 && hex(texto[i + 2]) >= 0) {
+            r += static_cast<char>(hex(texto[i + 1]) * 16 + hex(texto[i + 2]));
+            i += 2;
+        } else {
+            r += c;
+        }
+    }
+    return r;
+}
+
+void agregarConsulta(const std::string& consulta, std::vector<std::pair<std::string, std::string>>& args) {
+    size_t inicio = 0;
+    while (inicio < consulta.size()) {
+        size_t fin = consulta.find('&', inicio);
+        if (fin == std::string::npos) fin = consulta.size();
+        std::string par = consulta.substr(inicio, fin - inicio);
+        size_t igual = par.find('=');
+        if (!par.empty()) {
+            if (igual == std::string::npos) args.push_back(std::make_pair(decodificar(par), std::string()));
+            else args.push_back(std::make_pair(decodificar(par.substr(0, igual)), decodificar(par.substr(igual + 1))));
+        }
+        inicio = fin + 1;
+    }
+}
+
+} // namespace
+
+const char* RespuestaHttp::cabecera(const char* nombre) const {
+    for (uint8_t i = 0; i < nCabeceras; ++i) {
+        if (mismoNombre(cabeceras[i].nombre, nombre)) return cabeceras[i].valor;
+    }
+    return nullptr;
+}
+
+void RespuestaHttp::agregarCabecera(const char* nombre, const char* valor) {
+    if (nCabeceras >= sizeof(cabeceras) / sizeof(cabeceras[0])) return;
+    strlcpy(cabeceras[nCabeceras].nombre, nombre, sizeof(cabeceras[0].nombre));
+    strlcpy(cabeceras[nCabeceras].valor, valor, sizeof(cabeceras[0].valor));
+    ++nCabeceras;
+}
+
+void publicarServidor(uint16_t puerto, ServidorHttp* s) {
+    for (Publicado& p : publicados) {
+        if (p.servidor && p.puerto == puerto) {
+            p.servidor = s;
+            return;
+        }
+    }
+    for (Publicado& p : publicados) {
+        if (!p.servidor) {
+            p.puerto = puerto;
+            p.servidor = s;
+            return;
+        }
+    }
+}
+
+void retirarServidor(ServidorHttp* s) {
+    for (Publicado& p : publicados) {
+        if (p.servidor == s) p.servidor = nullptr;
+    }
+}
+
+void atenderServidores() {
+    for (const Publicado& p : publicados) {
+        if (p.servidor) p.servidor->atender();
+    }
+}
+
+ServidorHttp* servidor(uint16_t puerto) {
+    for (const Publicado& p : publicados) {
+        if (p.servidor && p.puerto == puerto) return p.servidor;
+    }
+    return nullptr;
+}
+
+ClienteHttp::ClienteHttp(std::function<void()> bombear, uint16_t puerto)
+: bombear(bombear), puerto(puerto) {}
+
+ClienteHttp& ClienteHttp::cabecera(const char* nombre, const char* valor) {
+    siguientes.push_back(std::make_pair(std::string(nombre), std::string(valor)));
+    return *this;
+}
+
+RespuestaHttp ClienteHttp::get(const char* uri) {
+    PedidoHttp pedido;
+    pedido.metodo = Metodo::GET;
+    std::string u(uri);
+    size_t q = u.find('?');
+    pedido.ruta = u.substr(0, q);
+    if (q != std::string::npos) agregarConsulta(u.substr(q + 1), pedido.args);
+    return enviar(pedido);
+}
+
+RespuestaHttp ClienteHttp::post(const char* uri, const std::vector<std::pair<std::string, std::string>>& formulario) {
+    PedidoHttp pedido;
+    pedido.metodo = Metodo::POST;
+    std::string u(uri);
+    size_t q = u.find('?');
+    pedido.ruta = u.substr(0, q);
+    if (q != std::string::npos) agregarConsulta(u.substr(q + 1), pedido.args);
+    for (const auto& campo : formulario) pedido.args.push_back(campo);
+    return enviar(pedido);
+}
+
+RespuestaHttp ClienteHttp::enviar(PedidoHttp& pedido) {
+    pedido.cabeceras.swap(siguientes);
+    siguientes.clear();
+
+    RespuestaHttp respuesta;
+    ServidorHttp* s = servidor(puerto);
+    if (!s) {
+        respuesta.codigo = -1;                         // conexión rechazada
+        respuesta.completa = true;
+        return respuesta;
+    }
+    s->entregar(pedido, respuesta);
+    for (uint32_t vueltas = 0; !respuesta.completa && bombear && vueltas < 100000; ++vueltas) {
+        atenderServidores();
+        if (!respuesta.completa) bombear();
+    }
+    if (!respuesta.completa) {
+        s->abandonar(respuesta);
+        respuesta.codigo = -2;                         // nadie atendió el pedido
+    }
+    return respuesta;
+}
+
+} // namespace sim
+
+// ======================================================================
+//  Arduino
+// ======================================================================
+
+HardwareSerial Serial;
+EspClass ESP;
+
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+size_t strlcpy(char* destino, const char* origen, size_t capacidad) {
+    size_t largo = strlen(origen);
+    if (capacidad) {
+        size_t n = largo < capacidad - 1 ? largo : capacidad - 1;
+        memcpy(destino, origen, n);
+        destino[n] = '\0';
+    }
+    return largo;
+}
+#endif
+
+unsigned long millis() { return sim::ahoraMs(); }
+unsigned long micros() { return static_cast<unsigned long>(sim::ahoraUs()); }
+void delay(unsigned long ms) { sim::avanzar(static_cast<uint32_t>(ms)); }
+void yield() {}
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t pin, uint8_t nivel) { sim::e().pinesSalida[pin & 63] = nivel; }
+int  digitalRead(uint8_t pin) { return sim::e().pinesEntrada[pin & 63]; }
+
+static bool registroActivo() {
+    static const bool activo = getenv("WM_HOST_LOG") != nullptr;
+    return activo;
+}
+
+size_t HardwareSerial::print(const char* texto) {
+    if (registroActivo()) fputs(texto, stderr);
+    return strlen(texto);
+}
+
+size_t HardwareSerial::print(long v) {
+    if (registroActivo()) fprintf(stderr, "%ld", v);
+    return 1;
+}
+
+size_t HardwareSerial::println(const char* texto) {
+    if (registroActivo()) fprintf(stderr, "%s\n", texto);
+    return strlen(texto) + 1;
+}
+
+size_t HardwareSerial::println(long v) {
+    if (registroActivo()) fprintf(stderr, "%ld\n", v);
+    return 1;
+}
+
+size_t HardwareSerial::printf(const char* formato, ...) {
+    if (!registroActivo()) return 0;
+    va_list args;
+    va_start(args, formato);
+    int n = vfprintf(stderr, formato, args);
+    va_end(args);
+    return n > 0 ? static_cast<size_t>(n) : 0;
+}
+
+static const int64_t HEAP_ESP32 = 320 * 1024;
+
+uint32_t EspClass::getFreeHeap() {
+    int64_t libre = HEAP_ESP32 - sim::memoria().bytesVivos;
+    return libre > 0 ? static_cast<uint32_t>(libre) : 0;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    int64_t libre = HEAP_ESP32 - sim::memoria().pico;
+    return libre > 0 ? static_cast<uint32_t>(libre) : 0;
+}
+
+uint32_t EspClass::getMaxAllocHeap() { return getFreeHeap(); }
+void     EspClass::restart()         { ++sim::e().reinicios; }
+
+// ======================================================================
+//  HAL de la librería
+// ======================================================================
+
+unsigned long wmMillis() { return sim::ahoraMs(); }
+uint64_t      wmMicros() { return sim::ahoraUs(); }
+void          wmDelay(unsigned long ms) { sim::avanzar(static_cast<uint32_t>(ms)); }
+
+void wmBloquear(WmCerrojo& cerrojo) {
+    if (cerrojo.ocupado) {
+        // En el dispositivo esto es un deadlock (o un cerrojo anidado)
+        fprintf(stderr, "simulador: WmCerrojo tomado dos veces\n");
+        abort();
+    }
+    cerrojo.ocupado = 1;
+    sim::Estado& s = sim::e();
+    ++s.bloqueos;
+    if (s.cerrojosTomados++ == 0) s.inicioCerrojoNs = sim::ahoraRealNs();
+}
+
+void wmDesbloquear(WmCerrojo& cerrojo) {
+    cerrojo.ocupado = 0;
+    sim::Estado& s = sim::e();
+    if (--s.cerrojosTomados == 0) {
+        uint64_t duracion = sim::ahoraRealNs() - s.inicioCerrojoNs;
+        if (duracion > s.cerrojoMaxNs) s.cerrojoMaxNs = duracion;
+    }
+}
+
+// ======================================================================
+//  ESP-IDF
+// ======================================================================
+
+uint32_t esp_random() { return sim::aleatorio(); }
+int64_t  esp_timer_get_time() { return static_cast<int64_t>(sim::ahoraUs()); }
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback) { sim::e().callbackNtp = callback; }
+void configTime(long, int, const char*, const char*, const char*) {}
+
+esp_err_t esp_wifi_get_config(wifi_interface_t, wifi_config_t* config) {
+    sim::driver();
+    *config = sim::e().sta;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_config(wifi_interface_t, wifi_config_t* config) {
+    sim::driver();
+    sim::e().sta = *config;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_connect() {
+    sim::driver();
+    if (!(sim::e().modo & WIFI_STA)) return ESP_FAIL;
+    sim::iniciarAsociacion();
+    return ESP_OK;
+}
+
+// ======================================================================
+//  FreeRTOS
+// ======================================================================
+
+BaseType_t xTaskCreate(TaskFunction_t funcion, const char* nombre, uint32_t pila, void* arg,
+                       UBaseType_t prioridad, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(funcion, nombre, pila, arg, prioridad, handle, tskNO_AFFINITY);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t funcion, const char* nombre, uint32_t, void* arg,
+                                   UBaseType_t, TaskHandle_t* handle, BaseType_t nucleo) {
+    sim::SinContar sinContar;
+    sim::Tarea t;
+    t.nombre = nombre;
+    t.funcion = funcion;
+    t.arg = arg;
+    t.nucleo = nucleo;
+    t.avisos = 0;
+    t.viva = true;
+    sim::e().tareas.push_back(t);
+    if (handle) *handle = reinterpret_cast<void*>(sim::e().tareas.size());
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return const_cast<void*>(sim::e().tareaActual);
+}
+
+static sim::Tarea* tareaDe(TaskHandle_t handle) {
+    size_t i = reinterpret_cast<size_t>(handle);
+    std::vector<sim::Tarea>& tareas = sim::e().tareas;
+    return i >= 1 && i <= tareas.size() ? &tareas[i - 1] : nullptr;
+}
+
+void xTaskNotifyGive(TaskHandle_t tarea) {
+    sim::Tarea* t = tareaDe(tarea);
+    if (t) ++t->avisos;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t limpiar, TickType_t) {
+    // No hay otras tareas que puedan avisar mientras se espera: no bloquea
+    sim::Tarea* t = tareaDe(xTaskGetCurrentTaskHandle());
+    if (!t) return 0;
+    uint32_t avisos = t->avisos;
+    t->avisos = limpiar ? 0 : (avisos ? avisos - 1 : 0);
+    return avisos;
+}
+
+void vTaskDelete(TaskHandle_t tarea) {
+    sim::Tarea* t = tareaDe(tarea ? tarea : xTaskGetCurrentTaskHandle());
+    if (t) t->viva = false;
+}
+
+// ======================================================================
+//  WiFi
+// ======================================================================
+
+WiFiClass WiFi;
+
+bool WiFiClass::mode(wifi_mode_t modo) {
+    sim::driver();
+    sim::Estado& s = sim::e();
+    if (!(modo & WIFI_STA) && s.estadoSta != sim::EstadoSta::LIBRE) sim::soltarSta(WIFI_REASON_ASSOC_LEAVE);
+    s.modo = modo;
+    return true;
+}
+
+wifi_mode_t WiFiClass::getMode() { return sim::e().modo; }
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* clave, int32_t canal,
+                             const uint8_t* bssid, bool conectar) {
+    sim::driver();
+    sim::Estado& s = sim::e();
+    if (!(s.modo & WIFI_STA)) s.modo = static_cast<wifi_mode_t>(s.modo | WIFI_STA);
+    // Como el original: la configuración se arma de cero (listen_interval en 0)
+    memset(&s.sta, 0, sizeof(s.sta));
+    strncpy(reinterpret_cast<char*>(s.sta.sta.ssid), ssid ? ssid : "", sizeof(s.sta.sta.ssid));
+    strncpy(reinterpret_cast<char*>(s.sta.sta.password), clave ? clave : "", sizeof(s.sta.sta.password) - 1);
+    s.sta.sta.channel = static_cast<uint8_t>(canal);
+    if (bssid) {
+        s.sta.sta.bssid_set = 1;
+        memcpy(s.sta.sta.bssid, bssid, 6);
+    }
+    if (conectar) sim::iniciarAsociacion();
+    return WL_DISCONNECTED;
+}
+
+bool WiFiClass::disconnect(bool, bool) {
+    sim::driver();
+    ++sim::e().desconexiones;
+    sim::soltarSta(WIFI_REASON_ASSOC_LEAVE);
+    return true;
+}
+
+bool WiFiClass::config(IPAddress ip, IPAddress, IPAddress, IPAddress, IPAddress) {
+    sim::driver();
+    sim::e().ipFija = static_cast<uint32_t>(ip) != 0;
+    sim::e().ipFijaValor = ip;
+    return true;
+}
+
+wl_status_t WiFiClass::status() {
+    sim::driver();
+    return sim::e().conIp ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+bool WiFiClass::setAutoReconnect(bool habilitado) {
+    sim::e().autoReconectar = habilitado;
+    return true;
+}
+
+bool WiFiClass::getAutoReconnect() { return sim::e().autoReconectar; }
+
+bool WiFiClass::setSleep(wifi_ps_type_t modo) {
+    sim::driver();
+    // Con el AP encendido el driver no acepta modem-sleep
+    if (modo != WIFI_PS_NONE && (sim::e().modo & WIFI_AP)) return false;
+    sim::e().sueno = modo;
+    return true;
+}
+
+bool WiFiClass::setTxPower(wifi_power_t potencia) {
+    sim::driver();
+    sim::e().potencia = potencia;
+    return true;
+}
+
+int8_t WiFiClass::RSSI() {
+    sim::driver();
+    sim::Estado& s = sim::e();
+    return s.apActual >= 0 ? s.aps[s.apActual].rssi : 0;
+}
+
+const uint8_t* WiFiClass::BSSID() {
+    sim::driver();
+    sim::Estado& s = sim::e();
+    return s.apActual >= 0 ? s.aps[s.apActual].bssid : nullptr;
+}
+
+int32_t WiFiClass::channel() {
+    sim::driver();
+    sim::Estado& s = sim::e();
+    return s.apActual >= 0 ? s.aps[s.apActual].canal : 0;
+}
+
+String WiFiClass::SSID() {
+    sim::driver();
+    sim::Estado& s = sim::e();
+    return s.apActual >= 0 ? String(s.aps[s.apActual].ssid.c_str()) : String();
+}
+
+IPAddress WiFiClass::localIP() {
+    sim::Estado& s = sim::e();
+    if (!s.conIp) return IPAddress();
+    return s.ipFija ? IPAddress(s.ipFijaValor) : IPAddress(192, 168, 1, 100);
+}
+
+IPAddress WiFiClass::gatewayIP()  { return sim::e().conIp ? IPAddress(192, 168, 1, 1) : IPAddress(); }
+IPAddress WiFiClass::subnetMask() { return sim::e().conIp ? IPAddress(255, 255, 255, 0) : IPAddress(); }
+IPAddress WiFiClass::dnsIP(uint8_t i) {
+    if (!sim::e().conIp) return IPAddress();
+    return i == 0 ? IPAddress(192, 168, 1, 1) : IPAddress(8, 8, 8, 8);
+}
+
+bool WiFiClass::softAP(const char*, const char*) {
+    sim::driver();
+    sim::Estado& s = sim::e();
+    s.modo = static_cast<wifi_mode_t>(s.modo | WIFI_AP);
+    return true;
+}
+
+IPAddress WiFiClass::softAPIP() {
+    return (sim::e().modo & WIFI_AP) ? IPAddress(192, 168, 4, 1) : IPAddress();
+}
+
+int16_t WiFiClass::scanNetworks(bool async, bool, bool, uint32_t, uint8_t, const char* ssid, const uint8_t*) {
+    sim::driver();
+    sim::Estado& s = sim::e();
+    if (!(s.modo & WIFI_STA) || s.escaneando) return WIFI_SCAN_FAILED;
+    ++s.escaneos;
+    ++s.generacionEscaneo;
+    strlcpy(s.ssidEscaneo, ssid ? ssid : "", sizeof(s.ssidEscaneo));
+    s.escaneando = true;
+    s.cantResultados = WIFI_SCAN_RUNNING;
+    uint32_t ms = s.ssidEscaneo[0] ? s.config.escaneoDirigidoMs : s.config.escaneoMs;
+    if (!async) {
+        sim::avanzar(ms);
+        sim::terminarEscaneo();
+        return s.cantResultados;
+    }
+    sim::agendar(ms * 1000ULL, sim::TipoEvento::FIN_ESCANEO, static_cast<int32_t>(s.generacionEscaneo), 0);
+    return WIFI_SCAN_RUNNING;
+}
+
+int16_t WiFiClass::scanComplete() {
+    sim::driver();
+    sim::Estado& s = sim::e();
+    return s.escaneando ? WIFI_SCAN_RUNNING : s.cantResultados;
+}
+
+void WiFiClass::scanDelete() {
+    sim::driver();
+    sim::Estado& s = sim::e();
+    if (!s.escaneando) s.cantResultados = WIFI_SCAN_FAILED;
+}
+
+void* WiFiClass::getScanInfoByIndex(int i) {
+    sim::driver();
+    sim::Estado& s = sim::e();
+    if (i < 0 || i >= s.cantResultados) return nullptr;
+    return &s.resultados[i];
+}
+
+String WiFiClass::SSID(uint8_t i) {
+    const wifi_ap_record_t* r = static_cast<const wifi_ap_record_t*>(getScanInfoByIndex(i));
+    return r ? String(reinterpret_cast<const char*>(r->ssid)) : String();
+}
+
+int32_t WiFiClass::RSSI(uint8_t i) {
+    const wifi_ap_record_t* r = static_cast<const wifi_ap_record_t*>(getScanInfoByIndex(i));
+    return r ? r->rssi : 0;
+}
+
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t i) {
+    const wifi_ap_record_t* r = static_cast<const wifi_ap_record_t*>(getScanInfoByIndex(i));
+    return r ? r->authmode : WIFI_AUTH_OPEN;
+}
+
+wifi_event_id_t WiFiClass::onEvent(WiFiEventFuncCb callback) {
+    sim::SinContar sinContar;
+    sim::Estado& s = sim::e();
+    for (size_t i = 0; i < sim::MAX_CALLBACKS; ++i) {
+        if (!s.idsCallbacks[i]) {
+            s.callbacks[i] = callback;
+            s.idsCallbacks[i] = ++sim::siguienteIdCallback;
+            return s.idsCallbacks[i];
+        }
+    }
+    return 0;
+}
+
+void WiFiClass::removeEvent(wifi_event_id_t id) {
+    sim::SinContar sinContar;
+    sim::Estado& s = sim::e();
+    for (size_t i = 0; i < sim::MAX_CALLBACKS; ++i) {
+        if (id && s.idsCallbacks[i] == id) {
+            s.idsCallbacks[i] = 0;
+            s.callbacks[i] = nullptr;
+        }
+    }
+}
+
+int WiFiClass::hostByName(const char*, IPAddress& resultado) {
+    ++sim::e().sondas;
+    const sim::Internet& net = sim::e().internet;
+    sim::avanzar(net.latenciaMs);
+    if (!net.hay) return 0;
+    resultado = IPAddress(142, 250, 0, 1);
+    return 1;
+}
+
+bool WiFiClient::connect(const char*, uint16_t, int32_t timeoutMs) {
+    ++sim::e().sondas;
+    const sim::Internet& net = sim::e().internet;
+    sim::avanzar(net.hay ? net.latenciaMs : static_cast<uint32_t>(timeoutMs));
+    return net.hay;
+}
+
+bool HTTPClient::begin(WiFiClient&, const char*, uint16_t, const char*) {
+    return true;
+}
+
+int HTTPClient::GET() {
+    ++sim::e().sondas;
+    const sim::Internet& net = sim::e().internet;
+    sim::avanzar(net.hay ? net.latenciaMs : static_cast<uint32_t>(timeoutMs));
+    return net.hay ? net.codigo : -1;
+}
+
+// ======================================================================
+//  LittleFS
+// ======================================================================
+
+LittleFSFS LittleFS;
+
+namespace {
+
+struct Abierto {
+    int         referencias = 0;
+    std::string ruta;
+    size_t      posicion = 0;
+    bool        escritura = false;
+};
+Abierto abiertos[sim::MAX_ARCHIVOS_ABIERTOS];
+
+std::string* contenido(int lugar) {
+    auto it = sim::e().archivos.find(abiertos[lugar].ruta);
+    return it == sim::e().archivos.end() ? nullptr : &it->second;
+}
+
+} // namespace
+
+File::File(const File& otro) : lugar(otro.lugar) {
+    if (lugar >= 0) ++abiertos[lugar].referencias;
+}
+
+File& File::operator=(const File& otro) {
+    if (this == &otro) return *this;
+    close();
+    lugar = otro.lugar;
+    if (lugar >= 0) ++abiertos[lugar].referencias;
+    return *this;
+}
+
+File::~File() { close(); }
+
+size_t File::read(uint8_t* destino, size_t n) {
+    if (lugar < 0) return 0;
+    std::string* datos = contenido(lugar);
+    if (!datos) return 0;
+    Abierto& a = abiertos[lugar];
+    size_t disponibles = a.posicion < datos->size() ? datos->size() - a.posicion : 0;
+    if (n > disponibles) n = disponibles;
+    memcpy(destino, datos->data() + a.posicion, n);
+    a.posicion += n;
+    sim::e().fs.bytesLeidos += n;
+    if (sim::e().fs.usPorKb) sim::avanzarUs(static_cast<uint64_t>(n) * sim::e().fs.usPorKb / 1024);
+    return n;
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::available() {
+    if (lugar < 0) return 0;
+    std::string* datos = contenido(lugar);
+    if (!datos) return 0;
+    return static_cast<int>(datos->size() - abiertos[lugar].posicion);
+}
+
+size_t File::write(const uint8_t* datos, size_t n) {
+    if (lugar < 0 || !abiertos[lugar].escritura || sim::e().fs.fallarEscrituras) return 0;
+    sim::SinContar sinContar;
+    std::string* destino = contenido(lugar);
+    if (!destino) return 0;
+    destino->append(reinterpret_cast<const char*>(datos), n);
+    abiertos[lugar].posicion = destino->size();
+    sim::e().fs.bytesEscritos += n;
+    return n;
+}
+
+size_t File::size() const {
+    if (lugar < 0) return 0;
+    std::string* datos = contenido(lugar);
+    return datos ? datos->size() : 0;
+}
+
+bool File::isDirectory() const { return false; }
+
+String File::readString() {
+    String r;
+    uint8_t bloque[64];
+    size_t n;
+    while ((n = read(bloque, sizeof(bloque))) > 0) r += String(reinterpret_cast<const char*>(bloque), n);
+    return r;
+}
+
+void File::close() {
+    if (lugar < 0) return;
+    Abierto& a = abiertos[lugar];
+    if (--a.referencias == 0) {
+        sim::SinContar sinContar;
+        a.ruta.clear();
+    }
+    lugar = -1;
+}
+
+bool LittleFSFS::begin(bool) { return sim::e().fs.montar; }
+
+bool LittleFSFS::exists(const char* ruta) {
+    return sim::e().archivos.count(ruta) != 0;
+}
+
+File LittleFSFS::open(const char* ruta, const char* modo) {
+    sim::SinContar sinContar;
+    sim::Estado& s = sim::e();
+    bool escritura = modo[0] == 'w' || modo[0] == 'a';
+    if (!escritura && !s.archivos.count(ruta)) return File();
+
+    for (size_t i = 0; i < sim::MAX_ARCHIVOS_ABIERTOS; ++i) {
+        Abierto& a = abiertos[i];
+        if (a.referencias) continue;
+        a.referencias = 1;
+        a.ruta = ruta;
+        a.escritura = escritura;
+        a.posicion = 0;
+        if (escritura) {
+            ++s.fs.aperturasEscritura;
+            std::string& datos = s.archivos[ruta];
+            if (modo[0] == 'w') datos.clear();
+            a.posicion = datos.size();
+        } else {
+            ++s.fs.aperturasLectura;
+        }
+        return File(static_cast<int>(i));
+    }
+    fprintf(stderr, "simulador: demasiados archivos abiertos\n");
+    return File();
+}
+
+bool LittleFSFS::remove(const char* ruta) {
+    sim::SinContar sinContar;
+    sim::Estado& s = sim::e();
+    if (!s.archivos.erase(ruta)) return false;
+    ++s.fs.borrados;
+    return true;
+}
+
+bool LittleFSFS::rename(const char* desde, const char* hacia) {
+    sim::SinContar sinContar;
+    sim::Estado& s = sim::e();
+    auto it = s.archivos.find(desde);
+    if (it == s.archivos.end()) return false;
+    std::string datos;
+    datos.swap(it->second);
+    s.archivos.erase(it);
+    s.archivos[hacia].swap(datos);
+    ++s.fs.renombres;
+    return true;
+}
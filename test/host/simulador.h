@@ -0,0 +1,251 @@
+#ifndef WM_HOST_SIMULADOR_H
+#define WM_HOST_SIMULADOR_H
+
+/**
+ * @file  simulador.h
+ * @brief Entorno simulado de las pruebas en el host: reloj virtual, radio con
+ *        AP configurables, LittleFS en memoria, cliente HTTP en proceso,
+ *        tareas de FreeRTOS y conteo de memoria dinámica.
+ *
+ * Todo es de un solo hilo y determinista: el tiempo sólo avanza con
+ * sim::avanzar() (o con wmDelay()), y en ese momento se entregan los eventos
+ * del driver que vencieron, en orden. sim::reiniciar() deja todo como recién
+ * encendido.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sim {
+
+// -------- reloj --------
+uint64_t ahoraUs();
+uint32_t ahoraMs();
+/** Avanza el reloj virtual entregando en orden los eventos que vencen. */
+void avanzar(uint32_t ms);
+void avanzarUs(uint64_t us);
+/** Avanza de a @p pasoMs llamando @p vuelta (p. ej. wm.update()) hasta que
+ *  @p listo dé true o pasen @p maxMs. @return ms transcurridos, o -1 si no llegó. */
+int32_t hasta(const std::function<bool()>& listo, const std::function<void()>& vuelta,
+              uint32_t maxMs, uint32_t pasoMs = 10);
+
+void reiniciar();               ///< reloj, radio, archivos, tareas, pines y contadores a cero
+void semilla(uint32_t valor);   ///< generador de esp_random() y de los fallos de la radio
+uint32_t aleatorio();
+
+// -------- radio --------
+struct Ap {
+    std::string ssid;
+    std::string clave;          ///< vacía = red abierta
+    uint8_t     bssid[6];
+    uint8_t     canal;
+    int8_t      rssi;
+    bool        encendido;
+};
+
+struct ConfigRadio {
+    uint32_t asociacionMs     = 120;   ///< auth + assoc + 4-way con BSSID y canal conocidos
+    uint32_t barridoMs        = 1800;  ///< sondeo de todos los canales antes de asociar
+    uint32_t dhcpMs           = 350;   ///< DHCP completo
+    uint32_t ipFijaMs         = 5;     ///< IP configurada con WiFi.config()
+    uint32_t escaneoMs        = 2200;  ///< escaneo activo de todos los canales
+    uint32_t escaneoDirigidoMs = 600;  ///< escaneo con SSID
+    uint32_t rechazoMs        = 400;   ///< hasta que el AP rechaza una clave incorrecta
+    uint32_t variacionMs      = 0;     ///< se suma al azar (0..variacionMs) a asociación y DHCP
+    double   probFallo        = 0;     ///< intentos que quedan sin respuesta (AP saturado)
+    double   probPerdidaIp    = 0;     ///< asociaciones en que DHCP no responde
+    uint32_t apUsPorKb        = 0;     ///< aire del AP del portal por KB enviado (0 = instantáneo)
+    uint8_t  dtim             = 1;     ///< período DTIM del AP, en beacons de 102,4 ms
+};
+ConfigRadio& radio();
+
+/** @return índice del AP. Sin BSSID se genera uno a partir del índice. */
+size_t agregarAp(const char* ssid, const char* clave, uint8_t canal, int8_t rssi,
+                 const uint8_t* bssid = nullptr);
+Ap&    ap(size_t i);
+size_t cantidadAps();
+/** Apaga o enciende un AP; si la STA estaba en él recibe BEACON_TIMEOUT. */
+void   encenderAp(size_t i, bool encendido);
+/** Redes sin AP detrás que sólo aparecen en los escaneos (para llenar la lista). */
+void   agregarRedFantasma(const char* ssid, uint8_t canal, int8_t rssi, uint8_t auth);
+
+uint32_t asociacionesIniciadas();   ///< esp_wifi_connect() / begin(conectar)
+uint32_t escaneosIniciados();
+uint32_t desconexiones();           ///< WiFi.disconnect()
+/** Asociaciones que lanzó el auto-reconnect del core (WiFi.setAutoReconnect(true), el
+ *  valor al arrancar) tras BEACON_TIMEOUT, AUTH_EXPIRE o un handshake vencido. */
+uint32_t reconexionesDriver();
+bool     staConIp();
+/** Un teléfono entra (o sale) del AP del portal. */
+void     clienteAp(bool entra);
+uint16_t listenInterval();          ///< el que quedó en la config de la STA
+uint8_t  modoSueno();               ///< wifi_ps_type_t del último WiFi.setSleep() aceptado
+uint8_t  potenciaTx();              ///< wifi_power_t del último WiFi.setTxPower(), en 0,25 dBm
+
+// -------- Internet (sonda del monitor) --------
+struct Internet {
+    bool     hay        = true;
+    int      codigo     = 204;      ///< lo que devuelve GET /generate_204
+    uint32_t latenciaMs = 40;
+};
+Internet& internet();
+uint32_t  sondasInternet();
+
+// -------- hora --------
+/** Dispara el callback de SNTP como si hubiera respondido con @p epochSegundos. */
+void sincronizarNtp(int64_t epochSegundos);
+
+// -------- pines y reinicio --------
+void     nivelPin(uint8_t pin, int nivel);    ///< lo que leerá digitalRead()
+int      salidaPin(uint8_t pin);              ///< último digitalWrite()
+uint32_t reinicios();                         ///< ESP.restart()
+
+// -------- tareas de FreeRTOS --------
+struct Tarea {
+    std::string nombre;
+    void      (*funcion)(void*);
+    void*       arg;
+    int         nucleo;
+    uint32_t    avisos;
+    bool        viva;               ///< false después de vTaskDelete()
+};
+const Tarea* tarea(const char* nombre);       ///< nullptr si nadie la creó
+size_t       cantidadTareas();
+/** Mientras vive, xTaskGetCurrentTaskHandle() devuelve @p handle. */
+class ComoTarea {
+public:
+    explicit ComoTarea(void* handle);
+    ~ComoTarea();
+private:
+    void* anterior;
+};
+void* handle(const char* nombreTarea);
+
+// -------- LittleFS --------
+struct Fs {
+    uint32_t aperturasLectura  = 0;
+    uint32_t aperturasEscritura = 0;
+    uint32_t bytesLeidos       = 0;
+    uint32_t bytesEscritos     = 0;
+    uint32_t renombres         = 0;
+    uint32_t borrados          = 0;
+    bool     fallarEscrituras  = false;   ///< write() devuelve 0
+    bool     montar            = true;    ///< LittleFS.begin() tiene éxito
+    uint32_t usPorKb           = 0;       ///< tiempo virtual de leer 1 KB de flash (0 = nada)
+};
+Fs& fs();
+void        escribirArchivo(const char* ruta, const std::string& contenido);
+bool        existeArchivo(const char* ruta);
+std::string leerArchivo(const char* ruta);
+std::vector<std::string> archivos();
+
+// -------- memoria dinámica (memoria.cpp) --------
+struct Memoria {
+    uint64_t asignaciones = 0;
+    uint64_t liberaciones = 0;
+    int64_t  bytesVivos   = 0;
+    int64_t  pico         = 0;
+};
+Memoria memoria();
+uint64_t asignaciones();
+/** Lleva el pico a lo que está vivo ahora (para medir el pico de un tramo). @return bytes vivos */
+int64_t  marcarPico();
+/** Mientras vive, lo que reserve el propio simulador no se cuenta. */
+class SinContar {
+public:
+    SinContar();
+    ~SinContar();
+};
+
+// -------- cerrojos (WmCerrojo) --------
+uint32_t bloqueos();                ///< wmBloquear() desde sim::reiniciar()
+uint64_t cerrojoMaxNs();            ///< mayor tiempo real con un cerrojo tomado
+/** Llamadas al driver de WiFi hechas con algún cerrojo tomado (debería ser 0). */
+uint32_t driverBajoCerrojo();
+
+// -------- HTTP --------
+enum class Metodo : uint8_t { GET, POST };
+
+struct CabeceraHttp {
+    char nombre[48];
+    char valor[160];
+};
+
+struct PedidoHttp {
+    Metodo metodo = Metodo::GET;
+    std::string ruta;                                        ///< sin la consulta
+    std::vector<std::pair<std::string, std::string>> args;   ///< consulta y formulario
+    std::vector<std::pair<std::string, std::string>> cabeceras;
+};
+
+struct RespuestaHttp {
+    int          codigo = 0;
+    char         tipo[64] = {0};
+    CabeceraHttp cabeceras[16];
+    uint8_t      nCabeceras = 0;
+    std::string  cuerpo;
+    bool         chunked = false;
+    size_t       largoDeclarado = 0;
+    uint32_t     trozos = 0;                ///< sendContent() / pedidos de bytes
+    bool         completa = false;
+    uint64_t     asignaciones = 0;          ///< new durante el manejador
+    int64_t      picoBytes = 0;             ///< memoria dinámica máxima por encima del inicio
+    uint64_t     primerByteNs = 0;          ///< reloj real, desde que el manejador empieza
+    uint64_t     totalNs = 0;
+    uint64_t     primerByteUs = 0;          ///< reloj virtual (incluye las lecturas de flash)
+    uint64_t     totalUs = 0;
+
+    const char* cabecera(const char* nombre) const;   ///< nullptr si no vino
+    void agregarCabecera(const char* nombre, const char* valor);
+};
+
+/** Lo que implementan los servidores simulados (WebServer y AsyncWebServer). */
+class ServidorHttp {
+public:
+    virtual ~ServidorHttp() {}
+    /** Recibe un pedido; @p respuesta debe vivir hasta que quede completa. */
+    virtual void entregar(const PedidoHttp& pedido, RespuestaHttp& respuesta) = 0;
+    /** El cliente se rindió: olvidar @p respuesta si sigue pendiente. */
+    virtual void abandonar(RespuestaHttp& respuesta) { (void)respuesta; }
+    /** Una vuelta de la tarea propia del servidor (AsyncTCP). WebServer no
+     *  tiene: lo atiende handleClient() desde update(). */
+    virtual void atender() {}
+};
+void          publicarServidor(uint16_t puerto, ServidorHttp* servidor);
+void          atenderServidores();      ///< atender() de todos los publicados
+void          retirarServidor(ServidorHttp* servidor);
+ServidorHttp* servidor(uint16_t puerto);
+
+/**
+ * @class ClienteHttp
+ * @brief Navegador en proceso: arma el pedido, lo entrega al servidor del
+ *        puerto y llama @p bombear (p. ej. wm.update()) y atenderServidores()
+ *        hasta que la respuesta esté completa.
+ */
+class ClienteHttp {
+public:
+    explicit ClienteHttp(std::function<void()> bombear = nullptr, uint16_t puerto = 80);
+
+    ClienteHttp& cabecera(const char* nombre, const char* valor);   ///< sólo para el próximo pedido
+    RespuestaHttp get(const char* uri);
+    RespuestaHttp post(const char* uri, const std::vector<std::pair<std::string, std::string>>& formulario);
+
+private:
+    RespuestaHttp enviar(PedidoHttp& pedido);
+
+    std::function<void()> bombear;
+    uint16_t puerto;
+    std::vector<std::pair<std::string, std::string>> siguientes;
+};
+
+// -------- estadística de las mediciones --------
+/** Percentil @p p (0..100) por rango más cercano; ordena @p muestras. */
+double percentil(std::vector<double>& muestras, double p);
+
+} // namespace sim
+
+#endif
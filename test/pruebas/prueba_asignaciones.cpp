@@ -0,0 +1,115 @@
+// Cero memoria dinámica en los caminos calientes: cada vuelta de update()
+// (portal abierto y conectado), / (embebido y desde LittleFS, con y sin gzip
+// y con 304), /scan (con y sin filtros) y la lectura del formulario de /save.
+// Lo que se arma una sola vez queda fuera con una primera pasada.
+
+#include "prueba.h"
+#include "escenario.h"
+
+namespace {
+
+void agregarRedes(int cantidad) {
+    for (int i = 0; i < cantidad; ++i) {
+        char ssid[24];
+        snprintf(ssid, sizeof(ssid), "Red-%02d", i);
+        sim::agregarRedFantasma(ssid, 1 + i % 11, -40 - i, i % 3 ? 3 : 0);
+    }
+}
+
+uint64_t asignacionesEnUpdate(WifiManager& wm, int vueltas) {
+    uint64_t antes = sim::asignaciones();
+    for (int i = 0; i < vueltas; ++i) {
+        wm.update();
+        sim::avanzar(10);
+    }
+    return sim::asignaciones() - antes;
+}
+
+// Pide @p uri dos veces (la primera arma lo que sea de una sola vez) y
+// devuelve las reservas de la segunda
+uint64_t asignacionesEnPedido(sim::ClienteHttp& cliente, const char* uri,
+                              const char* gzip = nullptr, const char* etag = nullptr) {
+    uint64_t asignaciones = 0;
+    for (int i = 0; i < 2; ++i) {
+        if (gzip) cliente.cabecera("Accept-Encoding", gzip);
+        if (etag) cliente.cabecera("If-None-Match", etag);
+        sim::RespuestaHttp r = cliente.get(uri);
+        VERIFICAR(r.codigo == 200 || r.codigo == 304);
+        asignaciones = r.asignaciones;
+    }
+    return asignaciones;
+}
+
+void verificarPortal(WifiManager& wm) {
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+    sim::RespuestaHttp primera = cliente.cabecera("Accept-Encoding", "gzip, deflate").get("/");
+    std::string etag = primera.cabecera("ETag") ? primera.cabecera("ETag") : "";
+    VERIFICAR(!etag.empty());
+
+    VERIFICAR_IGUAL(asignacionesEnPedido(cliente, "/"), 0u);
+    VERIFICAR_IGUAL(asignacionesEnPedido(cliente, "/", "gzip, deflate, br"), 0u);
+    VERIFICAR_IGUAL(asignacionesEnPedido(cliente, "/", "gzip, deflate", etag.c_str()), 0u);
+    VERIFICAR_IGUAL(asignacionesEnPedido(cliente, "/scan"), 0u);
+    VERIFICAR_IGUAL(asignacionesEnPedido(cliente, "/scan?min_rssi=-60&limit=5&secure=1"), 0u);
+}
+
+} // namespace
+
+PRUEBA(update_no_reserva_con_el_portal_ni_conectado) {
+    agregarRedes(30);
+    sim::agregarAp("Casa", "clave1234", 6, -55);
+    WifiManager wm;
+    wm.habilitarMetricas(true);
+    escenario::abrirPortal(wm);
+    sim::hasta([&wm]() { return wm.scanner().vigente(); }, [&wm]() { wm.update(); }, 10000);
+    asignacionesEnUpdate(wm, 100);
+    VERIFICAR_IGUAL(asignacionesEnUpdate(wm, 3000), 0u);    // incluye escaneos y muestreos periódicos
+
+    VERIFICAR(wm.agregarRed("Casa", "clave1234"));
+    wm.conectarAsync();
+    VERIFICAR(escenario::hastaOnline(wm, 10000) >= 0);
+    asignacionesEnUpdate(wm, 100);
+    VERIFICAR_IGUAL(asignacionesEnUpdate(wm, 3000), 0u);
+}
+
+PRUEBA(raiz_y_scan_sin_memoria_dinamica_embebido) {
+    agregarRedes(40);
+    WifiManager wm;
+    escenario::abrirPortal(wm);
+    sim::hasta([&wm]() { return wm.scanner().vigente(); }, [&wm]() { wm.update(); }, 10000);
+    verificarPortal(wm);
+}
+
+PRUEBA(raiz_y_scan_sin_memoria_dinamica_desde_littlefs) {
+    sim::escribirArchivo("/index.html", escenario::paginaDelRepo("index.html"));
+    sim::escribirArchivo("/index.html.gz", "GZ-comprimido");
+    agregarRedes(40);
+    WifiManager wm;
+    wm.usarPortalEmbebido(false);
+    escenario::abrirPortal(wm);
+    sim::hasta([&wm]() { return wm.scanner().vigente(); }, [&wm]() { wm.update(); }, 10000);
+    verificarPortal(wm);
+}
+
+// El formulario se lee por referencia: ni el SSID ni la clave se copian a un
+// String, aunque pasen de los 11 caracteres que entran sin heap
+PRUEBA(save_lee_el_formulario_sin_copias) {
+    WifiManager wm;
+    escenario::abrirPortal(wm);
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+    std::vector<std::pair<std::string, std::string>> formulario;
+    formulario.push_back(std::make_pair(std::string("ssid"), std::string("Oficina-Planta-Alta")));
+    formulario.push_back(std::make_pair(std::string("password"), std::string("una-clave-bastante-larga")));
+
+    sim::RespuestaHttp r = cliente.post("/save", formulario);
+    VERIFICAR_IGUAL(r.codigo, 200);
+    VERIFICAR_IGUAL(r.asignaciones, 0u);
+    VERIFICAR(wm.redesGuardadas().indice("Oficina-Planta-Alta") >= 0);
+
+    formulario[1].second = "";
+    r = cliente.post("/save", formulario);
+    VERIFICAR_IGUAL(r.codigo, 500);
+    VERIFICAR_IGUAL(r.asignaciones, 0u);
+}
+
+PRUEBAS_MAIN()
@@ -0,0 +1,99 @@
+// ETag y 304 de las páginas del portal: un navegador cautivo que recarga /
+// varias veces recibe el cuerpo una sola vez. Se cuentan los bytes que viajan
+// con y sin If-None-Match y se comparan con lo que dicen las métricas.
+
+#include "prueba.h"
+#include "escenario.h"
+
+namespace {
+
+const int RECARGAS = 20;
+
+struct Carga {
+    size_t   bytes = 0;         ///< cuerpos recibidos en todas las recargas
+    size_t   pagina = 0;        ///< largo de la primera respuesta
+    int      noModificadas = 0;
+};
+
+// Recarga / como un navegador: con @p conCache devuelve la última ETag vista
+Carga recargar(WifiManager& wm, bool conCache) {
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+    Carga c;
+    std::string etag;
+    for (int i = 0; i < RECARGAS; ++i) {
+        cliente.cabecera("Accept-Encoding", "gzip, deflate");
+        if (conCache && !etag.empty()) cliente.cabecera("If-None-Match", etag.c_str());
+        sim::RespuestaHttp r = cliente.get("/");
+        VERIFICAR(r.codigo == 200 || r.codigo == 304);
+        if (r.codigo == 304) {
+            ++c.noModificadas;
+            VERIFICAR(r.cuerpo.empty());
+        } else {
+            VERIFICAR(r.cabecera("ETag") != nullptr);
+            VERIFICAR(r.cabecera("Cache-Control") != nullptr);
+            if (r.cabecera("ETag")) etag = r.cabecera("ETag");
+        }
+        if (i == 0) c.pagina = r.cuerpo.size();
+        c.bytes += r.cuerpo.size();
+    }
+    return c;
+}
+
+void verificarAhorro(WifiManager& wm, const char* caso) {
+    Carga sinCache = recargar(wm, false);
+    uint32_t ahorradosAntes = wm.metricas().httpBytesAhorrados;
+    Carga conCache = recargar(wm, true);
+    uint32_t ahorrados = wm.metricas().httpBytesAhorrados - ahorradosAntes;
+
+    char nombre[64];
+    snprintf(nombre, sizeof(nombre), "cache_portal.%s.sin_etag", caso);
+    prueba::medir(nombre, static_cast<double>(sinCache.bytes), "bytes");
+    snprintf(nombre, sizeof(nombre), "cache_portal.%s.con_etag", caso);
+    prueba::medir(nombre, static_cast<double>(conCache.bytes), "bytes");
+    snprintf(nombre, sizeof(nombre), "cache_portal.%s.ahorrados", caso);
+    prueba::medir(nombre, static_cast<double>(ahorrados), "bytes");
+
+    VERIFICAR(sinCache.pagina > 0);
+    VERIFICAR_IGUAL(sinCache.noModificadas, 0);
+    VERIFICAR_IGUAL(sinCache.bytes, sinCache.pagina * RECARGAS);
+    // Sólo la primera carga trae el cuerpo; el resto es 304
+    VERIFICAR_IGUAL(conCache.noModificadas, RECARGAS - 1);
+    VERIFICAR_IGUAL(conCache.bytes, conCache.pagina);
+    VERIFICAR_IGUAL(static_cast<size_t>(ahorrados), sinCache.bytes - conCache.bytes);
+
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+    char linea[64];
+    snprintf(linea, sizeof(linea), "wm_http_bytes_saved_total %lu",
+             static_cast<unsigned long>(wm.metricas().httpBytesAhorrados));
+    VERIFICAR(cliente.get("/metrics").cuerpo.find(linea) != std::string::npos);
+}
+
+} // namespace
+
+PRUEBA(recargas_del_portal_embebido) {
+    WifiManager wm;
+    wm.habilitarMetricas(true);
+    escenario::abrirPortal(wm);
+    verificarAhorro(wm, "embebido");
+}
+
+PRUEBA(recargas_desde_littlefs_sin_gzip) {
+    sim::escribirArchivo("/index.html", escenario::paginaDelRepo("index.html"));
+    WifiManager wm;
+    wm.usarPortalEmbebido(false);
+    wm.habilitarMetricas(true);
+    escenario::abrirPortal(wm);
+    verificarAhorro(wm, "littlefs");
+}
+
+PRUEBA(cache_control_por_pagina) {
+    WifiManager wm;
+    wm.setCacheControl("index.html", 3600);
+    escenario::abrirPortal(wm);
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+    VERIFICAR_TEXTO(cliente.get("/").cabecera("Cache-Control"), "max-age=3600");
+    wm.setCacheControl("index.html", 0);
+    VERIFICAR_TEXTO(cliente.get("/").cabecera("Cache-Control"), "no-cache");
+}
+
+PRUEBAS_MAIN()
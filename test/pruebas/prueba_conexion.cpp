@@ -0,0 +1,200 @@
+// Conexión, reconexión y portal del WifiManager contra la radio simulada.
+
+#include "prueba.h"
+#include "escenario.h"
+
+PRUEBA(arranque_conecta_y_queda_online) {
+    sim::agregarAp("Casa", "clave1234", 6, -55);
+    escenario::guardarRed("Casa", "clave1234");
+
+    WifiManager wm;
+    wm.begin();
+    VERIFICAR(wm.tieneCredenciales());
+    VERIFICAR(wm.conectarAsync());
+    int32_t ms = escenario::hastaOnline(wm, 10000);
+    VERIFICAR(ms >= 0);
+    VERIFICAR(wm.isConnected());
+    VERIFICAR(sim::staConIp());
+    // Sin caché hace el barrido completo: barrido + asociación + DHCP
+    const sim::ConfigRadio& r = sim::radio();
+    VERIFICAR(ms >= static_cast<int32_t>(r.barridoMs + r.asociacionMs + r.dhcpMs));
+}
+
+PRUEBA(con_cache_reconecta_directo_al_bssid) {
+    sim::agregarAp("Casa", "clave1234", 6, -55);
+    escenario::guardarRed("Casa", "clave1234");
+    {
+        WifiManager primero;
+        primero.begin();
+        primero.conectarAsync();
+        VERIFICAR(escenario::hastaOnline(primero, 10000) >= 0);
+    }
+
+    WifiManager wm;
+    wm.begin();
+    wm.conectarAsync();
+    int32_t ms = escenario::hastaOnline(wm, 10000);
+    VERIFICAR(ms >= 0);
+    VERIFICAR(wm.getTiemposConexion().rapida);
+    VERIFICAR(!wm.getTiemposConexion().fallback);
+    VERIFICAR(ms < static_cast<int32_t>(sim::radio().barridoMs));
+}
+
+PRUEBA(clave_incorrecta_termina_en_backoff) {
+    sim::agregarAp("Casa", "otra-clave", 6, -55);
+    escenario::guardarRed("Casa", "clave1234");
+
+    WifiManager wm;
+    wm.begin();
+    wm.conectarAsync();
+    VERIFICAR(escenario::hastaEstado(wm, EstadoWiFi::BACKOFF, 40000) >= 0);
+    VERIFICAR(!wm.isConnected());
+}
+
+PRUEBA(caida_del_ap_reconecta_sola) {
+    size_t ap = sim::agregarAp("Casa", "clave1234", 6, -55);
+    escenario::guardarRed("Casa", "clave1234");
+
+    WifiManager wm;
+    wm.begin();
+    wm.conectarAsync();
+    VERIFICAR(escenario::hastaOnline(wm, 10000) >= 0);
+
+    sim::encenderAp(ap, false);
+    VERIFICAR(escenario::hastaEstado(wm, EstadoWiFi::BACKOFF, 1000) >= 0);
+    sim::avanzar(3000);
+    sim::encenderAp(ap, true);
+    VERIFICAR(escenario::hastaOnline(wm, 120000) >= 0);
+    VERIFICAR(wm.metricas().reconexionesOk >= 1);
+}
+
+// El core reintenta solo tras BEACON_TIMEOUT o un handshake vencido; el
+// manager lo apaga para que los reintentos sigan su PlanReconexion (jitter y
+// freno con la clave incorrecta)
+PRUEBA(el_driver_no_reintenta_por_su_cuenta) {
+    size_t ap = sim::agregarAp("Casa", "otra-clave", 6, -55);
+    escenario::guardarRed("Casa", "clave1234");
+    WifiManager wm;
+    wm.begin();
+    VERIFICAR(!WiFi.getAutoReconnect());
+    wm.conectarAsync();
+    VERIFICAR(sim::hasta([&wm]() { return wm.planReconexion().detenido(); }, [&wm]() { wm.update(); }, 120000) >= 0);
+    uint32_t asociaciones = sim::asociacionesIniciadas();
+    sim::hasta([]() { return false; }, [&wm]() { wm.update(); }, 60000);
+    VERIFICAR_IGUAL(sim::asociacionesIniciadas(), asociaciones);
+
+    // La caída del AP tampoco dispara una asociación fuera del plan
+    sim::ap(ap).clave = "clave1234";
+    wm.forzarReconexion();
+    VERIFICAR(escenario::hastaOnline(wm, 120000) >= 0);
+    sim::encenderAp(ap, false);
+    VERIFICAR(escenario::hastaEstado(wm, EstadoWiFi::BACKOFF, 1000) >= 0);
+    VERIFICAR_IGUAL(sim::reconexionesDriver(), 0u);
+}
+
+// Si el enlace vuelve mientras se espera (otro WiFi.begin(), o el core con su
+// auto-reconnect reactivado), BACKOFF lo toma en vez de tirarlo con un intento nuevo
+PRUEBA(el_enlace_que_vuelve_durante_el_backoff_queda_online) {
+    size_t ap = sim::agregarAp("Casa", "clave1234", 6, -55);
+    escenario::guardarRed("Casa", "clave1234");
+    WifiManager wm;
+    ConfigReconexion cfg;
+    cfg.baseMs = 60000;
+    wm.configurarReconexion(cfg);
+    wm.begin();
+    wm.conectarAsync();
+    VERIFICAR(escenario::hastaOnline(wm, 10000) >= 0);
+
+    sim::encenderAp(ap, false);
+    VERIFICAR(escenario::hastaEstado(wm, EstadoWiFi::BACKOFF, 1000) >= 0);
+    sim::encenderAp(ap, true);
+    uint32_t intentos = wm.metricas().reconexionIntentos;
+    uint32_t asociaciones = sim::asociacionesIniciadas();
+    WiFi.begin("Casa", "clave1234");
+    VERIFICAR(escenario::hastaOnline(wm, 10000) >= 0);
+    VERIFICAR_IGUAL(wm.metricas().reconexionIntentos, intentos);
+    VERIFICAR_IGUAL(sim::asociacionesIniciadas(), asociaciones + 1);
+    VERIFICAR(wm.isConnected());
+}
+
+PRUEBA(la_sonda_de_internet_arranca_con_hay_internet) {
+    sim::agregarAp("Casa", "clave1234", 6, -55);
+    escenario::guardarRed("Casa", "clave1234");
+
+    WifiManager wm;
+    wm.begin();
+    wm.conectarAsync();
+    VERIFICAR(escenario::hastaOnline(wm, 10000) >= 0);
+    sim::avanzar(60000);
+    VERIFICAR(sim::tarea("wm_internet") == nullptr);   // nadie preguntó: ni tarea ni sondas
+    VERIFICAR(!wm.monitorInternet().activo());
+
+    wm.hayInternet();
+    const sim::Tarea* t = sim::tarea("wm_internet");
+    VERIFICAR(t != nullptr);
+    VERIFICAR(t->avisos >= 1);                          // con enlace sondea enseguida
+    wm.hayInternet();
+    VERIFICAR_IGUAL(sim::cantidadTareas(), 1u);
+}
+
+// Con tarea propia, lo que la app llama desde loop() se encola: la máquina de
+// estados y la cola del enlace las toca sólo la tarea del manager
+PRUEBA(en_modo_tarea_la_app_no_consume_el_enlace) {
+    size_t ap = sim::agregarAp("Casa", "clave1234", 6, -55);
+    WifiManager wm;
+    wm.begin();
+    static void* tarea;
+    static int desdeLaTarea, desdeOtra;
+    desdeLaTarea = desdeOtra = 0;
+    wm.onEnlace([](const EventoEnlace&, void*) {
+        ++(xTaskGetCurrentTaskHandle() == tarea ? desdeLaTarea : desdeOtra);
+    });
+    VERIFICAR(wm.iniciarTarea(1));
+    tarea = sim::handle("wm_manager");
+    auto vueltaTarea = [&wm]() { sim::ComoTarea t(tarea); wm.update(); };
+    auto online = [&wm]() { return wm.getEstado() == EstadoWiFi::ONLINE; };
+
+    VERIFICAR(wm.agregarRed("Casa", "clave1234"));      // entra a la cola
+    VERIFICAR_IGUAL(wm.redesGuardadas().cantidad(), 0u);
+    vueltaTarea();
+    VERIFICAR_IGUAL(wm.redesGuardadas().cantidad(), 1u);
+    EventoWiFi ev;
+    bool guardada = false;
+    while (wm.siguienteEvento(ev)) guardada |= ev.tipo == TipoEventoWiFi::RED_GUARDADA && ev.ok;
+    VERIFICAR(guardada);
+
+    // Sin vueltas de la tarea, connectToWiFi() sólo espera: no asocia por su cuenta
+    VERIFICAR(!wm.connectToWiFi());
+    VERIFICAR(wm.getEstado() == EstadoWiFi::IDLE);
+    VERIFICAR(sim::hasta(online, vueltaTarea, 10000) >= 0);
+
+    wm.reintentarConexionSiNecesario();
+    VERIFICAR(!wm.scanRedDetectada());
+    VERIFICAR(escenario::hastaOnline(wm, 100) >= 0);    // update() desde otra tarea no rompe nada
+
+    sim::encenderAp(ap, false);
+    VERIFICAR(sim::hasta([&wm]() { return wm.getEstado() == EstadoWiFi::BACKOFF; }, vueltaTarea, 1000) >= 0);
+    wm.forzarReconexion();
+    VERIFICAR(wm.getEstado() == EstadoWiFi::BACKOFF);
+    VERIFICAR_IGUAL(wm.metricas().reconexionIntentos, 0u);
+    vueltaTarea();                                      // la tarea atiende la reconexión pedida
+    VERIFICAR_IGUAL(wm.metricas().reconexionIntentos, 1u);
+    sim::encenderAp(ap, true);
+    VERIFICAR(sim::hasta(online, vueltaTarea, 60000) >= 0);
+
+    VERIFICAR(desdeLaTarea > 0);
+    VERIFICAR_IGUAL(desdeOtra, 0);
+}
+
+PRUEBA(sin_credenciales_abre_el_portal) {
+    WifiManager wm;
+    escenario::abrirPortal(wm);
+    VERIFICAR(wm.getEstado() == EstadoWiFi::PORTAL);
+
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+    sim::RespuestaHttp r = cliente.get("/");
+    VERIFICAR_IGUAL(r.codigo, 200);
+    VERIFICAR(!r.cuerpo.empty());
+}
+
+PRUEBAS_MAIN()
@@ -0,0 +1,85 @@
+// Espacios de configuración cuyo archivo no entra en AlmacenConfig: valores
+// anidados, textos más largos que WM_CONFIG_VALOR, más claves que
+// WM_CONFIG_CLAVES o un archivo más grande que el documento. Se leen las
+// claves que entran y el espacio queda de sólo lectura, así el archivo nunca
+// se reescribe sin lo demás.
+
+#include "prueba.h"
+#include "escenario.h"
+
+namespace {
+
+// setConfig() y borrarConfig() fallan y el archivo queda como estaba. Con
+// @p otroEspacio, "setup" sigue guardándose (si quedó lugar en RAM).
+void verificarSoloLectura(WifiManager& wm, const char* ruta, const std::string& original, bool otroEspacio = true) {
+    VERIFICAR(!wm.setConfig("iporton", "puerto", 9090));
+    VERIFICAR(!wm.setConfig("iporton", "nueva", "x"));
+    VERIFICAR(!wm.borrarConfig("iporton", "puerto"));
+    VERIFICAR(wm.guardarConfig());
+    for (int i = 0; i < 500; ++i) {
+        wm.update();
+        sim::avanzar(10);
+    }
+    VERIFICAR_IGUAL(wm.metricas().configEscrituras, 0u);
+    VERIFICAR(sim::leerArchivo(ruta) == original);
+
+    if (!otroEspacio) return;
+    VERIFICAR(wm.setConfig("setup", "nombre", "porton"));
+    VERIFICAR(wm.guardarConfig());
+    VERIFICAR_IGUAL(wm.metricas().configEscrituras, 1u);
+}
+
+} // namespace
+
+PRUEBA(lo_anidado_o_largo_deja_el_espacio_de_solo_lectura) {
+    std::string original = "{\"puerto\":8080,\"mqtt\":{\"host\":\"h\"},\"cert\":\"" +
+                           std::string(WM_CONFIG_VALOR, 'c') + "\",\"activo\":true}";
+    sim::escribirArchivo("/iporton.json", original);
+    WifiManager wm;
+    wm.begin();
+
+    VERIFICAR_IGUAL(wm.getConfigInt("iporton", "puerto"), 8080);
+    VERIFICAR(wm.getConfigBool("iporton", "activo"));
+    verificarSoloLectura(wm, "/iporton.json", original);
+}
+
+PRUEBA(mas_claves_de_las_que_entran) {
+    std::string original = "{";
+    for (int i = 0; i < WM_CONFIG_CLAVES + 4; ++i) {
+        char par[24];
+        snprintf(par, sizeof(par), "%s\"k%d\":%d", i ? "," : "", i, i);
+        original += par;
+    }
+    original += "}";
+    sim::escribirArchivo("/iporton.json", original);
+    WifiManager wm;
+    wm.begin();
+
+    VERIFICAR_IGUAL(wm.getConfigInt("iporton", "k0", -1), 0);
+    verificarSoloLectura(wm, "/iporton.json", original, false);     // "iporton" ocupó todas las entradas
+}
+
+PRUEBA(un_archivo_que_no_entra_en_el_documento) {
+    std::string original = "{\"lista\":[";
+    for (int i = 0; i < WM_CONFIG_CLAVES * 32; ++i) original += i ? ",1" : "1";
+    original += "]}";
+    sim::escribirArchivo("/iporton.json", original);
+    WifiManager wm;
+    wm.begin();
+    verificarSoloLectura(wm, "/iporton.json", original);
+}
+
+// eraseAll() borra el archivo: el espacio vuelve a aceptar cambios
+PRUEBA(erase_all_libera_el_espacio) {
+    sim::escribirArchivo("/iporton.json", "{\"mqtt\":{\"host\":\"h\"}}");
+    WifiManager wm;
+    wm.begin();
+    VERIFICAR(!wm.setConfig("iporton", "puerto", 9090));
+
+    wm.eraseAll();
+    VERIFICAR(wm.setConfig("iporton", "puerto", 9090));
+    VERIFICAR(wm.guardarConfig());
+    VERIFICAR(sim::leerArchivo("/iporton.json") == "{\"puerto\":9090}");
+}
+
+PRUEBAS_MAIN()
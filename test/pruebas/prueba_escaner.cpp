@@ -0,0 +1,214 @@
+// WifiScanner y CursorJsonScan con 100 redes sintéticas: más de las que entran
+// en la caché, SSID repetidos en varios canales, uno oculto y nombres que hay
+// que escapar. El JSON se arma en bloques chicos y se vuelve a parsear.
+
+#include "prueba.h"
+#include "escenario.h"
+
+#include <ArduinoJson.h>
+#include <map>
+#include <set>
+
+namespace {
+
+const int REDES = 100;
+
+struct Esperado {
+    int  aps = 0;
+    std::set<int> canales;
+    int  rssi = -128;
+    bool segura = false;
+};
+
+std::string ssidSintetico(int i) {
+    char ssid[33];
+    int k = i % 70;                                     // las primeras 30 aparecen dos veces
+    if (k == 5) return "";                              // oculta
+    if (k == 7) return "Caf\xC3\xA9 \"7\" \\ x";
+    if (k == 9) return "\x01tab\t9";
+    snprintf(ssid, sizeof(ssid), "Red-%02d", k);
+    return ssid;
+}
+
+int rssiSintetico(int i) { return -30 - (i * 7) % 61; }
+
+void cargarRedes() {
+    for (int i = 0; i < REDES; ++i) {
+        sim::agregarRedFantasma(ssidSintetico(i).c_str(), static_cast<uint8_t>(1 + i % 11),
+                                static_cast<int8_t>(rssiSintetico(i)), i % 4 == 0 ? WIFI_AUTH_OPEN : WIFI_AUTH_WPA2_PSK);
+    }
+}
+
+// Lo que debería listar /scan: sólo entra lo que cabe en la caché
+std::map<std::string, Esperado> esperado() {
+    std::map<std::string, Esperado> grupos;
+    for (int i = 0; i < REDES && i < WM_SCAN_MAX; ++i) {
+        std::string ssid = ssidSintetico(i);
+        if (ssid.empty()) continue;
+        Esperado& g = grupos[ssid];
+        ++g.aps;
+        g.canales.insert(1 + i % 11);
+        if (rssiSintetico(i) > g.rssi) {
+            g.rssi = rssiSintetico(i);
+            g.segura = i % 4 != 0;
+        }
+    }
+    return grupos;
+}
+
+void escanear(WifiScanner& escaner) {
+    VERIFICAR(escaner.solicitar());
+    sim::hasta([&escaner]() { return !escaner.enCurso(); }, [&escaner]() { escaner.update(); }, 10000);
+}
+
+std::string leerTodo(CursorJsonScan& cursor, size_t bloque) {
+    std::string json;
+    uint8_t buf[512];
+    size_t n;
+    while ((n = cursor.leer(buf, bloque)) > 0) json.append(reinterpret_cast<char*>(buf), n);
+    return json;
+}
+
+// Parsea y compara contra lo esperado. @return redes listadas
+size_t verificarJson(const std::string& json, const FiltroScan& filtro = FiltroScan()) {
+    DynamicJsonDocument doc(32768);
+    DeserializationError error = deserializeJson(doc, json.c_str());
+    VERIFICAR(!error);
+    if (error) return 0;
+
+    std::map<std::string, Esperado> grupos = esperado();
+    std::set<std::string> vistas;
+    int anterior = 0;
+    JsonArray lista = doc.as<JsonArray>();
+    for (JsonObject red : lista) {
+        std::string ssid = red["ssid"] | "";
+        int rssi = red["rssi"] | 0;
+        VERIFICAR(grupos.count(ssid) == 1);
+        VERIFICAR(vistas.insert(ssid).second);                  // un objeto por SSID
+        VERIFICAR(rssi <= anterior);                            // de mejor a peor señal
+        anterior = rssi;
+        VERIFICAR(rssi >= filtro.minRssi);
+        if (filtro.segura >= 0) VERIFICAR_IGUAL(red["secure"].as<bool>(), filtro.segura == 1);
+
+        const Esperado& g = grupos[ssid];
+        VERIFICAR_IGUAL(rssi, g.rssi);
+        VERIFICAR_IGUAL(red["secure"].as<bool>(), g.segura);
+        VERIFICAR_IGUAL(red["aps"] | 0, g.aps);
+        VERIFICAR_IGUAL(red["channels"] | 0, static_cast<int>(g.canales.size()));
+    }
+    return lista.size();
+}
+
+} // namespace
+
+PRUEBA(la_cache_se_llena_y_cuenta_las_sobrantes) {
+    cargarRedes();
+    WifiScanner escaner;
+    escanear(escaner);
+
+    VERIFICAR(escaner.vigente());
+    VERIFICAR_IGUAL(escaner.cantidad(), WM_SCAN_MAX);
+    VERIFICAR_IGUAL(escaner.descartadas(), REDES - WM_SCAN_MAX);
+    VERIFICAR_IGUAL(escaner.cantidadGrupos(), esperado().size());
+    for (const auto& g : esperado()) VERIFICAR_IGUAL(escaner.mejorRssi(g.first.c_str()), g.second.rssi);
+}
+
+// Un SSID de 32 bytes, el máximo del estándar, entra entero
+PRUEBA(el_ssid_mas_largo_entra_entero) {
+    const std::string largo(32, 's');
+    sim::agregarRedFantasma(largo.c_str(), 6, -50, WIFI_AUTH_WPA2_PSK);
+    WifiScanner escaner;
+    escanear(escaner);
+
+    VERIFICAR_IGUAL(escaner.cantidad(), 1);
+    VERIFICAR(escaner.red(0).ssid == largo);
+}
+
+// El driver se lee y se agrupa fuera del cerrojo; con él sólo se cambia la
+// caché vigente, así que /scan en el servidor asíncrono no espera a la radio
+PRUEBA(copiar_y_agrupar_no_toma_el_cerrojo) {
+    cargarRedes();
+    WifiScanner escaner;
+    escanear(escaner);
+    uint32_t bloqueos = sim::bloqueos();
+    escanear(escaner);
+
+    VERIFICAR_IGUAL(sim::driverBajoCerrojo(), 0u);
+    VERIFICAR(sim::bloqueos() > bloqueos);
+    prueba::medir("escaner.cerrojo_max", sim::cerrojoMaxNs() / 1000.0, "us");
+    VERIFICAR(sim::cerrojoMaxNs() < 1000000);           // un cambio de índice, no 64 copias
+    VERIFICAR_IGUAL(escaner.cantidadGrupos(), esperado().size());
+
+    RedAgrupada g;
+    for (uint8_t i = 0; i < escaner.cantidadGrupos(); ++i) {
+        VERIFICAR(escaner.copiarGrupo(i, escaner.generacion(), g));
+        VERIFICAR_IGUAL(static_cast<size_t>(g.canales), esperado()[g.mejor.ssid].canales.size());
+    }
+}
+
+PRUEBA(el_cursor_arma_json_valido_en_cualquier_bloque) {
+    cargarRedes();
+    WifiScanner escaner;
+    escanear(escaner);
+
+    const size_t bloques[] = { 1, 7, 64, 512 };
+    for (size_t bloque : bloques) {
+        CursorJsonScan cursor(escaner);
+        VERIFICAR_IGUAL(verificarJson(leerTodo(cursor, bloque)), esperado().size());
+    }
+}
+
+PRUEBA(filtros_del_cursor) {
+    cargarRedes();
+    WifiScanner escaner;
+    escanear(escaner);
+
+    FiltroScan fuertes;
+    fuertes.leer("min_rssi", "-60");
+    CursorJsonScan cursorFuertes(escaner, fuertes);
+    size_t n = verificarJson(leerTodo(cursorFuertes, 64), fuertes);
+    size_t esperadas = 0;
+    for (const auto& g : esperado()) esperadas += g.second.rssi >= -60;
+    VERIFICAR_IGUAL(n, esperadas);
+
+    FiltroScan pocas;
+    pocas.leer("limit", "5");
+    CursorJsonScan cursorPocas(escaner, pocas);
+    VERIFICAR_IGUAL(verificarJson(leerTodo(cursorPocas, 64), pocas), 5u);
+
+    FiltroScan abiertas;
+    abiertas.leer("secure", "0");
+    CursorJsonScan cursorAbiertas(escaner, abiertas);
+    VERIFICAR(verificarJson(leerTodo(cursorAbiertas, 64), abiertas) > 0);
+}
+
+PRUEBA(un_escaneo_nuevo_a_mitad_cierra_el_arreglo) {
+    cargarRedes();
+    WifiScanner escaner;
+    escanear(escaner);
+
+    CursorJsonScan cursor(escaner);
+    uint8_t buf[200];
+    std::string json(reinterpret_cast<char*>(buf), cursor.leer(buf, sizeof(buf)));
+    escanear(escaner);
+    json += leerTodo(cursor, 64);
+
+    size_t n = verificarJson(json);
+    VERIFICAR(n > 0 && n < esperado().size());
+}
+
+PRUEBA(scan_del_portal_con_cien_redes) {
+    cargarRedes();
+    WifiManager wm;
+    escenario::abrirPortal(wm);
+    sim::hasta([&wm]() { return wm.scanner().vigente(); }, [&wm]() { wm.update(); }, 10000);
+
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+    sim::RespuestaHttp r = cliente.get("/scan");
+    VERIFICAR_IGUAL(r.codigo, 200);
+    VERIFICAR(r.chunked);
+    VERIFICAR_TEXTO(r.cabecera("X-Scan-Truncated"), "36");
+    VERIFICAR_IGUAL(verificarJson(r.cuerpo), esperado().size());
+}
+
+PRUEBAS_MAIN()
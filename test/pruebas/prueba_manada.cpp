@@ -0,0 +1,110 @@
+// Manada: cientos de equipos pierden el mismo AP cuando se reinicia. Se
+// compara el reintento fijo de antes (cada 10 s, todos a la vez) con
+// PlanReconexion, en ranuras de 100 ms y con un AP que sólo acepta unas
+// pocas asociaciones por ranura; las que no entran terminan en TIMEOUT.
+
+#include "prueba.h"
+#include "planreconexion.h"
+#include <esp_random.h>
+
+namespace {
+
+const int      EQUIPOS = 300;
+const uint32_t RANURA_MS = 100;
+const uint32_t AP_CAIDO_MS = 20000;         ///< lo que tarda el AP en volver
+const int      CAPACIDAD_POR_RANURA = 4;    ///< asociaciones que el AP atiende cada 100 ms
+const uint32_t FIJO_MS = 10000;             ///< reintentarConexionSiNecesario() anterior
+const uint32_t LIMITE_MS = 3600000;
+
+struct Resultado {
+    uint32_t picoPorSegundo = 0;    ///< intentos contra el AP en el peor segundo
+    uint32_t todosMs = 0;           ///< hasta que el último volvió a conectar
+    uint32_t mitadMs = 0;
+    uint32_t intentos = 0;
+    uint32_t timeouts = 0;
+};
+
+uint32_t aleatorioHardware(void*) {
+    return esp_random();
+}
+
+struct Equipo {
+    PlanReconexion plan;
+    uint32_t       proximoMs = 0;
+    bool           conectado = false;
+};
+
+// Todos pierden el enlace en t = 0. Con @p conPlan cada uno espera lo que diga
+// su PlanReconexion; sin él, reintenta cada FIJO_MS desde el mismo instante.
+Resultado simular(bool conPlan) {
+    std::vector<Equipo> equipos(EQUIPOS);
+    for (Equipo& e : equipos) {
+        e.plan.setAleatorio(aleatorioHardware, nullptr);
+        e.proximoMs = conPlan ? e.plan.registrarFallo(MotivoFallo::ENLACE_PERDIDO) : FIJO_MS;
+    }
+
+    Resultado r;
+    std::vector<uint32_t> porSegundo(LIMITE_MS / 1000, 0);
+    int conectados = 0;
+    for (uint32_t t = 0; t < LIMITE_MS && conectados < EQUIPOS; t += RANURA_MS) {
+        int atendidos = 0;
+        for (Equipo& e : equipos) {
+            if (e.conectado || e.proximoMs > t) continue;
+            ++r.intentos;
+            if (t >= AP_CAIDO_MS) ++porSegundo[t / 1000];   // antes sólo escanean, el AP no los ve
+
+            MotivoFallo motivo = MotivoFallo::NINGUNO;
+            if (t < AP_CAIDO_MS)                            motivo = MotivoFallo::AP_NO_ENCONTRADO;
+            else if (atendidos++ >= CAPACIDAD_POR_RANURA)   motivo = MotivoFallo::TIMEOUT;
+
+            if (motivo == MotivoFallo::NINGUNO) {
+                e.conectado = true;
+                e.plan.registrarExito();
+                if (++conectados == EQUIPOS / 2) r.mitadMs = t;
+                continue;
+            }
+            if (motivo == MotivoFallo::TIMEOUT) ++r.timeouts;
+            uint32_t espera = conPlan ? e.plan.registrarFallo(motivo) : FIJO_MS;
+            e.proximoMs = t + (espera < RANURA_MS ? RANURA_MS : espera);
+        }
+        if (conectados == EQUIPOS) r.todosMs = t;
+    }
+    for (uint32_t n : porSegundo) {
+        if (n > r.picoPorSegundo) r.picoPorSegundo = n;
+    }
+    VERIFICAR_IGUAL(conectados, EQUIPOS);
+    return r;
+}
+
+void informar(const char* nombre, const Resultado& r) {
+    char clave[64];
+    snprintf(clave, sizeof(clave), "manada.%s.pico_intentos", nombre);
+    prueba::medir(clave, r.picoPorSegundo, "intentos/s");
+    snprintf(clave, sizeof(clave), "manada.%s.mitad_conectados", nombre);
+    prueba::medir(clave, r.mitadMs / 1000.0, "s");
+    snprintf(clave, sizeof(clave), "manada.%s.todos_conectados", nombre);
+    prueba::medir(clave, r.todosMs / 1000.0, "s");
+    snprintf(clave, sizeof(clave), "manada.%s.intentos", nombre);
+    prueba::medir(clave, r.intentos, "intentos");
+    snprintf(clave, sizeof(clave), "manada.%s.timeouts", nombre);
+    prueba::medir(clave, r.timeouts, "intentos");
+}
+
+} // namespace
+
+PRUEBA(la_manada_se_dispersa_tras_reiniciar_el_ap) {
+    sim::semilla(15);
+    Resultado fijo = simular(false);
+    Resultado plan = simular(true);
+    informar("fijo", fijo);
+    informar("plan", plan);
+
+    // Cuando el AP vuelve, el reintento fijo llega en bloque: todos en la misma ranura
+    VERIFICAR_IGUAL(fijo.picoPorSegundo, static_cast<uint32_t>(EQUIPOS));
+    // Con jitter ningún segundo ve más de un décimo de la manada
+    VERIFICAR(plan.picoPorSegundo * 10 <= static_cast<uint32_t>(EQUIPOS));
+    VERIFICAR(plan.timeouts * 4 < fijo.timeouts);
+    VERIFICAR(plan.todosMs < fijo.todosMs);
+}
+
+PRUEBAS_MAIN()
@@ -0,0 +1,75 @@
+// Parámetros propios del portal y /params: lo que no entra en
+// WM_PARAMETRO_JSON se rechaza al registrarlo, así la página nunca recibe un
+// objeto cortado, ni con el peor valor que el campo acepta.
+
+#include "prueba.h"
+#include "escenario.h"
+
+#include <ArduinoJson.h>
+
+namespace {
+
+// /params parseado; falla la prueba si no es JSON válido
+void leerParams(WifiManager& wm, DynamicJsonDocument& doc) {
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+    sim::RespuestaHttp r = cliente.get("/params");
+    VERIFICAR_IGUAL(r.codigo, 200);
+    VERIFICAR(!deserializeJson(doc, r.cuerpo.c_str()));
+}
+
+} // namespace
+
+PRUEBA(lo_que_no_entra_se_rechaza_al_registrar) {
+    ParametrosPortal parametros;
+    static const std::string etiqueta(WM_PARAMETRO_JSON, 'e');
+    static std::string opciones;
+    for (int i = 0; opciones.size() < WM_PARAMETRO_JSON; ++i) opciones += i ? "|opcion" : "opcion";
+
+    VERIFICAR(!parametros.agregarTexto("nombre", etiqueta.c_str()));
+    VERIFICAR(!parametros.agregarEntero("intervalo", etiqueta.c_str(), 60));
+    VERIFICAR(!parametros.agregarBool("tls", etiqueta.c_str()));
+    VERIFICAR(!parametros.agregarOpciones("modo", "Modo", opciones.c_str(), "opcion"));
+    VERIFICAR_IGUAL(parametros.cantidad(), 0);
+
+    // Lo mismo con etiquetas normales entra, con el texto más largo posible
+    VERIFICAR(parametros.agregarTexto("mqtt_host", "MQTT server", "broker.local"));
+    VERIFICAR(parametros.agregarEntero("intervalo", "Interval (s)", 60, 5, 3600));
+    VERIFICAR(parametros.agregarBool("tls", "Use TLS"));
+    VERIFICAR(parametros.agregarOpciones("modo", "Mode", "normal|ahorro|debug", "normal"));
+    VERIFICAR_IGUAL(parametros.cantidad(), 4);
+}
+
+// El búfer que no alcanza da 0, no un objeto cortado
+PRUEBA(como_json_devuelve_cero_si_no_entra) {
+    ParametrosPortal parametros;
+    VERIFICAR(parametros.agregarOpciones("modo", "Mode", "normal|ahorro|debug", "normal"));
+    char buf[WM_PARAMETRO_JSON];
+    size_t completo = parametros.comoJson(0, nullptr, false, buf, sizeof(buf));
+    VERIFICAR(completo > 0);
+    for (size_t capacidad = 1; capacidad <= completo; ++capacidad) {
+        VERIFICAR_IGUAL(parametros.comoJson(0, nullptr, false, buf, capacidad), 0u);
+    }
+    VERIFICAR_IGUAL(parametros.comoJson(0, nullptr, false, buf, completo + 1), completo);
+}
+
+// El peor valor guardado (todo bytes de control, al largo máximo) sale entero
+// y un valor que el campo ya no acepta se muestra como el por defecto
+PRUEBA(params_es_json_valido_con_el_peor_valor) {
+    WifiManager wm;
+    VERIFICAR(wm.parametrosPortal().agregarTexto("clave_api", "API key \"v2\""));
+    VERIFICAR(wm.parametrosPortal().agregarOpciones("modo", "Mode", "normal|ahorro|debug", "normal"));
+    escenario::abrirPortal(wm);
+    std::string peor(WM_CONFIG_VALOR - 1, '\x01');
+    VERIFICAR(wm.setConfig("setup", "clave_api", peor.c_str()));
+    VERIFICAR(wm.setConfig("setup", "modo", "turbo"));
+
+    DynamicJsonDocument doc(4096);
+    leerParams(wm, doc);
+    JsonArray lista = doc.as<JsonArray>();
+    VERIFICAR_IGUAL(lista.size(), 2u);
+    VERIFICAR(lista[0]["value"].as<const char*>() == peor);
+    VERIFICAR_TEXTO(lista[0]["label"].as<const char*>(), "API key \"v2\"");
+    VERIFICAR_TEXTO(lista[1]["value"].as<const char*>(), "normal");
+}
+
+PRUEBAS_MAIN()
@@ -0,0 +1,117 @@
+// Portal sobre ESPAsyncWebServer (WM_ASYNC_SERVER=1): archivos de LittleFS
+// con su variante .gz, vida del cursor de /scan, métricas escritas desde la
+// tarea de AsyncTCP y envíos de /save rechazados.
+
+#include "prueba.h"
+#include "escenario.h"
+
+namespace {
+
+void abrirPortalAsync(WifiManager& wm) {
+    wm.usarPortalEmbebido(false);
+    wm.habilitarMetricas(true);
+    escenario::abrirPortal(wm);
+}
+
+} // namespace
+
+PRUEBA(el_gz_va_antes_que_el_plano) {
+    sim::escribirArchivo("/index.html", "<html>plano</html>");
+    sim::escribirArchivo("/index.html.gz", "GZ-comprimido");
+    WifiManager wm(2, 0, ServidorPortal::ASINCRONO);
+    abrirPortalAsync(wm);
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+
+    sim::RespuestaHttp gz = cliente.cabecera("Accept-Encoding", "gzip, deflate").get("/");
+    VERIFICAR_IGUAL(gz.codigo, 200);
+    VERIFICAR_TEXTO(gz.cuerpo.c_str(), "GZ-comprimido");
+    VERIFICAR_TEXTO(gz.cabecera("Content-Encoding"), "gzip");
+
+    // Sin Accept-Encoding sale el plano, y un ETag distinto del comprimido
+    sim::RespuestaHttp plano = cliente.get("/");
+    VERIFICAR_TEXTO(plano.cuerpo.c_str(), "<html>plano</html>");
+    VERIFICAR(plano.cabecera("Content-Encoding") == nullptr);
+    VERIFICAR(strcmp(plano.cabecera("ETag"), gz.cabecera("ETag")) != 0);
+
+    sim::RespuestaHttp revalida = cliente.cabecera("Accept-Encoding", "gzip")
+                                         .cabecera("If-None-Match", gz.cabecera("ETag")).get("/");
+    VERIFICAR_IGUAL(revalida.codigo, 304);
+}
+
+PRUEBA(el_cursor_de_scan_se_libera_al_cerrar) {
+    for (int i = 0; i < 40; ++i) {
+        char ssid[16];
+        snprintf(ssid, sizeof(ssid), "Red-%02d", i);
+        sim::agregarRedFantasma(ssid, 1 + i % 11, -40 - i, 3);
+    }
+    WifiManager wm(2, 0, ServidorPortal::ASINCRONO);
+    abrirPortalAsync(wm);
+    sim::hasta([&wm]() { return wm.scanner().vigente(); }, [&wm]() { wm.update(); }, 10000);
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+    cliente.get("/scan");                               // deja armadas las estructuras de una vez
+
+    int64_t vivos = sim::memoria().bytesVivos;
+    sim::RespuestaHttp completa = cliente.get("/scan");
+    VERIFICAR_IGUAL(completa.codigo, 200);
+    VERIFICAR(completa.chunked);
+    VERIFICAR(completa.cuerpo.size() > 2 * 1436);       // más de una vuelta de AsyncTCP
+    VERIFICAR_IGUAL(sim::memoria().bytesVivos, vivos);
+
+    // El teléfono se va con la respuesta a medias
+    sim::PedidoHttp pedido;
+    pedido.ruta = "/scan";
+    sim::RespuestaHttp cortada;
+    sim::servidor(80)->entregar(pedido, cortada);
+    sim::atenderServidores();
+    VERIFICAR(!cortada.completa && cortada.cuerpo.size() > 0);
+    sim::servidor(80)->abandonar(cortada);
+    VERIFICAR_IGUAL(sim::memoria().bytesVivos, vivos);
+}
+
+PRUEBA(las_metricas_http_se_registran_desde_asynctcp) {
+    WifiManager wm(2, 0, ServidorPortal::ASINCRONO);
+    abrirPortalAsync(wm);
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+    for (int i = 0; i < 3; ++i) cliente.get("/");
+    sim::RespuestaHttp cautivo = cliente.get("/generate_204");
+    VERIFICAR_IGUAL(cautivo.codigo, 302);
+    VERIFICAR_TEXTO(cautivo.cabecera("Location"), "http://192.168.4.1/");
+
+    const WifiMetrics& m = wm.metricas();
+    VERIFICAR_IGUAL(m.rutas[static_cast<uint8_t>(RutaHttp::RAIZ)].cantidad, 3u);
+    VERIFICAR_IGUAL(m.rutas[static_cast<uint8_t>(RutaHttp::NOT_FOUND)].cantidad, 1u);
+
+    sim::RespuestaHttp metricas = cliente.get("/metrics");
+    VERIFICAR(metricas.cuerpo.find("wm_http_handler_seconds_count{route=\"/\"} 3") != std::string::npos);
+}
+
+// Un /save con credenciales vacías o demasiado largas descarta también los
+// parámetros propios que ya se habían validado: el próximo envío no los arrastra
+PRUEBA(un_save_rechazado_descarta_los_parametros) {
+    WifiManager wm(2, 0, ServidorPortal::ASINCRONO);
+    VERIFICAR(wm.parametrosPortal().agregarEntero("intervalo", "Intervalo (s)", 60, 5, 3600));
+    abrirPortalAsync(wm);
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+
+    const std::string largo(80, 'x');
+    const char* const rechazos[][2] = { { "", "clave1234" }, { "Casa", "" }, { largo.c_str(), "clave1234" },
+                                        { "Casa", largo.c_str() } };
+    for (const auto& r : rechazos) {
+        std::vector<std::pair<std::string, std::string>> formulario;
+        formulario.push_back(std::make_pair(std::string("intervalo"), std::string("30")));
+        formulario.push_back(std::make_pair(std::string("ssid"), std::string(r[0])));
+        formulario.push_back(std::make_pair(std::string("password"), std::string(r[1])));
+        VERIFICAR_IGUAL(cliente.post("/save", formulario).codigo, 500);
+    }
+
+    // Sin el campo (la página vieja no lo dibuja) queda el valor por defecto
+    std::vector<std::pair<std::string, std::string>> formulario;
+    formulario.push_back(std::make_pair(std::string("ssid"), std::string("Casa")));
+    formulario.push_back(std::make_pair(std::string("password"), std::string("clave1234")));
+    VERIFICAR_IGUAL(cliente.post("/save", formulario).codigo, 200);
+    wm.update();
+    VERIFICAR(wm.redesGuardadas().indice("Casa") >= 0);
+    VERIFICAR_IGUAL(wm.getConfigInt("setup", "intervalo", 60), 60);
+}
+
+PRUEBAS_MAIN()
@@ -0,0 +1,62 @@
+// Tabla de redes conocidas a través de WifiManager::agregarRed().
+
+#include "prueba.h"
+#include "escenario.h"
+
+namespace {
+
+const RedGuardada* buscar(WifiManager& wm, const char* ssid) {
+    int8_t i = wm.redesGuardadas().indice(ssid);
+    return i < 0 ? nullptr : &wm.redesGuardadas().red(i);
+}
+
+} // namespace
+
+PRUEBA(volver_a_guardar_conserva_el_historial) {
+    sim::agregarAp("Casa", "clave1234", 6, -55);
+    escenario::guardarRed("Casa", "clave1234");
+
+    WifiManager wm;
+    wm.begin();
+    wm.agregarRed("Oficina", "otra-clave");
+    wm.conectarAsync();
+    VERIFICAR(escenario::hastaOnline(wm, 10000) >= 0);
+    RedGuardada antes = *buscar(wm, "Casa");
+    VERIFICAR(antes.latenciaMs > 0);
+
+    VERIFICAR(wm.agregarRed("Casa", "clave-nueva"));
+    const RedGuardada* despues = buscar(wm, "Casa");
+    VERIFICAR(despues != nullptr);
+    VERIFICAR_IGUAL(wm.redesGuardadas().cantidad(), 2);
+    VERIFICAR_IGUAL(despues->latenciaMs, antes.latenciaMs);
+    VERIFICAR_IGUAL(despues->ultimoExito, antes.ultimoExito);
+    VERIFICAR_TEXTO(despues->password, "clave-nueva");
+
+    // Y sobrevive al reinicio
+    WifiManager otro;
+    otro.begin();
+    VERIFICAR(buscar(otro, "Casa") && buscar(otro, "Casa")->latenciaMs == antes.latenciaMs);
+}
+
+PRUEBA(clave_invalida_no_pierde_la_red) {
+    escenario::guardarRed("Casa", "clave1234");
+
+    WifiManager wm;
+    wm.begin();
+    char larga[80];
+    memset(larga, 'x', sizeof(larga) - 1);
+    larga[sizeof(larga) - 1] = '\0';
+    VERIFICAR(!wm.agregarRed("Casa", larga));
+    VERIFICAR(!wm.agregarRed("Casa", nullptr));
+    VERIFICAR(!wm.agregarRed(nullptr, "x"));
+
+    const RedGuardada* red = buscar(wm, "Casa");
+    VERIFICAR(red != nullptr);
+    VERIFICAR_TEXTO(red->password, "clave1234");
+
+    WifiManager otro;
+    otro.begin();
+    VERIFICAR(otro.tieneCredenciales());
+}
+
+PRUEBAS_MAIN()
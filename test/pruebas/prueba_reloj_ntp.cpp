@@ -0,0 +1,44 @@
+// RelojNtp: deriva medida entre anclas y saltos de hora (NTP que corrige el
+// reloj de golpe, en cualquier sentido), que reanclan sin tocar la deriva.
+
+#include "prueba.h"
+
+#include <relojntp.h>
+
+namespace {
+
+const int64_t HORA_US = 3600LL * 1000000;
+const int64_t DIA_US  = 24 * HORA_US;
+const int64_t EPOCH_US = 1760000000LL * 1000000;
+
+// Ancla en 0 y una hora después con el cristal atrasado @p ppb
+void medirDeriva(RelojNtp& reloj, int64_t ppb) {
+    reloj.sincronizar(EPOCH_US, 0);
+    reloj.sincronizar(EPOCH_US + HORA_US + HORA_US * ppb / 1000000000LL, HORA_US);
+}
+
+} // namespace
+
+PRUEBA(mide_la_deriva_del_cristal) {
+    RelojNtp reloj;
+    medirDeriva(reloj, 20000);
+    VERIFICAR_IGUAL(reloj.derivaPpb(), 20000);
+    int64_t esperado = EPOCH_US + 2 * HORA_US + 2 * HORA_US * 20000 / 1000000000LL;
+    VERIFICAR_IGUAL(reloj.epochUs(2 * HORA_US), esperado);
+}
+
+PRUEBA(un_salto_de_hora_reancla_sin_tocar_la_deriva) {
+    // ~5,1 h: residuo · 1e9 pasa 2^64 y, desbordado, parecería una deriva de 400 ppm
+    const int64_t saltos[] = { 10LL * 1000000, -10LL * 1000000, 18448184074LL, DIA_US, -DIA_US, 400 * DIA_US };
+    for (int64_t salto : saltos) {
+        RelojNtp reloj;
+        medirDeriva(reloj, 20000);
+        int64_t nuevo = reloj.epochUs(2 * HORA_US) + salto;
+        reloj.sincronizar(nuevo, 2 * HORA_US);
+        VERIFICAR_IGUAL(reloj.derivaPpb(), 20000);
+        VERIFICAR_IGUAL(reloj.epochUs(2 * HORA_US), nuevo);
+        VERIFICAR_IGUAL(reloj.edadUs(2 * HORA_US), 0);
+    }
+}
+
+PRUEBAS_MAIN()
@@ -0,0 +1,48 @@
+// /save con el WebServer del core 2.x (WM_HOST_CORE2): arg() y argName()
+// devuelven String por valor. SSID, clave y parámetros más largos que los 11
+// caracteres que entran sin heap tienen que llegar intactos, aunque el
+// temporal de cada arg() se libere al terminar su vuelta.
+
+#include "prueba.h"
+#include "escenario.h"
+
+namespace {
+
+std::vector<std::pair<std::string, std::string>> formulario(const std::string& ssid, const std::string& clave) {
+    std::vector<std::pair<std::string, std::string>> campos;
+    campos.push_back(std::make_pair(std::string("ssid"), ssid));
+    campos.push_back(std::make_pair(std::string("password"), clave));
+    campos.push_back(std::make_pair(std::string("mqtt_host"), std::string("broker.planta-alta.local")));
+    return campos;
+}
+
+} // namespace
+
+PRUEBA(save_copia_lo_que_arg_devuelve_por_valor) {
+    WifiManager wm;
+    VERIFICAR(wm.parametrosPortal().agregarTexto("mqtt_host", "MQTT server", "broker.local"));
+    escenario::abrirPortal(wm);
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+
+    sim::RespuestaHttp r = cliente.post("/save", formulario("Oficina-Planta-Alta", "una-clave-bastante-larga"));
+    VERIFICAR_IGUAL(r.codigo, 200);
+    int i = wm.redesGuardadas().indice("Oficina-Planta-Alta");
+    VERIFICAR(i >= 0);
+    if (i >= 0) VERIFICAR_TEXTO(wm.redesGuardadas().red(i).password, "una-clave-bastante-larga");
+
+    char host[WM_CONFIG_VALOR];
+    VERIFICAR(wm.getConfigString("setup", "mqtt_host", host, sizeof(host)));
+    VERIFICAR_TEXTO(host, "broker.planta-alta.local");
+}
+
+PRUEBA(save_rechaza_un_ssid_que_no_entra) {
+    WifiManager wm;
+    escenario::abrirPortal(wm);
+    sim::ClienteHttp cliente([&wm]() { wm.update(); });
+
+    VERIFICAR_IGUAL(cliente.post("/save", formulario(std::string(33, 's'), "clave1234")).codigo, 500);
+    VERIFICAR_IGUAL(cliente.post("/save", formulario("Casa", std::string(65, 'c'))).codigo, 500);
+    VERIFICAR_IGUAL(wm.redesGuardadas().cantidad(), 0);
+}
+
+PRUEBAS_MAIN()
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""
+Genera src/wifimanager_portal.h a partir de data/wifimanager/*.html.
+
+Cada página se minifica, se comprime con gzip (nivel 9, sin marca de tiempo,
+salida reproducible) y se vuelca como arreglo constexpr en flash junto con su
+longitud y un hash FNV-1a de 32 bits que sirve de ETag.
+
+Uso (desde la raíz de la librería, después de editar los HTML):
+    python3 tools/embed_portal.py
+"""
+
+import gzip
+import os
+import re
+import sys
+
+RAIZ = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+ORIGEN = os.path.join(RAIZ, "data", "wifimanager")
+DESTINO = os.path.join(RAIZ, "src", "wifimanager_portal.h")
+PAGINAS = ["index.html", "success.html", "error.html"]
+
+
+def minificar_css(css):
+    css = re.sub(r"/\*.*?\*/", "", css, flags=re.S)
+    css = re.sub(r"\s+", " ", css)
+    css = re.sub(r"\s*([{};:,>])\s*", r"\1", css)
+    return css.replace(";}", "}").strip()
+
+
+def minificar_js(js):
+    # Conservador: sólo sangría, líneas vacías y comentarios de línea completa
+    lineas = []
+    for linea in js.splitlines():
+        linea = linea.strip()
+        if not linea or linea.startswith("//"):
+            continue
+        lineas.append(linea)
+    return "\n".join(lineas)
+
+
+def minificar_html(html):
+    partes = re.split(r"(<script>.*?</script>|<style>.*?</style>)", html, flags=re.S)
+    salida = []
+    for parte in partes:
+        if parte.startswith("<script>"):
+            salida.append("<script>" + minificar_js(parte[8:-9]) + "</script>")
+        elif parte.startswith("<style>"):
+            salida.append("<style>" + minificar_css(parte[7:-8]) + "</style>")
+        else:
+            parte = re.sub(r"<!--.*?-->", "", parte, flags=re.S)
+            parte = re.sub(r"\s+", " ", parte)
+            parte = re.sub(r">\s+<", "><", parte)
+            salida.append(parte.strip())
+    return "".join(salida)
+
+
+def fnv1a32(datos):
+    h = 0x811C9DC5
+    for b in datos:
+        h ^= b
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def identificador(nombre):
+    return re.sub(r"[^0-9A-Za-z]", "_", nombre) + "_gz"
+
+
+def volcar_bytes(datos):
+    lineas = []
+    for i in range(0, len(datos), 16):
+        lineas.append("    " + ", ".join("0x%02x" % b for b in datos[i:i + 16]) + ",")
+    return "\n".join(lineas)
+
+
+def main():
+    bloques = []
+    tabla = []
+    for nombre in PAGINAS:
+        with open(os.path.join(ORIGEN, nombre), encoding="utf-8") as f:
+            original = f.read()
+        minificado = minificar_html(original).encode("utf-8")
+        comprimido = gzip.compress(minificado, compresslevel=9, mtime=0)
+        ident = identificador(nombre)
+        hash_ = fnv1a32(comprimido)
+        bloques.append(
+            "// %s: %d bytes -> %d minificado -> %d gzip\n"
+            "constexpr uint8_t %s[] PROGMEM = {\n%s\n};\n"
+            % (nombre, len(original.encode("utf-8")), len(minificado), len(comprimido),
+               ident, volcar_bytes(comprimido)))
+        tabla.append('    { "%s", "text/html", %s, sizeof(%s), 0x%08xu, "\\"%08x\\"" },'
+                     % (nombre, ident, ident, hash_, hash_))
+
+    contenido = """// Generado por tools/embed_portal.py a partir de data/wifimanager/.
+// No editar a mano: modificar los HTML y volver a ejecutar el script.
+#ifndef WIFI_MANAGER_PORTAL_H
+#define WIFI_MANAGER_PORTAL_H
+
+#include <Arduino.h>
+
+/**
+ * @struct RecursoPortal
+ * @brief Página del portal embebida en flash, ya minificada y comprimida con gzip.
+ */
+struct RecursoPortal {
+    const char*    nombre;    ///< nombre relativo, p. ej. "index.html"
+    const char*    tipo;      ///< Content-Type
+    const uint8_t* datos;     ///< cuerpo gzip en flash
+    size_t         longitud;  ///< bytes de datos
+    uint32_t       hash;      ///< FNV-1a 32 de los bytes gzip
+    const char*    etag;      ///< hash entre comillas, listo para la cabecera ETag
+};
+
+namespace wm_portal {
+
+%s
+constexpr RecursoPortal RECURSOS[] = {
+%s
+};
+
+constexpr size_t CANTIDAD = sizeof(RECURSOS) / sizeof(RECURSOS[0]);
+
+} // namespace wm_portal
+
+#endif
+""" % ("\n".join(bloques), "\n".join(tabla))
+
+    with open(DESTINO, "w", encoding="utf-8", newline="\r\n") as f:
+        f.write(contenido)
+    print("Generado %s" % os.path.relpath(DESTINO, RAIZ))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())